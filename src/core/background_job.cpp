@@ -0,0 +1,90 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "core/background_job.h"
+
+#include <common/sprintf.h>  // for MemSPrintf
+#include <common/value.h>    // for ErrorValue
+
+#include "core/internal/cdb_connection_client.h"  // for CDBConnectionClient
+
+namespace fastonosql {
+namespace core {
+
+BackgroundJob::BackgroundJob()
+    : thread_(), running_(false), cancelled_(false), name_(), client_(nullptr) {}
+
+BackgroundJob::~BackgroundJob() {
+  Cancel();
+  Wait();
+}
+
+common::Error BackgroundJob::Start(const std::string& name,
+                                   job_func_t func,
+                                   CDBConnectionClient* client) {
+  if (running_) {
+    std::string buff = common::MemSPrintf("%s is already running in background", name_);
+    return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+  }
+
+  Wait();  // previous job is done, join its thread
+  cancelled_ = false;
+  running_ = true;
+  name_ = name;
+  client_ = client;
+  NotifyProgress(0);  // before command reply, GUI sees the job started
+  thread_ = std::thread([this, func]() {
+    std::string summary;
+    common::Error err = func(this, &summary);
+    if (!err && cancelled_) {
+      err = common::make_error_value("Interrupted.", common::ErrorValue::E_INTERRUPTED);
+    }
+    if (client_) {
+      client_->OnJobFinished(name_, err, summary);
+    }
+    running_ = false;
+  });
+  return common::Error();
+}
+
+void BackgroundJob::Cancel() {
+  cancelled_ = true;
+}
+
+void BackgroundJob::Wait() {
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+bool BackgroundJob::IsRunning() const {
+  return running_;
+}
+
+bool BackgroundJob::IsCancelled() const {
+  return cancelled_;
+}
+
+void BackgroundJob::NotifyProgress(int percent) {
+  if (client_) {
+    client_->OnJobProgress(name_, percent);
+  }
+}
+
+}  // namespace core
+}  // namespace fastonosql
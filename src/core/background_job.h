@@ -0,0 +1,67 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>      // for atomic
+#include <functional>  // for function
+#include <string>      // for string
+#include <thread>      // for thread
+
+#include <common/error.h>   // for Error
+#include <common/macros.h>  // for DISALLOW_COPY_AND_ASSIGN, WARN_UNUSED_RESULT
+
+namespace fastonosql {
+namespace core {
+
+class CDBConnectionClient;
+
+// One long engine job (COMPACT) on its own thread, so the driver thread keeps
+// serving commands. The job polls IsCancelled between its steps; client gets
+// OnJobProgress and OnJobFinished from the job thread.
+class BackgroundJob {
+ public:
+  typedef std::function<common::Error(BackgroundJob* job, std::string* summary)> job_func_t;
+
+  BackgroundJob();
+  ~BackgroundJob();  // cancels and waits for running job
+
+  // fails while previous job still runs
+  common::Error Start(const std::string& name,
+                      job_func_t func,
+                      CDBConnectionClient* client) WARN_UNUSED_RESULT;
+  void Cancel();  // any thread
+  void Wait();
+  bool IsRunning() const;
+
+  // job side
+  bool IsCancelled() const;
+  void NotifyProgress(int percent);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(BackgroundJob);
+
+  std::thread thread_;
+  std::atomic<bool> running_;
+  std::atomic<bool> cancelled_;
+  std::string name_;
+  CDBConnectionClient* client_;
+};
+
+}  // namespace core
+}  // namespace fastonosql
@@ -0,0 +1,360 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "core/benchmark.h"
+
+#include <inttypes.h>  // for PRIu64
+#include <stdlib.h>    // for strtoull
+#include <string.h>    // for strcmp
+
+#include <algorithm>  // for min
+#include <chrono>     // for steady_clock
+#include <random>     // for minstd_rand
+#include <thread>     // for thread
+
+extern "C" {
+#include "sds.h"
+}
+
+#include <common/convert2string.h>  // for ConvertToString
+#include <common/sprintf.h>         // for MemSPrintf
+#include <common/string_util.h>     // for FullEqualsASCII
+
+#include "core/db_key.h"  // for NKey, NDbKValue
+#include "core/global.h"  // for FastoObject, FastoObjectIPtr
+
+namespace fastonosql {
+namespace core {
+namespace {
+
+const char* kBenchmarkTests[] = {"SET", "GET", "DEL"};
+
+struct ClientStats {
+  ClientStats() : requests(0), errors(0), latency() {}
+
+  uint64_t requests;
+  uint64_t errors;
+  LatencyHistogram latency;
+};
+
+uint64_t NowUsec() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+common::Error ParseSize(const char* arg, const char* option, size_t* out) {
+  char* end = nullptr;
+  unsigned long long val = strtoull(arg, &end, 10);
+  if (!arg[0] || *end != '\0') {
+    return common::make_error_value(
+        common::MemSPrintf("Invalid value for %s option: %s", option, arg),
+        common::ErrorValue::E_ERROR);
+  }
+
+  *out = static_cast<size_t>(val);
+  return common::Error();
+}
+
+common::Error ParseTests(const std::string& arg, std::vector<std::string>* tests) {
+  tests->clear();
+  size_t start = 0;
+  while (start <= arg.size()) {
+    size_t end = arg.find(',', start);
+    if (end == std::string::npos) {
+      end = arg.size();
+    }
+
+    std::string test = arg.substr(start, end - start);
+    bool found = false;
+    for (size_t i = 0; i < SIZEOFMASS(kBenchmarkTests); ++i) {
+      if (common::FullEqualsASCII(test, kBenchmarkTests[i], false)) {
+        tests->push_back(kBenchmarkTests[i]);
+        found = true;
+        break;
+      }
+    }
+
+    if (!found) {
+      return common::make_error_value(
+          common::MemSPrintf("Unknown benchmark test: %s, supported: set,get,del", test),
+          common::ErrorValue::E_ERROR);
+    }
+    start = end + 1;
+  }
+
+  return common::Error();
+}
+
+std::string MakeKey(const BenchmarkConfig& config, std::minstd_rand* rand) {
+  if (!config.keyspace) {
+    return "key:__rand_int__";
+  }
+
+  return "key:" + common::ConvertToString(static_cast<uint64_t>((*rand)() % config.keyspace));
+}
+
+common::Error MakeCommand(translator_t translator,
+                          const std::string& test,
+                          const std::string& key,
+                          const std::string& value,
+                          std::string* cmdstring) {
+  NKey nkey(key);
+  if (test == "SET") {
+    NValue val(common::Value::createStringValue(value));
+    return translator->CreateKeyCommand(NDbKValue(nkey, val), cmdstring);
+  } else if (test == "GET") {
+    return translator->LoadKeyCommand(nkey, common::Value::TYPE_STRING, cmdstring);
+  }
+
+  return translator->DeleteKeyCommand(nkey, cmdstring);
+}
+
+void RunClient(const BenchmarkConfig& config,
+               const std::string& test,
+               internal::CommandHandler* handler,
+               size_t requests,
+               unsigned int seed,
+               benchmark_interrupt_t interrupted,
+               ClientStats* stats) {
+  translator_t translator = handler->Translator();
+  std::minstd_rand rand(seed);
+  const std::string value(config.value_size, 'x');
+  std::vector<std::string> batch;
+  size_t issued = 0;
+  while (issued < requests) {
+    if (interrupted && interrupted()) {
+      return;
+    }
+
+    // commands are prepared outside of timing, the ones which can't be
+    // built are errors and never sent
+    size_t depth = std::min(config.pipeline, requests - issued);
+    issued += depth;
+    batch.clear();
+    for (size_t i = 0; i < depth; ++i) {
+      std::string cmd;
+      common::Error err = MakeCommand(translator, test, MakeKey(config, &rand), value, &cmd);
+      if (err && err->isError()) {
+        stats->errors++;
+        continue;
+      }
+      batch.push_back(cmd);
+    }
+
+    if (batch.empty()) {
+      continue;
+    }
+
+    if (config.pipeline == 1) {
+      uint64_t start = NowUsec();
+      FastoObjectIPtr out(FastoObject::CreateRoot(batch[0]));
+      common::Error err = handler->Execute(batch[0], out.get());
+      stats->latency.Record(NowUsec() - start);
+      if (err && err->isError()) {
+        stats->errors++;
+      }
+      stats->requests++;
+      continue;
+    }
+
+    // like redis-benchmark: latency of a pipelined command is counted from
+    // sending the batch to the arrival of its reply
+    size_t replied = 0;
+    uint64_t start = NowUsec();
+    common::Error err = handler->ExecutePipeline(
+        batch, [stats, start, &replied](size_t index, common::Error rerr) {
+          UNUSED(index);
+          stats->latency.Record(NowUsec() - start);
+          if (rerr && rerr->isError()) {
+            stats->errors++;
+          }
+          replied++;
+        });
+    stats->requests += replied;
+    if (err && err->isError()) {
+      stats->errors += batch.size() - replied;
+    }
+  }
+}
+
+}  // namespace
+
+BenchmarkConfig::BenchmarkConfig()
+    : clients(BENCHMARK_DEFAULT_CLIENTS),
+      requests(BENCHMARK_DEFAULT_REQUESTS),
+      pipeline(1),
+      keyspace(BENCHMARK_DEFAULT_KEYSPACE),
+      value_size(BENCHMARK_DEFAULT_VALUE_SIZE),
+      tests({"SET", "GET"}) {}
+
+bool IsBenchmarkCommand(const std::string& line) {
+  size_t start = line.find_first_not_of(" \t");
+  if (start == std::string::npos) {
+    return false;
+  }
+
+  size_t end = line.find_first_of(" \t", start);
+  std::string name = line.substr(start, end == std::string::npos ? end : end - start);
+  return common::FullEqualsASCII(name, BENCHMARK_COMMAND, false);
+}
+
+common::Error ParseBenchmarkCommand(const std::string& line, BenchmarkConfig* config) {
+  if (!config || !IsBenchmarkCommand(line)) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  int argc = 0;
+  sds* argv = sdssplitargslong(line.c_str(), &argc);
+  if (!argv) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  BenchmarkConfig res;
+  common::Error err;
+  for (int i = 1; i < argc && (!err || !err->isError()); i += 2) {
+    const char* option = argv[i];
+    if (i + 1 >= argc) {
+      err = common::make_error_value(common::MemSPrintf("Missing value for %s option", option),
+                                     common::ErrorValue::E_ERROR);
+    } else if (strcmp(option, "-c") == 0) {
+      err = ParseSize(argv[i + 1], option, &res.clients);
+    } else if (strcmp(option, "-n") == 0) {
+      err = ParseSize(argv[i + 1], option, &res.requests);
+    } else if (strcmp(option, "-P") == 0) {
+      err = ParseSize(argv[i + 1], option, &res.pipeline);
+    } else if (strcmp(option, "-r") == 0) {
+      err = ParseSize(argv[i + 1], option, &res.keyspace);
+    } else if (strcmp(option, "-d") == 0) {
+      err = ParseSize(argv[i + 1], option, &res.value_size);
+    } else if (strcmp(option, "-t") == 0) {
+      err = ParseTests(argv[i + 1], &res.tests);
+    } else {
+      err = common::make_error_value(common::MemSPrintf("Unknown option: %s", option),
+                                     common::ErrorValue::E_ERROR);
+    }
+  }
+  sdsfreesplitres(argv, argc);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  if (res.clients == 0 || res.clients > BENCHMARK_MAX_CLIENTS) {
+    return common::make_error_value(
+        common::MemSPrintf("Clients count should be in range 1 - %d", BENCHMARK_MAX_CLIENTS),
+        common::ErrorValue::E_ERROR);
+  }
+
+  if (res.requests == 0 || res.pipeline == 0) {
+    return common::make_error_value("Requests and pipeline should be positive",
+                                    common::ErrorValue::E_ERROR);
+  }
+
+  *config = res;
+  return common::Error();
+}
+
+BenchmarkResult::BenchmarkResult()
+    : test(), clients(0), requests(0), errors(0), elapsed_usec(0), latency() {}
+
+BenchmarkResult::BenchmarkResult(const std::string& test)
+    : test(test), clients(0), requests(0), errors(0), elapsed_usec(0), latency() {}
+
+double BenchmarkResult::OpsPerSec() const {
+  return elapsed_usec ? requests * 1000000.0 / elapsed_usec : 0;
+}
+
+common::Error RunBenchmark(const BenchmarkConfig& config,
+                           const std::vector<internal::CommandHandler*>& clients,
+                           benchmark_interrupt_t interrupted,
+                           benchmark_results_t* results) {
+  if (clients.empty() || !results) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  if (config.pipeline > 1 && !clients[0]->IsPipelineSupported()) {
+    return common::make_error_value("Pipeline (-P) isn't supported by this database",
+                                    common::ErrorValue::E_ERROR);
+  }
+
+  translator_t translator = clients[0]->Translator();
+  for (size_t i = 0; i < config.tests.size(); ++i) {
+    std::string cmd;
+    common::Error err = MakeCommand(translator, config.tests[i], "key", "value", &cmd);
+    if (err && err->isError()) {
+      return err;
+    }
+  }
+
+  for (size_t t = 0; t < config.tests.size(); ++t) {
+    const std::string test = config.tests[t];
+    std::vector<ClientStats> stats(clients.size());
+    std::vector<std::thread> threads;
+    uint64_t start = NowUsec();
+    for (size_t i = 0; i < clients.size(); ++i) {
+      size_t requests = config.requests / clients.size() + (i < config.requests % clients.size());
+      threads.push_back(std::thread(RunClient, std::cref(config), std::cref(test), clients[i],
+                                    requests, static_cast<unsigned int>(i + 1), interrupted,
+                                    &stats[i]));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+      threads[i].join();
+    }
+
+    BenchmarkResult result(test);
+    result.clients = clients.size();
+    result.elapsed_usec = NowUsec() - start;
+    for (size_t i = 0; i < stats.size(); ++i) {
+      result.requests += stats[i].requests;
+      result.errors += stats[i].errors;
+      result.latency.Merge(stats[i].latency);
+    }
+    results->push_back(result);
+
+    if (interrupted && interrupted()) {
+      return common::make_error_value("Interrupted benchmark", common::ErrorValue::E_INTERRUPTED);
+    }
+  }
+
+  return common::Error();
+}
+
+std::string BenchmarkReport(const BenchmarkConfig& config, const benchmark_results_t& results) {
+  std::string report;
+  for (size_t i = 0; i < results.size(); ++i) {
+    const BenchmarkResult& res = results[i];
+    const LatencyHistogram& lat = res.latency;
+    report += common::MemSPrintf(
+        "====== %s ======\n"
+        "  %" PRIu64 " requests completed in %.2f seconds, %" PRIu64 " errors\n"
+        "  %" PRIuMAX " parallel clients, pipeline %" PRIuMAX ", %" PRIuMAX
+        " bytes payload, keyspace %" PRIuMAX "\n"
+        "  %.2f requests per second\n"
+        "  latency usec: min %" PRIu64 ", p50 %" PRIu64 ", p90 %" PRIu64 ", p99 %" PRIu64
+        ", p99.9 %" PRIu64 ", max %" PRIu64 ", avg %.2f\n",
+        res.test, res.requests, res.elapsed_usec / 1000000.0, res.errors,
+        static_cast<uintmax_t>(res.clients), static_cast<uintmax_t>(config.pipeline),
+        static_cast<uintmax_t>(config.value_size), static_cast<uintmax_t>(config.keyspace),
+        res.OpsPerSec(), lat.Min(), lat.ValueAtPercentile(50), lat.ValueAtPercentile(90),
+        lat.ValueAtPercentile(99), lat.ValueAtPercentile(99.9), lat.Max(), lat.Mean());
+  }
+  return report;
+}
+
+}  // namespace core
+}  // namespace fastonosql
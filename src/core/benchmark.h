@@ -0,0 +1,141 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint64_t
+
+#include <functional>  // for function
+#include <string>      // for string
+#include <vector>      // for vector
+
+#include <common/error.h>   // for Error
+#include <common/macros.h>  // for WARN_UNUSED_RESULT
+#include <common/value.h>   // for ErrorValue
+
+#include "core/latency_histogram.h"  // for LatencyHistogram
+
+#include "core/internal/cdb_connection_client.h"  // for CDBConnectionClient
+#include "core/internal/command_handler.h"        // for CommandHandler
+
+#define BENCHMARK_COMMAND "BENCHMARK"
+#define BENCHMARK_DEFAULT_CLIENTS 4
+#define BENCHMARK_MAX_CLIENTS 256
+#define BENCHMARK_DEFAULT_REQUESTS 10000
+#define BENCHMARK_DEFAULT_KEYSPACE 10000
+#define BENCHMARK_DEFAULT_VALUE_SIZE 3
+
+namespace fastonosql {
+namespace core {
+
+// BENCHMARK [-c clients] [-n requests] [-P pipeline] [-r keyspace] [-d bytes] [-t set,get,del]
+struct BenchmarkConfig {
+  BenchmarkConfig();
+
+  size_t clients;
+  size_t requests;    // per test, split between clients
+  size_t pipeline;    // commands sent before reading replies, engines with pipelining only
+  size_t keyspace;    // random keys key:0 .. key:keyspace-1, 0 for single key
+  size_t value_size;  // SET payload
+  std::vector<std::string> tests;
+};
+
+bool IsBenchmarkCommand(const std::string& line);
+common::Error ParseBenchmarkCommand(const std::string& line,
+                                    BenchmarkConfig* config) WARN_UNUSED_RESULT;
+
+struct BenchmarkResult {
+  BenchmarkResult();
+  explicit BenchmarkResult(const std::string& test);
+
+  double OpsPerSec() const;
+
+  std::string test;
+  size_t clients;
+  uint64_t requests;
+  uint64_t errors;
+  uint64_t elapsed_usec;
+  LatencyHistogram latency;  // usec
+};
+
+typedef std::vector<BenchmarkResult> benchmark_results_t;
+typedef std::function<bool()> benchmark_interrupt_t;
+
+// every client runs in own thread, the same handler can be passed several
+// times if the engine handle is thread safe
+common::Error RunBenchmark(const BenchmarkConfig& config,
+                           const std::vector<internal::CommandHandler*>& clients,
+                           benchmark_interrupt_t interrupted,
+                           benchmark_results_t* results) WARN_UNUSED_RESULT;
+std::string BenchmarkReport(const BenchmarkConfig& config, const benchmark_results_t& results);
+
+// remote engines: own connection per client
+template <class DBConnection>
+common::Error RunConnectionsBenchmark(const typename DBConnection::config_t& db_config,
+                                      const BenchmarkConfig& config,
+                                      benchmark_interrupt_t interrupted,
+                                      benchmark_results_t* results) {
+  std::vector<DBConnection*> connections;
+  std::vector<internal::CommandHandler*> clients;
+  common::Error err;
+  for (size_t i = 0; i < config.clients; ++i) {
+    DBConnection* connection = new DBConnection(nullptr);
+    connections.push_back(connection);
+    err = connection->Connect(db_config);
+    if (err && err->isError()) {
+      break;
+    }
+    clients.push_back(connection);
+  }
+
+  if (!err || !err->isError()) {
+    err = RunBenchmark(config, clients, interrupted, results);
+  }
+
+  for (size_t i = 0; i < connections.size(); ++i) {
+    if (connections[i]->IsConnected()) {
+      common::Error derr = connections[i]->Disconnect();
+      DCHECK(!derr);
+    }
+    delete connections[i];
+  }
+  return err;
+}
+
+// embedded engines: all clients share the opened handle, key notifications
+// of the connection client are muted while running
+template <class DBConnection>
+common::Error RunSharedBenchmark(DBConnection* connection,
+                                 const BenchmarkConfig& config,
+                                 benchmark_interrupt_t interrupted,
+                                 benchmark_results_t* results) {
+  if (!connection || !connection->IsConnected()) {
+    return common::make_error_value("Not connected", common::ErrorValue::E_ERROR);
+  }
+
+  std::vector<internal::CommandHandler*> clients(config.clients, connection);
+  CDBConnectionClient* client = connection->Client();
+  connection->SetClient(nullptr);
+  common::Error err = RunBenchmark(config, clients, interrupted, results);
+  connection->SetClient(client);
+  return err;
+}
+
+}  // namespace core
+}  // namespace fastonosql
@@ -0,0 +1,387 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "core/command_stats.h"
+
+#include <inttypes.h>  // for PRIu64
+
+#include <algorithm>   // for sort
+#include <chrono>      // for steady_clock
+#include <functional>  // for hash
+#include <memory>      // for unique_ptr
+
+extern "C" {
+#include "sds.h"
+}
+
+#include <common/convert2string.h>  // for ConvertToString
+#include <common/macros.h>          // for COMPILE_ASSERT, SIZEOFMASS
+#include <common/sprintf.h>         // for MemSPrintf
+#include <common/string_util.h>     // for FullEqualsASCII
+
+namespace fastonosql {
+namespace core {
+namespace {
+
+const char* kStageNames[] = {"lookup", "args", "call", "post", "total"};
+COMPILE_ASSERT(SIZEOFMASS(kStageNames) == STAGE_COUNT, "kStageNames must match CommandStage");
+const double kQuantiles[] = {0.5, 0.9, 0.99};
+
+thread_local PostScope* current_post_scope = nullptr;
+
+double NsecToUsec(uint64_t nsec) {
+  return nsec / 1000.0;
+}
+
+std::string EscapeJson(const std::string& str) {
+  std::string res;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      res += '\\';
+      res += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      res += common::MemSPrintf("\\u%04x", static_cast<int>(c));
+    } else {
+      res += c;
+    }
+  }
+  return res;
+}
+
+std::string EscapePrometheusLabel(const std::string& str) {
+  std::string res;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      res += '\\';
+      res += c;
+    } else if (c == '\n') {
+      res += "\\n";
+    } else {
+      res += c;
+    }
+  }
+  return res;
+}
+
+std::string PrometheusLabels(const CommandStatsInfo& info) {
+  return common::MemSPrintf("type=\"%s\",command=\"%s\"",
+                            EscapePrometheusLabel(common::ConvertToString(info.type)),
+                            EscapePrometheusLabel(info.name));
+}
+
+bool CommandStatsLess(const CommandStatsInfo& lhs, const CommandStatsInfo& rhs) {
+  return lhs.name < rhs.name;
+}
+
+}  // namespace
+
+struct CommandStats::Entry {
+  Entry(connectionTypes type, const std::string& name)
+      : type(type), name(name), calls(0), errors(0) {
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+      stages[i].reset(
+          new AtomicLatencyHistogram(COMMAND_STATS_HIGHEST_NSEC, COMMAND_STATS_SIGNIFICANT_DIGITS));
+    }
+  }
+
+  const connectionTypes type;
+  const std::string name;
+  std::atomic<uint64_t> calls;
+  std::atomic<uint64_t> errors;
+  std::unique_ptr<AtomicLatencyHistogram> stages[STAGE_COUNT];
+};
+
+const char* CommandStageName(CommandStage stage) {
+  return stage < STAGE_COUNT ? kStageNames[stage] : "unknown";
+}
+
+uint64_t CommandStatsNowNsec() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+CommandStatsInfo::CommandStatsInfo() : type(), name(), calls(0), errors(0), stages() {}
+
+CommandStats::CommandStats() {
+  for (size_t i = 0; i < COMMAND_STATS_MAX_ENTRIES; ++i) {
+    entries_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+CommandStats::~CommandStats() {
+  for (size_t i = 0; i < COMMAND_STATS_MAX_ENTRIES; ++i) {
+    delete entries_[i].load(std::memory_order_relaxed);
+  }
+}
+
+void CommandStats::Record(connectionTypes type,
+                          const std::string& name,
+                          const uint64_t (&stages)[STAGE_COUNT],
+                          bool error) {
+  Entry* entry = FindOrCreate(type, name);
+  if (!entry) {  // table full
+    return;
+  }
+
+  entry->calls.fetch_add(1, std::memory_order_relaxed);
+  if (error) {
+    entry->errors.fetch_add(1, std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < STAGE_COUNT; ++i) {
+    if (stages[i] != COMMAND_STAGE_SKIPPED) {
+      entry->stages[i]->Record(stages[i]);
+    }
+  }
+}
+
+command_stats_t CommandStats::Snapshot(connectionTypes type) const {
+  command_stats_t res;
+  for (size_t i = 0; i < COMMAND_STATS_MAX_ENTRIES; ++i) {
+    Entry* entry = entries_[i].load(std::memory_order_acquire);
+    if (!entry || entry->type != type) {
+      continue;
+    }
+
+    CommandStatsInfo info;
+    info.type = entry->type;
+    info.name = entry->name;
+    info.calls = entry->calls.load(std::memory_order_relaxed);
+    info.errors = entry->errors.load(std::memory_order_relaxed);
+    for (size_t j = 0; j < STAGE_COUNT; ++j) {
+      info.stages.push_back(entry->stages[j]->Snapshot());
+    }
+    if (info.calls) {
+      res.push_back(info);
+    }
+  }
+
+  std::sort(res.begin(), res.end(), &CommandStatsLess);
+  return res;
+}
+
+void CommandStats::Reset(connectionTypes type) {
+  for (size_t i = 0; i < COMMAND_STATS_MAX_ENTRIES; ++i) {
+    Entry* entry = entries_[i].load(std::memory_order_acquire);
+    if (!entry || entry->type != type) {
+      continue;
+    }
+
+    entry->calls.store(0, std::memory_order_relaxed);
+    entry->errors.store(0, std::memory_order_relaxed);
+    for (size_t j = 0; j < STAGE_COUNT; ++j) {
+      entry->stages[j]->Reset();
+    }
+  }
+}
+
+CommandStats::Entry* CommandStats::FindOrCreate(connectionTypes type, const std::string& name) {
+  const size_t hash = std::hash<std::string>()(name) * 31 + static_cast<size_t>(type);
+  Entry* created = nullptr;
+  for (size_t probe = 0; probe < COMMAND_STATS_MAX_ENTRIES; ++probe) {
+    std::atomic<Entry*>& slot = entries_[(hash + probe) % COMMAND_STATS_MAX_ENTRIES];
+    Entry* entry = slot.load(std::memory_order_acquire);
+    if (!entry) {
+      if (!created) {
+        created = new Entry(type, name);
+      }
+      if (slot.compare_exchange_strong(entry, created, std::memory_order_acq_rel)) {
+        return created;
+      }
+      // lost the race, entry is now the winner
+    }
+
+    if (entry->type == type && entry->name == name) {
+      delete created;
+      return entry;
+    }
+  }
+
+  delete created;
+  return nullptr;
+}
+
+PostScope::PostScope() : nsec_(0), prev_(current_post_scope) {
+  current_post_scope = this;
+}
+
+PostScope::~PostScope() {
+  current_post_scope = prev_;
+}
+
+uint64_t PostScope::ElapsedNsec() const {
+  return nsec_;
+}
+
+void PostScope::AddPostTime(uint64_t nsec) {
+  if (current_post_scope) {
+    current_post_scope->nsec_ += nsec;
+  }
+}
+
+bool IsStatsCommand(const std::string& line) {
+  size_t start = line.find_first_not_of(" \t");
+  if (start == std::string::npos) {
+    return false;
+  }
+
+  size_t end = line.find_first_of(" \t", start);
+  std::string name = line.substr(start, end == std::string::npos ? end : end - start);
+  return common::FullEqualsASCII(name, STATS_COMMAND, false);
+}
+
+common::Error ParseStatsCommand(const std::string& line, bool* reset, StatsFormat* format) {
+  if (!reset || !format || !IsStatsCommand(line)) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  int argc = 0;
+  sds* argv = sdssplitargslong(line.c_str(), &argc);
+  if (!argv) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  bool lreset = false;
+  StatsFormat lformat = STATS_TEXT;
+  common::Error err;
+  if (argc > 2) {
+    err = common::make_error_value("Usage: " STATS_COMMAND " [RESET|TEXT|JSON|PROMETHEUS]",
+                                   common::ErrorValue::E_ERROR);
+  } else if (argc == 2) {
+    const std::string arg = argv[1];
+    if (common::FullEqualsASCII(arg, "RESET", false)) {
+      lreset = true;
+    } else if (common::FullEqualsASCII(arg, "TEXT", false)) {
+      lformat = STATS_TEXT;
+    } else if (common::FullEqualsASCII(arg, "JSON", false)) {
+      lformat = STATS_JSON;
+    } else if (common::FullEqualsASCII(arg, "PROMETHEUS", false)) {
+      lformat = STATS_PROMETHEUS;
+    } else {
+      std::string buff = common::MemSPrintf("Unknown " STATS_COMMAND " option: %s", arg);
+      err = common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
+  }
+  sdsfreesplitres(argv, argc);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  *reset = lreset;
+  *format = lformat;
+  return common::Error();
+}
+
+std::string CommandStatsReport(const command_stats_t& stats) {
+  if (stats.empty()) {
+    return "No commands executed";
+  }
+
+  std::string report = common::MemSPrintf("%-24s %10s %8s", "command", "calls", "errors");
+  for (size_t i = 0; i < STAGE_COUNT; ++i) {
+    report += common::MemSPrintf(" %19s", std::string(kStageNames[i]) + " p50/p99");
+  }
+  report += "\n";
+
+  for (const CommandStatsInfo& info : stats) {
+    report +=
+        common::MemSPrintf("%-24s %10" PRIu64 " %8" PRIu64, info.name, info.calls, info.errors);
+    for (const LatencyHistogram& stage : info.stages) {
+      std::string lat = common::MemSPrintf("%.1f/%.1f", NsecToUsec(stage.ValueAtPercentile(50)),
+                                           NsecToUsec(stage.ValueAtPercentile(99)));
+      report += common::MemSPrintf(" %19s", lat);
+    }
+    report += "\n";
+  }
+  report += "latency in usec";
+  return report;
+}
+
+std::string CommandStatsToJson(const command_stats_t& stats) {
+  std::string json = "{\"commands\":[";
+  for (size_t i = 0; i < stats.size(); ++i) {
+    const CommandStatsInfo& info = stats[i];
+    if (i) {
+      json += ",";
+    }
+    json += common::MemSPrintf(
+        "{\"type\":\"%s\",\"name\":\"%s\",\"calls\":%" PRIu64 ",\"errors\":%" PRIu64
+        ",\"stages\":{",
+        EscapeJson(common::ConvertToString(info.type)), EscapeJson(info.name), info.calls,
+        info.errors);
+    for (size_t j = 0; j < info.stages.size(); ++j) {
+      const LatencyHistogram& stage = info.stages[j];
+      if (j) {
+        json += ",";
+      }
+      json += common::MemSPrintf(
+          "\"%s\":{\"count\":%" PRIu64
+          ",\"mean_usec\":%.3f,\"p50_usec\":%.3f,\"p90_usec\":%.3f,\"p99_usec\":%.3f,"
+          "\"max_usec\":%.3f}",
+          kStageNames[j], stage.TotalCount(), stage.Mean() / 1000.0,
+          NsecToUsec(stage.ValueAtPercentile(50)), NsecToUsec(stage.ValueAtPercentile(90)),
+          NsecToUsec(stage.ValueAtPercentile(99)), NsecToUsec(stage.Max()));
+    }
+    json += "}}";
+  }
+  json += "]}";
+  return json;
+}
+
+std::string CommandStatsToPrometheus(const command_stats_t& stats) {
+  std::string text =
+      "# HELP fastonosql_command_calls_total Executed commands.\n"
+      "# TYPE fastonosql_command_calls_total counter\n";
+  for (const CommandStatsInfo& info : stats) {
+    text += common::MemSPrintf("fastonosql_command_calls_total{%s} %" PRIu64 "\n",
+                               PrometheusLabels(info), info.calls);
+  }
+
+  text +=
+      "# HELP fastonosql_command_errors_total Commands finished with error.\n"
+      "# TYPE fastonosql_command_errors_total counter\n";
+  for (const CommandStatsInfo& info : stats) {
+    text += common::MemSPrintf("fastonosql_command_errors_total{%s} %" PRIu64 "\n",
+                               PrometheusLabels(info), info.errors);
+  }
+
+  text +=
+      "# HELP fastonosql_command_stage_seconds Time spent in command execution stage.\n"
+      "# TYPE fastonosql_command_stage_seconds summary\n";
+  for (const CommandStatsInfo& info : stats) {
+    const std::string labels = PrometheusLabels(info);
+    for (size_t j = 0; j < info.stages.size(); ++j) {
+      const LatencyHistogram& stage = info.stages[j];
+      for (double quantile : kQuantiles) {
+        text += common::MemSPrintf(
+            "fastonosql_command_stage_seconds{%s,stage=\"%s\",quantile=\"%g\"} %.9f\n", labels,
+            kStageNames[j], quantile, stage.ValueAtPercentile(quantile * 100) / 1e9);
+      }
+      text += common::MemSPrintf("fastonosql_command_stage_seconds_sum{%s,stage=\"%s\"} %.9f\n",
+                                 labels, kStageNames[j], stage.Mean() * stage.TotalCount() / 1e9);
+      text += common::MemSPrintf("fastonosql_command_stage_seconds_count{%s,stage=\"%s\"} %" PRIu64
+                                 "\n",
+                                 labels, kStageNames[j], stage.TotalCount());
+    }
+  }
+  return text;
+}
+
+}  // namespace core
+}  // namespace fastonosql
@@ -0,0 +1,133 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint64_t
+
+#include <atomic>  // for atomic
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include <common/error.h>                       // for Error
+#include <common/macros.h>                      // for WARN_UNUSED_RESULT
+#include <common/patterns/singleton_pattern.h>  // for LazySingleton
+
+#include "core/connection_types.h"   // for connectionTypes
+#include "core/latency_histogram.h"  // for AtomicLatencyHistogram, LatencyHistogram
+
+#define STATS_COMMAND "STATS"
+#define COMMAND_STATS_MAX_ENTRIES 2048
+#define COMMAND_STATS_HIGHEST_NSEC UINT64_C(60000000000)  // 1 minute
+#define COMMAND_STATS_SIGNIFICANT_DIGITS 2
+#define COMMAND_STATS_UNKNOWN_COMMAND "(unknown)"
+#define COMMAND_STAGE_SKIPPED UINT64_MAX  // stage not reached, not recorded
+
+namespace fastonosql {
+namespace core {
+
+// where time of one CommandHandler::Execute goes, total covers all of them
+enum CommandStage {
+  STAGE_LOOKUP = 0,  // translator FindCommand
+  STAGE_ARGS,        // translator TestCommandArgs
+  STAGE_CALL,        // engine call and building reply objects
+  STAGE_POST,        // posting reply objects to the driver event queue, excluded from call
+  STAGE_TOTAL,
+  STAGE_COUNT
+};
+
+const char* CommandStageName(CommandStage stage);
+
+uint64_t CommandStatsNowNsec();
+
+// per command counters and stage histograms (nsec)
+struct CommandStatsInfo {
+  CommandStatsInfo();
+
+  connectionTypes type;
+  std::string name;
+  uint64_t calls;
+  uint64_t errors;
+  std::vector<LatencyHistogram> stages;  // indexed by CommandStage
+};
+
+typedef std::vector<CommandStatsInfo> command_stats_t;
+
+// Process wide, keyed by connection type and command name. Recording is lock
+// free: entries live in a fixed open addressing table, are created with CAS on
+// first call of a command and never freed, so histograms only cost memory for
+// commands which were actually executed.
+class CommandStats : public common::patterns::LazySingleton<CommandStats> {
+  friend class common::patterns::LazySingleton<CommandStats>;
+
+ public:
+  void Record(connectionTypes type,
+              const std::string& name,
+              const uint64_t (&stages)[STAGE_COUNT],
+              bool error);
+
+  command_stats_t Snapshot(connectionTypes type) const;
+  void Reset(connectionTypes type);
+
+ private:
+  struct Entry;
+
+  CommandStats();
+  ~CommandStats();
+
+  Entry* FindOrCreate(connectionTypes type, const std::string& name);
+
+  std::atomic<Entry*> entries_[COMMAND_STATS_MAX_ENTRIES];
+};
+
+// Replies are posted to the driver event queue from inside engine call
+// (FastoObject observers), observers report that time here and it is charged
+// to the post stage of the command running on the current thread. GUI handles
+// the queued events later, outside of the command.
+class PostScope {
+ public:
+  PostScope();
+  ~PostScope();
+
+  uint64_t ElapsedNsec() const;
+
+  static void AddPostTime(uint64_t nsec);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(PostScope);
+
+  uint64_t nsec_;
+  PostScope* const prev_;
+};
+
+// STATS [RESET | TEXT | JSON | PROMETHEUS]
+enum StatsFormat { STATS_TEXT, STATS_JSON, STATS_PROMETHEUS };
+
+bool IsStatsCommand(const std::string& line);
+common::Error ParseStatsCommand(const std::string& line,
+                                bool* reset,
+                                StatsFormat* format) WARN_UNUSED_RESULT;
+
+std::string CommandStatsReport(const command_stats_t& stats);
+std::string CommandStatsToJson(const command_stats_t& stats);
+std::string CommandStatsToPrometheus(const command_stats_t& stats);
+
+}  // namespace core
+}  // namespace fastonosql
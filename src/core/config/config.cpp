@@ -53,7 +53,8 @@ config_args_t LocalConfig::Args() const {
   return argv;
 }
 
-RemoteConfig::RemoteConfig(const common::net::HostAndPort& host) : BaseConfig(), host(host) {}
+RemoteConfig::RemoteConfig(const common::net::HostAndPort& host)
+    : BaseConfig(), host(host), timeout_msec(0) {}
 
 config_args_t RemoteConfig::Args() const {
   config_args_t argv;
@@ -52,6 +52,7 @@ struct RemoteConfig : public BaseConfig {
   config_args_t Args() const;
 
   common::net::HostAndPort host;
+  int timeout_msec;  // connect and read timeout, 0 - blocking; not a command line option
 };
 
 std::string ConvertToStringConfigArgs(const config_args_t& args);
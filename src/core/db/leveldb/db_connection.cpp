@@ -18,6 +18,8 @@
 
 #include "core/db/leveldb/db_connection.h"
 
+#include <sstream>  // for istringstream
+
 #include <leveldb/c.h>  // for leveldb_major_version, etc
 #include <leveldb/db.h>
 #include <leveldb/options.h>  // for ReadOptions, WriteOptions
@@ -25,18 +27,54 @@
 #include <common/sprintf.h>
 #include <common/convert2string.h>  // for ConvertFromString
 #include <common/file_system.h>
+#include <common/time.h>  // for current_mstime
 
 #include "core/db/leveldb/command_translator.h"
 #include "core/db/leveldb/database_info.h"
 #include "core/db/leveldb/internal/commands_api.h"
 
-#include "core/global.h"  // for FastoObject, etc
+#include "core/global.h"       // for FastoObject, etc
+#include "core/key_pattern.h"  // for KeyPattern
+#include "core/key_ranges.h"   // for ParallelScanKeys, MakeCompactBounds
+#include "core/key_sampler.h"  // for KeySampler, SampleKeyRanges
 
 #define LEVELDB_HEADER_STATS                             \
   "                               Compactions\n"         \
   "Level  Files Size(MB) Time(sec) Read(MB) Write(MB)\n" \
   "--------------------------------------------------\n"
 
+#define MB_BYTES (1024 * 1024)
+
+namespace {
+
+// engine types for range scan templates of core/key_ranges.h
+struct KeyRangeTraits {
+  typedef ::leveldb::DB db_t;
+  typedef ::leveldb::Snapshot snapshot_t;
+  typedef ::leveldb::Range range_t;
+  typedef ::leveldb::ReadOptions read_options_t;
+  typedef ::leveldb::Iterator iterator_t;
+  typedef ::leveldb::Slice slice_t;
+  typedef ::leveldb::Status status_t;
+
+  static void SetUpperBound(read_options_t* ro, const slice_t* upper_bound) {
+    UNUSED(ro);
+    UNUSED(upper_bound);
+  }
+
+  static status_t CompactRange(db_t* db, const slice_t* begin, const slice_t* end) {
+    db->CompactRange(begin, end);
+    return status_t();
+  }
+
+  static uint64_t StoredBytes(db_t* db, const std::vector<std::string>& bounds) {
+    std::vector<uint64_t> sizes;
+    return fastonosql::core::ApproximateKeyRangeSizes<db_t, range_t>(db, bounds, &sizes);
+  }
+};
+
+}  // namespace
+
 namespace fastonosql {
 namespace core {
 namespace internal {
@@ -128,13 +166,53 @@ common::Error TestConnection(const Config& config) {
   return common::Error();
 }
 
+DBConnection::ScanSession::ScanSession()
+    : snapshot(nullptr), it(nullptr), pattern(), cursor(0), last_access_msec(0) {}
+
 DBConnection::DBConnection(CDBConnectionClient* client)
-    : base_class(client, new CommandTranslator(base_class::Commands())) {}
+    : base_class(client, new CommandTranslator(base_class::Commands())), scan_session_() {}
+
+DBConnection::~DBConnection() {
+  compact_job_.Cancel();
+  compact_job_.Wait();
+  ReleaseScanSession();
+}
 
-common::Error DBConnection::Info(const char* args, ServerInfo::Stats* statsout) {
+common::Error DBConnection::Disconnect() {
+  compact_job_.Cancel();
+  compact_job_.Wait();
+  ReleaseScanSession();
+  return base_class::Disconnect();
+}
+
+void DBConnection::ExpireScanSession() {
+  if (!scan_session_.snapshot) {
+    return;
+  }
+
+  common::time64_t idle = common::time::current_mstime() - scan_session_.last_access_msec;
+  if (idle > SCAN_SESSION_TIMEOUT_MSEC) {
+    ReleaseScanSession();
+  }
+}
+
+void DBConnection::ReleaseScanSession() {
+  delete scan_session_.it;
+  scan_session_.it = nullptr;
+  if (scan_session_.snapshot) {
+    DCHECK(connection_.handle_);
+    connection_.handle_->ReleaseSnapshot(scan_session_.snapshot);
+    scan_session_.snapshot = nullptr;
+  }
+  scan_session_.pattern.clear();
+  scan_session_.cursor = 0;
+  scan_session_.last_access_msec = 0;
+}
+
+common::Error DBConnection::Info(const char* args, ServerInfo* info) {
   UNUSED(args);
 
-  if (!statsout) {
+  if (!info) {
     DNOTREACHED();
     return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
   }
@@ -149,6 +227,41 @@ common::Error DBConnection::Info(const char* args, ServerInfo::Stats* statsout)
     return common::make_error_value("info function failed", common::ErrorValue::E_ERROR);
   }
 
+  ServerInfo::Levels llevels;
+  ServerInfo::Storage lstorage;
+  if (rets.size() > sizeof(LEVELDB_HEADER_STATS)) {
+    // Level Files Size(MB) Time(sec) Read(MB) Write(MB), only levels with files or compactions
+    std::istringstream rows(rets.substr(sizeof(LEVELDB_HEADER_STATS) - 1));
+    std::string row;
+    while (std::getline(rows, row)) {
+      std::istringstream columns(row);
+      size_t level = 0;
+      uint32_t files = 0;
+      double size_mb = 0;
+      if (!(columns >> level >> files >> size_mb) || level >= LEVELDB_LEVELS_COUNT) {
+        continue;
+      }
+
+      llevels.size_mb_at_level[level] = size_mb;
+      lstorage.total_size_mb += size_mb;
+    }
+  }
+
+  for (size_t i = 0; i < LEVELDB_LEVELS_COUNT; ++i) {
+    std::string files;
+    if (connection_.handle_->GetProperty(
+            "leveldb.num-files-at-level" + common::ConvertToString(i), &files)) {
+      llevels.files_at_level[i] = common::ConvertFromString<uint32_t>(files);
+      lstorage.total_files += llevels.files_at_level[i];
+    }
+  }
+
+  std::string memory_usage;
+  if (connection_.handle_->GetProperty("leveldb.approximate-memory-usage", &memory_usage)) {
+    lstorage.approximate_memory_usage_mb =
+        common::ConvertFromString<uint64_t>(memory_usage) / MB_BYTES;
+  }
+
   ServerInfo::Stats lstats;
   if (rets.size() > sizeof(LEVELDB_HEADER_STATS)) {
     const char* retsc = rets.c_str() + sizeof(LEVELDB_HEADER_STATS);
@@ -178,7 +291,90 @@ common::Error DBConnection::Info(const char* args, ServerInfo::Stats* statsout)
     }
   }
 
-  *statsout = lstats;
+  info->stats_ = lstats;
+  info->levels_ = llevels;
+  info->storage_ = lstorage;
+  return common::Error();
+}
+
+common::Error DBConnection::Compact(const std::string& start,
+                                    const std::string& end,
+                                    FastoObject* out) {
+  if (!out) {
+    DNOTREACHED();
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  if (!IsConnected()) {
+    return common::make_error_value("Not connected", common::Value::E_ERROR);
+  }
+
+  std::vector<std::string> bounds;
+  common::Error err = MakeCompactBounds(start, end, &bounds);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  // db handle is thread safe, Disconnect cancels and waits for the job before closing it
+  ::leveldb::DB* db = connection_.handle_;
+  auto compact = [db, bounds](BackgroundJob* job, std::string* summary) -> common::Error {
+    uint64_t reclaimed = 0;
+    common::Error cerr = CompactKeyRanges<KeyRangeTraits>(
+        db, bounds, [job]() { return job->IsCancelled(); },
+        [job](int percent) { job->NotifyProgress(percent); }, &reclaimed);
+    if (cerr && cerr->isError()) {
+      return cerr;
+    }
+
+    *summary = common::MemSPrintf("reclaimed %" PRIu64 " bytes", reclaimed);
+    return common::Error();
+  };
+  err = compact_job_.Start("COMPACT", compact, Client());
+  if (err && err->isError()) {
+    return err;
+  }
+
+  common::StringValue* val =
+      common::Value::createStringValue("OK, compaction started in background, stop cancels it");
+  FastoObject* child = new FastoObject(out, val, Delimiter());
+  out->AddChildren(child);
+  return common::Error();
+}
+
+void DBConnection::CancelCompact() {
+  compact_job_.Cancel();
+}
+
+common::Error DBConnection::Sample(size_t sample_size, uint32_t msec, FastoObject* out) {
+  if (!out) {
+    DNOTREACHED();
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  if (!IsConnected()) {
+    return common::make_error_value("Not connected", common::Value::E_ERROR);
+  }
+
+  // equal data size parts, each read in turn within the time budget
+  ::leveldb::DB* db = connection_.handle_;
+  const ::leveldb::Snapshot* snapshot = db->GetSnapshot();
+  const std::vector<KeyRange> ranges =
+      SplitKeyRange(KeyRange(), KEY_SAMPLER_RANGES, MakeKeyRangeSizes<KeyRangeTraits>(db));
+  KeySampler sampler(sample_size, NsSeparator(), msec, common::time::current_mstime());
+  bool complete = false;
+  common::Error err = SampleKeyRanges<KeyRangeTraits>(
+      db, snapshot, ranges, [this]() { return IsInterrupted(); }, &sampler, &complete);
+  db->ReleaseSnapshot(snapshot);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  std::vector<std::string> lines = sampler.Report(complete);
+  for (size_t i = 0; i < lines.size(); ++i) {
+    common::StringValue* val = common::Value::createStringValue(lines[i]);
+    FastoObject* child = new FastoObject(out, val, Delimiter());
+    out->AddChildren(child);
+  }
   return common::Error();
 }
 
@@ -237,35 +433,104 @@ common::Error DBConnection::ScanImpl(uint64_t cursor_in,
                                      uint64_t count_keys,
                                      std::vector<std::string>* keys_out,
                                      uint64_t* cursor_out) {
-  ::leveldb::ReadOptions ro;
-  ::leveldb::Iterator* it = connection_.handle_->NewIterator(ro);
-  uint64_t offset_pos = cursor_in;
+  ExpireScanSession();
+  KeyPattern kpattern(pattern);
+  if (cursor_in == 0 && count_keys >= KEY_RANGES_MIN_SCAN_COUNT) {
+    return ParallelScan(kpattern, count_keys, keys_out, cursor_out);
+  }
+
+  uint64_t offset_pos = 0;
+  if (!scan_session_.it || cursor_in == 0 || scan_session_.cursor != cursor_in ||
+      scan_session_.pattern != pattern) {
+    // new browse or unknown cursor: pin fresh snapshot, skip cursor_in matched keys
+    ReleaseScanSession();
+    scan_session_.snapshot = connection_.handle_->GetSnapshot();
+    ::leveldb::ReadOptions ro;
+    ro.snapshot = scan_session_.snapshot;
+    ro.fill_cache = false;
+    scan_session_.it = connection_.handle_->NewIterator(ro);
+    scan_session_.it->Seek(kpattern.Prefix());
+    scan_session_.pattern = pattern;
+    offset_pos = cursor_in;
+  }
+
+  ::leveldb::Iterator* it = scan_session_.it;
   uint64_t lcursor_out = 0;
   std::vector<std::string> lkeys_out;
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    std::string key = it->key().ToString();
-    if (lkeys_out.size() < count_keys) {
-      if (common::MatchPattern(key, pattern)) {
-        if (offset_pos == 0) {
-          lkeys_out.push_back(key);
-        } else {
-          offset_pos--;
-        }
+  for (; it->Valid(); it->Next()) {
+    ::leveldb::Slice key = it->key();
+    if (!kpattern.HasPrefix(key.data(), key.size())) {
+      break;  // keys are ordered, rest of db is out of prefix range
+    }
+
+    if (kpattern.Match(key.data(), key.size())) {
+      if (offset_pos != 0) {
+        offset_pos--;
+      } else if (lkeys_out.size() >= count_keys) {
+        // next page starts at this key, cursor stays 0 if no match is left
+        lcursor_out = cursor_in + count_keys;
+        break;
+      } else {
+        lkeys_out.push_back(key.ToString());
       }
-    } else {
-      lcursor_out = cursor_in + count_keys;
-      break;
     }
   }
 
   auto st = it->status();
-  delete it;
-
   if (!st.ok()) {
+    ReleaseScanSession();
     std::string buff = common::MemSPrintf("SCAN function error: %s", st.ToString());
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
+  if (lcursor_out == 0) {
+    ReleaseScanSession();
+  } else {
+    scan_session_.cursor = lcursor_out;
+    scan_session_.last_access_msec = common::time::current_mstime();
+  }
+
+  *keys_out = lkeys_out;
+  *cursor_out = lcursor_out;
+  return common::Error();
+}
+
+common::Error DBConnection::ParallelScan(const KeyPattern& kpattern,
+                                         uint64_t count_keys,
+                                         std::vector<std::string>* keys_out,
+                                         uint64_t* cursor_out) {
+  ReleaseScanSession();
+  ::leveldb::DB* db = connection_.handle_;
+  const ::leveldb::Snapshot* snapshot = db->GetSnapshot();
+  std::vector<std::string> lkeys_out;
+  common::Error err = ParallelScanKeys<KeyRangeTraits>(
+      db, snapshot, kpattern, count_keys + 1, [this]() { return IsInterrupted(); }, &lkeys_out);
+  if (err && err->isError()) {
+    db->ReleaseSnapshot(snapshot);
+    return err;
+  }
+
+  // one key past the page tells whether anything is left for the next one
+  uint64_t lcursor_out = 0;
+  if (lkeys_out.size() <= count_keys) {
+    db->ReleaseSnapshot(snapshot);
+  } else {
+    // next pages continue serially right after the last returned key
+    lkeys_out.pop_back();
+    ::leveldb::ReadOptions ro;
+    ro.snapshot = snapshot;
+    ro.fill_cache = false;
+    scan_session_.snapshot = snapshot;
+    scan_session_.it = db->NewIterator(ro);
+    scan_session_.it->Seek(lkeys_out.back());
+    if (scan_session_.it->Valid() && scan_session_.it->key() == lkeys_out.back()) {
+      scan_session_.it->Next();
+    }
+    scan_session_.pattern = kpattern.Pattern();
+    scan_session_.cursor = lcursor_out = count_keys;
+    scan_session_.last_access_msec = common::time::current_mstime();
+  }
+
   *keys_out = lkeys_out;
   *cursor_out = lcursor_out;
   return common::Error();
@@ -300,26 +565,16 @@ common::Error DBConnection::KeysImpl(const std::string& key_start,
 }
 
 common::Error DBConnection::DBkcountImpl(size_t* size) {
-  ::leveldb::ReadOptions ro;
-  ::leveldb::Iterator* it = connection_.handle_->NewIterator(ro);
-  size_t sz = 0;
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    sz++;
-  }
-
-  auto st = it->status();
-  delete it;
-
-  if (!st.ok()) {
-    std::string buff = common::MemSPrintf("Couldn't determine DBKCOUNT error: %s", st.ToString());
-    return common::make_error_value(buff, common::ErrorValue::E_ERROR);
-  }
-
-  *size = sz;
-  return common::Error();
+  ::leveldb::DB* db = connection_.handle_;
+  const ::leveldb::Snapshot* snapshot = db->GetSnapshot();  // same version for all workers
+  common::Error err = ParallelCountKeys<KeyRangeTraits>(
+      db, snapshot, [this]() { return IsInterrupted(); }, size);
+  db->ReleaseSnapshot(snapshot);
+  return err;
 }
 
 common::Error DBConnection::FlushDBImpl() {
+  ReleaseScanSession();
   ::leveldb::ReadOptions ro;
   ::leveldb::WriteOptions wo;
   ::leveldb::Iterator* it = connection_.handle_->NewIterator(ro);
@@ -23,7 +23,9 @@
 
 #include <common/error.h>   // for Error
 #include <common/macros.h>  // for WARN_UNUSED_RESULT
+#include <common/types.h>   // for time64_t
 
+#include "core/background_job.h"           // for BackgroundJob
 #include "core/command_info.h"             // for UNDEFINED_EXAMPLE_STR, UNDEFIN...
 #include "core/connection_types.h"         // for connectionTypes::LEVELDB
 #include "core/db_key.h"                   // for NDbKValue, NKey, NKeys
@@ -52,8 +54,15 @@ namespace core {
 class IDataBaseInfo;
 }
 }
+namespace fastonosql {
+namespace core {
+class KeyPattern;
+}
+}
 namespace leveldb {
 class DB;
+class Iterator;
+class Snapshot;
 }  // lines 30-30
 
 namespace fastonosql {
@@ -69,8 +78,20 @@ class DBConnection : public core::internal::CDBConnection<NativeConnection, Conf
  public:
   typedef core::internal::CDBConnection<NativeConnection, Config, LEVELDB> base_class;
   explicit DBConnection(CDBConnectionClient* client);
+  virtual ~DBConnection();
+
+  // stops background COMPACT, releases scan session before db handle
+  common::Error Disconnect() WARN_UNUSED_RESULT;
+  void ExpireScanSession();  // releases scan session idle more than SCAN_SESSION_TIMEOUT_MSEC
 
-  common::Error Info(const char* args, ServerInfo::Stats* statsout) WARN_UNUSED_RESULT;
+  common::Error Info(const char* args, ServerInfo* info) WARN_UNUSED_RESULT;
+  common::Error Compact(const std::string& start,
+                        const std::string& end,
+                        FastoObject* out) WARN_UNUSED_RESULT;  // starts background job
+  void CancelCompact();  // any thread, background COMPACT stops at its next step
+  common::Error Sample(size_t sample_size,
+                       uint32_t msec,
+                       FastoObject* out) WARN_UNUSED_RESULT;  // interruptible
 
  private:
   common::Error DelInner(const std::string& key) WARN_UNUSED_RESULT;
@@ -96,6 +117,28 @@ class DBConnection : public core::internal::CDBConnection<NativeConnection, Conf
   virtual common::Error SetTTLImpl(const NKey& key, ttl_t ttl) override;
   virtual common::Error GetTTLImpl(const NKey& key, ttl_t* ttl) override;
   virtual common::Error QuitImpl() override;
+
+  // first SCAN page of at least KEY_RANGES_MIN_SCAN_COUNT keys, key ranges are matched
+  // on all cores and the scan session continues after the last returned key
+  common::Error ParallelScan(const KeyPattern& kpattern,
+                             uint64_t count_keys,
+                             std::vector<std::string>* keys_out,
+                             uint64_t* cursor_out) WARN_UNUSED_RESULT;
+  void ReleaseScanSession();
+
+  // SCAN pages continue one iterator over a pinned snapshot, other commands
+  // read the live db so own writes are visible to them
+  struct ScanSession {
+    ScanSession();
+
+    const ::leveldb::Snapshot* snapshot;
+    ::leveldb::Iterator* it;
+    std::string pattern;
+    uint64_t cursor;  // cursor which continues this session
+    common::time64_t last_access_msec;
+  } scan_session_;
+
+  BackgroundJob compact_job_;
 };
 
 }  // namespace leveldb
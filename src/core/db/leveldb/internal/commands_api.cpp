@@ -18,6 +18,8 @@
 
 #include "core/db/leveldb/internal/commands_api.h"
 
+#include "core/key_sampler.h"  // for ParseSampleArgs
+
 namespace fastonosql {
 namespace core {
 namespace leveldb {
@@ -28,19 +30,43 @@ common::Error CommandsApi::Info(internal::CommandHandler* handler,
                                 FastoObject* out) {
   DBConnection* level = static_cast<DBConnection*>(handler);
 
-  ServerInfo::Stats statsout;
-  common::Error err = level->Info(argc == 1 ? argv[0] : nullptr, &statsout);
+  ServerInfo linf;
+  common::Error err = level->Info(argc == 1 ? argv[0] : nullptr, &linf);
   if (err && err->isError()) {
     return err;
   }
 
-  ServerInfo linf(statsout);
   common::StringValue* val = common::Value::createStringValue(linf.ToString());
   FastoObject* child = new FastoObject(out, val, level->Delimiter());
   out->AddChildren(child);
   return common::Error();
 }
 
+common::Error CommandsApi::Compact(internal::CommandHandler* handler,
+                                   int argc,
+                                   const char** argv,
+                                   FastoObject* out) {
+  DBConnection* level = static_cast<DBConnection*>(handler);
+  std::string start = argc >= 1 ? argv[0] : std::string();
+  std::string end = argc >= 2 ? argv[1] : std::string();
+  return level->Compact(start, end, out);
+}
+
+common::Error CommandsApi::Sample(internal::CommandHandler* handler,
+                                  int argc,
+                                  const char** argv,
+                                  FastoObject* out) {
+  DBConnection* level = static_cast<DBConnection*>(handler);
+  size_t sample_size = 0;
+  uint32_t msec = 0;
+  common::Error err = ParseSampleArgs(argc, argv, &sample_size, &msec);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  return level->Sample(sample_size, msec, out);
+}
+
 }  // namespace leveldb
 }  // namespace core
 }  // namespace fastonosql
@@ -46,6 +46,26 @@ const std::vector<Field> LeveldbCommonFields = {
     Field(LEVELDB_READ_MB_LABEL, common::Value::TYPE_UINTEGER),
     Field(LEVELDB_WRITE_MB_LABEL, common::Value::TYPE_UINTEGER)};
 
+std::vector<Field> makeLeveldbLevelsFields() {
+  std::vector<Field> fields;
+  for (size_t i = 0; i < LEVELDB_LEVELS_COUNT; ++i) {
+    fields.push_back(Field(LEVELDB_FILES_AT_LEVEL_LABEL + common::ConvertToString(i),
+                           common::Value::TYPE_UINTEGER));
+  }
+  for (size_t i = 0; i < LEVELDB_LEVELS_COUNT; ++i) {
+    fields.push_back(Field(LEVELDB_SIZE_MB_AT_LEVEL_LABEL + common::ConvertToString(i),
+                           common::Value::TYPE_UINTEGER));
+  }
+  return fields;
+}
+
+const std::vector<Field> LeveldbLevelsFields = makeLeveldbLevelsFields();
+
+const std::vector<Field> LeveldbStorageFields = {
+    Field(LEVELDB_TOTAL_FILES_LABEL, common::Value::TYPE_UINTEGER),
+    Field(LEVELDB_TOTAL_SIZE_MB_LABEL, common::Value::TYPE_UINTEGER),
+    Field(LEVELDB_APPROXIMATE_MEMORY_USAGE_MB_LABEL, common::Value::TYPE_UINTEGER)};
+
 }  // namespace
 
 template <>
@@ -56,7 +76,9 @@ std::vector<common::Value::Type> DBTraits<LEVELDB>::SupportedTypes() {
 
 template <>
 std::vector<info_field_t> DBTraits<LEVELDB>::InfoFields() {
-  return {std::make_pair(LEVELDB_STATS_LABEL, LeveldbCommonFields)};
+  return {std::make_pair(LEVELDB_STATS_LABEL, LeveldbCommonFields),
+          std::make_pair(LEVELDB_LEVELS_LABEL, LeveldbLevelsFields),
+          std::make_pair(LEVELDB_STORAGE_LABEL, LeveldbStorageFields)};
 }
 
 namespace leveldb {
@@ -108,6 +130,88 @@ common::Value* ServerInfo::Stats::ValueByIndex(unsigned char index) const {
   return nullptr;
 }
 
+ServerInfo::Levels::Levels() {
+  for (size_t i = 0; i < LEVELDB_LEVELS_COUNT; ++i) {
+    files_at_level[i] = 0;
+    size_mb_at_level[i] = 0;
+  }
+}
+
+ServerInfo::Levels::Levels(const std::string& levels_text) : Levels() {
+  static const std::string files_label = LEVELDB_FILES_AT_LEVEL_LABEL;
+  static const std::string size_label = LEVELDB_SIZE_MB_AT_LEVEL_LABEL;
+  size_t pos = 0;
+  size_t start = 0;
+
+  while ((pos = levels_text.find(MARKER, start)) != std::string::npos) {
+    std::string line = levels_text.substr(start, pos - start);
+    size_t delem = line.find_first_of(':');
+    std::string field = line.substr(0, delem);
+    std::string value = line.substr(delem + 1);
+    if (field.compare(0, files_label.size(), files_label) == 0) {
+      size_t level = common::ConvertFromString<size_t>(field.substr(files_label.size()));
+      if (level < LEVELDB_LEVELS_COUNT) {
+        files_at_level[level] = common::ConvertFromString<uint32_t>(value);
+      }
+    } else if (field.compare(0, size_label.size(), size_label) == 0) {
+      size_t level = common::ConvertFromString<size_t>(field.substr(size_label.size()));
+      if (level < LEVELDB_LEVELS_COUNT) {
+        size_mb_at_level[level] = common::ConvertFromString<uint32_t>(value);
+      }
+    }
+    start = pos + 2;
+  }
+}
+
+common::Value* ServerInfo::Levels::ValueByIndex(unsigned char index) const {
+  if (index < LEVELDB_LEVELS_COUNT) {
+    return new common::FundamentalValue(files_at_level[index]);
+  } else if (index < LEVELDB_LEVELS_COUNT * 2) {
+    return new common::FundamentalValue(size_mb_at_level[index - LEVELDB_LEVELS_COUNT]);
+  }
+
+  NOTREACHED();
+  return nullptr;
+}
+
+ServerInfo::Storage::Storage() : total_files(0), total_size_mb(0), approximate_memory_usage_mb(0) {}
+
+ServerInfo::Storage::Storage(const std::string& storage_text) : Storage() {
+  size_t pos = 0;
+  size_t start = 0;
+
+  while ((pos = storage_text.find(MARKER, start)) != std::string::npos) {
+    std::string line = storage_text.substr(start, pos - start);
+    size_t delem = line.find_first_of(':');
+    std::string field = line.substr(0, delem);
+    std::string value = line.substr(delem + 1);
+    if (field == LEVELDB_TOTAL_FILES_LABEL) {
+      total_files = common::ConvertFromString<uint32_t>(value);
+    } else if (field == LEVELDB_TOTAL_SIZE_MB_LABEL) {
+      total_size_mb = common::ConvertFromString<uint32_t>(value);
+    } else if (field == LEVELDB_APPROXIMATE_MEMORY_USAGE_MB_LABEL) {
+      approximate_memory_usage_mb = common::ConvertFromString<uint32_t>(value);
+    }
+    start = pos + 2;
+  }
+}
+
+common::Value* ServerInfo::Storage::ValueByIndex(unsigned char index) const {
+  switch (index) {
+    case 0:
+      return new common::FundamentalValue(total_files);
+    case 1:
+      return new common::FundamentalValue(total_size_mb);
+    case 2:
+      return new common::FundamentalValue(approximate_memory_usage_mb);
+    default:
+      break;
+  }
+
+  NOTREACHED();
+  return nullptr;
+}
+
 ServerInfo::ServerInfo() : IServerInfo(LEVELDB) {}
 
 ServerInfo::ServerInfo(const Stats& stats) : IServerInfo(LEVELDB), stats_(stats) {}
@@ -116,6 +220,10 @@ common::Value* ServerInfo::ValueByIndexes(unsigned char property, unsigned char
   switch (property) {
     case 0:
       return stats_.ValueByIndex(field);
+    case 1:
+      return levels_.ValueByIndex(field);
+    case 2:
+      return storage_.ValueByIndex(field);
     default:
       break;
   }
@@ -131,6 +239,23 @@ std::ostream& operator<<(std::ostream& out, const ServerInfo::Stats& value) {
              << value.read_mb << MARKER << LEVELDB_WRITE_MB_LABEL ":" << value.write_mb << MARKER;
 }
 
+std::ostream& operator<<(std::ostream& out, const ServerInfo::Levels& value) {
+  for (size_t i = 0; i < LEVELDB_LEVELS_COUNT; ++i) {
+    out << LEVELDB_FILES_AT_LEVEL_LABEL << i << ":" << value.files_at_level[i] << MARKER;
+  }
+  for (size_t i = 0; i < LEVELDB_LEVELS_COUNT; ++i) {
+    out << LEVELDB_SIZE_MB_AT_LEVEL_LABEL << i << ":" << value.size_mb_at_level[i] << MARKER;
+  }
+  return out;
+}
+
+std::ostream& operator<<(std::ostream& out, const ServerInfo::Storage& value) {
+  return out << LEVELDB_TOTAL_FILES_LABEL ":" << value.total_files << MARKER
+             << LEVELDB_TOTAL_SIZE_MB_LABEL ":" << value.total_size_mb << MARKER
+             << LEVELDB_APPROXIMATE_MEMORY_USAGE_MB_LABEL ":" << value.approximate_memory_usage_mb
+             << MARKER;
+}
+
 std::ostream& operator<<(std::ostream& out, const ServerInfo& value) {
   return out << value.ToString();
 }
@@ -142,15 +267,42 @@ ServerInfo* MakeLeveldbServerInfo(const std::string& content) {
 
   ServerInfo* result = new ServerInfo;
   static const std::vector<info_field_t> fields = DBTraits<LEVELDB>::InfoFields();
+  size_t j = 0;
   std::string word;
-  DCHECK_EQ(fields.size(), 1);
+  size_t pos = 0;
 
-  for (size_t i = 0; i < content.size(); ++i) {
+  for (size_t i = 0; i < content.size() && j < fields.size(); ++i) {
     word += content[i];
-    if (word == fields[0].first) {
-      std::string part = content.substr(i + 1);
-      result->stats_ = ServerInfo::Stats(part);
-      break;
+    if (word == fields[j].first) {
+      size_t end = std::string::npos;
+      if (j + 1 != fields.size()) {
+        end = content.find(fields[j + 1].first, pos);
+      }
+
+      std::string part = end == std::string::npos ? content.substr(i + 1)
+                                                  : content.substr(i + 1, end - i - 1);
+      switch (j) {
+        case 0:
+          result->stats_ = ServerInfo::Stats(part);
+          break;
+        case 1:
+          result->levels_ = ServerInfo::Levels(part);
+          break;
+        case 2:
+          result->storage_ = ServerInfo::Storage(part);
+          break;
+        default:
+          break;
+      }
+
+      if (end == std::string::npos) {  // old history files have only # Stats section
+        break;
+      }
+
+      i = end - 1;
+      pos = end;
+      ++j;
+      word.clear();
     }
   }
 
@@ -159,7 +311,8 @@ ServerInfo* MakeLeveldbServerInfo(const std::string& content) {
 
 std::string ServerInfo::ToString() const {
   std::stringstream str;
-  str << LEVELDB_STATS_LABEL MARKER << stats_;
+  str << LEVELDB_STATS_LABEL MARKER << stats_ << LEVELDB_LEVELS_LABEL MARKER << levels_
+      << LEVELDB_STORAGE_LABEL MARKER << storage_;
   return str.str();
 }
 
@@ -36,6 +36,18 @@
 #define LEVELDB_READ_MB_LABEL "read_mb"
 #define LEVELDB_WRITE_MB_LABEL "write_mb"
 
+#define LEVELDB_LEVELS_LABEL "# Levels"
+
+#define LEVELDB_LEVELS_COUNT 7
+#define LEVELDB_FILES_AT_LEVEL_LABEL "files_at_level"
+#define LEVELDB_SIZE_MB_AT_LEVEL_LABEL "size_mb_at_level"
+
+#define LEVELDB_STORAGE_LABEL "# Storage"
+
+#define LEVELDB_TOTAL_FILES_LABEL "total_files"
+#define LEVELDB_TOTAL_SIZE_MB_LABEL "total_size_mb"
+#define LEVELDB_APPROXIMATE_MEMORY_USAGE_MB_LABEL "approximate_memory_usage_mb"
+
 namespace common {
 class Value;
 }
@@ -60,6 +72,26 @@ class ServerInfo : public IServerInfo {
     uint32_t write_mb;
   } stats_;
 
+  // leveldb.num-files-at-level<N>, per level rows of leveldb.stats
+  struct Levels : IStateField {
+    Levels();
+    explicit Levels(const std::string& levels_text);
+    virtual common::Value* ValueByIndex(unsigned char index) const override;
+
+    uint32_t files_at_level[LEVELDB_LEVELS_COUNT];
+    uint32_t size_mb_at_level[LEVELDB_LEVELS_COUNT];
+  } levels_;
+
+  struct Storage : IStateField {
+    Storage();
+    explicit Storage(const std::string& storage_text);
+    virtual common::Value* ValueByIndex(unsigned char index) const override;
+
+    uint32_t total_files;
+    uint32_t total_size_mb;
+    uint32_t approximate_memory_usage_mb;
+  } storage_;
+
   ServerInfo();
   explicit ServerInfo(const Stats& stats);
 
@@ -56,6 +56,8 @@ Config parseOptions(int argc, char** argv) {
       cfg.dbname = argv[++i];
     } else if (!strcmp(argv[i], "-e") && !lastarg) {
       cfg.env_flags = common::ConvertFromString<int>(argv[++i]);
+    } else if (!strcmp(argv[i], "-m") && !lastarg) {
+      cfg.map_size = common::ConvertFromString<uint64_t>(argv[++i]);
     } else {
       if (argv[i][0] == '-') {
         const std::string buff = common::MemSPrintf(
@@ -77,7 +79,8 @@ Config parseOptions(int argc, char** argv) {
 
 Config::Config()
     : LocalConfig(common::file_system::prepare_path("~/test.lmdb")),
-      env_flags(LMDB_DEFAULT_ENV_FLAGS) {}
+      env_flags(LMDB_DEFAULT_ENV_FLAGS),
+      map_size(0) {}
 
 bool Config::ReadOnlyDB() const {
   return env_flags & MDB_RDONLY;
@@ -105,6 +108,11 @@ std::string ConvertToString(const fastonosql::core::lmdb::Config& conf) {
     argv.push_back(common::ConvertToString(conf.env_flags));
   }
 
+  if (conf.map_size) {
+    argv.push_back("-m");
+    argv.push_back(common::ConvertToString(conf.map_size));
+  }
+
   return fastonosql::core::ConvertToStringConfigArgs(argv);
 }
 
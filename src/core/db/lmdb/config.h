@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <stdint.h>  // for uint64_t
+
 #include <string>
 
 #include "core/config/config.h"
@@ -36,6 +38,7 @@ struct Config : public LocalConfig {
   void SetReadOnlyDB(bool ro);
 
   int env_flags;
+  uint64_t map_size;  // bytes, 0 - LMDB default (10MB) or the size of an existing database
 };
 
 }  // namespace lmdb
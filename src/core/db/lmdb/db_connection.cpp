@@ -18,25 +18,39 @@
 
 #include "core/db/lmdb/db_connection.h"
 
-#include <errno.h>   // for EACCES
-#include <lmdb.h>    // for mdb_txn_abort, MDB_val
-#include <stdlib.h>  // for NULL, free, calloc
-#include <time.h>    // for time_t
-#include <string>    // for string
+#include <errno.h>     // for EACCES
+#include <lmdb.h>      // for mdb_txn_abort, MDB_val
+#include <stdlib.h>    // for NULL, free, calloc
+#include <sys/stat.h>  // for stat
+#include <time.h>      // for time_t
+
+#include <algorithm>  // for min
+#include <atomic>     // for atomic
+#include <chrono>     // for milliseconds
+#include <string>     // for string
+#include <thread>     // for thread, sleep_for
+#include <vector>     // for vector
 
 #include <common/value.h>  // for StringValue (ptr only)
 #include <common/utils.h>  // for c_strornull
 #include <common/convert2string.h>
 #include <common/file_system.h>
+#include <common/time.h>  // for current_mstime
 
 #include "core/db/lmdb/config.h"  // for Config
 #include "core/db/lmdb/command_translator.h"
 #include "core/db/lmdb/database_info.h"
 #include "core/db/lmdb/internal/commands_api.h"
 
-#include "core/global.h"  // for FastoObject, etc
+#include "core/global.h"       // for FastoObject, etc
+#include "core/key_pattern.h"  // for KeyPattern
+#include "core/key_ranges.h"   // for InterpolateKeyRanges, ForEachKeyRange
+#include "core/key_sampler.h"  // for KeySampler
 
 #define LMDB_OK 0
+#define LMDB_DATA_FILE_NAME "data.mdb"
+#define LMDB_COMPACT_DIR_SUFFIX ".compact"
+#define LMDB_COMPACT_PROGRESS_MSEC 250
 
 namespace fastonosql {
 namespace core {
@@ -56,7 +70,8 @@ int lmdb_open(lmdb** context,
               const char* db_path,
               const char* db_name,
               int env_flags,
-              unsigned int db_env_flags) {
+              unsigned int db_env_flags,
+              size_t map_size) {
   lmdb* lcontext = reinterpret_cast<lmdb*>(calloc(1, sizeof(lmdb)));
   int rc = mdb_env_create(&lcontext->env);
   if (rc != LMDB_OK) {
@@ -64,6 +79,15 @@ int lmdb_open(lmdb** context,
     return rc;
   }
 
+  if (map_size) {
+    rc = mdb_env_set_mapsize(lcontext->env, map_size);
+    if (rc != LMDB_OK) {
+      mdb_env_close(lcontext->env);
+      free(lcontext);
+      return rc;
+    }
+  }
+
   rc = mdb_env_open(lcontext->env, db_path, env_flags, 0664);
   if (rc != LMDB_OK) {
     free(lcontext);
@@ -88,6 +112,44 @@ int lmdb_open(lmdb** context,
   return rc;
 }
 
+std::string lmdb_data_file_path(const std::string& path, int env_flags) {
+  if (env_flags & MDB_NOSUBDIR) {
+    return path;
+  }
+
+  return path + "/" LMDB_DATA_FILE_NAME;
+}
+
+uint64_t lmdb_data_file_size(const std::string& path, int env_flags) {
+  std::string file_path = lmdb_data_file_path(path, env_flags);
+  struct stat st;
+  if (stat(file_path.c_str(), &st) != 0) {
+    return 0;
+  }
+
+  return st.st_size;
+}
+
+// pages a compacted copy of the environment holds, 0 if unknown
+uint64_t lmdb_used_bytes(MDB_env* env, MDB_dbi dbi) {
+  MDB_txn* txn = NULL;
+  if (mdb_txn_begin(env, NULL, MDB_RDONLY, &txn) != LMDB_OK) {
+    return 0;
+  }
+
+  MDB_stat main_stat;
+  MDB_stat db_stat;
+  uint64_t bytes = 0;
+  if (mdb_env_stat(env, &main_stat) == LMDB_OK && mdb_stat(txn, dbi, &db_stat) == LMDB_OK) {
+    uint64_t pages = 2 + main_stat.ms_branch_pages + main_stat.ms_leaf_pages +  // 2 meta pages
+                     main_stat.ms_overflow_pages + db_stat.ms_branch_pages +
+                     db_stat.ms_leaf_pages + db_stat.ms_overflow_pages;
+    bytes = pages * main_stat.ms_psize;
+  }
+  mdb_txn_abort(txn);
+  return bytes;
+}
+
 void lmdb_close(lmdb** context) {
   if (!context) {
     return;
@@ -175,7 +237,10 @@ common::Error CreateConnection(const Config& config, NativeConnection** context)
 
   const char* db_path = common::utils::c_strornull(folder);
   int env_flags = config.env_flags;
-  int st = lmdb_open(&lcontext, db_path, NULL, env_flags, lmdb_db_flag_from_env_flags(env_flags));
+  // MDB_NOTLS: scan session read txn held alongside per command txns of the same thread
+  int st = lmdb_open(&lcontext, db_path, NULL, env_flags | MDB_NOTLS,
+                     lmdb_db_flag_from_env_flags(env_flags),
+                     static_cast<size_t>(config.map_size));
   if (st != LMDB_OK) {
     std::string buff = common::MemSPrintf("Fail open database: %s", mdb_strerror(st));
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
@@ -196,8 +261,49 @@ common::Error TestConnection(const Config& config) {
   return common::Error();
 }
 
+DBConnection::ScanSession::ScanSession()
+    : txn(NULL), cursor(NULL), pattern(), cursor_out(0), last_access_msec(0) {}
+
 DBConnection::DBConnection(CDBConnectionClient* client)
-    : base_class(client, new CommandTranslator(base_class::Commands())) {}
+    : base_class(client, new CommandTranslator(base_class::Commands())), scan_session_() {}
+
+DBConnection::~DBConnection() {
+  compact_job_.Cancel();
+  compact_job_.Wait();
+  ReleaseScanSession();
+}
+
+common::Error DBConnection::Disconnect() {
+  compact_job_.Cancel();
+  compact_job_.Wait();
+  ReleaseScanSession();
+  return base_class::Disconnect();
+}
+
+void DBConnection::ExpireScanSession() {
+  if (!scan_session_.txn) {
+    return;
+  }
+
+  common::time64_t idle = common::time::current_mstime() - scan_session_.last_access_msec;
+  if (idle > SCAN_SESSION_TIMEOUT_MSEC) {
+    ReleaseScanSession();
+  }
+}
+
+void DBConnection::ReleaseScanSession() {
+  if (scan_session_.cursor) {
+    mdb_cursor_close(scan_session_.cursor);
+    scan_session_.cursor = NULL;
+  }
+  if (scan_session_.txn) {
+    mdb_txn_abort(scan_session_.txn);
+    scan_session_.txn = NULL;
+  }
+  scan_session_.pattern.clear();
+  scan_session_.cursor_out = 0;
+  scan_session_.last_access_msec = 0;
+}
 
 std::string DBConnection::CurrentDBName() const {
   if (connection_.handle_) {
@@ -227,6 +333,103 @@ common::Error DBConnection::Info(const char* args, ServerInfo::Stats* statsout)
   return common::Error();
 }
 
+common::Error DBConnection::Compact(const std::string& dest_path, FastoObject* out) {
+  if (!out) {
+    DNOTREACHED();
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  if (!IsConnected()) {
+    return common::make_error_value("Not connected", common::Value::E_ERROR);
+  }
+
+  if (compact_job_.IsRunning()) {  // its copy must not be removed below
+    return common::make_error_value("COMPACT is already running in background",
+                                    common::ErrorValue::E_ERROR);
+  }
+
+  Config conf = config();
+  std::string path = dest_path.empty() ? conf.dbname + LMDB_COMPACT_DIR_SUFFIX : dest_path;
+  if (!(conf.env_flags & MDB_NOSUBDIR)) {
+    common::Error err = common::file_system::create_directory(path, true);
+    if (err && err->isError()) {
+      return err;
+    }
+  }
+
+  // mdb_env_copy2 doesn't overwrite, copy of previous COMPACT is replaced only on
+  // default destination
+  const std::string data_path = lmdb_data_file_path(path, conf.env_flags);
+  if (common::file_system::is_file_exist(data_path)) {
+    if (!dest_path.empty()) {
+      std::string buff = common::MemSPrintf("compact destination %s already exists", data_path);
+      return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
+
+    common::Error err = common::file_system::remove_file(data_path);
+    if (err && err->isError()) {
+      return err;
+    }
+  }
+
+  // env handle is thread safe, Disconnect cancels and waits for the job before closing it
+  MDB_env* env = connection_.handle_->env;
+  const MDB_dbi dbi = connection_.handle_->dbir;
+  const std::string live_path = conf.dbname;
+  const int env_flags = conf.env_flags;
+  auto copy = [env, dbi, path, live_path, env_flags](BackgroundJob* job,
+                                                     std::string* summary) -> common::Error {
+    // copy can't be stopped inside mdb_env_copy2, its growing file shows the progress
+    const uint64_t expected = lmdb_used_bytes(env, dbi);
+    std::atomic<bool> copying(true);
+    std::thread watcher([&]() {
+      while (copying) {
+        uint64_t written = lmdb_data_file_size(path, env_flags);
+        if (expected != 0) {
+          job->NotifyProgress(static_cast<int>(std::min<uint64_t>(written * 100 / expected, 99)));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(LMDB_COMPACT_PROGRESS_MSEC));
+      }
+    });
+    int rc = mdb_env_copy2(env, path.c_str(), MDB_CP_COMPACT);
+    copying = false;
+    watcher.join();
+    if (rc != LMDB_OK) {
+      std::string buff =
+          common::MemSPrintf("compact to %s function error: %s", path, mdb_strerror(rc));
+      return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
+
+    if (job->IsCancelled()) {  // don't leave a copy nobody waits for
+      common::Error err = common::file_system::remove_file(lmdb_data_file_path(path, env_flags));
+      if (err && err->isError()) {
+        return err;
+      }
+      return common::make_error_value("Interrupted.", common::ErrorValue::E_INTERRUPTED);
+    }
+
+    *summary = common::MemSPrintf(
+        "compacted copy %s has %" PRIu64 " bytes, live file keeps %" PRIu64
+        " bytes until the database is reopened from the copy",
+        path, lmdb_data_file_size(path, env_flags), lmdb_data_file_size(live_path, env_flags));
+    return common::Error();
+  };
+  common::Error err = compact_job_.Start("COMPACT", copy, Client());
+  if (err && err->isError()) {
+    return err;
+  }
+
+  common::StringValue* val = common::Value::createStringValue(
+      common::MemSPrintf("OK, copying compacted environment to %s in background", path));
+  FastoObject* child = new FastoObject(out, val, Delimiter());
+  out->AddChildren(child);
+  return common::Error();
+}
+
+void DBConnection::CancelCompact() {
+  compact_job_.Cancel();
+}
+
 common::Error DBConnection::SetInner(const std::string& key, const std::string& value) {
   if (!IsConnected()) {
     return common::make_error_value("Not connected", common::Value::E_ERROR);
@@ -321,44 +524,227 @@ common::Error DBConnection::ScanImpl(uint64_t cursor_in,
                                      uint64_t count_keys,
                                      std::vector<std::string>* keys_out,
                                      uint64_t* cursor_out) {
-  MDB_cursor* cursor = NULL;
+  ExpireScanSession();
+  KeyPattern kpattern(pattern);
+  if (cursor_in == 0 && count_keys >= KEY_RANGES_MIN_SCAN_COUNT) {
+    return ParallelScan(kpattern, count_keys, keys_out, cursor_out);
+  }
+
+  uint64_t offset_pos = 0;
+  MDB_val key;
+  MDB_val data;
+  MDB_cursor_op op = MDB_GET_CURRENT;  // continue from key which didn't fit previous page
+  if (!scan_session_.cursor || cursor_in == 0 || scan_session_.cursor_out != cursor_in ||
+      scan_session_.pattern != pattern) {
+    // new browse or unknown cursor: begin fresh read txn, skip cursor_in matched keys
+    ReleaseScanSession();
+    int rc = mdb_txn_begin(connection_.handle_->env, NULL, MDB_RDONLY, &scan_session_.txn);
+    if (rc == LMDB_OK) {
+      rc = mdb_cursor_open(scan_session_.txn, connection_.handle_->dbir, &scan_session_.cursor);
+    }
+
+    if (rc != LMDB_OK) {
+      ReleaseScanSession();
+      std::string buff = common::MemSPrintf("Keys function error: %s", mdb_strerror(rc));
+      return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
+
+    scan_session_.pattern = pattern;
+    offset_pos = cursor_in;
+    op = MDB_FIRST;
+    if (!kpattern.Prefix().empty()) {
+      key.mv_size = kpattern.Prefix().size();
+      key.mv_data = const_cast<char*>(kpattern.Prefix().c_str());
+      op = MDB_SET_RANGE;  // first key >= prefix
+    }
+  }
+
+  uint64_t lcursor_out = 0;
+  std::vector<std::string> lkeys_out;
+  for (; mdb_cursor_get(scan_session_.cursor, &key, &data, op) == LMDB_OK; op = MDB_NEXT) {
+    const char* key_data = reinterpret_cast<const char*>(key.mv_data);
+    if (!kpattern.HasPrefix(key_data, key.mv_size)) {
+      break;  // keys are ordered, rest of db is out of prefix range
+    }
+
+    if (kpattern.Match(key_data, key.mv_size)) {
+      if (offset_pos != 0) {
+        offset_pos--;
+      } else if (lkeys_out.size() >= count_keys) {
+        // next page starts at this key, cursor stays 0 if no match is left
+        lcursor_out = cursor_in + count_keys;
+        break;
+      } else {
+        lkeys_out.push_back(std::string(key_data, key.mv_size));
+      }
+    }
+  }
+
+  if (lcursor_out == 0) {
+    ReleaseScanSession();
+  } else {
+    scan_session_.cursor_out = lcursor_out;
+    scan_session_.last_access_msec = common::time::current_mstime();
+  }
+
+  *keys_out = lkeys_out;
+  *cursor_out = lcursor_out;
+  return common::Error();
+}
+
+common::Error DBConnection::ParallelScan(const KeyPattern& kpattern,
+                                         uint64_t count_keys,
+                                         std::vector<std::string>* keys_out,
+                                         uint64_t* cursor_out) {
+  ReleaseScanSession();
+  MDB_env* env = connection_.handle_->env;
+  MDB_dbi dbi = connection_.handle_->dbir;
   MDB_txn* txn = NULL;
-  int rc = mdb_txn_begin(connection_.handle_->env, NULL, MDB_RDONLY, &txn);
+  MDB_cursor* cursor = NULL;
+  int rc = mdb_txn_begin(env, NULL, MDB_RDONLY, &txn);
   if (rc == LMDB_OK) {
-    rc = mdb_cursor_open(txn, connection_.handle_->dbir, &cursor);
+    rc = mdb_cursor_open(txn, dbi, &cursor);
   }
 
-  if (rc != LMDB_OK) {
+  // lmdb has no size estimations, first and last key of the prefix range give split points
+  const KeyRange prefix_range(kpattern.Prefix(), kpattern.PrefixUpperBound());
+  std::string first;
+  std::string last;
+  MDB_val key;
+  MDB_val data;
+  if (rc == LMDB_OK) {
+    key.mv_size = prefix_range.start.size();
+    key.mv_data = const_cast<char*>(prefix_range.start.data());
+    if (mdb_cursor_get(cursor, &key, &data, prefix_range.start.empty() ? MDB_FIRST
+                                                                      : MDB_SET_RANGE) ==
+        LMDB_OK) {
+      first.assign(static_cast<const char*>(key.mv_data), key.mv_size);
+    }
+
+    int found = MDB_NOTFOUND;
+    if (!prefix_range.end.empty()) {
+      key.mv_size = prefix_range.end.size();
+      key.mv_data = const_cast<char*>(prefix_range.end.data());
+      found = mdb_cursor_get(cursor, &key, &data, MDB_SET_RANGE);
+      if (found == LMDB_OK) {
+        found = mdb_cursor_get(cursor, &key, &data, MDB_PREV);
+      }
+    }
+    if (found == MDB_NOTFOUND) {
+      found = mdb_cursor_get(cursor, &key, &data, MDB_LAST);
+    }
+    if (found == LMDB_OK) {
+      last.assign(static_cast<const char*>(key.mv_data), key.mv_size);
+    }
+  }
+
+  if (cursor) {
+    mdb_cursor_close(cursor);
+  }
+  if (txn) {
     mdb_txn_abort(txn);
-    std::string buff = common::MemSPrintf("Keys function error: %s", mdb_strerror(rc));
+  }
+
+  if (rc != LMDB_OK) {
+    std::string buff = common::MemSPrintf("SCAN function error: %s", mdb_strerror(rc));
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
-  MDB_val key;
-  MDB_val data;
-  uint64_t offset_pos = cursor_in;
-  uint64_t lcursor_out = 0;
-  std::vector<std::string> lkeys_out;
-  while ((mdb_cursor_get(cursor, &key, &data, MDB_NEXT) == LMDB_OK)) {
-    if (lkeys_out.size() < count_keys) {
-      std::string skey(reinterpret_cast<const char*>(key.mv_data), key.mv_size);
-      if (common::MatchPattern(skey, pattern)) {
-        if (offset_pos == 0) {
-          lkeys_out.push_back(skey);
-        } else {
-          offset_pos--;
+  std::vector<KeyRange> ranges =
+      InterpolateKeyRanges(first, last, KeyRangesWorkers() * KEY_RANGES_PER_WORKER);
+  ranges.front().start = prefix_range.start;
+  ranges.back().end = prefix_range.end;
+
+  // one key past the page tells whether anything is left for the next one
+  KeyRangesCollector collector(ranges.size(), count_keys + 1);
+  auto scan_range = [&](size_t index, const KeyRange& range) -> common::Error {
+    // read txns belong to the thread which began them
+    MDB_txn* rtxn = NULL;
+    MDB_cursor* rcursor = NULL;
+    int rrc = mdb_txn_begin(env, NULL, MDB_RDONLY, &rtxn);
+    if (rrc == LMDB_OK) {
+      rrc = mdb_cursor_open(rtxn, dbi, &rcursor);
+    }
+
+    std::vector<std::string> found;
+    if (rrc == LMDB_OK) {
+      MDB_val rkey;
+      MDB_val rdata;
+      rkey.mv_size = range.start.size();
+      rkey.mv_data = const_cast<char*>(range.start.data());
+      MDB_cursor_op op = range.start.empty() ? MDB_FIRST : MDB_SET_RANGE;
+      uint64_t step = 0;
+      for (; (rrc = mdb_cursor_get(rcursor, &rkey, &rdata, op)) == LMDB_OK; op = MDB_NEXT) {
+        const char* key_data = static_cast<const char*>(rkey.mv_data);
+        if (!range.Contains(key_data, rkey.mv_size) || IsInterrupted()) {
+          break;
+        }
+
+        if (kpattern.Match(key_data, rkey.mv_size)) {
+          found.push_back(std::string(key_data, rkey.mv_size));
+        }
+        if (found.size() >= collector.Limit() ||
+            (++step % KEY_RANGES_CHECK_STEP == 0 && collector.IsEnough(index))) {
+          break;
         }
       }
+      if (rrc == MDB_NOTFOUND) {
+        rrc = LMDB_OK;
+      }
+    }
+
+    if (rcursor) {
+      mdb_cursor_close(rcursor);
+    }
+    if (rtxn) {
+      mdb_txn_abort(rtxn);
+    }
+
+    if (rrc != LMDB_OK) {
+      std::string buff = common::MemSPrintf("SCAN function error: %s", mdb_strerror(rrc));
+      return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
+
+    if (IsInterrupted()) {
+      return common::make_error_value("Interrupted.", common::ErrorValue::E_INTERRUPTED);
+    }
+
+    collector.Done(index, &found);
+    return common::Error();
+  };
+
+  common::Error err = ForEachKeyRange(ranges, scan_range);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  std::vector<std::string> lkeys_out = collector.Merge();
+  uint64_t lcursor_out = 0;
+  if (lkeys_out.size() > count_keys) {
+    // next pages continue serially from the first key which didn't fit
+    const std::string next = lkeys_out.back();
+    lkeys_out.pop_back();
+    rc = mdb_txn_begin(env, NULL, MDB_RDONLY, &scan_session_.txn);
+    if (rc == LMDB_OK) {
+      rc = mdb_cursor_open(scan_session_.txn, dbi, &scan_session_.cursor);
+    }
+    if (rc == LMDB_OK) {
+      key.mv_size = next.size();
+      key.mv_data = const_cast<char*>(next.data());
+      rc = mdb_cursor_get(scan_session_.cursor, &key, &data, MDB_SET_RANGE);
+    }
+
+    if (rc == LMDB_OK) {
+      scan_session_.pattern = kpattern.Pattern();
+      scan_session_.cursor_out = lcursor_out = count_keys;
+      scan_session_.last_access_msec = common::time::current_mstime();
     } else {
-      lcursor_out = cursor_in + count_keys;
-      break;
+      ReleaseScanSession();  // the rest was deleted meanwhile
     }
   }
 
   *keys_out = lkeys_out;
   *cursor_out = lcursor_out;
-  mdb_cursor_close(cursor);
-  mdb_txn_abort(txn);
   return common::Error();
 }
 
@@ -374,7 +760,9 @@ common::Error DBConnection::KeysImpl(const std::string& key_start,
   }
 
   if (rc != LMDB_OK) {
-    mdb_txn_abort(txn);
+    if (txn) {
+      mdb_txn_abort(txn);
+    }
     std::string buff = common::MemSPrintf("Keys function error: %s", mdb_strerror(rc));
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
@@ -393,34 +781,142 @@ common::Error DBConnection::KeysImpl(const std::string& key_start,
   return common::Error();
 }
 
-common::Error DBConnection::DBkcountImpl(size_t* size) {
-  MDB_cursor* cursor = NULL;
+common::Error DBConnection::Sample(size_t sample_size, uint32_t msec, FastoObject* out) {
+  if (!out) {
+    DNOTREACHED();
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  if (!IsConnected()) {
+    return common::make_error_value("Not connected", common::Value::E_ERROR);
+  }
+
   MDB_txn* txn = NULL;
   int rc = mdb_txn_begin(connection_.handle_->env, NULL, MDB_RDONLY, &txn);
+  MDB_cursor* cursor = NULL;
   if (rc == LMDB_OK) {
     rc = mdb_cursor_open(txn, connection_.handle_->dbir, &cursor);
   }
 
   if (rc != LMDB_OK) {
-    mdb_txn_abort(txn);
-    std::string buff = common::MemSPrintf("DBKCOUNT function error: %s", mdb_strerror(rc));
+    if (txn) {
+      mdb_txn_abort(txn);
+    }
+    std::string buff = common::MemSPrintf("SAMPLE function error: %s", mdb_strerror(rc));
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
+  // first and last key give split points, ranges are read in turn by own cursors
   MDB_val key;
   MDB_val data;
-  size_t sz = 0;
-  while (mdb_cursor_get(cursor, &key, &data, MDB_NEXT) == LMDB_OK) {
-    sz++;
+  std::string first;
+  std::string last;
+  if (mdb_cursor_get(cursor, &key, &data, MDB_FIRST) == LMDB_OK) {
+    first.assign(static_cast<const char*>(key.mv_data), key.mv_size);
+  }
+  if (mdb_cursor_get(cursor, &key, &data, MDB_LAST) == LMDB_OK) {
+    last.assign(static_cast<const char*>(key.mv_data), key.mv_size);
+  }
+
+  const std::vector<KeyRange> ranges = InterpolateKeyRanges(first, last, KEY_SAMPLER_RANGES);
+  std::vector<MDB_cursor*> cursors(ranges.size(), NULL);
+  std::vector<MDB_val> keys(ranges.size());
+  std::vector<MDB_val> datas(ranges.size());
+  std::vector<int> positions(ranges.size(), MDB_NOTFOUND);  // result of last cursor move
+  cursors[0] = cursor;
+  for (size_t i = 0; i < ranges.size() && rc == LMDB_OK; ++i) {
+    if (i != 0) {
+      rc = mdb_cursor_open(txn, connection_.handle_->dbir, &cursors[i]);
+    }
+    if (rc == LMDB_OK) {
+      keys[i].mv_size = ranges[i].start.size();
+      keys[i].mv_data = const_cast<char*>(ranges[i].start.data());
+      positions[i] = mdb_cursor_get(cursors[i], &keys[i], &datas[i],
+                                    ranges[i].start.empty() ? MDB_FIRST : MDB_SET_RANGE);
+    }
+  }
+
+  // data points into the map, value bytes are touched only for sampled keys
+  KeySampler sampler(sample_size, NsSeparator(), msec, common::time::current_mstime());
+  size_t active = ranges.size();
+  std::vector<bool> done(ranges.size(), false);
+  bool interrupted = false;
+  while (rc == LMDB_OK && active != 0 && !sampler.IsExpired()) {
+    if (IsInterrupted()) {
+      interrupted = true;
+      break;
+    }
+
+    for (size_t i = 0; i < ranges.size() && rc == LMDB_OK && !sampler.IsExpired(); ++i) {
+      for (size_t step = 0; !done[i] && step < KEY_SAMPLER_CHECK_STEP && !sampler.IsExpired();
+           ++step) {
+        const char* key_data = static_cast<const char*>(keys[i].mv_data);
+        if (positions[i] != LMDB_OK || !ranges[i].Contains(key_data, keys[i].mv_size)) {
+          if (positions[i] != LMDB_OK && positions[i] != MDB_NOTFOUND) {
+            rc = positions[i];
+          }
+          done[i] = true;
+          active--;
+          break;
+        }
+
+        if (sampler.Add(key_data, keys[i].mv_size, datas[i].mv_size)) {
+          sampler.Sample(static_cast<const char*>(datas[i].mv_data), datas[i].mv_size);
+        }
+        positions[i] = mdb_cursor_get(cursors[i], &keys[i], &datas[i], MDB_NEXT);
+      }
+    }
+  }
+  for (size_t i = 0; i < cursors.size(); ++i) {
+    if (cursors[i]) {
+      mdb_cursor_close(cursors[i]);
+    }
   }
-  mdb_cursor_close(cursor);
   mdb_txn_abort(txn);
 
-  *size = sz;
+  if (interrupted) {
+    return common::make_error_value("Interrupted.", common::ErrorValue::E_INTERRUPTED);
+  }
+
+  if (rc != LMDB_OK) {
+    std::string buff = common::MemSPrintf("SAMPLE function error: %s", mdb_strerror(rc));
+    return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+  }
+
+  const bool complete = active == 0;
+  std::vector<std::string> lines = sampler.Report(complete);
+  for (size_t i = 0; i < lines.size(); ++i) {
+    common::StringValue* val = common::Value::createStringValue(lines[i]);
+    FastoObject* child = new FastoObject(out, val, Delimiter());
+    out->AddChildren(child);
+  }
+  return common::Error();
+}
+
+common::Error DBConnection::DBkcountImpl(size_t* size) {
+  MDB_txn* txn = NULL;
+  int rc = mdb_txn_begin(connection_.handle_->env, NULL, MDB_RDONLY, &txn);
+  MDB_stat stat;
+  if (rc == LMDB_OK) {
+    // b-tree root keeps entries count, no need to walk leaf pages (db isn't MDB_DUPSORT)
+    rc = mdb_stat(txn, connection_.handle_->dbir, &stat);
+  }
+
+  if (txn) {
+    mdb_txn_abort(txn);
+  }
+
+  if (rc != LMDB_OK) {
+    std::string buff = common::MemSPrintf("DBKCOUNT function error: %s", mdb_strerror(rc));
+    return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+  }
+
+  *size = stat.ms_entries;
   return common::Error();
 }
 
 common::Error DBConnection::FlushDBImpl() {
+  ReleaseScanSession();
   MDB_cursor* cursor = NULL;
   MDB_txn* txn = NULL;
   int env_flags = connection_.config_.env_flags;
@@ -23,7 +23,9 @@
 
 #include <common/error.h>   // for Error
 #include <common/macros.h>  // for WARN_UNUSED_RESULT
+#include <common/types.h>   // for time64_t
 
+#include "core/background_job.h"           // for BackgroundJob
 #include "core/command_info.h"             // for UNDEFINED_EXAMPLE_STR, UNDEFINED_...
 #include "core/connection_types.h"         // for connectionTypes::LMDB
 #include "core/db_key.h"                   // for NDbKValue, NKey, NKeys
@@ -32,6 +34,9 @@
 #include "core/db/lmdb/server_info.h"  // for ServerInfo
 #include "core/db/lmdb/config.h"
 
+struct MDB_txn;
+struct MDB_cursor;
+
 namespace fastonosql {
 class FastoObject;
 }
@@ -52,6 +57,11 @@ class IDataBaseInfo;
 }
 namespace fastonosql {
 namespace core {
+class KeyPattern;
+}
+}
+namespace fastonosql {
+namespace core {
 namespace lmdb {
 struct lmdb;
 }
@@ -71,9 +81,23 @@ class DBConnection : public core::internal::CDBConnection<NativeConnection, Conf
  public:
   typedef core::internal::CDBConnection<NativeConnection, Config, LMDB> base_class;
   explicit DBConnection(CDBConnectionClient* client);
+  virtual ~DBConnection();
+
+  // stops background COMPACT, releases scan session before env handle
+  common::Error Disconnect() WARN_UNUSED_RESULT;
+  // releases scan session idle more than SCAN_SESSION_TIMEOUT_MSEC,
+  // held read txn keeps LMDB from reusing freed pages
+  void ExpireScanSession();
 
   std::string CurrentDBName() const;
   common::Error Info(const char* args, ServerInfo::Stats* statsout) WARN_UNUSED_RESULT;
+  // starts background copy of compacted environment, the live file doesn't shrink,
+  // database must be reopened from the copy to reclaim space
+  common::Error Compact(const std::string& dest_path, FastoObject* out) WARN_UNUSED_RESULT;
+  void CancelCompact();  // any thread, background COMPACT stops at its next step
+  common::Error Sample(size_t sample_size,
+                       uint32_t msec,
+                       FastoObject* out) WARN_UNUSED_RESULT;  // interruptible
 
  private:
   common::Error SetInner(const std::string& key, const std::string& value) WARN_UNUSED_RESULT;
@@ -99,6 +123,29 @@ class DBConnection : public core::internal::CDBConnection<NativeConnection, Conf
   virtual common::Error SetTTLImpl(const NKey& key, ttl_t ttl) override;
   virtual common::Error GetTTLImpl(const NKey& key, ttl_t* ttl) override;
   virtual common::Error QuitImpl() override;
+
+  // first SCAN page of at least KEY_RANGES_MIN_SCAN_COUNT keys, key ranges interpolated
+  // between first and last key of the prefix are matched on all cores, each range in
+  // own read txn, and the scan session continues after the last returned key
+  common::Error ParallelScan(const KeyPattern& kpattern,
+                             uint64_t count_keys,
+                             std::vector<std::string>* keys_out,
+                             uint64_t* cursor_out) WARN_UNUSED_RESULT;
+  void ReleaseScanSession();
+
+  // SCAN pages continue one cursor inside a held read txn, other commands
+  // begin own txns so own writes are visible to them
+  struct ScanSession {
+    ScanSession();
+
+    MDB_txn* txn;
+    MDB_cursor* cursor;
+    std::string pattern;
+    uint64_t cursor_out;  // cursor which continues this session
+    common::time64_t last_access_msec;
+  } scan_session_;
+
+  BackgroundJob compact_job_;
 };
 
 }  // namespace lmdb
@@ -18,6 +18,8 @@
 
 #include "core/db/lmdb/internal/commands_api.h"
 
+#include "core/key_sampler.h"  // for ParseSampleArgs
+
 namespace fastonosql {
 namespace core {
 namespace lmdb {
@@ -39,6 +41,30 @@ common::Error CommandsApi::Info(internal::CommandHandler* handler,
   return common::Error();
 }
 
+common::Error CommandsApi::Compact(internal::CommandHandler* handler,
+                                   int argc,
+                                   const char** argv,
+                                   FastoObject* out) {
+  DBConnection* mdb = static_cast<DBConnection*>(handler);
+  std::string dest_path = argc >= 1 ? argv[0] : std::string();
+  return mdb->Compact(dest_path, out);
+}
+
+common::Error CommandsApi::Sample(internal::CommandHandler* handler,
+                                  int argc,
+                                  const char** argv,
+                                  FastoObject* out) {
+  DBConnection* mdb = static_cast<DBConnection*>(handler);
+  size_t sample_size = 0;
+  uint32_t msec = 0;
+  common::Error err = ParseSampleArgs(argc, argv, &sample_size, &msec);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  return mdb->Sample(sample_size, msec, out);
+}
+
 }  // namespace lmdb
 }  // namespace core
 }  // namespace fastonosql
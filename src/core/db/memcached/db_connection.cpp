@@ -30,6 +30,7 @@
 #include <common/convert2string.h>  // for ConvertFromString
 #include <common/net/types.h>       // for HostAndPort
 #include <common/sprintf.h>         // for MemSPrintf
+#include <common/time.h>            // for current_mstime
 #include <common/utils.h>           // for c_strornull
 #include <common/value.h>           // for Value::ErrorsType::E_ERROR, etc
 
@@ -38,7 +39,8 @@
 #include "core/db/memcached/command_translator.h"
 #include "core/db/memcached/internal/commands_api.h"
 
-#include "core/global.h"  // for FastoObject, etc
+#include "core/global.h"       // for FastoObject, etc
+#include "core/key_pattern.h"  // for KeyPattern
 
 namespace {
 
@@ -91,7 +93,7 @@ struct ScanHolder {
         offset_pos(cursor_in) {}
 
   const uint64_t cursor_in;
-  const std::string pattern;
+  const KeyPattern pattern;
   const uint64_t limit;
   std::vector<std::string> r;
   uint64_t cursor_out;
@@ -100,10 +102,9 @@ struct ScanHolder {
   memcached_return_t addKey(const char* key, size_t key_length, time_t exp) {
     UNUSED(exp);
     if (r.size() < limit) {
-      std::string received_key(key, key_length);
-      if (common::MatchPattern(received_key, pattern)) {
+      if (pattern.Match(key, key_length)) {
         if (offset_pos == 0) {
-          r.push_back(received_key);
+          r.push_back(std::string(key, key_length));
         } else {
           offset_pos--;
         }
@@ -254,6 +255,12 @@ common::Error CreateConnection(const Config& config, NativeConnection** context)
         common::ErrorValue::E_ERROR);
   }
 
+  if (config.timeout_msec > 0) {
+    // libmemcached waits in poll(), both limits are in milliseconds
+    memcached_behavior_set(memc, MEMCACHED_BEHAVIOR_CONNECT_TIMEOUT, config.timeout_msec);
+    memcached_behavior_set(memc, MEMCACHED_BEHAVIOR_POLL_TIMEOUT, config.timeout_msec);
+  }
+
   memcached_return_t error = memcached_version(memc);
   if (error != MEMCACHED_SUCCESS) {
     memcached_free(memc);
@@ -292,8 +299,26 @@ common::Error TestConnection(const Config& config) {
   return common::Error();
 }
 
+DBConnection::CrawlCache::CrawlCache() : expirations(), truncated(false), crawl_msec(0) {}
+
 DBConnection::DBConnection(CDBConnectionClient* client)
-    : base_class(client, new CommandTranslator(base_class::Commands())), current_info_() {}
+    : base_class(client, new CommandTranslator(base_class::Commands())),
+      current_info_(),
+      text_client_(),
+      text_supported_(true),
+      meta_supported_(true),
+      metadump_supported_(true),
+      crawl_cache_(),
+      key_index_() {}
+
+common::Error DBConnection::Disconnect() {
+  text_client_.Disconnect();
+  meta_supported_ = true;
+  metadump_supported_ = true;
+  InvalidateCrawlCache();
+  key_index_.Reset();
+  return base_class::Disconnect();
+}
 
 common::Error DBConnection::Info(const char* args, ServerInfo::Stats* statsout) {
   if (!statsout) {
@@ -360,6 +385,7 @@ common::Error DBConnection::AddIfNotExist(const NKey& key,
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
+  InvalidateCrawlCache();
   if (client_) {
     client_->OnKeyAdded(NDbKValue(key, NValue(common::Value::createStringValue(value))));
   }
@@ -384,6 +410,7 @@ common::Error DBConnection::Replace(const NKey& key,
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
+  InvalidateCrawlCache();
   if (client_) {
     client_->OnKeyLoaded(NDbKValue(key, NValue(common::Value::createStringValue(value))));
   }
@@ -507,6 +534,7 @@ common::Error DBConnection::DelInner(const std::string& key, time_t expiration)
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
+  InvalidateCrawlCache();
   return common::Error();
 }
 
@@ -526,6 +554,7 @@ common::Error DBConnection::SetInner(const std::string& key,
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
+  InvalidateCrawlCache();
   return common::Error();
 }
 
@@ -582,14 +611,180 @@ common::Error DBConnection::ExpireInner(const std::string& key, ttl_t expiration
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
+  InvalidateCrawlCache();
   return common::Error();
 }
 
 common::Error DBConnection::TTL(const std::string& key, ttl_t* expiration) {
+  if (!expiration) {
+    DNOTREACHED();
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
   if (!IsConnected()) {
     return common::make_error_value("Not connected", common::Value::E_ERROR);
   }
 
+  common::Error err = ConnectTextClient();
+  if (err && err->isError()) {
+    // text protocol unavailable (e.g. SASL-only server), only full dump is left
+    return DumpTTL(key, expiration);
+  }
+
+  if (meta_supported_ && IsValidTextKey(key)) {
+    bool supported = false;
+    bool exists = false;
+    int64_t ttl = 0;
+    err = text_client_.MetaTTL(key, &supported, &exists, &ttl);
+    if (err && err->isError()) {
+      // text connection dropped or rejected, libmemcached has its own connection
+      text_client_.Disconnect();
+      return DumpTTL(key, expiration);
+    }
+
+    if (supported) {
+      if (!exists) {
+        *expiration = EXPIRED_TTL;
+      } else {
+        *expiration = ttl < 0 ? NO_TTL : ttl;
+      }
+      return common::Error();
+    }
+
+    meta_supported_ = false;
+  }
+
+  if (metadump_supported_) {
+    bool supported = false;
+    err = CrawlTTL(key, &supported, expiration);
+    if (err && err->isError()) {
+      return err;
+    }
+
+    if (supported) {
+      return common::Error();
+    }
+
+    metadump_supported_ = false;
+  }
+
+  return DumpTTL(key, expiration);
+}
+
+uint64_t DBConnection::TextConnectTimeout() const {
+  return memcached_behavior_get(connection_.handle_, MEMCACHED_BEHAVIOR_CONNECT_TIMEOUT);
+}
+
+common::Error DBConnection::ConnectTextClient() {
+  if (text_client_.IsConnected()) {
+    return common::Error();
+  }
+
+  if (!text_supported_) {
+    return common::make_error_value("Text protocol refused", common::ErrorValue::E_ERROR);
+  }
+
+  common::Error err = text_client_.Connect(connection_.config_, TextConnectTimeout());
+  if (err && err->isError() && !connection_.config_.user.empty()) {
+    // SASL-only server, don't pay for a refused connect on every call
+    text_supported_ = false;
+  }
+  return err;
+}
+
+common::Error DBConnection::CrawlTTL(const std::string& key, bool* supported, ttl_t* expiration) {
+  bool found = false;
+  time_t exp = -1;
+  common::time64_t cur_msec = common::time::current_mstime();
+  bool expired = cur_msec - crawl_cache_.crawl_msec > MEMCACHED_CRAWL_CACHE_MSEC;
+  if (crawl_cache_.crawl_msec == 0 || expired) {
+    common::Error err = Crawl(key, supported, &found, &exp);
+    if (err && err->isError()) {
+      return err;
+    }
+
+    if (!*supported) {
+      return common::Error();
+    }
+  } else {
+    std::map<std::string, time_t>::const_iterator it = crawl_cache_.expirations.find(key);
+    if (it != crawl_cache_.expirations.end()) {
+      found = true;
+      exp = it->second;
+    } else if (crawl_cache_.truncated) {
+      common::Error err = Crawl(key, supported, &found, &exp);
+      if (err && err->isError()) {
+        return err;
+      }
+
+      if (!*supported) {
+        return common::Error();
+      }
+    }
+  }
+
+  *supported = true;
+  if (!found) {
+    *expiration = EXPIRED_TTL;
+    return common::Error();
+  }
+
+  if (exp < 0) {
+    *expiration = NO_TTL;
+    return common::Error();
+  }
+
+  time_t cur_t = time(NULL);
+  *expiration = exp > cur_t ? exp - cur_t : EXPIRED_TTL;
+  return common::Error();
+}
+
+common::Error DBConnection::Crawl(const std::string& key,
+                                  bool* supported,
+                                  bool* found,
+                                  time_t* exp) {
+  InvalidateCrawlCache();
+  common::Error err = text_client_.StartMetadump(supported);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  if (!*supported) {
+    return common::Error();
+  }
+
+  *found = false;
+  while (true) {
+    MetadumpItem item;
+    bool end = false;
+    err = text_client_.ReadMetadumpItem(&item, &end);
+    if (err && err->isError()) {
+      text_client_.Disconnect();
+      InvalidateCrawlCache();
+      return err;
+    }
+
+    if (end) {
+      break;
+    }
+
+    if (item.key == key) {
+      *found = true;
+      *exp = item.exp;
+    }
+
+    // the stream is read to the end anyway, the key looked up is always seen
+    if (crawl_cache_.expirations.size() < MEMCACHED_CRAWL_CACHE_MAX_KEYS) {
+      crawl_cache_.expirations[item.key] = item.exp;
+    } else {
+      crawl_cache_.truncated = true;
+    }
+  }
+  crawl_cache_.crawl_msec = common::time::current_mstime();
+  return common::Error();
+}
+
+common::Error DBConnection::DumpTTL(const std::string& key, ttl_t* expiration) {
   time_t exp;
   TTLHolder hld(key, &exp);
   memcached_dump_fn func[1] = {0};
@@ -615,6 +810,39 @@ common::Error DBConnection::TTL(const std::string& key, ttl_t* expiration) {
   return common::Error();
 }
 
+void DBConnection::InvalidateCrawlCache() {
+  crawl_cache_.expirations.clear();
+  crawl_cache_.truncated = false;
+  crawl_cache_.crawl_msec = 0;
+}
+
+common::Error DBConnection::StartKeyIndex(bool* supported) {
+  *supported = metadump_supported_ && text_supported_;
+  if (!*supported) {
+    return common::Error();
+  }
+
+  // also finds out whether the server takes our credentials over the text protocol
+  common::Error err = ConnectTextClient();
+  if (err && err->isError()) {
+    if (!text_supported_) {
+      *supported = false;
+      return common::Error();
+    }
+    return err;
+  }
+
+  err = key_index_.Start(connection_.config_, TextConnectTimeout(), supported);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  if (!*supported) {
+    metadump_supported_ = false;
+  }
+  return common::Error();
+}
+
 common::Error DBConnection::VersionServer() const {
   if (!IsConnected()) {
     return common::make_error_value("Not connected", common::Value::E_ERROR);
@@ -635,18 +863,58 @@ common::Error DBConnection::ScanImpl(uint64_t cursor_in,
                                      uint64_t count_keys,
                                      std::vector<std::string>* keys_out,
                                      uint64_t* cursor_out) {
-  ScanHolder hld(cursor_in, pattern, count_keys);
-  memcached_dump_fn func[1] = {0};
-  func[0] = memcached_dump_scan_callback;
-  memcached_return_t result = memcached_dump(connection_.handle_, func, &hld, SIZEOFMASS(func));
-  if (result != MEMCACHED_SUCCESS) {
-    std::string buff = common::MemSPrintf("SCAN function error: %s",
-                                          memcached_strerror(connection_.handle_, result));
+  // cursor 0 starts a new crawl unless the current one is fresh,
+  // other cursors are positions in the index filled by it
+  bool restart = cursor_in == 0 && key_index_.IsStale(common::time::current_mstime());
+  bool supported = metadump_supported_ && text_supported_;
+  common::Error err;
+  if (restart || !key_index_.IsBuilt()) {
+    err = StartKeyIndex(&supported);
+  }
+  if (err && err->isError()) {
+    std::string buff = common::MemSPrintf("SCAN function error: %s", err->description());
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
-  *keys_out = hld.r;
-  *cursor_out = hld.cursor_out;
+  if (!supported) {
+    ScanHolder hld(cursor_in, pattern, count_keys);
+    memcached_dump_fn func[1] = {0};
+    func[0] = memcached_dump_scan_callback;
+    memcached_return_t result = memcached_dump(connection_.handle_, func, &hld, SIZEOFMASS(func));
+    if (result != MEMCACHED_SUCCESS) {
+      std::string buff = common::MemSPrintf("SCAN function error: %s",
+                                            memcached_strerror(connection_.handle_, result));
+      return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
+
+    *keys_out = hld.r;
+    *cursor_out = hld.cursor_out;
+    return common::Error();
+  }
+
+  // the page is returned as soon as the crawl got past its last key
+  const KeyPattern kpattern(pattern);
+  std::vector<std::string> result;
+  auto on_item = [&kpattern, &result, count_keys](const MetadumpItem& item) {
+    if (!kpattern.Match(item.key.data(), item.key.size())) {
+      return true;
+    }
+
+    if (result.size() >= count_keys) {
+      return false;  // next page starts here
+    }
+    result.push_back(item.key);
+    return true;
+  };
+  size_t pos = 0;
+  bool end = false;
+  err = key_index_.Walk(cursor_in, on_item, [this]() { return IsInterrupted(); }, &pos, &end);
+  if (err && err->isError()) {
+    return err;  // interrupted or the crawl connection failed
+  }
+
+  *keys_out = result;
+  *cursor_out = end ? 0 : pos;
   return common::Error();
 }
 
@@ -654,29 +922,62 @@ common::Error DBConnection::KeysImpl(const std::string& key_start,
                                      const std::string& key_end,
                                      uint64_t limit,
                                      std::vector<std::string>* ret) {
-  KeysHolder hld(key_start, key_end, limit, ret);
-  memcached_dump_fn func[1] = {0};
-  func[0] = memcached_dump_keys_callback;
-  memcached_return_t result = memcached_dump(connection_.handle_, func, &hld, SIZEOFMASS(func));
-  if (result != MEMCACHED_SUCCESS) {
-    std::string buff = common::MemSPrintf("KEYS function error: %s",
-                                          memcached_strerror(connection_.handle_, result));
+  // shares the SCAN index, a stale one is crawled again and SCAN cursors of
+  // older pages point into the new crawl
+  bool supported = metadump_supported_ && text_supported_;
+  common::Error err;
+  if (key_index_.IsStale(common::time::current_mstime())) {
+    err = StartKeyIndex(&supported);
+  }
+  if (err && err->isError()) {
+    std::string buff = common::MemSPrintf("KEYS function error: %s", err->description());
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
+  if (!supported) {
+    KeysHolder hld(key_start, key_end, limit, ret);
+    memcached_dump_fn func[1] = {0};
+    func[0] = memcached_dump_keys_callback;
+    memcached_return_t result = memcached_dump(connection_.handle_, func, &hld, SIZEOFMASS(func));
+    if (result != MEMCACHED_SUCCESS) {
+      std::string buff = common::MemSPrintf("KEYS function error: %s",
+                                            memcached_strerror(connection_.handle_, result));
+      return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
+
+    return common::Error();
+  }
+
+  auto on_item = [&key_start, &key_end, limit, ret](const MetadumpItem& item) {
+    if (ret->size() >= limit) {
+      return false;
+    }
+
+    if (key_start < item.key && key_end > item.key) {
+      ret->push_back(item.key);
+    }
+    return true;
+  };
+  size_t pos = 0;
+  bool end = false;
+  err = key_index_.Walk(0, on_item, [this]() { return IsInterrupted(); }, &pos, &end);
+  if (err && err->isError()) {
+    return err;  // interrupted or the crawl connection failed
+  }
+
   return common::Error();
 }
 
 common::Error DBConnection::DBkcountImpl(size_t* size) {
-  std::vector<std::string> ret;
-  common::Error err = Keys("a", "z", UINT64_MAX, &ret);
+  ServerInfo::Stats stats;
+  common::Error err = Info(nullptr, &stats);
   if (err && err->isError()) {
     std::string buff =
         common::MemSPrintf("Couldn't determine DBKCOUNT error: %s", err->description());
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
-  *size = ret.size();
+  *size = stats.curr_items;
   return common::Error();
 }
 
@@ -688,6 +989,8 @@ common::Error DBConnection::FlushDBImpl() {
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
+  key_index_.Reset();
+  InvalidateCrawlCache();
   return common::Error();
 }
 
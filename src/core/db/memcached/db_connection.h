@@ -20,10 +20,12 @@
 
 #include <stdint.h>  // for uint32_t, uint64_t
 #include <time.h>    // for time_t
+#include <map>       // for map
 #include <string>    // for string
 
 #include <common/error.h>   // for Error
 #include <common/macros.h>  // for WARN_UNUSED_RESULT
+#include <common/types.h>   // for time64_t
 
 #include "core/command_info.h"             // for UNDEFINED_EXAMPLE_STR, UNDEF...
 #include "core/connection_types.h"         // for connectionTypes::MEMCACHED
@@ -31,6 +33,11 @@
 #include "core/internal/cdb_connection.h"  // for CDBConnection
 #include "core/db/memcached/server_info.h"
 #include "core/db/memcached/config.h"
+#include "core/db/memcached/key_index.h"
+#include "core/db/memcached/text_client.h"
+
+#define MEMCACHED_CRAWL_CACHE_MSEC 30000       // lru_crawler results reused for TTL lookups
+#define MEMCACHED_CRAWL_CACHE_MAX_KEYS 1000000  // expirations kept from one crawl
 
 namespace fastonosql {
 namespace core {
@@ -69,6 +76,8 @@ class DBConnection : public core::internal::CDBConnection<NativeConnection, Conf
   typedef core::internal::CDBConnection<NativeConnection, Config, MEMCACHED> base_class;
   explicit DBConnection(CDBConnectionClient* client);
 
+  common::Error Disconnect() WARN_UNUSED_RESULT;
+
   common::Error Info(const char* args, ServerInfo::Stats* statsout) WARN_UNUSED_RESULT;
 
   common::Error AddIfNotExist(const NKey& key,
@@ -100,6 +109,16 @@ class DBConnection : public core::internal::CDBConnection<NativeConnection, Conf
                          uint32_t flags) WARN_UNUSED_RESULT;
   common::Error ExpireInner(const std::string& key, ttl_t expiration) WARN_UNUSED_RESULT;
 
+  uint64_t TextConnectTimeout() const;
+  common::Error ConnectTextClient() WARN_UNUSED_RESULT;
+  common::Error CrawlTTL(const std::string& key, bool* supported, ttl_t* expiration)
+      WARN_UNUSED_RESULT;
+  common::Error Crawl(const std::string& key, bool* supported, bool* found, time_t* exp)
+      WARN_UNUSED_RESULT;
+  common::Error DumpTTL(const std::string& key, ttl_t* expiration) WARN_UNUSED_RESULT;
+  void InvalidateCrawlCache();
+  common::Error StartKeyIndex(bool* supported) WARN_UNUSED_RESULT;
+
   virtual common::Error ScanImpl(uint64_t cursor_in,
                                  const std::string& pattern,
                                  uint64_t count_keys,
@@ -121,6 +140,23 @@ class DBConnection : public core::internal::CDBConnection<NativeConnection, Conf
   virtual common::Error QuitImpl() override;
 
   ServerInfo::Stats current_info_;
+
+  TextClient text_client_;
+  bool text_supported_;  // false once the server refused a text connection with our credentials
+  bool meta_supported_;
+  bool metadump_supported_;
+
+  // expirations of items from the last lru_crawler metadump,
+  // at most MEMCACHED_CRAWL_CACHE_MAX_KEYS of them
+  struct CrawlCache {
+    CrawlCache();
+
+    std::map<std::string, time_t> expirations;
+    bool truncated;               // crawl had more items, misses need a new crawl
+    common::time64_t crawl_msec;  // 0 when there is no crawl
+  } crawl_cache_;
+
+  KeyIndex key_index_;
 };
 
 }  // namespace memcached
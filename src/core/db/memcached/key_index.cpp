@@ -0,0 +1,162 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "core/db/memcached/key_index.h"
+
+#include <chrono>  // for milliseconds
+
+#include <common/time.h>   // for current_mstime
+#include <common/value.h>  // for ErrorValue
+
+namespace fastonosql {
+namespace core {
+namespace memcached {
+
+KeyIndex::KeyIndex()
+    : client_(),
+      thread_(),
+      stop_(false),
+      lock_(),
+      items_added_(),
+      items_(),
+      finished_(false),
+      error_(),
+      built_(false),
+      build_msec_(0) {}
+
+KeyIndex::~KeyIndex() {
+  Stop();
+}
+
+common::Error KeyIndex::Start(const Config& config,
+                              uint64_t connect_timeout_msec,
+                              bool* supported) {
+  if (!supported) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  Reset();
+  common::Error err = client_.Connect(config, connect_timeout_msec);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  err = client_.StartMetadump(supported);
+  if (err && err->isError()) {
+    client_.Disconnect();
+    return err;
+  }
+
+  if (!*supported) {
+    client_.Disconnect();
+    return common::Error();
+  }
+
+  stop_ = false;
+  built_ = true;
+  build_msec_ = common::time::current_mstime();
+  thread_ = std::thread(&KeyIndex::Crawl, this);
+  return common::Error();
+}
+
+void KeyIndex::Reset() {
+  Stop();
+  std::lock_guard<std::mutex> lock(lock_);
+  std::vector<MetadumpItem>().swap(items_);
+  finished_ = false;
+  error_ = common::Error();
+  built_ = false;
+  build_msec_ = 0;
+}
+
+bool KeyIndex::IsBuilt() const {
+  return built_;
+}
+
+bool KeyIndex::IsStale(common::time64_t cur_msec) const {
+  return !built_ || cur_msec - build_msec_ > MEMCACHED_KEY_INDEX_TTL_MSEC;
+}
+
+common::Error KeyIndex::Walk(size_t pos,
+                             item_func_t on_item,
+                             std::function<bool()> is_interrupted,
+                             size_t* next_pos,
+                             bool* end) {
+  if (!next_pos || !end) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  std::unique_lock<std::mutex> lock(lock_);
+  while (true) {
+    for (; pos < items_.size(); ++pos) {
+      if (!on_item(items_[pos])) {
+        *next_pos = pos;
+        *end = false;
+        return common::Error();
+      }
+    }
+
+    if (finished_ || !built_) {
+      *next_pos = pos;
+      *end = true;
+      return error_;
+    }
+
+    if (is_interrupted()) {
+      return common::make_error_value("Interrupted.", common::ErrorValue::E_INTERRUPTED);
+    }
+    items_added_.wait_for(lock, std::chrono::milliseconds(MEMCACHED_KEY_INDEX_WAIT_MSEC));
+  }
+}
+
+void KeyIndex::Stop() {
+  stop_ = true;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void KeyIndex::Crawl() {
+  common::Error err;
+  while (!stop_) {
+    MetadumpItem item;
+    bool end = false;
+    err = client_.ReadMetadumpItem(&item, &end);
+    if ((err && err->isError()) || end) {
+      break;
+    }
+
+    std::lock_guard<std::mutex> lock(lock_);
+    if (items_.size() >= MEMCACHED_KEY_INDEX_MAX_ITEMS) {
+      break;
+    }
+    items_.push_back(item);
+    items_added_.notify_all();
+  }
+
+  // an unread rest of the stream can't be skipped reliably, next crawl reconnects
+  client_.Disconnect();
+  std::lock_guard<std::mutex> lock(lock_);
+  error_ = err;
+  finished_ = true;
+  items_added_.notify_all();
+}
+
+}  // namespace memcached
+}  // namespace core
+}  // namespace fastonosql
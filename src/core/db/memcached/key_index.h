@@ -0,0 +1,95 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+
+#include <atomic>              // for atomic
+#include <condition_variable>  // for condition_variable
+#include <functional>          // for function
+#include <mutex>               // for mutex
+#include <string>              // for string
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+#include <common/error.h>   // for Error
+#include <common/macros.h>  // for WARN_UNUSED_RESULT, DISALLOW_COPY_AND_ASSIGN
+#include <common/types.h>   // for time64_t
+
+#include "core/db/memcached/config.h"  // for Config
+#include "core/db/memcached/text_client.h"
+
+#define MEMCACHED_KEY_INDEX_TTL_MSEC 60000     // SCAN from cursor 0 rebuilds older indexes
+#define MEMCACHED_KEY_INDEX_MAX_ITEMS 1000000  // items kept from one crawl, the rest is dropped
+#define MEMCACHED_KEY_INDEX_WAIT_MSEC 100      // interrupt check period while waiting for items
+
+namespace fastonosql {
+namespace core {
+namespace memcached {
+
+// keys of one "lru_crawler metadump all" in crawl order, position in the index
+// is a scan cursor; the dump is read by a background thread over its own text
+// connection, readers walk the items read so far and wait for more
+class KeyIndex {
+ public:
+  typedef std::function<bool(const MetadumpItem& item)> item_func_t;
+
+  KeyIndex();
+  ~KeyIndex();  // stops the crawl
+
+  // drops the index and starts a new crawl; *supported is false when the server
+  // has no lru_crawler metadump
+  common::Error Start(const Config& config, uint64_t connect_timeout_msec, bool* supported)
+      WARN_UNUSED_RESULT;
+  void Reset();
+
+  bool IsBuilt() const;  // crawl started, maybe not finished yet
+  bool IsStale(common::time64_t cur_msec) const;
+
+  // calls on_item for items from pos on, waiting for the crawl when it is behind;
+  // stops before the item on_item returns false for, *next_pos is that item or the
+  // end, *end is true when the finished crawl has nothing after *next_pos
+  common::Error Walk(size_t pos,
+                     item_func_t on_item,
+                     std::function<bool()> is_interrupted,
+                     size_t* next_pos,
+                     bool* end) WARN_UNUSED_RESULT;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(KeyIndex);
+
+  void Stop();
+  void Crawl();
+
+  TextClient client_;
+  std::thread thread_;
+  std::atomic<bool> stop_;
+
+  mutable std::mutex lock_;
+  std::condition_variable items_added_;
+  std::vector<MetadumpItem> items_;
+  bool finished_;        // crawl read to the end, failed or hit MEMCACHED_KEY_INDEX_MAX_ITEMS
+  common::Error error_;  // why the crawl stopped early
+  bool built_;
+  common::time64_t build_msec_;
+};
+
+}  // namespace memcached
+}  // namespace core
+}  // namespace fastonosql
@@ -0,0 +1,483 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "core/db/memcached/text_client.h"
+
+#include <errno.h>   // for errno
+#include <stdlib.h>  // for strtoll
+#include <string.h>  // for memset, strerror
+
+#ifdef OS_WIN
+#include <winsock2.h>
+#include <ws2tcpip.h>  // for getaddrinfo
+#else
+#include <fcntl.h>       // for fcntl, O_NONBLOCK
+#include <netdb.h>       // for getaddrinfo
+#include <sys/select.h>  // for select
+#include <sys/socket.h>  // for socket, connect, send, recv
+#include <sys/time.h>    // for timeval
+#include <unistd.h>      // for close
+#endif
+
+#include <common/convert2string.h>  // for ConvertToString
+#include <common/sprintf.h>         // for MemSPrintf
+#include <common/value.h>           // for ErrorValue
+
+#ifdef OS_WIN
+#define INVALID_DESCRIPTOR INVALID_SOCKET
+#define close_descriptor closesocket
+#else
+#define INVALID_DESCRIPTOR -1
+#define close_descriptor close
+#endif
+
+#define READ_CHUNK_SIZE 16384
+
+namespace {
+
+int hex_value(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+std::string url_decode(const std::string& str) {
+  std::string res;
+  res.reserve(str.size());
+  for (size_t i = 0; i < str.size(); ++i) {
+    if (str[i] == '%' && i + 2 < str.size()) {
+      int hi = hex_value(str[i + 1]);
+      int lo = hex_value(str[i + 2]);
+      if (hi != -1 && lo != -1) {
+        res += static_cast<char>(hi * 16 + lo);
+        i += 2;
+        continue;
+      }
+    }
+    res += str[i];
+  }
+  return res;
+}
+
+void set_blocking(fastonosql::core::memcached::TextClient::descriptor_t fd, bool blocking) {
+#ifdef OS_WIN
+  u_long mode = blocking ? 0 : 1;
+  ioctlsocket(fd, FIONBIO, &mode);
+#else
+  int flags = fcntl(fd, F_GETFL, 0);
+  fcntl(fd, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK);
+#endif
+}
+
+// connect() bounded by timeout_msec, plain connect() waits for the kernel
+// SYN retries (minutes) when the host is down
+bool connect_timeout(fastonosql::core::memcached::TextClient::descriptor_t fd,
+                     const struct sockaddr* addr,
+                     socklen_t addrlen,
+                     uint64_t timeout_msec) {
+  set_blocking(fd, false);
+  int res = connect(fd, addr, addrlen);
+  if (res != 0) {
+#ifdef OS_WIN
+    bool in_progress = WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    bool in_progress = errno == EINPROGRESS;
+#endif
+    if (!in_progress) {
+      return false;
+    }
+
+    fd_set wset;
+    FD_ZERO(&wset);
+    FD_SET(fd, &wset);
+    struct timeval tv;
+    tv.tv_sec = timeout_msec / 1000;
+    tv.tv_usec = (timeout_msec % 1000) * 1000;
+    if (select(static_cast<int>(fd + 1), NULL, &wset, NULL, &tv) <= 0) {
+      return false;
+    }
+
+    int so_error = 0;
+    socklen_t len = sizeof(so_error);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&so_error), &len) != 0 ||
+        so_error != 0) {
+      return false;
+    }
+  }
+  set_blocking(fd, true);
+  return true;
+}
+
+bool is_error_reply(const std::string& line) {
+  return line == "ERROR" || line.compare(0, 13, "CLIENT_ERROR ") == 0 ||
+         line.compare(0, 13, "SERVER_ERROR ") == 0 || line.compare(0, 5, "BUSY ") == 0;
+}
+
+}  // namespace
+
+namespace fastonosql {
+namespace core {
+namespace memcached {
+
+bool IsValidTextKey(const std::string& key) {
+  if (key.empty() || key.size() > MEMCACHED_MAX_KEY_LENGTH) {
+    return false;
+  }
+
+  for (size_t i = 0; i < key.size(); ++i) {
+    unsigned char c = key[i];
+    if (c <= ' ' || c == 0x7f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+MetadumpItem::MetadumpItem() : key(), exp(-1) {}
+
+bool ParseMetadumpLine(const std::string& line, MetadumpItem* item) {
+  if (!item) {
+    return false;
+  }
+
+  bool have_key = false;
+  time_t exp = -1;
+  std::string key;
+  size_t pos = 0;
+  while (pos < line.size()) {
+    size_t end = line.find(' ', pos);
+    if (end == std::string::npos) {
+      end = line.size();
+    }
+
+    size_t eq = line.find('=', pos);
+    if (eq != std::string::npos && eq < end) {
+      const std::string name = line.substr(pos, eq - pos);
+      const std::string value = line.substr(eq + 1, end - eq - 1);
+      if (name == "key") {
+        key = url_decode(value);
+        have_key = !key.empty();
+      } else if (name == "exp") {
+        exp = strtoll(value.c_str(), NULL, 10);
+      }
+    }
+    pos = end + 1;
+  }
+
+  if (!have_key) {
+    return false;
+  }
+
+  item->key = key;
+  item->exp = exp;
+  return true;
+}
+
+TextClient::TextClient()
+    : fd_(INVALID_DESCRIPTOR),
+      buffer_(),
+      buffer_pos_(0),
+      pending_line_(),
+      has_pending_line_(false) {}
+
+TextClient::~TextClient() {
+  Disconnect();
+}
+
+common::Error TextClient::Connect(const Config& config, uint64_t connect_timeout_msec) {
+  Disconnect();
+
+  const common::net::HostAndPort& host = config.host;
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  struct addrinfo* result = NULL;
+  std::string port = common::ConvertToString(host.port);
+  int res = getaddrinfo(host.host.c_str(), port.c_str(), &hints, &result);
+  if (res != 0) {
+    std::string buff = common::MemSPrintf("Couldn't resolve %s: %s", host.host, gai_strerror(res));
+    return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+  }
+
+  for (struct addrinfo* rp = result; rp; rp = rp->ai_next) {
+    descriptor_t fd = socket(rp->ai_family, rp->ai_socktype, rp->ai_protocol);
+    if (fd == INVALID_DESCRIPTOR) {
+      continue;
+    }
+
+    if (connect_timeout(fd, rp->ai_addr, rp->ai_addrlen, connect_timeout_msec)) {
+      fd_ = fd;
+      break;
+    }
+    close_descriptor(fd);
+  }
+  freeaddrinfo(result);
+
+  if (fd_ == INVALID_DESCRIPTOR) {
+    std::string buff = common::MemSPrintf("Couldn't connect to %s:%u", host.host, host.port);
+    return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+  }
+
+#ifdef OS_WIN
+  DWORD timeout = MEMCACHED_TEXT_CLIENT_TIMEOUT_SEC * 1000;
+#else
+  struct timeval timeout;
+  timeout.tv_sec = MEMCACHED_TEXT_CLIENT_TIMEOUT_SEC;
+  timeout.tv_usec = 0;
+#endif
+  setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout),
+             sizeof(timeout));
+  setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout),
+             sizeof(timeout));
+
+  if (!config.user.empty()) {
+    common::Error err = Authenticate(config.user, config.password);
+    if (err && err->isError()) {
+      Disconnect();
+      return err;
+    }
+  }
+  return common::Error();
+}
+
+void TextClient::Disconnect() {
+  if (fd_ != INVALID_DESCRIPTOR) {
+    close_descriptor(fd_);
+    fd_ = INVALID_DESCRIPTOR;
+  }
+  buffer_.clear();
+  buffer_pos_ = 0;
+  pending_line_.clear();
+  has_pending_line_ = false;
+}
+
+bool TextClient::IsConnected() const {
+  return fd_ != INVALID_DESCRIPTOR;
+}
+
+common::Error TextClient::SendCommand(const std::string& command) {
+  if (!IsConnected()) {
+    return common::make_error_value("Not connected", common::ErrorValue::E_ERROR);
+  }
+
+  std::string data = command + "\r\n";
+  size_t sent = 0;
+  while (sent < data.size()) {
+    int res = send(fd_, data.c_str() + sent, data.size() - sent, 0);
+    if (res <= 0) {
+      return Fail("send");
+    }
+    sent += res;
+  }
+
+  return common::Error();
+}
+
+common::Error TextClient::ReadLine(std::string* line) {
+  if (!line) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  if (has_pending_line_) {
+    *line = pending_line_;
+    pending_line_.clear();
+    has_pending_line_ = false;
+    return common::Error();
+  }
+
+  if (!IsConnected()) {
+    return common::make_error_value("Not connected", common::ErrorValue::E_ERROR);
+  }
+
+  while (true) {
+    size_t eol = buffer_.find("\r\n", buffer_pos_);
+    if (eol != std::string::npos) {
+      *line = buffer_.substr(buffer_pos_, eol - buffer_pos_);
+      buffer_pos_ = eol + 2;
+      return common::Error();
+    }
+
+    // keep unread tail only, so the buffer doesn't grow with the stream
+    buffer_.erase(0, buffer_pos_);
+    buffer_pos_ = 0;
+
+    char chunk[READ_CHUNK_SIZE];
+    int res = recv(fd_, chunk, sizeof(chunk), 0);
+    if (res == 0) {
+      Disconnect();
+      return common::make_error_value("Connection closed by server", common::ErrorValue::E_ERROR);
+    }
+    if (res < 0) {
+      return Fail("recv");
+    }
+    buffer_.append(chunk, res);
+  }
+}
+
+common::Error TextClient::MetaTTL(const std::string& key,
+                                  bool* supported,
+                                  bool* exists,
+                                  int64_t* ttl) {
+  if (!supported || !exists || !ttl) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  if (!IsValidTextKey(key)) {
+    return common::make_error_value("Invalid key for text protocol", common::ErrorValue::E_ERROR);
+  }
+
+  common::Error err = SendCommand("mg " + key + " t");
+  if (err && err->isError()) {
+    return err;
+  }
+
+  std::string line;
+  err = ReadLine(&line);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  if (line == "EN") {
+    *supported = true;
+    *exists = false;
+    return common::Error();
+  }
+
+  // "HD t123", 1.6.0-1.6.9 answered "OK t123"
+  if (line.compare(0, 2, "HD") == 0 || line.compare(0, 2, "OK") == 0) {
+    size_t pos = line.find(" t");
+    if (pos == std::string::npos) {
+      return common::make_error_value("Unexpected mg reply: " + line, common::ErrorValue::E_ERROR);
+    }
+    *supported = true;
+    *exists = true;
+    *ttl = strtoll(line.c_str() + pos + 2, NULL, 10);
+    return common::Error();
+  }
+
+  if (line == "ERROR") {
+    *supported = false;
+    return common::Error();
+  }
+
+  return common::make_error_value("Unexpected mg reply: " + line, common::ErrorValue::E_ERROR);
+}
+
+common::Error TextClient::StartMetadump(bool* supported) {
+  if (!supported) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  common::Error err = SendCommand("lru_crawler metadump all");
+  if (err && err->isError()) {
+    return err;
+  }
+
+  std::string line;
+  err = ReadLine(&line);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  if (line == "ERROR") {
+    *supported = false;
+    return common::Error();
+  }
+
+  if (is_error_reply(line)) {
+    return common::make_error_value("lru_crawler metadump error: " + line,
+                                    common::ErrorValue::E_ERROR);
+  }
+
+  *supported = true;
+  pending_line_ = line;
+  has_pending_line_ = true;
+  return common::Error();
+}
+
+common::Error TextClient::ReadMetadumpItem(MetadumpItem* item, bool* end) {
+  if (!item || !end) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  while (true) {
+    std::string line;
+    common::Error err = ReadLine(&line);
+    if (err && err->isError()) {
+      return err;
+    }
+
+    if (line == "END") {
+      *end = true;
+      return common::Error();
+    }
+
+    if (is_error_reply(line)) {
+      return common::make_error_value("lru_crawler metadump error: " + line,
+                                      common::ErrorValue::E_ERROR);
+    }
+
+    if (ParseMetadumpLine(line, item)) {
+      *end = false;
+      return common::Error();
+    }
+  }
+}
+
+common::Error TextClient::Authenticate(const std::string& user, const std::string& password) {
+  // memcached -Y: any key, the value is "user password"
+  const std::string token = user + " " + password;
+  common::Error err =
+      SendCommand("set auth 0 0 " + common::ConvertToString(token.size()) + "\r\n" + token);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  // SASL-only servers close text protocol connections
+  std::string line;
+  err = ReadLine(&line);
+  if (err && err->isError()) {
+    std::string buff = common::MemSPrintf("Text protocol auth error: %s", err->description());
+    return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+  }
+
+  if (line != "STORED") {
+    return common::make_error_value("Text protocol auth error: " + line,
+                                    common::ErrorValue::E_ERROR);
+  }
+  return common::Error();
+}
+
+common::Error TextClient::Fail(const std::string& what) {
+  std::string buff = common::MemSPrintf("Memcached %s error: %s", what, strerror(errno));
+  Disconnect();
+  return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+}
+
+}  // namespace memcached
+}  // namespace core
+}  // namespace fastonosql
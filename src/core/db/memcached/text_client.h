@@ -0,0 +1,99 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>  // for int64_t, uint64_t, uintptr_t
+#include <time.h>    // for time_t
+
+#include <string>  // for string
+
+#include <common/error.h>   // for Error
+#include <common/macros.h>  // for WARN_UNUSED_RESULT
+
+#include "core/db/memcached/config.h"  // for Config
+
+#define MEMCACHED_TEXT_CLIENT_TIMEOUT_SEC 5
+#define MEMCACHED_MAX_KEY_LENGTH 250
+
+namespace fastonosql {
+namespace core {
+namespace memcached {
+
+// one line of "lru_crawler metadump":
+// key=user%3A1 exp=1500000100 la=1500000000 cas=12 fetch=no cls=1 size=63
+struct MetadumpItem {
+  MetadumpItem();
+
+  std::string key;  // url decoded
+  time_t exp;       // absolute server time, -1 never expires
+};
+
+bool ParseMetadumpLine(const std::string& line, MetadumpItem* item);
+
+// keys with spaces or control characters can't be sent in text commands
+bool IsValidTextKey(const std::string& key);
+
+// plain text protocol connection to one server, used for the commands
+// libmemcached doesn't expose: meta commands and lru_crawler
+class TextClient {
+ public:
+#ifdef OS_WIN
+  typedef uintptr_t descriptor_t;
+#else
+  typedef int descriptor_t;
+#endif
+
+  TextClient();
+  ~TextClient();
+
+  // connects to config.host within connect_timeout_msec, servers with
+  // user/password get the text protocol auth ("set" with "user password"),
+  // SASL-only servers refuse it and the connect fails
+  common::Error Connect(const Config& config, uint64_t connect_timeout_msec) WARN_UNUSED_RESULT;
+  void Disconnect();
+  bool IsConnected() const;
+
+  common::Error SendCommand(const std::string& command) WARN_UNUSED_RESULT;  // without \r\n
+  common::Error ReadLine(std::string* line) WARN_UNUSED_RESULT;              // without \r\n
+
+  // "mg <key> t", needs memcached 1.6+; ttl is -1 for items without expiration,
+  // *supported is false when the server answered ERROR
+  common::Error MetaTTL(const std::string& key, bool* supported, bool* exists, int64_t* ttl)
+      WARN_UNUSED_RESULT;
+
+  // starts "lru_crawler metadump all", read items with ReadMetadumpItem;
+  // *supported is false when the server doesn't know the command
+  common::Error StartMetadump(bool* supported) WARN_UNUSED_RESULT;
+  common::Error ReadMetadumpItem(MetadumpItem* item, bool* end) WARN_UNUSED_RESULT;
+
+ private:
+  common::Error Authenticate(const std::string& user, const std::string& password)
+      WARN_UNUSED_RESULT;
+  common::Error Fail(const std::string& what) WARN_UNUSED_RESULT;
+
+  descriptor_t fd_;
+  std::string buffer_;
+  size_t buffer_pos_;
+  std::string pending_line_;  // first metadump line, read to detect errors
+  bool has_pending_line_;
+};
+
+}  // namespace memcached
+}  // namespace core
+}  // namespace fastonosql
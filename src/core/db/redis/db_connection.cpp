@@ -56,6 +56,7 @@ extern "C" {
 #include <common/utils.h>           // for c_strornull, usleep, etc
 #include <common/value.h>           // for ErrorValue, etc
 
+#include "core/fasto_object_writer.h"  // for FastoObjectWriter
 #include "core/icommand_translator.h"  // for translator_t, etc
 
 #include "core/command_holder.h"  // for CommandHolder
@@ -68,6 +69,7 @@ extern "C" {
 #include "core/db/redis/sentinel_info.h"  // for DiscoverySentinelInfo, etc
 #include "core/db/redis/command_translator.h"
 #include "core/db/redis/internal/commands_api.h"
+#include "core/db/redis/monitor_stats.h"
 
 #define HIREDIS_VERSION    \
   STRINGIZE(HIREDIS_MAJOR) \
@@ -243,7 +245,6 @@ CDBConnection<redis::NativeConnection, redis::RConfig, REDIS>::Commands() {
 }  // namespace internal
 
 namespace redis {
-namespace {
 
 common::Error valueFromReplay(redisReply* r, common::Value** out) {
   if (!out) {
@@ -296,6 +297,8 @@ common::Error valueFromReplay(redisReply* r, common::Value** out) {
   return common::Error();
 }
 
+namespace {
+
 common::Error cliPrintContextError(redisContext* context) {
   if (!context) {
     DNOTREACHED();
@@ -306,6 +309,33 @@ common::Error cliPrintContextError(redisContext* context) {
   return common::make_error_value(buff, common::ErrorValue::E_ERROR);
 }
 
+common::Error cliReplyError(redisContext* context) {
+  /* Filter cases where we should reconnect */
+  if (context->err == REDIS_ERR_IO && errno == ECONNRESET) {
+    return common::make_error_value("Needed reconnect.", common::ErrorValue::E_ERROR);
+  }
+  if (context->err == REDIS_ERR_EOF) {
+    return common::make_error_value("Needed reconnect.", common::ErrorValue::E_ERROR);
+  }
+
+  return cliPrintContextError(context);
+}
+
+// first call adds snapshot child, next ones replace its value (ItemUpdated instead of ChildAdded)
+void updateStreamSnapshot(FastoObject* out,
+                          const std::string& report,
+                          const std::string& delimiter,
+                          FastoObject** snapshot) {
+  common::StringValue* val = common::Value::createStringValue(report);
+  if (!*snapshot) {
+    *snapshot = new FastoObject(out, val, delimiter);
+    out->AddChildren(*snapshot);
+    return;
+  }
+
+  (*snapshot)->SetValue(common::ValueSPtr(val));
+}
+
 common::Error authContext(const char* auth_str, redisContext* context) {
   if (!auth_str) {
     return common::Error();
@@ -339,10 +369,20 @@ common::Error CreateConnection(const RConfig& config, NativeConnection** context
 
   redisContext* lcontext = NULL;
   bool is_local = !config.hostsocket.empty();
+  // timeouts apply to sockets, ssh channels keep the session's own waits
+  bool is_ssh = !is_local && config.ssh_info.current_method != SSHInfo::UNKNOWN;
+  bool use_timeout = config.timeout_msec > 0 && !is_ssh;
+  struct timeval tv;
+  tv.tv_sec = config.timeout_msec / 1000;
+  tv.tv_usec = (config.timeout_msec % 1000) * 1000;
 
   if (is_local) {
     const char* hostsocket = common::utils::c_strornull(config.hostsocket);
-    lcontext = redisConnectUnix(hostsocket);
+    lcontext = use_timeout ? redisConnectUnixWithTimeout(hostsocket, tv)
+                           : redisConnectUnix(hostsocket);
+  } else if (use_timeout) {
+    const char* host = common::utils::c_strornull(config.host.host);
+    lcontext = redisConnectWithTimeout(host, config.host.port, tv);
   } else {
     SSHInfo sinfo = config.ssh_info;
     const char* host = common::utils::c_strornull(config.host.host);
@@ -357,7 +397,7 @@ common::Error CreateConnection(const RConfig& config, NativeConnection** context
     const char* private_key = common::utils::c_strornull(sinfo.private_key);
     const char* passphrase = common::utils::c_strornull(sinfo.passphrase);
     lcontext = redisConnect(host, port, ssh_address, ssh_port, username, password, public_key,
-                            private_key, passphrase, curM);
+                            private_key, passphrase, curM, sinfo.window_size, sinfo.packet_size);
   }
 
   if (!lcontext) {
@@ -385,10 +425,19 @@ common::Error CreateConnection(const RConfig& config, NativeConnection** context
     return common::make_error_value(buff, common::Value::E_ERROR);
   }
 
+  if (use_timeout && redisSetTimeout(lcontext, tv) != REDIS_OK) {
+    redisFree(lcontext);
+    return common::make_error_value("Couldn't set connection timeout", common::Value::E_ERROR);
+  }
+
   *context = lcontext;
   return common::Error();
 }
 
+void KeepAliveSSHSessions() {
+  redisSshSessionsKeepAlive();
+}
+
 common::Error TestConnection(const RConfig& rconfig) {
   redisContext* context = NULL;
   common::Error err = CreateConnection(rconfig, &context);
@@ -524,7 +573,8 @@ common::Error DiscoverySentinelConnection(const RConfig& rconfig,
 DBConnection::DBConnection(CDBConnectionClient* client)
     : base_class(client, new CommandTranslator(base_class::Commands())),
       isAuth_(false),
-      cur_db_(-1) {}
+      cur_db_(-1),
+      reply_writer_(nullptr) {}
 
 bool DBConnection::IsAuthenticated() const {
   if (!IsConnected()) {
@@ -1041,35 +1091,83 @@ common::Error DBConnection::CliFormatReplyRaw(FastoObject* out, redisReply* r) {
   return common::Error();
 }
 
-common::Error DBConnection::CliReadReply(FastoObject* out) {
-  if (!out) {
-    DNOTREACHED();
-    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+common::Error DBConnection::CliGetReply(redisReply** reply) {
+  if (!IsConnected()) {
+    return common::make_error_value("Not connected", common::Value::E_ERROR);
+  }
+
+  void* _reply = NULL;
+  if (redisGetReply(connection_.handle_, &_reply) != REDIS_OK) {
+    return cliReplyError(connection_.handle_);
   }
 
+  *reply = static_cast<redisReply*>(_reply);
+  return common::Error();
+}
+
+common::Error DBConnection::CliWaitReply(redisReply** reply, uint32_t timeout_msec) {
   if (!IsConnected()) {
     return common::make_error_value("Not connected", common::Value::E_ERROR);
   }
 
   void* _reply = NULL;
-  if (redisGetReply(connection_.handle_, &_reply) != REDIS_OK) {
-    /* Filter cases where we should reconnect */
-    if (connection_.handle_->err == REDIS_ERR_IO && errno == ECONNRESET) {
-      return common::make_error_value("Needed reconnect.", common::ErrorValue::E_ERROR);
-    }
-    if (connection_.handle_->err == REDIS_ERR_EOF) {
-      return common::make_error_value("Needed reconnect.", common::ErrorValue::E_ERROR);
-    }
+  if (redisGetReplyTimeout(connection_.handle_, &_reply, timeout_msec) != REDIS_OK) {
+    return cliReplyError(connection_.handle_);
+  }
 
-    return cliPrintContextError(connection_.handle_); /* avoid compiler warning */
+  *reply = static_cast<redisReply*>(_reply);
+  return common::Error();
+}
+
+common::Error DBConnection::CliReadReply(FastoObject* out) {
+  if (!out) {
+    DNOTREACHED();
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  redisReply* reply = NULL;
+  common::Error err = CliGetReply(&reply);
+  if (err && err->isError()) {
+    return err;
   }
 
-  redisReply* reply = static_cast<redisReply*>(_reply);
   common::Error er = CliFormatReplyRaw(out, reply);
   freeReplyObject(reply);
   return er;
 }
 
+// hiredis has the whole reply in memory already, this only saves
+// converting it into values of a tree before it is written
+common::Error DBConnection::CliStreamReply(redisReply* r) {
+  common::Error err = reply_writer_->BeginArray(r->elements, Delimiter());
+  if (err && err->isError()) {
+    return err;
+  }
+
+  for (size_t i = 0; i < r->elements; ++i) {
+    redisReply* element = r->element[i];
+    std::unique_ptr<common::Value> val;
+    if (element->type == REDIS_REPLY_NIL) {
+      val.reset(common::Value::createNullValue());
+    } else if (element->type == REDIS_REPLY_ERROR) {
+      val.reset(common::Value::createErrorValue(std::string(element->str, element->len),
+                                                common::ErrorValue::E_NONE,
+                                                common::logging::L_WARNING));
+    } else if (element->type == REDIS_REPLY_INTEGER) {
+      val.reset(common::Value::createLongLongIntegerValue(element->integer));
+    } else {
+      val.reset(common::Value::createStringValue(std::string(element->str, element->len)));
+    }
+
+    err = reply_writer_->AppendElement(val.get());
+    if (err && err->isError()) {
+      return err;
+    }
+  }
+
+  return reply_writer_->EndArray();
+}
+
 common::Error DBConnection::ExecuteAsPipeline(
     const std::vector<FastoObjectCommandIPtr>& cmds,
     void (*log_command_cb)(FastoObjectCommandIPtr command)) {
@@ -1119,6 +1217,56 @@ common::Error DBConnection::ExecuteAsPipeline(
   return common::Error();
 }
 
+bool DBConnection::IsPipelineSupported() const {
+  return true;
+}
+
+common::Error DBConnection::ExecutePipeline(const std::vector<std::string>& commands,
+                                            pipeline_reply_t on_reply) {
+  if (!IsConnected()) {
+    return common::make_error_value("Not connected", common::Value::E_ERROR);
+  }
+
+  for (size_t i = 0; i < commands.size(); ++i) {
+    int argc = 0;
+    sds* argv = sdssplitargslong(commands[i].c_str(), &argc);
+    if (!argv) {
+      return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+    }
+
+    std::vector<size_t> argvlen(argc);
+    for (int j = 0; j < argc; ++j) {
+      argvlen[j] = sdslen(argv[j]);
+    }
+    int res = redisAppendCommandArgv(connection_.handle_, argc, const_cast<const char**>(argv),
+                                     argvlen.data());
+    sdsfreesplitres(argv, argc);
+    if (res != REDIS_OK) {
+      return cliPrintContextError(connection_.handle_);
+    }
+  }
+
+  // the first redisGetReply flushes the whole output buffer
+  for (size_t i = 0; i < commands.size(); ++i) {
+    void* _reply = NULL;
+    if (redisGetReply(connection_.handle_, &_reply) != REDIS_OK) {
+      return cliReplyError(connection_.handle_);
+    }
+
+    redisReply* reply = static_cast<redisReply*>(_reply);
+    common::Error err;
+    if (reply->type == REDIS_REPLY_ERROR) {
+      err = common::make_error_value(std::string(reply->str, reply->len), common::Value::E_ERROR);
+    }
+    freeReplyObject(reply);
+    if (on_reply) {
+      on_reply(i, err);
+    }
+  }
+
+  return common::Error();
+}
+
 common::Error DBConnection::CommonExec(int argc, const char** argv, FastoObject* out) {
   if (!out || argc < 1) {
     DNOTREACHED();
@@ -1138,12 +1286,27 @@ common::Error DBConnection::CommonExec(int argc, const char** argv, FastoObject*
 
   redisAppendCommandArgv(connection_.handle_, argc, const_cast<const char**>(argv), argvlen);
   free(argvlen);
-  common::Error err = CliReadReply(out);
+  if (!reply_writer_) {
+    return CliReadReply(out);
+  }
+
+  redisReply* reply = NULL;
+  common::Error err = CliGetReply(&reply);
   if (err && err->isError()) {
     return err;
   }
 
-  return common::Error();
+  bool flat = reply->type == REDIS_REPLY_ARRAY;
+  for (size_t i = 0; flat && i < reply->elements; ++i) {
+    flat = reply->element[i]->type != REDIS_REPLY_ARRAY;
+  }
+  err = flat ? CliStreamReply(reply) : CliFormatReplyRaw(out, reply);
+  freeReplyObject(reply);
+  return err;
+}
+
+void DBConnection::SetReplyWriter(FastoObjectWriter* writer) {
+  reply_writer_ = writer;
 }
 
 common::Error DBConnection::Auth(const std::string& password) {
@@ -1188,13 +1351,40 @@ common::Error DBConnection::Monitor(int argc, const char** argv, FastoObject* ou
     return err;
   }
 
+  common::time64_t last_snapshot = common::time::current_mstime();
+  EventRing ring(STREAM_RING_CAPACITY);
+  MonitorAggregator stats(NsSeparator(), last_snapshot);
+  FastoObject* snapshot = nullptr;
   while (true) {
-    common::Error er = CliReadReply(out);
+    redisReply* reply = NULL;
+    common::Error er = CliWaitReply(&reply, STREAM_SNAPSHOT_INTERVAL_MSEC);
     if (er && er->isError()) {
       return er;
     }
 
-    if (IsInterrupted()) {
+    if (reply && reply->type == REDIS_REPLY_ERROR) {
+      std::string str(reply->str, reply->len);
+      freeReplyObject(reply);
+      return common::make_error_value(str, common::ErrorValue::E_ERROR);
+    }
+
+    if (reply && (reply->type == REDIS_REPLY_STATUS || reply->type == REDIS_REPLY_STRING)) {
+      std::string line(reply->str, reply->len);
+      ring.Push(line);
+      stats.AddLine(line);
+    }
+    if (reply) {
+      freeReplyObject(reply);
+    }
+
+    common::time64_t now = common::time::current_mstime();
+    bool interrupted = IsInterrupted();
+    if (interrupted || !snapshot || now - last_snapshot >= STREAM_SNAPSHOT_INTERVAL_MSEC) {
+      updateStreamSnapshot(out, stats.Report(ring, now), Delimiter(), &snapshot);
+      last_snapshot = now;
+    }
+
+    if (interrupted) {
       return common::make_error_value("Interrupted.", common::ErrorValue::E_INTERRUPTED);
     }
   }
@@ -1224,13 +1414,51 @@ common::Error DBConnection::Subscribe(int argc, const char** argv, FastoObject*
     return err;
   }
 
+  common::time64_t last_snapshot = common::time::current_mstime();
+  EventRing ring(STREAM_RING_CAPACITY);
+  SubscribeAggregator stats(last_snapshot);
+  FastoObject* snapshot = nullptr;
   while (true) {
-    common::Error er = CliReadReply(out);
+    redisReply* reply = NULL;
+    common::Error er = CliWaitReply(&reply, STREAM_SNAPSHOT_INTERVAL_MSEC);
     if (er && er->isError()) {
       return er;
     }
 
-    if (IsInterrupted()) {
+    if (reply && reply->type == REDIS_REPLY_ERROR) {
+      std::string str(reply->str, reply->len);
+      freeReplyObject(reply);
+      return common::make_error_value(str, common::ErrorValue::E_ERROR);
+    }
+
+    // message channel payload | pmessage pattern channel payload | subscribe channel count
+    if (reply && reply->type == REDIS_REPLY_ARRAY && reply->elements >= 3) {
+      redisReply** elements = reply->element;
+      std::string kind(elements[0]->str, elements[0]->len);
+      if (kind == "pmessage" && reply->elements == 4) {
+        std::string channel(elements[2]->str, elements[2]->len);
+        ring.Push(channel + ": " + std::string(elements[3]->str, elements[3]->len));
+        stats.AddMessage(channel);
+      } else if (kind == "message") {
+        std::string channel(elements[1]->str, elements[1]->len);
+        ring.Push(channel + ": " + std::string(elements[2]->str, elements[2]->len));
+        stats.AddMessage(channel);
+      } else if (elements[1]->type == REDIS_REPLY_STRING) {
+        ring.Push(kind + " " + std::string(elements[1]->str, elements[1]->len));
+      }
+    }
+    if (reply) {
+      freeReplyObject(reply);
+    }
+
+    common::time64_t now = common::time::current_mstime();
+    bool interrupted = IsInterrupted();
+    if (interrupted || !snapshot || now - last_snapshot >= STREAM_SNAPSHOT_INTERVAL_MSEC) {
+      updateStreamSnapshot(out, stats.Report(ring, now), Delimiter(), &snapshot);
+      last_snapshot = now;
+    }
+
+    if (interrupted) {
       return common::make_error_value("Interrupted.", common::ErrorValue::E_INTERRUPTED);
     }
   }
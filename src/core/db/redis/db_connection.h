@@ -44,6 +44,7 @@ class CDBConnectionClient;
 namespace fastonosql {
 namespace core {
 class IDataBaseInfo;
+class FastoObjectWriter;
 }
 }
 struct redisContext;  // lines 49-49
@@ -61,6 +62,8 @@ struct redisReply;    // lines 50-50
 #define STAT_MODE_REQUEST "STAT"
 #define SCAN_MODE_REQUEST "SCAN"
 
+#define SSH_KEEPALIVE_TIMEOUT_MSEC 10000
+
 namespace fastonosql {
 namespace core {
 namespace redis {
@@ -73,8 +76,11 @@ struct RConfig : public Config {
   SSHInfo ssh_info;
 };
 
+common::Error valueFromReplay(redisReply* r, common::Value** out) WARN_UNUSED_RESULT;
 common::Error CreateConnection(const RConfig& config, NativeConnection** context);
 common::Error TestConnection(const RConfig& rconfig);
+// Keeps shared SSH tunnel sessions alive and closes the ones idle too long.
+void KeepAliveSSHSessions();
 
 common::Error DiscoveryClusterConnection(const RConfig& rconfig,
                                          std::vector<ServerDiscoveryClusterInfoSPtr>* infos);
@@ -98,8 +104,17 @@ class DBConnection : public core::internal::CDBConnection<NativeConnection, RCon
                                   void (*log_command_cb)(FastoObjectCommandIPtr))
       WARN_UNUSED_RESULT;
 
+  virtual bool IsPipelineSupported() const override;
+  virtual common::Error ExecutePipeline(const std::vector<std::string>& commands,
+                                        pipeline_reply_t on_reply) override;
+
   common::Error CommonExec(int argc, const char** argv, FastoObject* out) WARN_UNUSED_RESULT;
+  // flat array replies of CommonExec go element by element into writer instead
+  // of a FastoObject tree, nullptr - off
+  void SetReplyWriter(FastoObjectWriter* writer);
   common::Error Auth(const std::string& password) WARN_UNUSED_RESULT;
+  // MONITOR and SUBSCRIBE keep bounded event ring and statistics,
+  // output is one child updated at most every STREAM_SNAPSHOT_INTERVAL_MSEC
   common::Error Monitor(int argc,
                         const char** argv,
                         FastoObject* out) WARN_UNUSED_RESULT;  // interrupt
@@ -158,10 +173,15 @@ class DBConnection : public core::internal::CDBConnection<NativeConnection, RCon
 
   common::Error CliFormatReplyRaw(FastoObjectArray* ar, redisReply* r) WARN_UNUSED_RESULT;
   common::Error CliFormatReplyRaw(FastoObject* out, redisReply* r) WARN_UNUSED_RESULT;
+  common::Error CliGetReply(redisReply** reply) WARN_UNUSED_RESULT;
+  common::Error CliWaitReply(redisReply** reply,
+                             uint32_t timeout_msec) WARN_UNUSED_RESULT;  // NULL reply on timeout
   common::Error CliReadReply(FastoObject* out) WARN_UNUSED_RESULT;
+  common::Error CliStreamReply(redisReply* r) WARN_UNUSED_RESULT;
 
   bool isAuth_;
   int cur_db_;
+  FastoObjectWriter* reply_writer_;
 };
 
 }  // namespace redis
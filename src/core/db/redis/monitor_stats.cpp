@@ -0,0 +1,246 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "core/db/redis/monitor_stats.h"
+
+#include <ctype.h>  // for toupper
+
+#include <common/sprintf.h>  // for MemSPrintf
+
+namespace fastonosql {
+namespace core {
+namespace redis {
+
+namespace {
+
+// reads "..." token starting at pos, escapes are kept as is
+bool ReadQuoted(const std::string& line, size_t* pos, std::string* token) {
+  size_t start = line.find('"', *pos);
+  if (start == std::string::npos) {
+    return false;
+  }
+
+  size_t i = start + 1;
+  while (i < line.size() && line[i] != '"') {
+    if (line[i] == '\\') {
+      i++;
+    }
+    i++;
+  }
+
+  if (i >= line.size()) {
+    return false;
+  }
+
+  *token = line.substr(start + 1, i - start - 1);
+  *pos = i + 1;
+  return true;
+}
+
+double PerSecond(uint64_t count, common::time64_t elapsed_msec) {
+  if (elapsed_msec <= 0) {
+    return 0;
+  }
+
+  return static_cast<double>(count) * 1000 / elapsed_msec;
+}
+
+std::string TopSection(const std::string& label,
+                       const TopCounter& counter,
+                       common::time64_t elapsed_msec,
+                       bool with_rate) {
+  std::string result = label + "\n";
+  std::vector<TopCounter::item_t> top = counter.Top(STREAM_TOP_REPORT_SIZE);
+  for (size_t i = 0; i < top.size(); ++i) {
+    if (with_rate) {
+      result += common::MemSPrintf("%s: %llu (%.2f/s)\n", top[i].first,
+                                   static_cast<unsigned long long>(top[i].second),
+                                   PerSecond(top[i].second, elapsed_msec));
+    } else {
+      result += common::MemSPrintf("%s: %llu\n", top[i].first,
+                                   static_cast<unsigned long long>(top[i].second));
+    }
+  }
+  return result;
+}
+
+std::string RingSection(const EventRing& ring, common::time64_t elapsed_msec) {
+  std::string result = common::MemSPrintf(
+      "events: %llu (%.2f/s), not shown: %llu\n", static_cast<unsigned long long>(ring.TotalCount()),
+      PerSecond(ring.TotalCount(), elapsed_msec),
+      static_cast<unsigned long long>(ring.DroppedCount()));
+  return result;
+}
+
+std::string LastEventsSection(const EventRing& ring) {
+  std::string result = "# Last events\n";
+  std::vector<std::string> events = ring.Events();
+  for (size_t i = 0; i < events.size(); ++i) {
+    result += events[i];
+    result += "\n";
+  }
+  return result;
+}
+
+}  // namespace
+
+EventRing::EventRing(size_t capacity)
+    : capacity_(capacity), events_(), head_(0), total_(0), dropped_(0) {
+  events_.reserve(capacity);
+}
+
+void EventRing::Push(const std::string& event) {
+  total_++;
+  if (events_.size() < capacity_) {
+    events_.push_back(event);
+    return;
+  }
+
+  if (events_.empty()) {
+    dropped_++;
+    return;
+  }
+
+  events_[head_] = event;
+  head_ = (head_ + 1) % events_.size();
+  dropped_++;
+}
+
+std::vector<std::string> EventRing::Events() const {
+  std::vector<std::string> result;
+  result.reserve(events_.size());
+  for (size_t i = 0; i < events_.size(); ++i) {
+    result.push_back(events_[(head_ + i) % events_.size()]);
+  }
+  return result;
+}
+
+uint64_t EventRing::TotalCount() const {
+  return total_;
+}
+
+uint64_t EventRing::DroppedCount() const {
+  return dropped_;
+}
+
+TopCounter::TopCounter(size_t capacity) : capacity_(capacity), counts_(), order_() {}
+
+void TopCounter::Add(const std::string& item) {
+  auto it = counts_.find(item);
+  if (it != counts_.end()) {
+    order_.erase(std::make_pair(it->second, item));
+    it->second++;
+    order_.insert(std::make_pair(it->second, item));
+    return;
+  }
+
+  uint64_t count = 1;
+  if (counts_.size() >= capacity_) {
+    if (order_.empty()) {
+      return;
+    }
+    auto min = order_.begin();
+    count = min->first + 1;
+    counts_.erase(min->second);
+    order_.erase(min);
+  }
+
+  counts_[item] = count;
+  order_.insert(std::make_pair(count, item));
+}
+
+std::vector<TopCounter::item_t> TopCounter::Top(size_t count) const {
+  std::vector<item_t> result;
+  for (auto it = order_.rbegin(); it != order_.rend() && result.size() < count; ++it) {
+    result.push_back(std::make_pair(it->second, it->first));
+  }
+  return result;
+}
+
+MonitorAggregator::MonitorAggregator(const std::string& ns_separator,
+                                     common::time64_t start_msec)
+    : ns_separator_(ns_separator),
+      start_msec_(start_msec),
+      commands_(STREAM_TOP_CAPACITY),
+      keys_(STREAM_TOP_CAPACITY),
+      prefixes_(STREAM_TOP_CAPACITY),
+      clients_(STREAM_TOP_CAPACITY) {}
+
+void MonitorAggregator::AddLine(const std::string& line) {
+  size_t open = line.find('[');
+  size_t close = line.find(']', open);
+  if (open == std::string::npos || close == std::string::npos) {
+    return;
+  }
+
+  size_t client_start = line.find(' ', open);  // skip db number
+  if (client_start != std::string::npos && client_start < close) {
+    clients_.Add(line.substr(client_start + 1, close - client_start - 1));
+  }
+
+  size_t pos = close;
+  std::string command;
+  if (!ReadQuoted(line, &pos, &command)) {
+    return;
+  }
+
+  for (size_t i = 0; i < command.size(); ++i) {
+    command[i] = toupper(command[i]);
+  }
+  commands_.Add(command);
+
+  std::string key;
+  if (!ReadQuoted(line, &pos, &key)) {
+    return;
+  }
+
+  keys_.Add(key);
+  if (ns_separator_.empty()) {
+    return;
+  }
+
+  size_t ns_pos = key.find(ns_separator_);
+  if (ns_pos != std::string::npos) {
+    prefixes_.Add(key.substr(0, ns_pos));
+  }
+}
+
+std::string MonitorAggregator::Report(const EventRing& ring, common::time64_t now_msec) const {
+  common::time64_t elapsed = now_msec - start_msec_;
+  return RingSection(ring, elapsed) + TopSection("# Commands", commands_, elapsed, true) +
+         TopSection("# Keys", keys_, elapsed, false) +
+         TopSection("# Prefixes", prefixes_, elapsed, false) +
+         TopSection("# Clients", clients_, elapsed, true) + LastEventsSection(ring);
+}
+
+SubscribeAggregator::SubscribeAggregator(common::time64_t start_msec)
+    : start_msec_(start_msec), channels_(STREAM_TOP_CAPACITY) {}
+
+void SubscribeAggregator::AddMessage(const std::string& channel) {
+  channels_.Add(channel);
+}
+
+std::string SubscribeAggregator::Report(const EventRing& ring, common::time64_t now_msec) const {
+  common::time64_t elapsed = now_msec - start_msec_;
+  return RingSection(ring, elapsed) + TopSection("# Channels", channels_, elapsed, true) +
+         LastEventsSection(ring);
+}
+
+}  // namespace redis
+}  // namespace core
+}  // namespace fastonosql
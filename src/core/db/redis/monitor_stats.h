@@ -0,0 +1,110 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint64_t
+
+#include <map>      // for map
+#include <set>      // for set
+#include <string>   // for string
+#include <utility>  // for pair
+#include <vector>   // for vector
+
+#include <common/types.h>  // for time64_t
+
+#define STREAM_RING_CAPACITY 1000           // last MONITOR/SUBSCRIBE events kept for output
+#define STREAM_SNAPSHOT_INTERVAL_MSEC 1000  // time between output updates, quiet or not
+#define STREAM_TOP_CAPACITY 1024            // tracked items per top counter
+#define STREAM_TOP_REPORT_SIZE 10
+
+namespace fastonosql {
+namespace core {
+namespace redis {
+
+// keeps last capacity events, older ones are overwritten and counted as dropped
+class EventRing {
+ public:
+  explicit EventRing(size_t capacity);
+
+  void Push(const std::string& event);
+  std::vector<std::string> Events() const;  // oldest first
+
+  uint64_t TotalCount() const;
+  uint64_t DroppedCount() const;
+
+ private:
+  const size_t capacity_;
+  std::vector<std::string> events_;
+  size_t head_;  // oldest event once ring is full
+  uint64_t total_;
+  uint64_t dropped_;
+};
+
+// space-saving heavy hitters: at most capacity items tracked, a new item
+// replaces the least counted one and inherits its count (upper bound estimate)
+class TopCounter {
+ public:
+  typedef std::pair<std::string, uint64_t> item_t;
+
+  explicit TopCounter(size_t capacity);
+
+  void Add(const std::string& item);
+  std::vector<item_t> Top(size_t count) const;  // most counted first
+
+ private:
+  const size_t capacity_;
+  std::map<std::string, uint64_t> counts_;
+  std::set<std::pair<uint64_t, std::string> > order_;
+};
+
+// streaming statistics over MONITOR lines:
+// 1339518083.107412 [0 127.0.0.1:60866] "set" "user:1:name" "value"
+class MonitorAggregator {
+ public:
+  MonitorAggregator(const std::string& ns_separator, common::time64_t start_msec);
+
+  void AddLine(const std::string& line);
+  std::string Report(const EventRing& ring, common::time64_t now_msec) const;
+
+ private:
+  const std::string ns_separator_;
+  const common::time64_t start_msec_;
+  TopCounter commands_;
+  TopCounter keys_;
+  TopCounter prefixes_;
+  TopCounter clients_;
+};
+
+// per channel statistics over SUBSCRIBE/PSUBSCRIBE messages
+class SubscribeAggregator {
+ public:
+  explicit SubscribeAggregator(common::time64_t start_msec);
+
+  void AddMessage(const std::string& channel);
+  std::string Report(const EventRing& ring, common::time64_t now_msec) const;
+
+ private:
+  const common::time64_t start_msec_;
+  TopCounter channels_;
+};
+
+}  // namespace redis
+}  // namespace core
+}  // namespace fastonosql
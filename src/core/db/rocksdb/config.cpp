@@ -53,6 +53,8 @@ Config parseOptions(int argc, char** argv) {
       cfg.dbname = argv[++i];
     } else if (!strcmp(argv[i], "-c")) {
       cfg.create_if_missing = true;
+    } else if (!strcmp(argv[i], "-s")) {
+      cfg.enable_statistics = true;
     } else {
       if (argv[i][0] == '-') {
         const std::string buff = common::MemSPrintf(
@@ -73,7 +75,9 @@ Config parseOptions(int argc, char** argv) {
 }  // namespace
 
 Config::Config()
-    : LocalConfig(common::file_system::prepare_path("~/test.rocksdb")), create_if_missing(false) {}
+    : LocalConfig(common::file_system::prepare_path("~/test.rocksdb")),
+      create_if_missing(false),
+      enable_statistics(false) {}
 
 }  // namespace rocksdb
 }  // namespace core
@@ -88,6 +92,10 @@ std::string ConvertToString(const fastonosql::core::rocksdb::Config& conf) {
     argv.push_back("-c");
   }
 
+  if (conf.enable_statistics) {
+    argv.push_back("-s");
+  }
+
   return fastonosql::core::ConvertToStringConfigArgs(argv);
 }
 
@@ -20,17 +20,19 @@
 
 #include <string.h>  // for strtok
 
+#include <map>     // for map
 #include <memory>  // for __shared_ptr
 #include <string>  // for string, operator<, etc
 #include <vector>  // for vector
 
 #include <rocksdb/db.h>
+#include <rocksdb/statistics.h>
 
 #include <common/file_system.h>     // for is_directory
-#include <common/string_util.h>     // for MatchPattern
 #include <common/types.h>           // for tribool, tribool::SUCCESS
 #include <common/convert2string.h>  // for ConvertFromString
 #include <common/sprintf.h>         // for MemSPrintf
+#include <common/time.h>            // for current_mstime
 #include <common/value.h>           // for Value::ErrorsType::E_ERROR, etc
 
 #include "core/command_holder.h"       // for CommandHolder
@@ -42,6 +44,11 @@
 #include "core/db/rocksdb/command_translator.h"
 #include "core/db/rocksdb/internal/commands_api.h"
 
+#include "core/global.h"       // for FastoObject, etc
+#include "core/key_pattern.h"  // for KeyPattern
+#include "core/key_ranges.h"   // for ParallelScanKeys, MakeCompactBounds
+#include "core/key_sampler.h"  // for KeySampler, SampleKeyRanges
+
 #define ROCKSDB_HEADER_STATS                               \
   "\n** Compaction Stats [default] **\n"                   \
   "Level    Files   Size(MB) Score Read(GB)  Rn(GB) "      \
@@ -55,6 +62,51 @@
   "-----"                                                  \
   "--------------------------------------\n"
 
+#define MB_BYTES (1024 * 1024)
+
+namespace {
+
+uint64_t GetIntPropertyOrZero(::rocksdb::DB* db, const ::rocksdb::Slice& property) {
+  uint64_t value = 0;
+  if (!db->GetIntProperty(property, &value)) {
+    return 0;
+  }
+
+  return value;
+}
+
+uint32_t GetMbPropertyOrZero(::rocksdb::DB* db, const ::rocksdb::Slice& property) {
+  return GetIntPropertyOrZero(db, property) / MB_BYTES;
+}
+
+// engine types for range scan templates of core/key_ranges.h
+struct KeyRangeTraits {
+  typedef ::rocksdb::DB db_t;
+  typedef ::rocksdb::Snapshot snapshot_t;
+  typedef ::rocksdb::Range range_t;
+  typedef ::rocksdb::ReadOptions read_options_t;
+  typedef ::rocksdb::Iterator iterator_t;
+  typedef ::rocksdb::Slice slice_t;
+  typedef ::rocksdb::Status status_t;
+
+  static void SetUpperBound(read_options_t* ro, const slice_t* upper_bound) {
+    ro->iterate_upper_bound = upper_bound;
+  }
+
+  static status_t CompactRange(db_t* db, const slice_t* begin, const slice_t* end) {
+    ::rocksdb::CompactRangeOptions co;
+    co.exclusive_manual_compaction = false;  // automatic compactions keep running
+    return db->CompactRange(co, begin, end);
+  }
+
+  static uint64_t StoredBytes(db_t* db, const std::vector<std::string>& bounds) {
+    UNUSED(bounds);
+    return GetIntPropertyOrZero(db, ::rocksdb::DB::Properties::kTotalSstFilesSize);
+  }
+};
+
+}  // namespace
+
 namespace fastonosql {
 namespace core {
 namespace internal {
@@ -123,6 +175,9 @@ common::Error CreateConnection(const Config& config, NativeConnection** context)
 
   ::rocksdb::Options rs;
   rs.create_if_missing = config.create_if_missing;
+  if (config.enable_statistics) {
+    rs.statistics = ::rocksdb::CreateDBStatistics();
+  }
   auto st = ::rocksdb::DB::Open(rs, folder, &lcontext);
   if (!st.ok()) {
     std::string buff = common::MemSPrintf("Fail open database: %s!", st.ToString());
@@ -144,12 +199,61 @@ common::Error TestConnection(const Config& config) {
   return common::Error();
 }
 
+DBConnection::ScanSession::ScanSession()
+    : snapshot(nullptr),
+      it(nullptr),
+      upper_bound_key(),
+      upper_bound(nullptr),
+      pattern(),
+      cursor(0),
+      last_access_msec(0) {}
+
 DBConnection::DBConnection(CDBConnectionClient* client)
-    : base_class(client, new CommandTranslator(base_class::Commands())) {}
+    : base_class(client, new CommandTranslator(base_class::Commands())), scan_session_() {}
+
+DBConnection::~DBConnection() {
+  compact_job_.Cancel();
+  compact_job_.Wait();
+  ReleaseScanSession();
+}
+
+common::Error DBConnection::Disconnect() {
+  compact_job_.Cancel();
+  compact_job_.Wait();
+  ReleaseScanSession();
+  return base_class::Disconnect();
+}
+
+void DBConnection::ExpireScanSession() {
+  if (!scan_session_.snapshot) {
+    return;
+  }
+
+  common::time64_t idle = common::time::current_mstime() - scan_session_.last_access_msec;
+  if (idle > SCAN_SESSION_TIMEOUT_MSEC) {
+    ReleaseScanSession();
+  }
+}
+
+void DBConnection::ReleaseScanSession() {
+  delete scan_session_.it;
+  scan_session_.it = nullptr;
+  delete scan_session_.upper_bound;  // must outlive iterator
+  scan_session_.upper_bound = nullptr;
+  scan_session_.upper_bound_key.clear();
+  if (scan_session_.snapshot) {
+    DCHECK(connection_.handle_);
+    connection_.handle_->ReleaseSnapshot(scan_session_.snapshot);
+    scan_session_.snapshot = nullptr;
+  }
+  scan_session_.pattern.clear();
+  scan_session_.cursor = 0;
+  scan_session_.last_access_msec = 0;
+}
 
-common::Error DBConnection::Info(const char* args, ServerInfo::Stats* statsout) {
+common::Error DBConnection::Info(const char* args, ServerInfo* info) {
   UNUSED(args);
-  if (!statsout) {
+  if (!info) {
     DNOTREACHED();
     return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
   }
@@ -158,8 +262,9 @@ common::Error DBConnection::Info(const char* args, ServerInfo::Stats* statsout)
     return common::make_error_value("Not connected", common::Value::E_ERROR);
   }
 
+  ::rocksdb::DB* db = connection_.handle_;
   std::string rets;
-  bool isok = connection_.handle_->GetProperty("rocksdb.stats", &rets);
+  bool isok = db->GetProperty("rocksdb.stats", &rets);
   if (!isok) {
     return common::make_error_value("info function failed", common::ErrorValue::E_ERROR);
   }
@@ -193,7 +298,84 @@ common::Error DBConnection::Info(const char* args, ServerInfo::Stats* statsout)
     }
   }
 
-  *statsout = lstatsout;
+  ServerInfo::Levels llevels;
+  std::map<std::string, std::string> cfstats;
+  bool have_cfstats = db->GetMapProperty(::rocksdb::DB::Properties::kCFStats, &cfstats);
+  for (size_t i = 0; i < ROCKSDB_LEVELS_COUNT; ++i) {
+    std::string level = common::ConvertToString(i);
+    std::string files;
+    if (db->GetProperty(::rocksdb::DB::Properties::kNumFilesAtLevelPrefix + level, &files)) {
+      llevels.files_at_level[i] = common::ConvertFromString<uint32_t>(files);
+    }
+
+    if (have_cfstats) {
+      auto it = cfstats.find("compaction.L" + level + ".SizeBytes");
+      if (it != cfstats.end()) {
+        llevels.size_mb_at_level[i] = common::ConvertFromString<uint64_t>(it->second) / MB_BYTES;
+      }
+    }
+  }
+
+  ServerInfo::Compaction lcompaction;
+  lcompaction.pending_compaction_mb =
+      GetMbPropertyOrZero(db, ::rocksdb::DB::Properties::kEstimatePendingCompactionBytes);
+  lcompaction.running_compactions =
+      GetIntPropertyOrZero(db, ::rocksdb::DB::Properties::kNumRunningCompactions);
+  lcompaction.running_flushes =
+      GetIntPropertyOrZero(db, ::rocksdb::DB::Properties::kNumRunningFlushes);
+  lcompaction.is_write_stopped =
+      GetIntPropertyOrZero(db, ::rocksdb::DB::Properties::kIsWriteStopped);
+  lcompaction.delayed_write_rate =
+      GetIntPropertyOrZero(db, ::rocksdb::DB::Properties::kActualDelayedWriteRate);
+
+  ServerInfo::Memtables lmemtables;
+  lmemtables.active_mem_table_mb =
+      GetMbPropertyOrZero(db, ::rocksdb::DB::Properties::kCurSizeActiveMemTable);
+  lmemtables.all_mem_tables_mb =
+      GetMbPropertyOrZero(db, ::rocksdb::DB::Properties::kCurSizeAllMemTables);
+  lmemtables.pinned_mem_tables_mb =
+      GetMbPropertyOrZero(db, ::rocksdb::DB::Properties::kSizeAllMemTables);
+  lmemtables.immutable_mem_tables =
+      GetIntPropertyOrZero(db, ::rocksdb::DB::Properties::kNumImmutableMemTable);
+
+  ServerInfo::Cache lcache;
+  lcache.block_cache_usage_mb =
+      GetMbPropertyOrZero(db, ::rocksdb::DB::Properties::kBlockCacheUsage);
+  std::shared_ptr< ::rocksdb::Statistics> statistics = db->GetDBOptions().statistics;
+  if (statistics) {
+    uint64_t hit = statistics->getTickerCount(::rocksdb::BLOCK_CACHE_HIT);
+    uint64_t miss = statistics->getTickerCount(::rocksdb::BLOCK_CACHE_MISS);
+    lcache.block_cache_hit = hit;
+    lcache.block_cache_miss = miss;
+    lcache.block_cache_hit_ratio = hit + miss ? static_cast<double>(hit) / (hit + miss) : 0;
+    lcache.bloom_filter_useful = statistics->getTickerCount(::rocksdb::BLOOM_FILTER_USEFUL);
+    lcompaction.stall_micros = statistics->getTickerCount(::rocksdb::STALL_MICROS);
+
+    ::rocksdb::HistogramData get_hist;
+    statistics->histogramData(::rocksdb::DB_GET, &get_hist);
+    lcache.get_p50_micros = get_hist.median;
+    lcache.get_p99_micros = get_hist.percentile99;
+
+    ::rocksdb::HistogramData write_hist;
+    statistics->histogramData(::rocksdb::DB_WRITE, &write_hist);
+    lcache.write_p50_micros = write_hist.median;
+    lcache.write_p99_micros = write_hist.percentile99;
+  }
+
+  ServerInfo::Storage lstorage;
+  lstorage.live_sst_mb = GetMbPropertyOrZero(db, ::rocksdb::DB::Properties::kLiveSstFilesSize);
+  lstorage.total_sst_mb = GetMbPropertyOrZero(db, ::rocksdb::DB::Properties::kTotalSstFilesSize);
+  lstorage.estimate_num_keys =
+      GetIntPropertyOrZero(db, ::rocksdb::DB::Properties::kEstimateNumKeys);
+  lstorage.estimate_live_data_mb =
+      GetMbPropertyOrZero(db, ::rocksdb::DB::Properties::kEstimateLiveDataSize);
+
+  info->stats_ = lstatsout;
+  info->levels_ = llevels;
+  info->compaction_ = lcompaction;
+  info->memtables_ = lmemtables;
+  info->cache_ = lcache;
+  info->storage_ = lstorage;
   return common::Error();
 }
 
@@ -258,6 +440,87 @@ common::Error DBConnection::Merge(const std::string& key, const std::string& val
   return common::Error();
 }
 
+common::Error DBConnection::Compact(const std::string& start,
+                                    const std::string& end,
+                                    FastoObject* out) {
+  if (!out) {
+    DNOTREACHED();
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  if (!IsConnected()) {
+    return common::make_error_value("Not connected", common::Value::E_ERROR);
+  }
+
+  std::vector<std::string> bounds;
+  common::Error err = MakeCompactBounds(start, end, &bounds);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  // db handle is thread safe, Disconnect cancels and waits for the job before closing it
+  ::rocksdb::DB* db = connection_.handle_;
+  auto compact = [db, bounds](BackgroundJob* job, std::string* summary) -> common::Error {
+    uint64_t reclaimed = 0;
+    common::Error cerr = CompactKeyRanges<KeyRangeTraits>(
+        db, bounds, [job]() { return job->IsCancelled(); },
+        [job](int percent) { job->NotifyProgress(percent); }, &reclaimed);
+    if (cerr && cerr->isError()) {
+      return cerr;
+    }
+
+    *summary = common::MemSPrintf("reclaimed %" PRIu64 " bytes", reclaimed);
+    return common::Error();
+  };
+  err = compact_job_.Start("COMPACT", compact, Client());
+  if (err && err->isError()) {
+    return err;
+  }
+
+  common::StringValue* val =
+      common::Value::createStringValue("OK, compaction started in background, stop cancels it");
+  FastoObject* child = new FastoObject(out, val, Delimiter());
+  out->AddChildren(child);
+  return common::Error();
+}
+
+void DBConnection::CancelCompact() {
+  compact_job_.Cancel();
+}
+
+common::Error DBConnection::Sample(size_t sample_size, uint32_t msec, FastoObject* out) {
+  if (!out) {
+    DNOTREACHED();
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  if (!IsConnected()) {
+    return common::make_error_value("Not connected", common::Value::E_ERROR);
+  }
+
+  // equal data size parts, each read in turn within the time budget
+  ::rocksdb::DB* db = connection_.handle_;
+  const ::rocksdb::Snapshot* snapshot = db->GetSnapshot();
+  const std::vector<KeyRange> ranges =
+      SplitKeyRange(KeyRange(), KEY_SAMPLER_RANGES, MakeKeyRangeSizes<KeyRangeTraits>(db));
+  KeySampler sampler(sample_size, NsSeparator(), msec, common::time::current_mstime());
+  bool complete = false;
+  common::Error err = SampleKeyRanges<KeyRangeTraits>(
+      db, snapshot, ranges, [this]() { return IsInterrupted(); }, &sampler, &complete);
+  db->ReleaseSnapshot(snapshot);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  std::vector<std::string> lines = sampler.Report(complete);
+  for (size_t i = 0; i < lines.size(); ++i) {
+    common::StringValue* val = common::Value::createStringValue(lines[i]);
+    FastoObject* child = new FastoObject(out, val, Delimiter());
+    out->AddChildren(child);
+  }
+  return common::Error();
+}
+
 common::Error DBConnection::SetInner(const std::string& key, const std::string& value) {
   if (!IsConnected()) {
     return common::make_error_value("Not connected", common::Value::E_ERROR);
@@ -298,36 +561,115 @@ common::Error DBConnection::ScanImpl(uint64_t cursor_in,
                                      uint64_t count_keys,
                                      std::vector<std::string>* keys_out,
                                      uint64_t* cursor_out) {
-  ::rocksdb::ReadOptions ro;
-  ::rocksdb::Iterator* it =
-      connection_.handle_->NewIterator(ro);  // keys(key_start, key_end, limit, ret);
-  uint64_t offset_pos = cursor_in;
+  ExpireScanSession();
+  KeyPattern kpattern(pattern);
+  if (cursor_in == 0 && count_keys >= KEY_RANGES_MIN_SCAN_COUNT) {
+    return ParallelScan(kpattern, count_keys, keys_out, cursor_out);
+  }
+
+  uint64_t offset_pos = 0;
+  if (!scan_session_.it || cursor_in == 0 || scan_session_.cursor != cursor_in ||
+      scan_session_.pattern != pattern) {
+    // new browse or unknown cursor: pin fresh snapshot, skip cursor_in matched keys
+    ReleaseScanSession();
+    scan_session_.snapshot = connection_.handle_->GetSnapshot();
+    ::rocksdb::ReadOptions ro;
+    ro.snapshot = scan_session_.snapshot;
+    ro.fill_cache = false;
+    scan_session_.upper_bound_key = kpattern.PrefixUpperBound();
+    if (!scan_session_.upper_bound_key.empty()) {
+      // lets sst readers stop at prefix range end instead of reading next blocks
+      scan_session_.upper_bound = new ::rocksdb::Slice(scan_session_.upper_bound_key);
+      ro.iterate_upper_bound = scan_session_.upper_bound;
+    }
+    scan_session_.it = connection_.handle_->NewIterator(ro);
+    scan_session_.it->Seek(kpattern.Prefix());
+    scan_session_.pattern = pattern;
+    offset_pos = cursor_in;
+  }
+
+  ::rocksdb::Iterator* it = scan_session_.it;
   uint64_t lcursor_out = 0;
   std::vector<std::string> lkeys_out;
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    std::string key = it->key().ToString();
-    if (lkeys_out.size() < count_keys) {
-      if (common::MatchPattern(key, pattern)) {
-        if (offset_pos == 0) {
-          lkeys_out.push_back(key);
-        } else {
-          offset_pos--;
-        }
+  for (; it->Valid(); it->Next()) {
+    ::rocksdb::Slice key = it->key();
+    if (!kpattern.HasPrefix(key.data(), key.size())) {
+      break;  // keys are ordered, rest of db is out of prefix range
+    }
+
+    if (kpattern.Match(key.data(), key.size())) {
+      if (offset_pos != 0) {
+        offset_pos--;
+      } else if (lkeys_out.size() >= count_keys) {
+        // next page starts at this key, cursor stays 0 if no match is left
+        lcursor_out = cursor_in + count_keys;
+        break;
+      } else {
+        lkeys_out.push_back(key.ToString());
       }
-    } else {
-      lcursor_out = cursor_in + count_keys;
-      break;
     }
   }
 
   auto st = it->status();
-  delete it;
-
   if (!st.ok()) {
+    ReleaseScanSession();
     std::string buff = common::MemSPrintf("Keys function error: %s", st.ToString());
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
+  if (lcursor_out == 0) {
+    ReleaseScanSession();
+  } else {
+    scan_session_.cursor = lcursor_out;
+    scan_session_.last_access_msec = common::time::current_mstime();
+  }
+
+  *keys_out = lkeys_out;
+  *cursor_out = lcursor_out;
+  return common::Error();
+}
+
+common::Error DBConnection::ParallelScan(const KeyPattern& kpattern,
+                                         uint64_t count_keys,
+                                         std::vector<std::string>* keys_out,
+                                         uint64_t* cursor_out) {
+  ReleaseScanSession();
+  ::rocksdb::DB* db = connection_.handle_;
+  const ::rocksdb::Snapshot* snapshot = db->GetSnapshot();
+  std::vector<std::string> lkeys_out;
+  common::Error err = ParallelScanKeys<KeyRangeTraits>(
+      db, snapshot, kpattern, count_keys + 1, [this]() { return IsInterrupted(); }, &lkeys_out);
+  if (err && err->isError()) {
+    db->ReleaseSnapshot(snapshot);
+    return err;
+  }
+
+  // one key past the page tells whether anything is left for the next one
+  uint64_t lcursor_out = 0;
+  if (lkeys_out.size() <= count_keys) {
+    db->ReleaseSnapshot(snapshot);
+  } else {
+    // next pages continue serially right after the last returned key
+    lkeys_out.pop_back();
+    ::rocksdb::ReadOptions ro;
+    ro.snapshot = snapshot;
+    ro.fill_cache = false;
+    scan_session_.snapshot = snapshot;
+    scan_session_.upper_bound_key = kpattern.PrefixUpperBound();
+    if (!scan_session_.upper_bound_key.empty()) {
+      scan_session_.upper_bound = new ::rocksdb::Slice(scan_session_.upper_bound_key);
+      ro.iterate_upper_bound = scan_session_.upper_bound;
+    }
+    scan_session_.it = db->NewIterator(ro);
+    scan_session_.it->Seek(lkeys_out.back());
+    if (scan_session_.it->Valid() && scan_session_.it->key() == lkeys_out.back()) {
+      scan_session_.it->Next();
+    }
+    scan_session_.pattern = kpattern.Pattern();
+    scan_session_.cursor = lcursor_out = count_keys;
+    scan_session_.last_access_msec = common::time::current_mstime();
+  }
+
   *keys_out = lkeys_out;
   *cursor_out = lcursor_out;
   return common::Error();
@@ -362,26 +704,16 @@ common::Error DBConnection::KeysImpl(const std::string& key_start,
 }
 
 common::Error DBConnection::DBkcountImpl(size_t* size) {
-  ::rocksdb::ReadOptions ro;
-  ::rocksdb::Iterator* it = connection_.handle_->NewIterator(ro);
-  size_t sz = 0;
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    sz++;
-  }
-
-  auto st = it->status();
-  delete it;
-
-  if (!st.ok()) {
-    std::string buff = common::MemSPrintf("Couldn't determine DBKCOUNT error: %s", st.ToString());
-    return common::make_error_value(buff, common::ErrorValue::E_ERROR);
-  }
-
-  *size = sz;
-  return common::Error();
+  ::rocksdb::DB* db = connection_.handle_;
+  const ::rocksdb::Snapshot* snapshot = db->GetSnapshot();  // same version for all workers
+  common::Error err = ParallelCountKeys<KeyRangeTraits>(
+      db, snapshot, [this]() { return IsInterrupted(); }, size);
+  db->ReleaseSnapshot(snapshot);
+  return err;
 }
 
 common::Error DBConnection::FlushDBImpl() {
+  ReleaseScanSession();
   ::rocksdb::ReadOptions ro;
   ::rocksdb::WriteOptions wo;
   ::rocksdb::Iterator* it = connection_.handle_->NewIterator(ro);
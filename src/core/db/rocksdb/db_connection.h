@@ -26,7 +26,9 @@
 
 #include <common/error.h>   // for Error
 #include <common/macros.h>  // for WARN_UNUSED_RESULT
+#include <common/types.h>   // for time64_t
 
+#include "core/background_job.h"  // for BackgroundJob
 #include "core/internal/cdb_connection.h"
 
 #include "core/connection_types.h"  // for connectionTypes::ROCKSDB
@@ -35,8 +37,16 @@
 #include "core/db/rocksdb/config.h"
 #include "core/db/rocksdb/server_info.h"
 
+namespace fastonosql {
+namespace core {
+class KeyPattern;
+}
+}
 namespace rocksdb {
 class DB;
+class Iterator;
+class Slice;
+class Snapshot;
 }
 
 namespace fastonosql {
@@ -52,12 +62,24 @@ class DBConnection : public core::internal::CDBConnection<NativeConnection, Conf
  public:
   typedef core::internal::CDBConnection<NativeConnection, Config, ROCKSDB> base_class;
   explicit DBConnection(CDBConnectionClient* client);
+  virtual ~DBConnection();
+
+  // stops background COMPACT, releases scan session before db handle
+  common::Error Disconnect() WARN_UNUSED_RESULT;
+  void ExpireScanSession();  // releases scan session idle more than SCAN_SESSION_TIMEOUT_MSEC
 
   std::string CurrentDBName() const;
 
-  common::Error Info(const char* args, ServerInfo::Stats* statsout) WARN_UNUSED_RESULT;
+  common::Error Info(const char* args, ServerInfo* info) WARN_UNUSED_RESULT;
   common::Error Mget(const std::vector<std::string>& keys, std::vector<std::string>* ret);
   common::Error Merge(const std::string& key, const std::string& value) WARN_UNUSED_RESULT;
+  common::Error Compact(const std::string& start,
+                        const std::string& end,
+                        FastoObject* out) WARN_UNUSED_RESULT;  // starts background job
+  void CancelCompact();  // any thread, background COMPACT stops at its next step
+  common::Error Sample(size_t sample_size,
+                       uint32_t msec,
+                       FastoObject* out) WARN_UNUSED_RESULT;  // interruptible
 
  private:
   common::Error SetInner(const std::string& key, const std::string& value) WARN_UNUSED_RESULT;
@@ -83,6 +105,30 @@ class DBConnection : public core::internal::CDBConnection<NativeConnection, Conf
   virtual common::Error SetTTLImpl(const NKey& key, ttl_t ttl) override;
   virtual common::Error GetTTLImpl(const NKey& key, ttl_t* ttl) override;
   virtual common::Error QuitImpl() override;
+
+  // first SCAN page of at least KEY_RANGES_MIN_SCAN_COUNT keys, key ranges are matched
+  // on all cores and the scan session continues after the last returned key
+  common::Error ParallelScan(const KeyPattern& kpattern,
+                             uint64_t count_keys,
+                             std::vector<std::string>* keys_out,
+                             uint64_t* cursor_out) WARN_UNUSED_RESULT;
+  void ReleaseScanSession();
+
+  // SCAN pages continue one iterator over a pinned snapshot, other commands
+  // read the live db so own writes are visible to them
+  struct ScanSession {
+    ScanSession();
+
+    const ::rocksdb::Snapshot* snapshot;
+    ::rocksdb::Iterator* it;
+    std::string upper_bound_key;  // iterate_upper_bound of it, end of pattern prefix range
+    ::rocksdb::Slice* upper_bound;
+    std::string pattern;
+    uint64_t cursor;  // cursor which continues this session
+    common::time64_t last_access_msec;
+  } scan_session_;
+
+  BackgroundJob compact_job_;
 };
 
 }  // namespace rocksdb
@@ -28,7 +28,8 @@
 #include "core/db/rocksdb/db_connection.h"
 #include "core/db/rocksdb/server_info.h"  // for ServerInfo, etc
 
-#include "core/global.h"  // for FastoObject, etc
+#include "core/global.h"       // for FastoObject, etc
+#include "core/key_sampler.h"  // for ParseSampleArgs
 
 namespace fastonosql {
 namespace core {
@@ -39,13 +40,13 @@ common::Error CommandsApi::Info(internal::CommandHandler* handler,
                                 const char** argv,
                                 FastoObject* out) {
   DBConnection* rocks = static_cast<DBConnection*>(handler);
-  ServerInfo::Stats statsout;
-  common::Error err = rocks->Info(argc == 1 ? argv[0] : nullptr, &statsout);
+  ServerInfo info;
+  common::Error err = rocks->Info(argc == 1 ? argv[0] : nullptr, &info);
   if (err && err->isError()) {
     return err;
   }
 
-  common::StringValue* val = common::Value::createStringValue(ServerInfo(statsout).ToString());
+  common::StringValue* val = common::Value::createStringValue(info.ToString());
   FastoObject* child = new FastoObject(out, val, rocks->Delimiter());
   out->AddChildren(child);
   return common::Error();
@@ -95,6 +96,31 @@ common::Error CommandsApi::Merge(internal::CommandHandler* handler,
   return common::Error();
 }
 
+common::Error CommandsApi::Compact(internal::CommandHandler* handler,
+                                   int argc,
+                                   const char** argv,
+                                   FastoObject* out) {
+  DBConnection* rocks = static_cast<DBConnection*>(handler);
+  std::string start = argc >= 1 ? argv[0] : std::string();
+  std::string end = argc >= 2 ? argv[1] : std::string();
+  return rocks->Compact(start, end, out);
+}
+
+common::Error CommandsApi::Sample(internal::CommandHandler* handler,
+                                  int argc,
+                                  const char** argv,
+                                  FastoObject* out) {
+  DBConnection* rocks = static_cast<DBConnection*>(handler);
+  size_t sample_size = 0;
+  uint32_t msec = 0;
+  common::Error err = ParseSampleArgs(argc, argv, &sample_size, &msec);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  return rocks->Sample(sample_size, msec, out);
+}
+
 }  // namespace rocksdb
 }  // namespace core
 }  // namespace fastonosql
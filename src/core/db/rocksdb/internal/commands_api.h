@@ -63,6 +63,14 @@ struct CommandsApi : public internal::ApiTraits<DBConnection> {
                              int argc,
                              const char** argv,
                              FastoObject* out);
+  static common::Error Compact(internal::CommandHandler* handler,
+                               int argc,
+                               const char** argv,
+                               FastoObject* out);
+  static common::Error Sample(internal::CommandHandler* handler,
+                              int argc,
+                              const char** argv,
+                              FastoObject* out);
 };
 
 static const std::vector<CommandHolder> g_commands = {
@@ -165,6 +173,24 @@ static const std::vector<CommandHolder> g_commands = {
                   2,
                   0,
                   &CommandsApi::Merge),
+    CommandHolder("COMPACT",
+                  "[start] [end]",
+                  "Compact the underlying storage for the key range, "
+                  "report progress and reclaimed bytes",
+                  UNDEFINED_SINCE,
+                  UNDEFINED_EXAMPLE_STR,
+                  0,
+                  2,
+                  &CommandsApi::Compact),
+    CommandHolder("SAMPLE",
+                  "[sample_size] [msec]",
+                  "Sample key lengths, value sizes and types, namespaces "
+                  "and compressibility of the database within time budget",
+                  UNDEFINED_SINCE,
+                  UNDEFINED_EXAMPLE_STR,
+                  0,
+                  2,
+                  &CommandsApi::Sample),
     CommandHolder("DEL",
                   "<key> [key ...]",
                   "Delete key.",
@@ -45,6 +45,52 @@ const std::vector<Field> rockCommonFields = {
     Field(ROCKSDB_READ_MB_LABEL, common::Value::TYPE_UINTEGER),
     Field(ROCKSDB_WRITE_MB_LABEL, common::Value::TYPE_UINTEGER)};
 
+std::vector<Field> makeRockLevelsFields() {
+  std::vector<Field> fields;
+  for (size_t i = 0; i < ROCKSDB_LEVELS_COUNT; ++i) {
+    fields.push_back(Field(ROCKSDB_FILES_AT_LEVEL_LABEL + common::ConvertToString(i),
+                           common::Value::TYPE_UINTEGER));
+  }
+  for (size_t i = 0; i < ROCKSDB_LEVELS_COUNT; ++i) {
+    fields.push_back(Field(ROCKSDB_SIZE_MB_AT_LEVEL_LABEL + common::ConvertToString(i),
+                           common::Value::TYPE_UINTEGER));
+  }
+  return fields;
+}
+
+const std::vector<Field> rockLevelsFields = makeRockLevelsFields();
+
+const std::vector<Field> rockCompactionFields = {
+    Field(ROCKSDB_PENDING_COMPACTION_MB_LABEL, common::Value::TYPE_UINTEGER),
+    Field(ROCKSDB_RUNNING_COMPACTIONS_LABEL, common::Value::TYPE_UINTEGER),
+    Field(ROCKSDB_RUNNING_FLUSHES_LABEL, common::Value::TYPE_UINTEGER),
+    Field(ROCKSDB_IS_WRITE_STOPPED_LABEL, common::Value::TYPE_UINTEGER),
+    Field(ROCKSDB_DELAYED_WRITE_RATE_LABEL, common::Value::TYPE_UINTEGER),
+    Field(ROCKSDB_STALL_MICROS_LABEL, common::Value::TYPE_ULONG_LONG_INTEGER)};
+
+const std::vector<Field> rockMemtablesFields = {
+    Field(ROCKSDB_ACTIVE_MEM_TABLE_MB_LABEL, common::Value::TYPE_UINTEGER),
+    Field(ROCKSDB_ALL_MEM_TABLES_MB_LABEL, common::Value::TYPE_UINTEGER),
+    Field(ROCKSDB_PINNED_MEM_TABLES_MB_LABEL, common::Value::TYPE_UINTEGER),
+    Field(ROCKSDB_IMMUTABLE_MEM_TABLES_LABEL, common::Value::TYPE_UINTEGER)};
+
+const std::vector<Field> rockCacheFields = {
+    Field(ROCKSDB_BLOCK_CACHE_USAGE_MB_LABEL, common::Value::TYPE_UINTEGER),
+    Field(ROCKSDB_BLOCK_CACHE_HIT_LABEL, common::Value::TYPE_ULONG_LONG_INTEGER),
+    Field(ROCKSDB_BLOCK_CACHE_MISS_LABEL, common::Value::TYPE_ULONG_LONG_INTEGER),
+    Field(ROCKSDB_BLOCK_CACHE_HIT_RATIO_LABEL, common::Value::TYPE_DOUBLE),
+    Field(ROCKSDB_BLOOM_FILTER_USEFUL_LABEL, common::Value::TYPE_ULONG_LONG_INTEGER),
+    Field(ROCKSDB_GET_P50_MICROS_LABEL, common::Value::TYPE_DOUBLE),
+    Field(ROCKSDB_GET_P99_MICROS_LABEL, common::Value::TYPE_DOUBLE),
+    Field(ROCKSDB_WRITE_P50_MICROS_LABEL, common::Value::TYPE_DOUBLE),
+    Field(ROCKSDB_WRITE_P99_MICROS_LABEL, common::Value::TYPE_DOUBLE)};
+
+const std::vector<Field> rockStorageFields = {
+    Field(ROCKSDB_LIVE_SST_MB_LABEL, common::Value::TYPE_UINTEGER),
+    Field(ROCKSDB_TOTAL_SST_MB_LABEL, common::Value::TYPE_UINTEGER),
+    Field(ROCKSDB_ESTIMATE_NUM_KEYS_LABEL, common::Value::TYPE_ULONG_LONG_INTEGER),
+    Field(ROCKSDB_ESTIMATE_LIVE_DATA_MB_LABEL, common::Value::TYPE_UINTEGER)};
+
 }  // namespace
 
 template <>
@@ -55,7 +101,12 @@ std::vector<common::Value::Type> DBTraits<ROCKSDB>::SupportedTypes() {
 
 template <>
 std::vector<info_field_t> DBTraits<ROCKSDB>::InfoFields() {
-  return {std::make_pair(ROCKSDB_STATS_LABEL, rockCommonFields)};
+  return {std::make_pair(ROCKSDB_STATS_LABEL, rockCommonFields),
+          std::make_pair(ROCKSDB_LEVELS_LABEL, rockLevelsFields),
+          std::make_pair(ROCKSDB_COMPACTION_LABEL, rockCompactionFields),
+          std::make_pair(ROCKSDB_MEMTABLES_LABEL, rockMemtablesFields),
+          std::make_pair(ROCKSDB_CACHE_LABEL, rockCacheFields),
+          std::make_pair(ROCKSDB_STORAGE_LABEL, rockStorageFields)};
 }
 
 namespace rocksdb {
@@ -107,6 +158,266 @@ common::Value* ServerInfo::Stats::ValueByIndex(unsigned char index) const {
   return nullptr;
 }
 
+ServerInfo::Levels::Levels() {
+  for (size_t i = 0; i < ROCKSDB_LEVELS_COUNT; ++i) {
+    files_at_level[i] = 0;
+    size_mb_at_level[i] = 0;
+  }
+}
+
+ServerInfo::Levels::Levels(const std::string& levels_text) : Levels() {
+  static const std::string files_label = ROCKSDB_FILES_AT_LEVEL_LABEL;
+  static const std::string size_label = ROCKSDB_SIZE_MB_AT_LEVEL_LABEL;
+  size_t pos = 0;
+  size_t start = 0;
+
+  while ((pos = levels_text.find(MARKER, start)) != std::string::npos) {
+    std::string line = levels_text.substr(start, pos - start);
+    size_t delem = line.find_first_of(':');
+    std::string field = line.substr(0, delem);
+    std::string value = line.substr(delem + 1);
+    if (field.compare(0, files_label.size(), files_label) == 0) {
+      size_t level = common::ConvertFromString<size_t>(field.substr(files_label.size()));
+      if (level < ROCKSDB_LEVELS_COUNT) {
+        files_at_level[level] = common::ConvertFromString<uint32_t>(value);
+      }
+    } else if (field.compare(0, size_label.size(), size_label) == 0) {
+      size_t level = common::ConvertFromString<size_t>(field.substr(size_label.size()));
+      if (level < ROCKSDB_LEVELS_COUNT) {
+        size_mb_at_level[level] = common::ConvertFromString<uint32_t>(value);
+      }
+    }
+    start = pos + 2;
+  }
+}
+
+common::Value* ServerInfo::Levels::ValueByIndex(unsigned char index) const {
+  if (index < ROCKSDB_LEVELS_COUNT) {
+    return new common::FundamentalValue(files_at_level[index]);
+  } else if (index < ROCKSDB_LEVELS_COUNT * 2) {
+    return new common::FundamentalValue(size_mb_at_level[index - ROCKSDB_LEVELS_COUNT]);
+  }
+
+  NOTREACHED();
+  return nullptr;
+}
+
+ServerInfo::Compaction::Compaction()
+    : pending_compaction_mb(0),
+      running_compactions(0),
+      running_flushes(0),
+      is_write_stopped(0),
+      delayed_write_rate(0),
+      stall_micros(0) {}
+
+ServerInfo::Compaction::Compaction(const std::string& compaction_text) : Compaction() {
+  size_t pos = 0;
+  size_t start = 0;
+
+  while ((pos = compaction_text.find(MARKER, start)) != std::string::npos) {
+    std::string line = compaction_text.substr(start, pos - start);
+    size_t delem = line.find_first_of(':');
+    std::string field = line.substr(0, delem);
+    std::string value = line.substr(delem + 1);
+    if (field == ROCKSDB_PENDING_COMPACTION_MB_LABEL) {
+      pending_compaction_mb = common::ConvertFromString<uint32_t>(value);
+    } else if (field == ROCKSDB_RUNNING_COMPACTIONS_LABEL) {
+      running_compactions = common::ConvertFromString<uint32_t>(value);
+    } else if (field == ROCKSDB_RUNNING_FLUSHES_LABEL) {
+      running_flushes = common::ConvertFromString<uint32_t>(value);
+    } else if (field == ROCKSDB_IS_WRITE_STOPPED_LABEL) {
+      is_write_stopped = common::ConvertFromString<uint32_t>(value);
+    } else if (field == ROCKSDB_DELAYED_WRITE_RATE_LABEL) {
+      delayed_write_rate = common::ConvertFromString<uint32_t>(value);
+    } else if (field == ROCKSDB_STALL_MICROS_LABEL) {
+      stall_micros = common::ConvertFromString<uint64_t>(value);
+    }
+    start = pos + 2;
+  }
+}
+
+common::Value* ServerInfo::Compaction::ValueByIndex(unsigned char index) const {
+  switch (index) {
+    case 0:
+      return new common::FundamentalValue(pending_compaction_mb);
+    case 1:
+      return new common::FundamentalValue(running_compactions);
+    case 2:
+      return new common::FundamentalValue(running_flushes);
+    case 3:
+      return new common::FundamentalValue(is_write_stopped);
+    case 4:
+      return new common::FundamentalValue(delayed_write_rate);
+    case 5:
+      return common::Value::createULongLongIntegerValue(stall_micros);
+    default:
+      break;
+  }
+
+  NOTREACHED();
+  return nullptr;
+}
+
+ServerInfo::Memtables::Memtables()
+    : active_mem_table_mb(0),
+      all_mem_tables_mb(0),
+      pinned_mem_tables_mb(0),
+      immutable_mem_tables(0) {}
+
+ServerInfo::Memtables::Memtables(const std::string& memtables_text) : Memtables() {
+  size_t pos = 0;
+  size_t start = 0;
+
+  while ((pos = memtables_text.find(MARKER, start)) != std::string::npos) {
+    std::string line = memtables_text.substr(start, pos - start);
+    size_t delem = line.find_first_of(':');
+    std::string field = line.substr(0, delem);
+    std::string value = line.substr(delem + 1);
+    if (field == ROCKSDB_ACTIVE_MEM_TABLE_MB_LABEL) {
+      active_mem_table_mb = common::ConvertFromString<uint32_t>(value);
+    } else if (field == ROCKSDB_ALL_MEM_TABLES_MB_LABEL) {
+      all_mem_tables_mb = common::ConvertFromString<uint32_t>(value);
+    } else if (field == ROCKSDB_PINNED_MEM_TABLES_MB_LABEL) {
+      pinned_mem_tables_mb = common::ConvertFromString<uint32_t>(value);
+    } else if (field == ROCKSDB_IMMUTABLE_MEM_TABLES_LABEL) {
+      immutable_mem_tables = common::ConvertFromString<uint32_t>(value);
+    }
+    start = pos + 2;
+  }
+}
+
+common::Value* ServerInfo::Memtables::ValueByIndex(unsigned char index) const {
+  switch (index) {
+    case 0:
+      return new common::FundamentalValue(active_mem_table_mb);
+    case 1:
+      return new common::FundamentalValue(all_mem_tables_mb);
+    case 2:
+      return new common::FundamentalValue(pinned_mem_tables_mb);
+    case 3:
+      return new common::FundamentalValue(immutable_mem_tables);
+    default:
+      break;
+  }
+
+  NOTREACHED();
+  return nullptr;
+}
+
+ServerInfo::Cache::Cache()
+    : block_cache_usage_mb(0),
+      block_cache_hit(0),
+      block_cache_miss(0),
+      block_cache_hit_ratio(0),
+      bloom_filter_useful(0),
+      get_p50_micros(0),
+      get_p99_micros(0),
+      write_p50_micros(0),
+      write_p99_micros(0) {}
+
+ServerInfo::Cache::Cache(const std::string& cache_text) : Cache() {
+  size_t pos = 0;
+  size_t start = 0;
+
+  while ((pos = cache_text.find(MARKER, start)) != std::string::npos) {
+    std::string line = cache_text.substr(start, pos - start);
+    size_t delem = line.find_first_of(':');
+    std::string field = line.substr(0, delem);
+    std::string value = line.substr(delem + 1);
+    if (field == ROCKSDB_BLOCK_CACHE_USAGE_MB_LABEL) {
+      block_cache_usage_mb = common::ConvertFromString<uint32_t>(value);
+    } else if (field == ROCKSDB_BLOCK_CACHE_HIT_LABEL) {
+      block_cache_hit = common::ConvertFromString<uint64_t>(value);
+    } else if (field == ROCKSDB_BLOCK_CACHE_MISS_LABEL) {
+      block_cache_miss = common::ConvertFromString<uint64_t>(value);
+    } else if (field == ROCKSDB_BLOCK_CACHE_HIT_RATIO_LABEL) {
+      block_cache_hit_ratio = common::ConvertFromString<double>(value);
+    } else if (field == ROCKSDB_BLOOM_FILTER_USEFUL_LABEL) {
+      bloom_filter_useful = common::ConvertFromString<uint64_t>(value);
+    } else if (field == ROCKSDB_GET_P50_MICROS_LABEL) {
+      get_p50_micros = common::ConvertFromString<double>(value);
+    } else if (field == ROCKSDB_GET_P99_MICROS_LABEL) {
+      get_p99_micros = common::ConvertFromString<double>(value);
+    } else if (field == ROCKSDB_WRITE_P50_MICROS_LABEL) {
+      write_p50_micros = common::ConvertFromString<double>(value);
+    } else if (field == ROCKSDB_WRITE_P99_MICROS_LABEL) {
+      write_p99_micros = common::ConvertFromString<double>(value);
+    }
+    start = pos + 2;
+  }
+}
+
+common::Value* ServerInfo::Cache::ValueByIndex(unsigned char index) const {
+  switch (index) {
+    case 0:
+      return new common::FundamentalValue(block_cache_usage_mb);
+    case 1:
+      return common::Value::createULongLongIntegerValue(block_cache_hit);
+    case 2:
+      return common::Value::createULongLongIntegerValue(block_cache_miss);
+    case 3:
+      return new common::FundamentalValue(block_cache_hit_ratio);
+    case 4:
+      return common::Value::createULongLongIntegerValue(bloom_filter_useful);
+    case 5:
+      return new common::FundamentalValue(get_p50_micros);
+    case 6:
+      return new common::FundamentalValue(get_p99_micros);
+    case 7:
+      return new common::FundamentalValue(write_p50_micros);
+    case 8:
+      return new common::FundamentalValue(write_p99_micros);
+    default:
+      break;
+  }
+
+  NOTREACHED();
+  return nullptr;
+}
+
+ServerInfo::Storage::Storage()
+    : live_sst_mb(0), total_sst_mb(0), estimate_num_keys(0), estimate_live_data_mb(0) {}
+
+ServerInfo::Storage::Storage(const std::string& storage_text) : Storage() {
+  size_t pos = 0;
+  size_t start = 0;
+
+  while ((pos = storage_text.find(MARKER, start)) != std::string::npos) {
+    std::string line = storage_text.substr(start, pos - start);
+    size_t delem = line.find_first_of(':');
+    std::string field = line.substr(0, delem);
+    std::string value = line.substr(delem + 1);
+    if (field == ROCKSDB_LIVE_SST_MB_LABEL) {
+      live_sst_mb = common::ConvertFromString<uint32_t>(value);
+    } else if (field == ROCKSDB_TOTAL_SST_MB_LABEL) {
+      total_sst_mb = common::ConvertFromString<uint32_t>(value);
+    } else if (field == ROCKSDB_ESTIMATE_NUM_KEYS_LABEL) {
+      estimate_num_keys = common::ConvertFromString<uint64_t>(value);
+    } else if (field == ROCKSDB_ESTIMATE_LIVE_DATA_MB_LABEL) {
+      estimate_live_data_mb = common::ConvertFromString<uint32_t>(value);
+    }
+    start = pos + 2;
+  }
+}
+
+common::Value* ServerInfo::Storage::ValueByIndex(unsigned char index) const {
+  switch (index) {
+    case 0:
+      return new common::FundamentalValue(live_sst_mb);
+    case 1:
+      return new common::FundamentalValue(total_sst_mb);
+    case 2:
+      return common::Value::createULongLongIntegerValue(estimate_num_keys);
+    case 3:
+      return new common::FundamentalValue(estimate_live_data_mb);
+    default:
+      break;
+  }
+
+  NOTREACHED();
+  return nullptr;
+}
+
 ServerInfo::ServerInfo() : IServerInfo(ROCKSDB) {}
 
 ServerInfo::ServerInfo(const Stats& stats) : IServerInfo(ROCKSDB), stats_(stats) {}
@@ -115,6 +426,16 @@ common::Value* ServerInfo::ValueByIndexes(unsigned char property, unsigned char
   switch (property) {
     case 0:
       return stats_.ValueByIndex(field);
+    case 1:
+      return levels_.ValueByIndex(field);
+    case 2:
+      return compaction_.ValueByIndex(field);
+    case 3:
+      return memtables_.ValueByIndex(field);
+    case 4:
+      return cache_.ValueByIndex(field);
+    case 5:
+      return storage_.ValueByIndex(field);
     default:
       break;
   }
@@ -130,6 +451,51 @@ std::ostream& operator<<(std::ostream& out, const ServerInfo::Stats& value) {
              << value.read_mb << MARKER << ROCKSDB_WRITE_MB_LABEL ":" << value.write_mb << MARKER;
 }
 
+std::ostream& operator<<(std::ostream& out, const ServerInfo::Levels& value) {
+  for (size_t i = 0; i < ROCKSDB_LEVELS_COUNT; ++i) {
+    out << ROCKSDB_FILES_AT_LEVEL_LABEL << i << ":" << value.files_at_level[i] << MARKER;
+  }
+  for (size_t i = 0; i < ROCKSDB_LEVELS_COUNT; ++i) {
+    out << ROCKSDB_SIZE_MB_AT_LEVEL_LABEL << i << ":" << value.size_mb_at_level[i] << MARKER;
+  }
+  return out;
+}
+
+std::ostream& operator<<(std::ostream& out, const ServerInfo::Compaction& value) {
+  return out << ROCKSDB_PENDING_COMPACTION_MB_LABEL ":" << value.pending_compaction_mb << MARKER
+             << ROCKSDB_RUNNING_COMPACTIONS_LABEL ":" << value.running_compactions << MARKER
+             << ROCKSDB_RUNNING_FLUSHES_LABEL ":" << value.running_flushes << MARKER
+             << ROCKSDB_IS_WRITE_STOPPED_LABEL ":" << value.is_write_stopped << MARKER
+             << ROCKSDB_DELAYED_WRITE_RATE_LABEL ":" << value.delayed_write_rate << MARKER
+             << ROCKSDB_STALL_MICROS_LABEL ":" << value.stall_micros << MARKER;
+}
+
+std::ostream& operator<<(std::ostream& out, const ServerInfo::Memtables& value) {
+  return out << ROCKSDB_ACTIVE_MEM_TABLE_MB_LABEL ":" << value.active_mem_table_mb << MARKER
+             << ROCKSDB_ALL_MEM_TABLES_MB_LABEL ":" << value.all_mem_tables_mb << MARKER
+             << ROCKSDB_PINNED_MEM_TABLES_MB_LABEL ":" << value.pinned_mem_tables_mb << MARKER
+             << ROCKSDB_IMMUTABLE_MEM_TABLES_LABEL ":" << value.immutable_mem_tables << MARKER;
+}
+
+std::ostream& operator<<(std::ostream& out, const ServerInfo::Cache& value) {
+  return out << ROCKSDB_BLOCK_CACHE_USAGE_MB_LABEL ":" << value.block_cache_usage_mb << MARKER
+             << ROCKSDB_BLOCK_CACHE_HIT_LABEL ":" << value.block_cache_hit << MARKER
+             << ROCKSDB_BLOCK_CACHE_MISS_LABEL ":" << value.block_cache_miss << MARKER
+             << ROCKSDB_BLOCK_CACHE_HIT_RATIO_LABEL ":" << value.block_cache_hit_ratio << MARKER
+             << ROCKSDB_BLOOM_FILTER_USEFUL_LABEL ":" << value.bloom_filter_useful << MARKER
+             << ROCKSDB_GET_P50_MICROS_LABEL ":" << value.get_p50_micros << MARKER
+             << ROCKSDB_GET_P99_MICROS_LABEL ":" << value.get_p99_micros << MARKER
+             << ROCKSDB_WRITE_P50_MICROS_LABEL ":" << value.write_p50_micros << MARKER
+             << ROCKSDB_WRITE_P99_MICROS_LABEL ":" << value.write_p99_micros << MARKER;
+}
+
+std::ostream& operator<<(std::ostream& out, const ServerInfo::Storage& value) {
+  return out << ROCKSDB_LIVE_SST_MB_LABEL ":" << value.live_sst_mb << MARKER
+             << ROCKSDB_TOTAL_SST_MB_LABEL ":" << value.total_sst_mb << MARKER
+             << ROCKSDB_ESTIMATE_NUM_KEYS_LABEL ":" << value.estimate_num_keys << MARKER
+             << ROCKSDB_ESTIMATE_LIVE_DATA_MB_LABEL ":" << value.estimate_live_data_mb << MARKER;
+}
+
 std::ostream& operator<<(std::ostream& out, const ServerInfo& value) {
   return out << value.ToString();
 }
@@ -141,15 +507,51 @@ ServerInfo* MakeRocksdbServerInfo(const std::string& content) {
 
   ServerInfo* result = new ServerInfo;
   static const std::vector<info_field_t> fields = DBTraits<ROCKSDB>::InfoFields();
+  size_t j = 0;
   std::string word;
-  DCHECK_EQ(fields.size(), 1);
+  size_t pos = 0;
 
-  for (size_t i = 0; i < content.size(); ++i) {
+  for (size_t i = 0; i < content.size() && j < fields.size(); ++i) {
     word += content[i];
-    if (word == fields[0].first) {
-      std::string part = content.substr(i + 1);
-      result->stats_ = ServerInfo::Stats(part);
-      break;
+    if (word == fields[j].first) {
+      size_t end = std::string::npos;
+      if (j + 1 != fields.size()) {
+        end = content.find(fields[j + 1].first, pos);
+      }
+
+      std::string part = end == std::string::npos ? content.substr(i + 1)
+                                                  : content.substr(i + 1, end - i - 1);
+      switch (j) {
+        case 0:
+          result->stats_ = ServerInfo::Stats(part);
+          break;
+        case 1:
+          result->levels_ = ServerInfo::Levels(part);
+          break;
+        case 2:
+          result->compaction_ = ServerInfo::Compaction(part);
+          break;
+        case 3:
+          result->memtables_ = ServerInfo::Memtables(part);
+          break;
+        case 4:
+          result->cache_ = ServerInfo::Cache(part);
+          break;
+        case 5:
+          result->storage_ = ServerInfo::Storage(part);
+          break;
+        default:
+          break;
+      }
+
+      if (end == std::string::npos) {  // old history files have only # Stats section
+        break;
+      }
+
+      i = end - 1;
+      pos = end;
+      ++j;
+      word.clear();
     }
   }
 
@@ -158,7 +560,10 @@ ServerInfo* MakeRocksdbServerInfo(const std::string& content) {
 
 std::string ServerInfo::ToString() const {
   std::stringstream str;
-  str << ROCKSDB_STATS_LABEL MARKER << stats_;
+  str << ROCKSDB_STATS_LABEL MARKER << stats_ << ROCKSDB_LEVELS_LABEL MARKER << levels_
+      << ROCKSDB_COMPACTION_LABEL MARKER << compaction_ << ROCKSDB_MEMTABLES_LABEL MARKER
+      << memtables_ << ROCKSDB_CACHE_LABEL MARKER << cache_ << ROCKSDB_STORAGE_LABEL MARKER
+      << storage_;
   return str.str();
 }
 
@@ -18,7 +18,7 @@
 
 #pragma once
 
-#include <stdint.h>  // for uint32_t
+#include <stdint.h>  // for uint32_t, uint64_t
 
 #include <iosfwd>  // for ostream
 #include <string>  // for string
@@ -36,6 +36,47 @@
 #define ROCKSDB_READ_MB_LABEL "read_mb"
 #define ROCKSDB_WRITE_MB_LABEL "write_mb"
 
+#define ROCKSDB_LEVELS_LABEL "# Levels"
+
+#define ROCKSDB_LEVELS_COUNT 7
+#define ROCKSDB_FILES_AT_LEVEL_LABEL "files_at_level"
+#define ROCKSDB_SIZE_MB_AT_LEVEL_LABEL "size_mb_at_level"
+
+#define ROCKSDB_COMPACTION_LABEL "# Compaction"
+
+#define ROCKSDB_PENDING_COMPACTION_MB_LABEL "pending_compaction_mb"
+#define ROCKSDB_RUNNING_COMPACTIONS_LABEL "running_compactions"
+#define ROCKSDB_RUNNING_FLUSHES_LABEL "running_flushes"
+#define ROCKSDB_IS_WRITE_STOPPED_LABEL "is_write_stopped"
+#define ROCKSDB_DELAYED_WRITE_RATE_LABEL "delayed_write_rate"
+#define ROCKSDB_STALL_MICROS_LABEL "stall_micros"
+
+#define ROCKSDB_MEMTABLES_LABEL "# Memtables"
+
+#define ROCKSDB_ACTIVE_MEM_TABLE_MB_LABEL "active_mem_table_mb"
+#define ROCKSDB_ALL_MEM_TABLES_MB_LABEL "all_mem_tables_mb"
+#define ROCKSDB_PINNED_MEM_TABLES_MB_LABEL "pinned_mem_tables_mb"
+#define ROCKSDB_IMMUTABLE_MEM_TABLES_LABEL "immutable_mem_tables"
+
+#define ROCKSDB_CACHE_LABEL "# Cache"
+
+#define ROCKSDB_BLOCK_CACHE_USAGE_MB_LABEL "block_cache_usage_mb"
+#define ROCKSDB_BLOCK_CACHE_HIT_LABEL "block_cache_hit"
+#define ROCKSDB_BLOCK_CACHE_MISS_LABEL "block_cache_miss"
+#define ROCKSDB_BLOCK_CACHE_HIT_RATIO_LABEL "block_cache_hit_ratio"
+#define ROCKSDB_BLOOM_FILTER_USEFUL_LABEL "bloom_filter_useful"
+#define ROCKSDB_GET_P50_MICROS_LABEL "get_p50_micros"
+#define ROCKSDB_GET_P99_MICROS_LABEL "get_p99_micros"
+#define ROCKSDB_WRITE_P50_MICROS_LABEL "write_p50_micros"
+#define ROCKSDB_WRITE_P99_MICROS_LABEL "write_p99_micros"
+
+#define ROCKSDB_STORAGE_LABEL "# Storage"
+
+#define ROCKSDB_LIVE_SST_MB_LABEL "live_sst_mb"
+#define ROCKSDB_TOTAL_SST_MB_LABEL "total_sst_mb"
+#define ROCKSDB_ESTIMATE_NUM_KEYS_LABEL "estimate_num_keys"
+#define ROCKSDB_ESTIMATE_LIVE_DATA_MB_LABEL "estimate_live_data_mb"
+
 namespace fastonosql {
 namespace core {
 namespace rocksdb {
@@ -56,6 +97,68 @@ class ServerInfo : public IServerInfo {
     uint32_t write_mb;
   } stats_;
 
+  // rocksdb.num-files-at-level<N>, compaction.L<N>.SizeBytes
+  struct Levels : IStateField {
+    Levels();
+    explicit Levels(const std::string& levels_text);
+    common::Value* ValueByIndex(unsigned char index) const override;
+
+    uint32_t files_at_level[ROCKSDB_LEVELS_COUNT];
+    uint32_t size_mb_at_level[ROCKSDB_LEVELS_COUNT];
+  } levels_;
+
+  struct Compaction : IStateField {
+    Compaction();
+    explicit Compaction(const std::string& compaction_text);
+    common::Value* ValueByIndex(unsigned char index) const override;
+
+    uint32_t pending_compaction_mb;
+    uint32_t running_compactions;
+    uint32_t running_flushes;
+    uint32_t is_write_stopped;
+    uint32_t delayed_write_rate;
+    uint64_t stall_micros;  // Statistics ticker, 0 if statistics disabled
+  } compaction_;
+
+  struct Memtables : IStateField {
+    Memtables();
+    explicit Memtables(const std::string& memtables_text);
+    common::Value* ValueByIndex(unsigned char index) const override;
+
+    uint32_t active_mem_table_mb;
+    uint32_t all_mem_tables_mb;
+    uint32_t pinned_mem_tables_mb;
+    uint32_t immutable_mem_tables;
+  } memtables_;
+
+  // tickers and histograms are filled only if statistics enabled
+  struct Cache : IStateField {
+    Cache();
+    explicit Cache(const std::string& cache_text);
+    common::Value* ValueByIndex(unsigned char index) const override;
+
+    uint32_t block_cache_usage_mb;
+    uint64_t block_cache_hit;
+    uint64_t block_cache_miss;
+    double block_cache_hit_ratio;
+    uint64_t bloom_filter_useful;
+    double get_p50_micros;
+    double get_p99_micros;
+    double write_p50_micros;
+    double write_p99_micros;
+  } cache_;
+
+  struct Storage : IStateField {
+    Storage();
+    explicit Storage(const std::string& storage_text);
+    common::Value* ValueByIndex(unsigned char index) const override;
+
+    uint32_t live_sst_mb;
+    uint32_t total_sst_mb;
+    uint64_t estimate_num_keys;
+    uint32_t estimate_live_data_mb;
+  } storage_;
+
   ServerInfo();
   explicit ServerInfo(const Stats& stats);
 
@@ -18,7 +18,8 @@
 
 #include "core/db/ssdb/db_connection.h"
 
-#include <memory>  // for __shared_ptr
+#include <algorithm>  // for min, max
+#include <memory>     // for __shared_ptr
 
 #include <SSDB.h>  // for Status, Client
 
@@ -27,6 +28,8 @@
 #include <common/sprintf.h>         // for MemSPrintf
 #include <common/value.h>           // for Value, etc
 
+#include "core/key_pattern.h"  // for KeyPattern
+
 #include "core/db/ssdb/config.h"  // for Config
 #include "core/db/ssdb/database_info.h"
 #include "core/db/ssdb/command_translator.h"
@@ -82,6 +85,30 @@ std::vector<CommandHolder> CDBConnection<ssdb::NativeConnection, ssdb::Config, S
 }
 }  // namespace internal
 namespace ssdb {
+namespace {
+
+#define SSDB_KEY_SEEK_PAD 8  // 0xff bytes appended to seek key just before prefix
+
+// keys returns (key_start, key_end], so seek from a key just before prefix:
+// "ab\0" -> "ab", "abc" -> "abb\xff..\xff", few unrelated keys are read
+std::string PrefixSeekKey(const std::string& prefix) {
+  if (prefix.empty()) {
+    return std::string();
+  }
+
+  std::string seek = prefix;
+  char& last = seek[seek.size() - 1];
+  if (last == '\0') {
+    seek.pop_back();
+    return seek;
+  }
+
+  last--;
+  seek.append(SSDB_KEY_SEEK_PAD, static_cast<char>(0xff));
+  return seek;
+}
+
+}  // namespace
 
 common::Error CreateConnection(const Config& config, NativeConnection** context) {
   if (!context) {
@@ -89,7 +116,8 @@ common::Error CreateConnection(const Config& config, NativeConnection** context)
   }
 
   DCHECK(*context == nullptr);
-  ::ssdb::Client* lcontext = ::ssdb::Client::connect(config.host.host, config.host.port);
+  ::ssdb::Client* lcontext =
+      ::ssdb::Client::connect(config.host.host, config.host.port, config.timeout_msec);
   if (!lcontext) {
     return common::make_error_value("Fail connect to server!", common::ErrorValue::E_ERROR);
   }
@@ -109,8 +137,10 @@ common::Error TestConnection(const Config& config) {
   return common::Error();
 }
 
+DBConnection::ScanSession::ScanSession() : cursor(0), pattern(), last_key() {}
+
 DBConnection::DBConnection(CDBConnectionClient* client)
-    : base_class(client, new CommandTranslator(base_class::Commands())) {}
+    : base_class(client, new CommandTranslator(base_class::Commands())), scan_session_() {}
 
 common::Error DBConnection::Info(const char* args, ServerInfo::Stats* statsout) {
   if (!statsout) {
@@ -822,12 +852,85 @@ common::Error DBConnection::ScanImpl(uint64_t cursor_in,
                                      uint64_t count_keys,
                                      std::vector<std::string>* keys_out,
                                      uint64_t* cursor_out) {
-  UNUSED(cursor_in);
-  UNUSED(pattern);
-  UNUSED(count_keys);
-  UNUSED(keys_out);
-  UNUSED(cursor_out);
-  return ICommandTranslator::NotSupported("SCAN");
+  // keys are ordered, so literal prefix of pattern narrows range on server:
+  // (key just before prefix, prefix upper bound], the rest is matched here
+  KeyPattern kpattern(pattern);
+  const std::string& prefix = kpattern.Prefix();
+  const std::string key_end = kpattern.PrefixUpperBound();
+  std::string key_start;
+  uint64_t offset_pos = 0;
+  if (cursor_in != 0 && scan_session_.cursor == cursor_in && scan_session_.pattern == pattern) {
+    key_start = scan_session_.last_key;
+  } else {
+    // new browse or unknown cursor: skip cursor_in matched keys
+    key_start = PrefixSeekKey(prefix);
+    offset_pos = cursor_in;
+  }
+
+  const uint64_t page = std::min<uint64_t>(std::max<uint64_t>(count_keys, SSDB_KEYS_PAGE_SIZE),
+                                           SSDB_KEYS_MAX_PAGE_SIZE);
+  std::vector<std::string> lkeys_out;
+  uint64_t lcursor_out = 0;
+  bool done = false;
+  while (!done) {
+    std::vector<std::string> ret;
+    auto st = connection_.handle_->keys(key_start, key_end, page, &ret);
+    if (st.error()) {
+      scan_session_ = ScanSession();
+      std::string buff = common::MemSPrintf("SCAN function error: %s", st.code());
+      return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
+
+    done = ret.size() < page;
+    std::string prev_key = key_start;
+    for (const std::string& key : ret) {
+      if (!kpattern.HasPrefix(key.data(), key.size())) {
+        if (key > prefix) {
+          done = true;  // past prefix range
+          break;
+        }
+        prev_key = key;
+        continue;  // between key_start and prefix
+      }
+
+      if (!kpattern.Match(key.data(), key.size())) {
+        prev_key = key;
+        continue;
+      }
+
+      if (offset_pos != 0) {
+        offset_pos--;
+        prev_key = key;
+        continue;
+      }
+
+      if (lkeys_out.size() >= count_keys) {
+        // next page starts at this match, cursor stays 0 if no match is left
+        lcursor_out = cursor_in + count_keys;
+        scan_session_.last_key = prev_key;
+        done = true;
+        break;
+      }
+
+      lkeys_out.push_back(key);
+      prev_key = key;
+    }
+
+    if (!ret.empty()) {
+      key_start = ret.back();
+    }
+  }
+
+  if (lcursor_out == 0) {
+    scan_session_ = ScanSession();
+  } else {
+    scan_session_.cursor = lcursor_out;
+    scan_session_.pattern = pattern;
+  }
+
+  *keys_out = lkeys_out;
+  *cursor_out = lcursor_out;
+  return common::Error();
 }
 
 common::Error DBConnection::KeysImpl(const std::string& key_start,
@@ -842,34 +945,56 @@ common::Error DBConnection::KeysImpl(const std::string& key_start,
   return common::Error();
 }
 
+// ssdb has no key counter (dbsize is approximate size in bytes),
+// count by pages so memory doesn't grow with database size
 common::Error DBConnection::DBkcountImpl(size_t* size) {
-  std::vector<std::string> ret;
-  auto st = connection_.handle_->keys("", "", UINT64_MAX, &ret);
-  if (st.error()) {
-    std::string buff = common::MemSPrintf("Couldn't determine DBKCOUNT error: %s", st.code());
-    return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+  size_t count = 0;
+  std::string key_start;
+  while (true) {
+    std::vector<std::string> ret;
+    auto st = connection_.handle_->keys(key_start, std::string(), SSDB_KEYS_MAX_PAGE_SIZE, &ret);
+    if (st.error()) {
+      std::string buff = common::MemSPrintf("Couldn't determine DBKCOUNT error: %s", st.code());
+      return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
+
+    count += ret.size();
+    if (ret.size() < SSDB_KEYS_MAX_PAGE_SIZE) {
+      break;
+    }
+    key_start = ret.back();
   }
 
-  *size = ret.size();
+  *size = count;
   return common::Error();
 }
 
 common::Error DBConnection::FlushDBImpl() {
-  std::vector<std::string> ret;
-  auto st = connection_.handle_->keys(std::string(), std::string(), 0, &ret);
-  if (st.error()) {
-    std::string buff = common::MemSPrintf("Flushdb function error: %s", st.code());
-    return common::make_error_value(buff, common::ErrorValue::E_ERROR);
-  }
+  std::string key_start;
+  while (true) {
+    std::vector<std::string> ret;
+    auto st = connection_.handle_->keys(key_start, std::string(), SSDB_KEYS_PAGE_SIZE, &ret);
+    if (st.error()) {
+      std::string buff = common::MemSPrintf("Flushdb function error: %s", st.code());
+      return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
 
-  for (size_t i = 0; i < ret.size(); ++i) {
-    std::string key = ret[i];
-    common::Error err = DelInner(key);
+    if (ret.empty()) {
+      break;
+    }
+
+    common::Error err = MultiDel(ret);
     if (err && err->isError()) {
       return err;
     }
+
+    if (ret.size() < SSDB_KEYS_PAGE_SIZE) {
+      break;
+    }
+    key_start = ret.back();
   }
 
+  scan_session_ = ScanSession();
   return common::Error();
 }
 
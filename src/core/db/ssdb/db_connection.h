@@ -35,6 +35,9 @@
 #include "core/db/ssdb/config.h"
 #include "core/db/ssdb/server_info.h"
 
+#define SSDB_KEYS_PAGE_SIZE 1000        // keys per round trip for SCAN, FLUSHDB
+#define SSDB_KEYS_MAX_PAGE_SIZE 100000  // SCAN page upper bound for big COUNT, DBKCOUNT page
+
 namespace ssdb {
 class Client;
 }
@@ -187,6 +190,15 @@ class DBConnection : public core::internal::CDBConnection<NativeConnection, Conf
   virtual common::Error SetTTLImpl(const NKey& key, ttl_t ttl) override;
   virtual common::Error GetTTLImpl(const NKey& key, ttl_t* ttl) override;
   virtual common::Error QuitImpl() override;
+
+  // SCAN continues from the last returned key instead of skipping cursor keys
+  struct ScanSession {
+    ScanSession();
+
+    uint64_t cursor;
+    std::string pattern;
+    std::string last_key;
+  } scan_session_;
 };
 
 }  // namespace ssdb
@@ -18,9 +18,12 @@
 
 #include "core/db/unqlite/db_connection.h"
 
-#include <memory>  // for __shared_ptr
-#include <string>  // for string, operator<, etc
-#include <vector>  // for vector
+#include <string.h>  // for memchr
+
+#include <memory>   // for __shared_ptr
+#include <string>   // for string, operator<, etc
+#include <utility>  // for make_pair
+#include <vector>   // for vector
 
 extern "C" {
 #include <unqlite.h>
@@ -31,13 +34,29 @@ extern "C" {
 #include <common/value.h>    // for Value::ErrorsType::E_ERROR, etc
 #include <common/convert2string.h>
 #include <common/file_system.h>
+#include <common/macros.h>  // for UNUSED
 
 #include "core/db/unqlite/config.h"  // for Config
 #include "core/db/unqlite/database_info.h"
 #include "core/db/unqlite/command_translator.h"
 #include "core/db/unqlite/internal/commands_api.h"
 
-#include "core/global.h"  // for FastoObject, etc
+#include "core/global.h"       // for FastoObject, etc
+#include "core/key_pattern.h"  // for KeyPattern
+
+// $collection, $filter_offset and $filter_count are bound before every run, so
+// one compiled VM serves every page of every collection for the same filter
+#define JX9_FIND_SCRIPT_PATTERN_1ARGS_S                           \
+  "if (!db_exists($collection)) { return; }"                      \
+  "db_reset_record_cursor($collection);"                          \
+  "$skip = $filter_offset;"                                       \
+  "$left = $filter_count;"                                        \
+  "while ($left > 0 && ($rec = db_fetch($collection)) != NULL) {" \
+  "  if (!(%s)) { continue; }"                                    \
+  "  if ($skip > 0) { $skip--; continue; }"                       \
+  "  print json_encode($rec), \"\\n\";"                           \
+  "  $left--;"                                                    \
+  "}"
 
 namespace {
 
@@ -109,6 +128,55 @@ int unqlite_data_callback(const void* pData, unsigned int nDatalen, void* str) {
   return UNQLITE_OK;
 }
 
+std::string unqlite_jx9_strerror(unqlite* context) {
+  const char* zErr = NULL;
+  int iLen = 0;
+  unqlite_config(context, UNQLITE_CONFIG_JX9_ERR_LOG, &zErr, &iLen);
+  return std::string(zErr, iLen);
+}
+
+common::Value* unqlite_jx9_value(unqlite_value* value);
+
+int unqlite_jx9_array_walk(unqlite_value* key, unqlite_value* value, void* user_data) {
+  UNUSED(key);
+  common::ArrayValue* array = static_cast<common::ArrayValue*>(user_data);
+  array->append(unqlite_jx9_value(value));
+  return UNQLITE_OK;
+}
+
+int unqlite_jx9_object_walk(unqlite_value* key, unqlite_value* value, void* user_data) {
+  common::HashValue* hash = static_cast<common::HashValue*>(user_data);
+  int len = 0;
+  const char* key_str = unqlite_value_to_string(key, &len);
+  hash->insert(common::Value::createStringValue(std::string(key_str, len)),
+               unqlite_jx9_value(value));
+  return UNQLITE_OK;
+}
+
+common::Value* unqlite_jx9_value(unqlite_value* value) {
+  if (unqlite_value_is_json_object(value)) {
+    common::HashValue* hash = common::Value::createHashValue();
+    unqlite_array_walk(value, unqlite_jx9_object_walk, hash);
+    return hash;
+  } else if (unqlite_value_is_json_array(value)) {
+    common::ArrayValue* array = common::Value::createArrayValue();
+    unqlite_array_walk(value, unqlite_jx9_array_walk, array);
+    return array;
+  } else if (unqlite_value_is_null(value)) {
+    return common::Value::createNullValue();
+  } else if (unqlite_value_is_bool(value)) {
+    return common::Value::createBooleanValue(unqlite_value_to_bool(value));
+  } else if (unqlite_value_is_int(value)) {
+    return common::Value::createLongLongIntegerValue(unqlite_value_to_int64(value));
+  } else if (unqlite_value_is_float(value)) {
+    return common::Value::createDoubleValue(unqlite_value_to_double(value));
+  }
+
+  int len = 0;
+  const char* str = unqlite_value_to_string(value, &len);
+  return common::Value::createStringValue(std::string(str, len));
+}
+
 }  // namespace
 
 namespace fastonosql {
@@ -161,6 +229,59 @@ CDBConnection<unqlite::NativeConnection, unqlite::Config, UNQLITE>::Commands() {
 }
 }  // namespace internal
 namespace unqlite {
+namespace {
+
+// VM output consumer, turns printed text into one reply per line
+struct Jx9Output {
+  Jx9Output(DBConnection* connection, FastoObject* out)
+      : connection(connection), out(out), pending() {}
+
+  void AddLine(const char* data, size_t size) {
+    common::StringValue* val = common::Value::createStringValue(std::string(data, size));
+    FastoObject* child = new FastoObject(out, val, connection->Delimiter());
+    out->AddChildren(child);
+  }
+
+  void Flush() {
+    if (!pending.empty()) {
+      AddLine(pending.data(), pending.size());
+      pending.clear();
+    }
+  }
+
+  DBConnection* const connection;
+  FastoObject* const out;
+  std::string pending;  // tail of the last chunk without new line
+};
+
+int unqlite_jx9_output_callback(const void* pOutput, unsigned int nLen, void* user_data) {
+  Jx9Output* output = static_cast<Jx9Output*>(user_data);
+  if (output->connection->IsInterrupted()) {
+    return UNQLITE_ABORT;
+  }
+
+  const char* data = static_cast<const char*>(pOutput);
+  const char* end = data + nLen;
+  while (data != end) {
+    const char* nl = static_cast<const char*>(memchr(data, '\n', end - data));
+    if (!nl) {
+      output->pending.append(data, end - data);
+      break;
+    }
+
+    if (output->pending.empty()) {
+      output->AddLine(data, nl - data);
+    } else {
+      output->pending.append(data, nl - data);
+      output->Flush();
+    }
+    data = nl + 1;
+  }
+
+  return UNQLITE_OK;
+}
+
+}  // namespace
 
 common::Error CreateConnection(const Config& config, NativeConnection** context) {
   if (!context) {
@@ -201,7 +322,16 @@ common::Error TestConnection(const Config& config) {
 }
 
 DBConnection::DBConnection(CDBConnectionClient* client)
-    : base_class(client, new CommandTranslator(base_class::Commands())) {}
+    : base_class(client, new CommandTranslator(base_class::Commands())), jx9_cache_() {}
+
+DBConnection::~DBConnection() {
+  ReleaseJx9Cache();
+}
+
+common::Error DBConnection::Disconnect() {
+  ReleaseJx9Cache();
+  return base_class::Disconnect();
+}
 
 common::Error DBConnection::Info(const char* args, ServerInfo::Stats* statsout) {
   UNUSED(args);
@@ -221,6 +351,117 @@ common::Error DBConnection::Info(const char* args, ServerInfo::Stats* statsout)
   return common::Error();
 }
 
+common::Error DBConnection::Jx9(const std::string& script,
+                                const std::string& variable,
+                                FastoObject* out) {
+  return ExecJx9(script, std::vector<Jx9Var>(), variable, out);
+}
+
+common::Error DBConnection::Jx9Find(const std::string& collection,
+                                    const std::string& filter,
+                                    uint64_t offset,
+                                    uint64_t count,
+                                    FastoObject* out) {
+  std::string cond = filter.empty() ? std::string("TRUE") : filter;
+  std::string script = common::MemSPrintf(JX9_FIND_SCRIPT_PATTERN_1ARGS_S, cond);
+  std::vector<Jx9Var> vars = {{"collection", collection, 0, true},
+                              {"filter_offset", std::string(), static_cast<int64_t>(offset), false},
+                              {"filter_count", std::string(), static_cast<int64_t>(count), false}};
+  return ExecJx9(script, vars, std::string(), out);
+}
+
+common::Error DBConnection::ExecJx9(const std::string& script,
+                                    const std::vector<Jx9Var>& vars,
+                                    const std::string& variable,
+                                    FastoObject* out) {
+  if (!out) {
+    DNOTREACHED();
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  if (!IsConnected()) {
+    return common::make_error_value("Not connected", common::Value::E_ERROR);
+  }
+
+  unqlite_vm* vm = nullptr;
+  common::Error err = CompileJx9(script, &vm);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  Jx9Output output(this, out);
+  unqlite_vm_config(vm, UNQLITE_VM_CONFIG_OUTPUT, unqlite_jx9_output_callback, &output);
+  std::vector<unqlite_value*> values;
+  for (const Jx9Var& var : vars) {
+    unqlite_value* value = unqlite_vm_new_scalar(vm);
+    if (var.is_str) {
+      unqlite_value_string(value, var.str.c_str(), var.str.size());
+    } else {
+      unqlite_value_int64(value, var.num);
+    }
+    unqlite_vm_config(vm, UNQLITE_VM_CONFIG_CREATE_VAR, var.name.c_str(), value);
+    values.push_back(value);
+  }
+
+  int rc = unqlite_vm_exec(vm);
+  output.Flush();
+  if (IsInterrupted()) {
+    err = common::make_error_value("Interrupted.", common::ErrorValue::E_INTERRUPTED);
+  } else if (rc != UNQLITE_OK) {
+    std::string buff = common::MemSPrintf("JX9 function error: %s", unqlite_strerror(rc));
+    err = common::make_error_value(buff, common::ErrorValue::E_ERROR);
+  } else if (!variable.empty()) {
+    unqlite_value* value = unqlite_vm_extract_variable(vm, variable.c_str());
+    if (value) {
+      FastoObject* child = new FastoObject(out, unqlite_jx9_value(value), Delimiter());
+      out->AddChildren(child);
+    } else {
+      std::string buff = common::MemSPrintf("JX9 variable $%s not defined", variable);
+      err = common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
+  }
+
+  for (unqlite_value* value : values) {
+    unqlite_vm_release_value(vm, value);
+  }
+  unqlite_vm_reset(vm);  // ready for the next run from cache
+  return err;
+}
+
+common::Error DBConnection::CompileJx9(const std::string& script, unqlite_vm** vm) {
+  for (auto it = jx9_cache_.begin(); it != jx9_cache_.end(); ++it) {
+    if (it->first == script) {
+      jx9_cache_.splice(jx9_cache_.begin(), jx9_cache_, it);
+      *vm = it->second;
+      return common::Error();
+    }
+  }
+
+  unqlite_vm* lvm = nullptr;
+  int rc = unqlite_compile(connection_.handle_, script.c_str(), script.size(), &lvm);
+  if (rc != UNQLITE_OK) {
+    std::string jx9_error = unqlite_jx9_strerror(connection_.handle_);
+    std::string buff = common::MemSPrintf("JX9 compile error: %s",
+                                          jx9_error.empty() ? unqlite_strerror(rc) : jx9_error);
+    return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+  }
+
+  if (jx9_cache_.size() >= JX9_VM_CACHE_SIZE) {
+    unqlite_vm_release(jx9_cache_.back().second);
+    jx9_cache_.pop_back();
+  }
+  jx9_cache_.push_front(std::make_pair(script, lvm));
+  *vm = lvm;
+  return common::Error();
+}
+
+void DBConnection::ReleaseJx9Cache() {
+  for (auto it = jx9_cache_.begin(); it != jx9_cache_.end(); ++it) {
+    unqlite_vm_release(it->second);
+  }
+  jx9_cache_.clear();
+}
+
 common::Error DBConnection::SetInner(const std::string& key, const std::string& value) {
   if (!IsConnected()) {
     return common::make_error_value("Not connected", common::Value::E_ERROR);
@@ -280,14 +521,15 @@ common::Error DBConnection::ScanImpl(uint64_t cursor_in,
   unqlite_kv_cursor_first_entry(pCur);
 
   /* Iterate over the entries */
+  KeyPattern kpattern(pattern);
+  std::string skey;
   uint64_t offset_pos = cursor_in;
   uint64_t lcursor_out = 0;
   std::vector<std::string> lkeys_out;
   while (unqlite_kv_cursor_valid_entry(pCur)) {
     if (lkeys_out.size() < count_keys) {
-      std::string skey;
       unqlite_kv_cursor_key_callback(pCur, unqlite_data_callback, &skey);
-      if (common::MatchPattern(skey, pattern)) {
+      if (kpattern.Match(skey.data(), skey.size())) {
         if (offset_pos == 0) {
           lkeys_out.push_back(skey);
         } else {
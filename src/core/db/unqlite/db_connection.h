@@ -21,8 +21,10 @@
 #include <stddef.h>  // for size_t
 #include <stdint.h>  // for uint64_t
 
-#include <string>  // for string
-#include <vector>  // for vector
+#include <list>     // for list
+#include <string>   // for string
+#include <utility>  // for pair
+#include <vector>   // for vector
 
 #include <common/error.h>   // for Error
 #include <common/macros.h>  // for WARN_UNUSED_RESULT
@@ -32,7 +34,11 @@
 #include "core/db/unqlite/config.h"
 #include "core/db/unqlite/server_info.h"
 
+#define JX9_VM_CACHE_SIZE 16        // compiled scripts kept per connection
+#define JX9_FIND_DEFAULT_COUNT 100  // documents per JX9FIND page
+
 struct unqlite;
+struct unqlite_vm;
 
 namespace fastonosql {
 namespace core {
@@ -47,8 +53,23 @@ class DBConnection : public core::internal::CDBConnection<NativeConnection, Conf
  public:
   typedef core::internal::CDBConnection<NativeConnection, Config, UNQLITE> base_class;
   explicit DBConnection(CDBConnectionClient* client);
+  virtual ~DBConnection();
+
+  common::Error Disconnect() WARN_UNUSED_RESULT;  // releases compiled scripts before db handle
 
   common::Error Info(const char* args, ServerInfo::Stats* statsout) WARN_UNUSED_RESULT;
+  // runs script, every printed line becomes a reply, variable (if not empty) is
+  // extracted after run, interruptible between printed chunks
+  common::Error Jx9(const std::string& script,
+                    const std::string& variable,
+                    FastoObject* out) WARN_UNUSED_RESULT;
+  // JSON documents of collection for which filter ($rec is the document) is
+  // true, paged by offset and count, filtered inside the engine
+  common::Error Jx9Find(const std::string& collection,
+                        const std::string& filter,
+                        uint64_t offset,
+                        uint64_t count,
+                        FastoObject* out) WARN_UNUSED_RESULT;
 
  private:
   common::Error DelInner(const std::string& key) WARN_UNUSED_RESULT;
@@ -74,6 +95,24 @@ class DBConnection : public core::internal::CDBConnection<NativeConnection, Conf
   virtual common::Error SetTTLImpl(const NKey& key, ttl_t ttl) override;
   virtual common::Error GetTTLImpl(const NKey& key, ttl_t* ttl) override;
   virtual common::Error QuitImpl() override;
+
+  struct Jx9Var {
+    std::string name;
+    std::string str;
+    int64_t num;
+    bool is_str;
+  };
+
+  common::Error ExecJx9(const std::string& script,
+                        const std::vector<Jx9Var>& vars,
+                        const std::string& variable,
+                        FastoObject* out) WARN_UNUSED_RESULT;
+  common::Error CompileJx9(const std::string& script, unqlite_vm** vm) WARN_UNUSED_RESULT;
+  void ReleaseJx9Cache();
+
+  // most recently used first, at most JX9_VM_CACHE_SIZE
+  typedef std::list<std::pair<std::string, unqlite_vm*>> jx9_cache_t;
+  jx9_cache_t jx9_cache_;
 };
 
 }  // namespace unqlite
@@ -19,8 +19,10 @@
 #include "core/db/unqlite/internal/commands_api.h"
 
 #include <memory>  // for __shared_ptr
+#include <string>  // for string
 
-#include <common/value.h>  // for ErrorValue, StringValue, etc
+#include <common/convert2string.h>  // for ConvertFromString
+#include <common/value.h>           // for ErrorValue, StringValue, etc
 
 #include "core/db/unqlite/db_connection.h"  // for DBConnection
 #include "core/db/unqlite/server_info.h"    // for ServerInfo, etc
@@ -49,6 +51,27 @@ common::Error CommandsApi::Info(internal::CommandHandler* handler,
   return common::Error();
 }
 
+common::Error CommandsApi::Jx9(internal::CommandHandler* handler,
+                               int argc,
+                               const char** argv,
+                               FastoObject* out) {
+  DBConnection* unq = static_cast<DBConnection*>(handler);
+  std::string variable = argc == 2 ? argv[1] : std::string();
+  return unq->Jx9(argv[0], variable, out);
+}
+
+common::Error CommandsApi::Jx9Find(internal::CommandHandler* handler,
+                                   int argc,
+                                   const char** argv,
+                                   FastoObject* out) {
+  DBConnection* unq = static_cast<DBConnection*>(handler);
+  std::string filter = argc >= 2 ? argv[1] : std::string();
+  uint64_t offset = argc >= 3 ? common::ConvertFromString<uint64_t>(argv[2]) : 0;
+  uint64_t count =
+      argc == 4 ? common::ConvertFromString<uint64_t>(argv[3]) : JX9_FIND_DEFAULT_COUNT;
+  return unq->Jx9Find(argv[0], filter, offset, count, out);
+}
+
 }  // namespace unqlite
 }  // namespace core
 }  // namespace fastonosql
@@ -55,6 +55,14 @@ struct CommandsApi : public internal::ApiTraits<DBConnection> {
                             int argc,
                             const char** argv,
                             FastoObject* out);
+  static common::Error Jx9(internal::CommandHandler* handler,
+                           int argc,
+                           const char** argv,
+                           FastoObject* out);
+  static common::Error Jx9Find(internal::CommandHandler* handler,
+                               int argc,
+                               const char** argv,
+                               FastoObject* out);
 };
 
 static const std::vector<CommandHolder> g_commands = {
@@ -74,6 +82,24 @@ static const std::vector<CommandHolder> g_commands = {
                   1,
                   0,
                   &CommandsApi::Info),
+    CommandHolder("JX9",
+                  "<script> [variable]",
+                  "Run Jx9 script inside the engine, printed lines and "
+                  "the variable value are returned",
+                  UNDEFINED_SINCE,
+                  UNDEFINED_EXAMPLE_STR,
+                  1,
+                  1,
+                  &CommandsApi::Jx9),
+    CommandHolder("JX9FIND",
+                  "<collection> [filter] [offset] [count]",
+                  "Return JSON documents of the collection for which "
+                  "the Jx9 filter on $rec is true",
+                  UNDEFINED_SINCE,
+                  UNDEFINED_EXAMPLE_STR,
+                  1,
+                  3,
+                  &CommandsApi::Jx9Find),
     CommandHolder("SCAN",
                   "<cursor> [MATCH pattern] [COUNT count]",
                   "Incrementally iterate the keys space",
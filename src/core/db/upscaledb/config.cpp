@@ -29,6 +29,7 @@ extern "C" {
 
 #include <common/convert2string.h>
 #include <common/file_system.h>  // for prepare_path
+#include <common/macros.h>       // for SIZEOFMASS
 #include <common/log_levels.h>   // for LEVEL_LOG::L_WARNING
 #include <common/sprintf.h>      // for MemSPrintf
 
@@ -40,6 +41,19 @@ namespace upscaledb {
 
 namespace {
 
+const std::string key_types[] = {"binary", "uint8",  "uint16", "uint32",
+                                 "uint64", "real32", "real64"};
+
+KeyType KeyTypeFromString(const std::string& text) {
+  for (size_t i = 0; i < SIZEOFMASS(key_types); ++i) {
+    if (text == key_types[i]) {
+      return static_cast<KeyType>(i);
+    }
+  }
+
+  return KEY_BINARY;  // unknown names mean untyped keys
+}
+
 Config parseOptions(int argc, char** argv) {
   Config cfg;
   for (int i = 0; i < argc; i++) {
@@ -56,6 +70,8 @@ Config parseOptions(int argc, char** argv) {
     } else if (!strcmp(argv[i], "-n")) {
       cfg.dbnum = common::ConvertFromString<uint16_t>(argv[++i]);
       ;
+    } else if (!strcmp(argv[i], "-k") && !lastarg) {
+      cfg.key_type = KeyTypeFromString(argv[++i]);
     } else {
       if (argv[i][0] == '-') {
         const std::string buff = common::MemSPrintf(
@@ -78,7 +94,8 @@ Config parseOptions(int argc, char** argv) {
 Config::Config()
     : LocalConfig(common::file_system::prepare_path("~/test.upscaledb")),
       create_if_missing(false),
-      dbnum(1) {}
+      dbnum(1),
+      key_type(KEY_BINARY) {}
 
 }  // namespace upscaledb
 }  // namespace core
@@ -86,6 +103,15 @@ Config::Config()
 
 namespace common {
 
+template <>
+fastonosql::core::upscaledb::KeyType ConvertFromString(const std::string& text) {
+  return fastonosql::core::upscaledb::KeyTypeFromString(text);
+}
+
+std::string ConvertToString(fastonosql::core::upscaledb::KeyType t) {
+  return fastonosql::core::upscaledb::key_types[t];
+}
+
 std::string ConvertToString(const fastonosql::core::upscaledb::Config& conf) {
   auto argv = conf.Args();
 
@@ -98,6 +124,11 @@ std::string ConvertToString(const fastonosql::core::upscaledb::Config& conf) {
     argv.push_back(ConvertToString(conf.dbnum));
   }
 
+  if (conf.key_type != fastonosql::core::upscaledb::KEY_BINARY) {
+    argv.push_back("-k");
+    argv.push_back(ConvertToString(conf.key_type));
+  }
+
   return fastonosql::core::ConvertToStringConfigArgs(argv);
 }
 
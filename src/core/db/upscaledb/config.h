@@ -28,11 +28,25 @@ namespace fastonosql {
 namespace core {
 namespace upscaledb {
 
+// fixed size key types are compared and stored natively by the engine,
+// SET/GET take and SCAN returns them as decimal strings
+enum KeyType {
+  KEY_BINARY = 0,
+  KEY_UINT8,
+  KEY_UINT16,
+  KEY_UINT32,
+  KEY_UINT64,
+  KEY_REAL32,
+  KEY_REAL64
+};
+
+// -c -n -k
 struct Config : public LocalConfig {
   Config();
 
   bool create_if_missing;
   uint16_t dbnum;
+  KeyType key_type;  // for created databases, opened ones keep their own
 };
 
 }  // namespace upscaledb
@@ -40,5 +54,6 @@ struct Config : public LocalConfig {
 }  // namespace fastonosql
 
 namespace common {
+std::string ConvertToString(fastonosql::core::upscaledb::KeyType t);
 std::string ConvertToString(const fastonosql::core::upscaledb::Config& conf);
 }  // namespace common
@@ -18,19 +18,24 @@
 
 #include "core/db/upscaledb/db_connection.h"
 
-#include <stdlib.h>  // for NULL, free, calloc
-#include <string.h>  // for memset
-#include <string>    // for string
-#include <memory>    // for __shared_ptr
+#include <inttypes.h>  // for PRIu32, PRIu64
+#include <stdint.h>    // for UINT8_MAX, UINT16_MAX, UINT32_MAX
+#include <stdlib.h>    // for NULL, free, calloc, realloc, strtoull
+#include <string.h>    // for memset, memcpy
+#include <errno.h>     // for errno
+#include <algorithm>   // for min
+#include <string>      // for string
+#include <memory>      // for __shared_ptr
+#include <vector>      // for vector
 
 #include <ups/upscaledb.h>
+#include <ups/upscaledb_uqi.h>
 
 #include <common/value.h>  // for StringValue (ptr only)
 #include <common/utils.h>  // for c_strornull
 #include <common/convert2string.h>
 #include <common/file_system.h>  // for get_dir_path, is_directory, etc
 #include <common/sprintf.h>      // for MemSPrintf
-#include <common/string_util.h>  // for MatchPattern
 #include <common/types.h>        // for tribool, tribool::SUCCESS
 
 #include "core/command_holder.h"       // for CommandHolder
@@ -40,22 +45,242 @@
 #include "core/db/upscaledb/database_info.h"
 #include "core/db/upscaledb/internal/commands_api.h"
 
+#include "core/global.h"       // for FastoObject
+#include "core/key_pattern.h"  // for KeyPattern
+
 namespace fastonosql {
 namespace core {
 namespace upscaledb {
 
+struct upscaledb_db {
+  uint16_t name;
+  ups_db_t* db;
+  uint32_t key_type;  // UPS_TYPE_*
+};
+
 struct upscaledb {
   ups_env_t* env;
-  ups_db_t* db;
+  ups_db_t* db;  // handle of cur_db, one of dbs
   uint16_t cur_db;
+  uint32_t key_type;  // UPS_TYPE_* of cur_db
+  upscaledb_db* dbs;  // every database of env, kept open while connected
+  uint32_t dbs_count;
 };
 
 namespace {
 
+uint32_t upscaledb_key_type(KeyType type) {
+  switch (type) {
+    case KEY_UINT8:
+      return UPS_TYPE_UINT8;
+    case KEY_UINT16:
+      return UPS_TYPE_UINT16;
+    case KEY_UINT32:
+      return UPS_TYPE_UINT32;
+    case KEY_UINT64:
+      return UPS_TYPE_UINT64;
+    case KEY_REAL32:
+      return UPS_TYPE_REAL32;
+    case KEY_REAL64:
+      return UPS_TYPE_REAL64;
+    default:
+      return UPS_TYPE_BINARY;
+  }
+}
+
+uint32_t upscaledb_db_key_type(ups_db_t* db) {
+  ups_parameter_t params[] = {{UPS_PARAM_KEY_TYPE, 0}, {0, 0}};
+  ups_status_t st = ups_db_get_parameters(db, params);
+  if (st != UPS_SUCCESS) {
+    return UPS_TYPE_BINARY;
+  }
+
+  return static_cast<uint32_t>(params[0].value);
+}
+
+template <typename T>
+common::Error upscaledb_store(T val, std::string* raw) {
+  raw->assign(reinterpret_cast<const char*>(&val), sizeof(val));
+  return common::Error();
+}
+
+template <typename T>
+T upscaledb_load(const void* data) {
+  T val;
+  memcpy(&val, data, sizeof(val));
+  return val;
+}
+
+// decimal text into the fixed size native representation of type
+common::Error upscaledb_encode(uint32_t type, const std::string& text, std::string* raw) {
+  if (type == UPS_TYPE_BINARY || type == UPS_TYPE_CUSTOM) {
+    *raw = text;
+    return common::Error();
+  }
+
+  const char* str = text.c_str();
+  char* end = nullptr;
+  errno = 0;
+  if (type == UPS_TYPE_REAL32 || type == UPS_TYPE_REAL64) {
+    double val = strtod(str, &end);
+    if (text.empty() || *end != 0 || errno == ERANGE) {
+      return common::make_error_value(common::MemSPrintf("Invalid real key: %s", text),
+                                      common::ErrorValue::E_ERROR);
+    }
+
+    return type == UPS_TYPE_REAL32 ? upscaledb_store(static_cast<float>(val), raw)
+                                   : upscaledb_store(val, raw);
+  }
+
+  unsigned long long val = strtoull(str, &end, 10);
+  if (text.empty() || text[0] == '-' || *end != 0 || errno == ERANGE ||
+      (type == UPS_TYPE_UINT8 && val > UINT8_MAX) ||
+      (type == UPS_TYPE_UINT16 && val > UINT16_MAX) ||
+      (type == UPS_TYPE_UINT32 && val > UINT32_MAX)) {
+    return common::make_error_value(common::MemSPrintf("Invalid integer key: %s", text),
+                                    common::ErrorValue::E_ERROR);
+  }
+
+  if (type == UPS_TYPE_UINT8) {
+    return upscaledb_store(static_cast<uint8_t>(val), raw);
+  } else if (type == UPS_TYPE_UINT16) {
+    return upscaledb_store(static_cast<uint16_t>(val), raw);
+  } else if (type == UPS_TYPE_UINT32) {
+    return upscaledb_store(static_cast<uint32_t>(val), raw);
+  }
+  return upscaledb_store(static_cast<uint64_t>(val), raw);
+}
+
+// native representation of type into text, binary data as is
+std::string upscaledb_decode(uint32_t type, const void* data, uint32_t size) {
+  if (type == UPS_TYPE_UINT8 && size == sizeof(uint8_t)) {
+    return common::MemSPrintf("%u", static_cast<unsigned>(upscaledb_load<uint8_t>(data)));
+  } else if (type == UPS_TYPE_UINT16 && size == sizeof(uint16_t)) {
+    return common::MemSPrintf("%u", static_cast<unsigned>(upscaledb_load<uint16_t>(data)));
+  } else if (type == UPS_TYPE_UINT32 && size == sizeof(uint32_t)) {
+    return common::MemSPrintf("%" PRIu32, upscaledb_load<uint32_t>(data));
+  } else if (type == UPS_TYPE_UINT64 && size == sizeof(uint64_t)) {
+    return common::MemSPrintf("%" PRIu64, upscaledb_load<uint64_t>(data));
+  } else if (type == UPS_TYPE_REAL32 && size == sizeof(float)) {
+    return common::MemSPrintf("%.9g", static_cast<double>(upscaledb_load<float>(data)));
+  } else if (type == UPS_TYPE_REAL64 && size == sizeof(double)) {
+    return common::MemSPrintf("%.17g", upscaledb_load<double>(data));
+  }
+
+  return std::string(static_cast<const char*>(data), size);
+}
+
+template <typename T>
+int upscaledb_compare_as(const void* a, const void* b) {
+  const T x = upscaledb_load<T>(a);
+  const T y = upscaledb_load<T>(b);
+  return x < y ? -1 : (y < x ? 1 : 0);
+}
+
+// orders native keys of type like the btree does, binary keys bytewise
+int upscaledb_compare(uint32_t type, const void* data, uint32_t size, const std::string& raw) {
+  if (type == UPS_TYPE_UINT8 && size == sizeof(uint8_t)) {
+    return upscaledb_compare_as<uint8_t>(data, raw.data());
+  } else if (type == UPS_TYPE_UINT16 && size == sizeof(uint16_t)) {
+    return upscaledb_compare_as<uint16_t>(data, raw.data());
+  } else if (type == UPS_TYPE_UINT32 && size == sizeof(uint32_t)) {
+    return upscaledb_compare_as<uint32_t>(data, raw.data());
+  } else if (type == UPS_TYPE_UINT64 && size == sizeof(uint64_t)) {
+    return upscaledb_compare_as<uint64_t>(data, raw.data());
+  } else if (type == UPS_TYPE_REAL32 && size == sizeof(float)) {
+    return upscaledb_compare_as<float>(data, raw.data());
+  } else if (type == UPS_TYPE_REAL64 && size == sizeof(double)) {
+    return upscaledb_compare_as<double>(data, raw.data());
+  }
+
+  const size_t common_size = std::min<size_t>(size, raw.size());
+  int res = common_size ? memcmp(data, raw.data(), common_size) : 0;
+  if (res != 0) {
+    return res;
+  }
+  return size < raw.size() ? -1 : (size > raw.size() ? 1 : 0);
+}
+
+upscaledb_db* upscaledb_find_db(upscaledb* context, uint16_t name) {
+  for (uint32_t i = 0; i < context->dbs_count; ++i) {
+    if (context->dbs[i].name == name) {
+      return &context->dbs[i];
+    }
+  }
+
+  return NULL;
+}
+
+ups_status_t upscaledb_add_db(upscaledb* context, uint16_t name, ups_db_t* db) {
+  upscaledb_db* dbs = reinterpret_cast<upscaledb_db*>(
+      realloc(context->dbs, sizeof(upscaledb_db) * (context->dbs_count + 1)));
+  if (!dbs) {
+    return UPS_OUT_OF_MEMORY;
+  }
+
+  dbs[context->dbs_count].name = name;
+  dbs[context->dbs_count].db = db;
+  dbs[context->dbs_count].key_type = upscaledb_db_key_type(db);
+  context->dbs = dbs;
+  context->dbs_count++;
+  return UPS_SUCCESS;
+}
+
+void upscaledb_close_dbs(upscaledb* context) {
+  for (uint32_t i = 0; i < context->dbs_count; ++i) {
+    ups_status_t st = ups_db_close(context->dbs[i].db, 0);
+    DCHECK(st == UPS_SUCCESS);
+  }
+  free(context->dbs);
+  context->dbs = NULL;
+  context->dbs_count = 0;
+  context->db = NULL;
+}
+
+// opens every database of env, so switching between them is only a pointer change
+ups_status_t upscaledb_open_dbs(upscaledb* context) {
+  std::vector<uint16_t> names(16);
+  uint32_t count = 0;
+  ups_status_t st = UPS_SUCCESS;
+  while (true) {
+    count = static_cast<uint32_t>(names.size());
+    st = ups_env_get_database_names(context->env, &names[0], &count);
+    if (st != UPS_LIMITS_REACHED) {
+      break;
+    }
+    names.resize(names.size() * 2);
+  }
+
+  if (st != UPS_SUCCESS) {
+    return st;
+  }
+
+  for (uint32_t i = 0; i < count; ++i) {
+    if (upscaledb_find_db(context, names[i])) {  // created one
+      continue;
+    }
+
+    ups_db_t* db = NULL;
+    st = ups_env_open_db(context->env, &db, names[i], 0, NULL);
+    if (st != UPS_SUCCESS) {
+      return st;
+    }
+
+    st = upscaledb_add_db(context, names[i], db);
+    if (st != UPS_SUCCESS) {
+      ups_db_close(db, 0);
+      return st;
+    }
+  }
+
+  return UPS_SUCCESS;
+}
+
 ups_status_t upscaledb_open(upscaledb** context,
                             const char* dbpath,
                             uint16_t db,
-                            bool create_if_missing) {
+                            bool create_if_missing,
+                            uint32_t key_type) {
   upscaledb* lcontext = reinterpret_cast<upscaledb*>(calloc(1, sizeof(upscaledb)));
   bool need_to_create = false;
   if (create_if_missing) {
@@ -72,14 +297,31 @@ ups_status_t upscaledb_open(upscaledb** context,
     return st;
   }
 
-  st = need_to_create ? ups_env_create_db(lcontext->env, &lcontext->db, db, 0, NULL)
-                      : ups_env_open_db(lcontext->env, &lcontext->db, db, 0, NULL);
-  if (st != UPS_SUCCESS) {
+  if (need_to_create) {
+    ups_db_t* created = NULL;
+    ups_parameter_t params[] = {{UPS_PARAM_KEY_TYPE, key_type}, {0, 0}};
+    st = ups_env_create_db(lcontext->env, &created, db, 0,
+                           key_type == UPS_TYPE_BINARY ? NULL : params);
+    if (st == UPS_SUCCESS) {
+      st = upscaledb_add_db(lcontext, db, created);
+    }
+  }
+
+  if (st == UPS_SUCCESS) {
+    st = upscaledb_open_dbs(lcontext);
+  }
+
+  upscaledb_db* cur = st == UPS_SUCCESS ? upscaledb_find_db(lcontext, db) : NULL;
+  if (!cur) {
+    upscaledb_close_dbs(lcontext);
+    ups_env_close(lcontext->env, 0);
     free(lcontext);
-    return st;
+    return st == UPS_SUCCESS ? UPS_DATABASE_NOT_FOUND : st;
   }
 
+  lcontext->db = cur->db;
   lcontext->cur_db = db;
+  lcontext->key_type = cur->key_type;
   *context = lcontext;
   return UPS_SUCCESS;
 }
@@ -94,9 +336,8 @@ void upscaledb_close(upscaledb** context) {
     return;
   }
 
-  ups_status_t st = ups_db_close(lcontext->db, 0);
-  DCHECK(st == UPS_SUCCESS);
-  st = ups_env_close(lcontext->env, 0);
+  upscaledb_close_dbs(lcontext);
+  ups_status_t st = ups_env_close(lcontext->env, 0);
   DCHECK(st == UPS_SUCCESS);
   free(lcontext);
   *context = NULL;
@@ -169,7 +410,8 @@ common::Error CreateConnection(const Config& config, NativeConnection** context)
   }
 
   const char* dbname = common::utils::c_strornull(db_path);
-  int st = upscaledb_open(&lcontext, dbname, config.dbnum, config.create_if_missing);
+  int st = upscaledb_open(&lcontext, dbname, config.dbnum, config.create_if_missing,
+                          upscaledb_key_type(config.key_type));
   if (st != UPS_SUCCESS) {
     std::string buff = common::MemSPrintf("Fail open database: %s", ups_strerror(st));
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
@@ -235,15 +477,96 @@ common::Error DBConnection::Info(const char* args, ServerInfo::Stats* statsout)
   return common::Error();
 }
 
+common::Error DBConnection::DataBases(std::vector<IDataBaseInfoSPtr>* dbs) {
+  if (!dbs) {
+    DNOTREACHED();
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  if (!IsConnected()) {
+    return common::make_error_value("Not connected", common::Value::E_ERROR);
+  }
+
+  upscaledb* context = connection_.handle_;
+  for (uint32_t i = 0; i < context->dbs_count; ++i) {
+    uint64_t sz = 0;
+    ups_status_t st = ups_db_count(context->dbs[i].db, NULL, UPS_SKIP_DUPLICATES, &sz);
+    if (st != UPS_SUCCESS) {
+      std::string buff = common::MemSPrintf("DATABASES function error: %s", ups_strerror(st));
+      return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
+
+    uint16_t name = context->dbs[i].name;
+    IDataBaseInfoSPtr info(
+        new DataBaseInfo(common::ConvertToString(name), name == context->cur_db, sz));
+    dbs->push_back(info);
+  }
+
+  return common::Error();
+}
+
+common::Error DBConnection::Query(const std::string& query, FastoObject* out) {
+  if (!out) {
+    DNOTREACHED();
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  if (!IsConnected()) {
+    return common::make_error_value("Not connected", common::Value::E_ERROR);
+  }
+
+  uqi_result_t* result = NULL;
+  ups_status_t st = uqi_select(connection_.handle_->env, query.c_str(), &result);
+  if (st != UPS_SUCCESS) {
+    std::string buff = common::MemSPrintf("QUERY function error: %s", ups_strerror(st));
+    return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+  }
+
+  const uint32_t rows = uqi_result_get_row_count(result);
+  const uint32_t key_type = uqi_result_get_key_type(result);
+  const uint32_t record_type = uqi_result_get_record_type(result);
+  for (uint32_t i = 0; i < rows; ++i) {
+    if (IsInterrupted()) {
+      uqi_result_close(result);
+      return common::make_error_value("Interrupted.", common::ErrorValue::E_INTERRUPTED);
+    }
+
+    ups_key_t key;
+    memset(&key, 0, sizeof(key));
+    ups_record_t rec;
+    memset(&rec, 0, sizeof(rec));
+    uqi_result_get_key(result, i, &key);
+    uqi_result_get_record(result, i, &rec);
+
+    // aggregates (COUNT, SUM, ...) return the function name as key
+    std::string line = upscaledb_decode(record_type, rec.data, rec.size);
+    if (key.size) {
+      line = upscaledb_decode(key_type, key.data, key.size) + " " + line;
+    }
+    common::StringValue* val = common::Value::createStringValue(line);
+    FastoObject* child = new FastoObject(out, val, Delimiter());
+    out->AddChildren(child);
+  }
+
+  uqi_result_close(result);
+  return common::Error();
+}
+
 common::Error DBConnection::SetInner(const std::string& key, const std::string& value) {
   if (!IsConnected()) {
     return common::make_error_value("Not connected", common::Value::E_ERROR);
   }
 
+  std::string raw_key;
+  common::Error err = upscaledb_encode(connection_.handle_->key_type, key, &raw_key);
+  if (err && err->isError()) {
+    return err;
+  }
+
   ups_key_t dkey;
   memset(&dkey, 0, sizeof(dkey));
-  dkey.size = key.size();
-  dkey.data = const_cast<char*>(key.c_str());
+  dkey.size = raw_key.size();
+  dkey.data = const_cast<char*>(raw_key.c_str());
 
   ups_record_t rec;
   memset(&rec, 0, sizeof(rec));
@@ -263,10 +586,16 @@ common::Error DBConnection::GetInner(const std::string& key, std::string* ret_va
     return common::make_error_value("Not connected", common::Value::E_ERROR);
   }
 
+  std::string raw_key;
+  common::Error err = upscaledb_encode(connection_.handle_->key_type, key, &raw_key);
+  if (err && err->isError()) {
+    return err;
+  }
+
   ups_key_t dkey;
   memset(&dkey, 0, sizeof(dkey));
-  dkey.size = key.size();
-  dkey.data = const_cast<char*>(key.c_str());
+  dkey.size = raw_key.size();
+  dkey.data = const_cast<char*>(raw_key.c_str());
 
   ups_record_t rec;
   memset(&rec, 0, sizeof(rec));
@@ -286,11 +615,17 @@ common::Error DBConnection::DelInner(const std::string& key) {
     return common::make_error_value("Not connected", common::Value::E_ERROR);
   }
 
+  std::string raw_key;
+  common::Error err = upscaledb_encode(connection_.handle_->key_type, key, &raw_key);
+  if (err && err->isError()) {
+    return err;
+  }
+
   ups_key_t dkey;
   memset(&dkey, 0, sizeof(dkey));
 
-  dkey.size = key.size();
-  dkey.data = const_cast<char*>(key.c_str());
+  dkey.size = raw_key.size();
+  dkey.data = const_cast<char*>(raw_key.c_str());
 
   ups_status_t st = ups_db_erase(connection_.handle_->db, 0, &dkey, 0);
   if (st != UPS_SUCCESS) {
@@ -320,6 +655,9 @@ common::Error DBConnection::ScanImpl(uint64_t cursor_in,
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
+  KeyPattern kpattern(pattern);
+  const uint32_t key_type = connection_.handle_->key_type;
+  std::string typed_key;
   uint64_t offset_pos = cursor_in;
   uint64_t lcursor_out = 0;
   std::vector<std::string> lkeys_out;
@@ -329,10 +667,16 @@ common::Error DBConnection::ScanImpl(uint64_t cursor_in,
        * of the database */
       st = ups_cursor_move(cursor, &key, &rec, UPS_CURSOR_NEXT | UPS_SKIP_DUPLICATES);
       if (st == UPS_SUCCESS) {
-        std::string skey(reinterpret_cast<const char*>(key.data), key.size);
-        if (common::MatchPattern(skey, pattern)) {
+        const char* key_data = reinterpret_cast<const char*>(key.data);
+        size_t key_size = key.size;
+        if (key_type != UPS_TYPE_BINARY) {  // match typed keys by their text
+          typed_key = upscaledb_decode(key_type, key.data, key.size);
+          key_data = typed_key.data();
+          key_size = typed_key.size();
+        }
+        if (kpattern.Match(key_data, key_size)) {
           if (offset_pos == 0) {
-            lkeys_out.push_back(skey);
+            lkeys_out.push_back(std::string(key_data, key_size));
           } else {
             offset_pos--;
           }
@@ -354,10 +698,27 @@ common::Error DBConnection::ScanImpl(uint64_t cursor_in,
   return common::Error();
 }
 
+// bounds are keys as text, encoded to the key type so typed keys are
+// ordered by value and not by their decimal text
 common::Error DBConnection::KeysImpl(const std::string& key_start,
                                      const std::string& key_end,
                                      uint64_t limit,
                                      std::vector<std::string>* ret) {
+  const uint32_t key_type = connection_.handle_->key_type;
+  std::string raw_start;  // empty - from the first key
+  std::string raw_end;
+  common::Error err;
+  if (!key_start.empty()) {
+    err = upscaledb_encode(key_type, key_start, &raw_start);
+    if (err && err->isError()) {
+      return err;
+    }
+  }
+  err = upscaledb_encode(key_type, key_end, &raw_end);
+  if (err && err->isError()) {
+    return err;
+  }
+
   ups_cursor_t* cursor; /* upscaledb cursor object */
   ups_key_t key;
   ups_record_t rec;
@@ -372,21 +733,30 @@ common::Error DBConnection::KeysImpl(const std::string& key_start,
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
-  do {
-    st = ups_cursor_move(cursor, &key, &rec, UPS_CURSOR_NEXT | UPS_SKIP_DUPLICATES);
-    if (st == UPS_SUCCESS) {
-      std::string skey(reinterpret_cast<const char*>(key.data), key.size);
-      if (key_start < skey && key_end > skey) {
-        ret->push_back(skey);
-      }
-    } else if (st && st != UPS_KEY_NOT_FOUND) {
-      ups_cursor_close(cursor);
-      std::string buff = common::MemSPrintf("SCAN function error: %s", ups_strerror(st));
-      return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+  if (raw_start.empty()) {
+    st = ups_cursor_move(cursor, &key, &rec, UPS_CURSOR_FIRST);
+  } else {  // key points to the found one after the call
+    key.data = const_cast<char*>(raw_start.data());
+    key.size = raw_start.size();
+    st = ups_cursor_find(cursor, &key, &rec, UPS_FIND_GEQ_MATCH);
+  }
+
+  // (key_start, key_end)
+  while (st == UPS_SUCCESS && limit > ret->size()) {
+    if (upscaledb_compare(key_type, key.data, key.size, raw_end) >= 0) {
+      break;
+    }
+    if (raw_start.empty() || upscaledb_compare(key_type, key.data, key.size, raw_start) > 0) {
+      ret->push_back(upscaledb_decode(key_type, key.data, key.size));
     }
-  } while (st == UPS_SUCCESS && limit > ret->size());
+    st = ups_cursor_move(cursor, &key, &rec, UPS_CURSOR_NEXT | UPS_SKIP_DUPLICATES);
+  }
 
   ups_cursor_close(cursor);
+  if (st != UPS_SUCCESS && st != UPS_KEY_NOT_FOUND) {
+    std::string buff = common::MemSPrintf("KEYS function error: %s", ups_strerror(st));
+    return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+  }
   return common::Error();
 }
 
@@ -436,20 +806,17 @@ common::Error DBConnection::FlushDBImpl() {
 
 common::Error DBConnection::SelectImpl(const std::string& name, IDataBaseInfo** info) {
   uint16_t num = common::ConvertFromString<uint16_t>(name);
-  ups_db_t* db = NULL;
-  ups_status_t st = ups_env_open_db(connection_.handle_->env, &db, num, 0, NULL);
-  if (st != UPS_SUCCESS && st != UPS_DATABASE_ALREADY_OPEN) {
-    std::string buff = common::MemSPrintf("SELECT function error: %s", ups_strerror(st));
+  upscaledb_db* sel = upscaledb_find_db(connection_.handle_, num);
+  if (!sel) {
+    std::string buff =
+        common::MemSPrintf("SELECT function error: %s", ups_strerror(UPS_DATABASE_NOT_FOUND));
     return common::make_error_value(buff, common::ErrorValue::E_ERROR);
   }
 
-  if (st == UPS_SUCCESS) {  // if ready to change
-    st = ups_db_close(connection_.handle_->db, 0);
-    DCHECK(st == UPS_SUCCESS);
-    connection_.handle_->db = db;
-    connection_.config_.dbnum = num;
-    connection_.handle_->cur_db = num;
-  }
+  connection_.handle_->db = sel->db;
+  connection_.handle_->cur_db = num;
+  connection_.handle_->key_type = sel->key_type;
+  connection_.config_.dbnum = num;
 
   size_t kcount = 0;
   common::Error err = DBkcount(&kcount);
@@ -30,6 +30,7 @@
 #include "core/connection_types.h"         // for connectionTypes::UPSCALEDB
 #include "core/db_key.h"                   // for NDbKValue, NKey, NKeys
 #include "core/internal/cdb_connection.h"  // for CDBConnection
+#include "core/database/idatabase_info.h"  // for IDataBaseInfoSPtr
 
 #include "core/db/upscaledb/server_info.h"  // for ServerInfo
 #include "core/db/upscaledb/config.h"
@@ -42,6 +43,7 @@ class CDBConnectionClient;
 namespace fastonosql {
 namespace core {
 class IDataBaseInfo;
+class FastoObject;
 }
 }
 namespace fastonosql {
@@ -70,6 +72,10 @@ class DBConnection : public core::internal::CDBConnection<NativeConnection, Conf
 
   std::string CurrentDBName() const;
   common::Error Info(const char* args, ServerInfo::Stats* statsout) WARN_UNUSED_RESULT;
+  // every database of the environment with its keys count, current one is default
+  common::Error DataBases(std::vector<IDataBaseInfoSPtr>* dbs) WARN_UNUSED_RESULT;
+  // UQI select executed inside the engine, one reply per result row
+  common::Error Query(const std::string& query, FastoObject* out) WARN_UNUSED_RESULT;
 
  private:
   common::Error SetInner(const std::string& key, const std::string& value) WARN_UNUSED_RESULT;
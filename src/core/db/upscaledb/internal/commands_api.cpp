@@ -19,6 +19,7 @@
 #include "core/db/upscaledb/internal/commands_api.h"
 
 #include <memory>  // for __shared_ptr
+#include <string>  // for string
 
 #include <common/value.h>  // for ErrorValue, StringValue, etc
 
@@ -48,6 +49,21 @@ common::Error CommandsApi::Info(internal::CommandHandler* handler,
   return common::Error();
 }
 
+common::Error CommandsApi::Query(internal::CommandHandler* handler,
+                                 int argc,
+                                 const char** argv,
+                                 FastoObject* out) {
+  DBConnection* mdb = static_cast<DBConnection*>(handler);
+  std::string query;  // unquoted queries come split into words
+  for (int i = 0; i < argc; ++i) {
+    if (i) {
+      query += " ";
+    }
+    query += argv[i];
+  }
+  return mdb->Query(query, out);
+}
+
 }  // namespace upscaledb
 }  // namespace core
 }  // namespace fastonosql
@@ -55,6 +55,10 @@ struct CommandsApi : public internal::ApiTraits<DBConnection> {
                             int argc,
                             const char** argv,
                             FastoObject* out);
+  static common::Error Query(internal::CommandHandler* handler,
+                             int argc,
+                             const char** argv,
+                             FastoObject* out);
 };
 
 static const std::vector<CommandHolder> g_commands = {
@@ -74,6 +78,15 @@ static const std::vector<CommandHolder> g_commands = {
                   1,
                   0,
                   &CommandsApi::Info),
+    CommandHolder("QUERY",
+                  "<uqi> [uqi ...]",
+                  "Run UQI select inside the engine, e.g. "
+                  "COUNT($key) FROM DATABASE 1 WHERE $key > 100",
+                  UNDEFINED_SINCE,
+                  UNDEFINED_EXAMPLE_STR,
+                  1,
+                  INFINITE_COMMAND_ARGS,
+                  &CommandsApi::Query),
     CommandHolder("SCAN",
                   "<cursor> [MATCH pattern] [COUNT count]",
                   "Incrementally iterate the keys space",
@@ -0,0 +1,847 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "core/fasto_object_writer.h"
+
+#include <errno.h>     // for errno
+#include <inttypes.h>  // for PRIu64
+#include <string.h>    // for strerror
+
+#ifdef OS_WIN
+#include <windows.h>  // for MultiByteToWideChar
+#endif
+
+#include <common/convert2string.h>  // for ConvertToString
+#include <common/sprintf.h>         // for MemSPrintf
+
+namespace fastonosql {
+namespace core {
+
+namespace {
+
+bool IsIntegerType(common::Value::Type type) {
+  return type == common::Value::TYPE_INTEGER || type == common::Value::TYPE_UINTEGER ||
+         type == common::Value::TYPE_LONG_INTEGER || type == common::Value::TYPE_ULONG_INTEGER ||
+         type == common::Value::TYPE_LONG_LONG_INTEGER ||
+         type == common::Value::TYPE_ULONG_LONG_INTEGER;
+}
+
+bool IsListType(common::Value::Type type) {
+  return type == common::Value::TYPE_ARRAY || type == common::Value::TYPE_SET;
+}
+
+bool IsMapType(common::Value::Type type) {
+  return type == common::Value::TYPE_HASH || type == common::Value::TYPE_ZSET;
+}
+
+// calls func(element) for arrays and sets, func(key, value) for hashes and zsets
+template <typename ListFunc, typename MapFunc>
+common::Error ForEachElement(common::Value* value, ListFunc list_func, MapFunc map_func) {
+  common::Value::Type type = value->type();
+  if (type == common::Value::TYPE_ARRAY) {
+    common::ArrayValue* array = static_cast<common::ArrayValue*>(value);
+    for (auto it = array->begin(); it != array->end(); ++it) {
+      common::Error err = list_func(*it);
+      if (err && err->isError()) {
+        return err;
+      }
+    }
+  } else if (type == common::Value::TYPE_SET) {
+    common::SetValue* set = static_cast<common::SetValue*>(value);
+    for (auto it = set->begin(); it != set->end(); ++it) {
+      common::Error err = list_func(*it);
+      if (err && err->isError()) {
+        return err;
+      }
+    }
+  } else if (type == common::Value::TYPE_ZSET) {
+    common::ZSetValue* zset = static_cast<common::ZSetValue*>(value);
+    for (auto it = zset->begin(); it != zset->end(); ++it) {
+      common::Error err = map_func((*it).first, (*it).second);
+      if (err && err->isError()) {
+        return err;
+      }
+    }
+  } else if (type == common::Value::TYPE_HASH) {
+    common::HashValue* hash = static_cast<common::HashValue*>(value);
+    for (auto it = hash->begin(); it != hash->end(); ++it) {
+      common::Error err = map_func((*it).first, (*it).second);
+      if (err && err->isError()) {
+        return err;
+      }
+    }
+  }
+
+  return common::Error();
+}
+
+size_t ElementsCount(common::Value* value) {
+  common::Value::Type type = value->type();
+  if (type == common::Value::TYPE_ARRAY) {
+    return static_cast<common::ArrayValue*>(value)->size();
+  } else if (type == common::Value::TYPE_SET) {
+    return static_cast<common::SetValue*>(value)->size();
+  } else if (type == common::Value::TYPE_ZSET) {
+    return static_cast<common::ZSetValue*>(value)->size() * 2;
+  } else if (type == common::Value::TYPE_HASH) {
+    return static_cast<common::HashValue*>(value)->size() * 2;
+  }
+
+  return 0;
+}
+
+}  // namespace
+
+IWriterSink::~IWriterSink() {}
+
+StringSink::StringSink(std::string* out, size_t limit)
+    : out_(out), limit_(limit), truncated_(false) {
+  CHECK(out_);
+}
+
+common::Error StringSink::Write(const char* data, size_t size) {
+  if (truncated_) {
+    return common::make_error_value(OUTPUT_LIMIT_REACHED, common::ErrorValue::E_ERROR);
+  }
+
+  if (limit_ && out_->size() + size > limit_) {
+    out_->append(data, limit_ - out_->size());
+    truncated_ = true;
+    return common::make_error_value(OUTPUT_LIMIT_REACHED, common::ErrorValue::E_ERROR);
+  }
+
+  out_->append(data, size);
+  return common::Error();
+}
+
+bool StringSink::IsTruncated() const {
+  return truncated_;
+}
+
+FileSink::FileSink() : file_(nullptr), path_(), buffer_(), written_(0) {}
+
+FileSink::~FileSink() {
+  common::Error err = Close();
+  DCHECK(!err);
+}
+
+common::Error FileSink::Open(const std::string& path) {
+  if (file_) {
+    return common::make_error_value("File already opened", common::ErrorValue::E_ERROR);
+  }
+
+#ifdef OS_WIN
+  // path is UTF-8 (from QString), narrow fopen would take it in the ANSI code page
+  FILE* file = nullptr;
+  int wsize = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+  if (wsize > 0) {
+    std::wstring wpath(static_cast<size_t>(wsize), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wpath[0], wsize);
+    file = _wfopen(wpath.c_str(), L"wb");
+  }
+#else
+  FILE* file = fopen(path.c_str(), "wb");
+#endif
+  if (!file) {
+    std::string buff = common::MemSPrintf("Can't open file %s: %s", path, strerror(errno));
+    return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+  }
+
+  file_ = file;
+  path_ = path;
+  buffer_.reserve(FILE_SINK_BUFFER_SIZE);
+  written_ = 0;
+  return common::Error();
+}
+
+common::Error FileSink::Close() {
+  if (!file_) {
+    return common::Error();
+  }
+
+  common::Error err = Flush();
+  if (fclose(file_) != 0 && !err) {
+    std::string buff = common::MemSPrintf("Can't close file %s: %s", path_, strerror(errno));
+    err = common::make_error_value(buff, common::ErrorValue::E_ERROR);
+  }
+  file_ = nullptr;
+  return err;
+}
+
+common::Error FileSink::Write(const char* data, size_t size) {
+  if (!file_) {
+    return common::make_error_value("File not opened", common::ErrorValue::E_ERROR);
+  }
+
+  if (buffer_.size() + size > FILE_SINK_BUFFER_SIZE) {
+    common::Error err = Flush();
+    if (err && err->isError()) {
+      return err;
+    }
+  }
+
+  written_ += size;
+  if (size >= FILE_SINK_BUFFER_SIZE) {  // big pieces go around the buffer
+    if (fwrite(data, 1, size, file_) != size) {
+      std::string buff = common::MemSPrintf("Can't write file %s: %s", path_, strerror(errno));
+      return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
+    return common::Error();
+  }
+
+  buffer_.append(data, size);
+  return common::Error();
+}
+
+common::Error FileSink::Flush() {
+  if (!file_ || buffer_.empty()) {
+    return common::Error();
+  }
+
+  size_t size = buffer_.size();
+  size_t written = fwrite(buffer_.data(), 1, size, file_);
+  buffer_.clear();
+  if (written != size) {
+    std::string buff = common::MemSPrintf("Can't write file %s: %s", path_, strerror(errno));
+    return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+  }
+
+  return common::Error();
+}
+
+size_t FileSink::BytesWritten() const {
+  return written_;
+}
+
+FastoObjectWriter::FastoObjectWriter(IWriterSink* sink) : sink_(sink), rows_(0) {
+  CHECK(sink_);
+}
+
+FastoObjectWriter::~FastoObjectWriter() {}
+
+common::Error FastoObjectWriter::Write(FastoObject* root) {
+  common::Error err = Start();
+  if (err && err->isError()) {
+    return err;
+  }
+
+  err = Append(root);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  return Finish();
+}
+
+common::Error FastoObjectWriter::Start() {
+  rows_ = 0;
+  return BeginDocument();
+}
+
+common::Error FastoObjectWriter::Append(FastoObject* root) {
+  if (!root) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  struct Frame {
+    FastoObject* obj;
+    size_t next_child;
+  };
+
+  common::Error err = BeginNode(root);
+  if (err && err->isError()) {
+    return err;
+  }
+  CountRows(root);
+
+  // explicit stack, deeply nested replies must not exhaust the thread stack
+  std::vector<Frame> stack;
+  stack.push_back({root, 0});
+  while (!stack.empty()) {
+    Frame& top = stack.back();
+    if (top.next_child < top.obj->ChildrenCount()) {
+      FastoObject* child = top.obj->ChildAt(top.next_child++).get();
+      err = BeginNode(child);
+      if (err && err->isError()) {
+        return err;
+      }
+      CountRows(child);
+      stack.push_back({child, 0});
+      continue;
+    }
+
+    err = EndNode(top.obj);
+    if (err && err->isError()) {
+      return err;
+    }
+    stack.pop_back();
+  }
+
+  return common::Error();
+}
+
+common::Error FastoObjectWriter::Finish() {
+  return EndDocument();
+}
+
+common::Error FastoObjectWriter::BeginArray(size_t count, const std::string& delimiter) {
+  return BeginStreamedArray(count, delimiter);
+}
+
+common::Error FastoObjectWriter::AppendElement(common::Value* element) {
+  if (!element) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  rows_++;
+  return PutStreamedElement(element);
+}
+
+common::Error FastoObjectWriter::EndArray() {
+  return EndStreamedArray();
+}
+
+size_t FastoObjectWriter::RowsWritten() const {
+  return rows_;
+}
+
+void FastoObjectWriter::CountRows(FastoObject* obj) {
+  if (IsContainerNode(obj)) {
+    return;
+  }
+
+  common::Value* value = obj->Value().get();
+  if (!value) {
+    return;
+  }
+
+  common::Value::Type type = value->type();
+  if (IsListType(type)) {
+    rows_ += ElementsCount(value);
+  } else if (IsMapType(type)) {
+    rows_ += ElementsCount(value) / 2;
+  } else {
+    rows_++;
+  }
+}
+
+common::Error FastoObjectWriter::BeginDocument() {
+  return common::Error();
+}
+
+common::Error FastoObjectWriter::EndDocument() {
+  return common::Error();
+}
+
+common::Error FastoObjectWriter::EndNode(FastoObject* obj) {
+  UNUSED(obj);
+  return common::Error();
+}
+
+bool FastoObjectWriter::IsContainerNode(FastoObject* obj) {
+  return !obj->Parent() || dynamic_cast<FastoObjectCommand*>(obj);  // +
+}
+
+common::Error FastoObjectWriter::Put(const char* data, size_t size) {
+  if (!size) {
+    return common::Error();
+  }
+
+  return sink_->Write(data, size);
+}
+
+common::Error FastoObjectWriter::Put(const std::string& data) {
+  return Put(data.data(), data.size());
+}
+
+common::Error FastoObjectWriter::Put(char c) {
+  return Put(&c, 1);
+}
+
+RawWriter::RawWriter(IWriterSink* sink)
+    : FastoObjectWriter(sink), stream_delimiter_(), stream_left_(0), stream_written_(false) {}
+
+common::Error RawWriter::BeginNode(FastoObject* obj) {
+  if (dynamic_cast<FastoObjectCommand*>(obj)) {  // +
+    return common::Error();
+  }
+
+  bool written = false;
+  const std::string delimiter = obj->Delimiter();
+  common::Error err = PutValue(obj->Value().get(), delimiter, &written);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  return written ? Put(delimiter) : common::Error();
+}
+
+common::Error RawWriter::PutValue(common::Value* value,
+                                  const std::string& delimiter,
+                                  bool* written) {
+  if (!value) {
+    return common::Error();
+  }
+
+  common::Value::Type type = value->type();
+  if (!IsListType(type) && !IsMapType(type)) {
+    std::string str = value->toString();
+    *written = !str.empty();
+    return Put(str);
+  }
+
+  if (ElementsCount(value) == 0) {
+    *written = true;
+    if (type == common::Value::TYPE_ARRAY) {
+      return Put("(empty list)");
+    } else if (type == common::Value::TYPE_SET) {
+      return Put("(empty set)");
+    } else if (type == common::Value::TYPE_ZSET) {
+      return Put("(empty zset)");
+    }
+    return Put("(empty hash)");
+  }
+
+  size_t left = IsMapType(type) ? ElementsCount(value) / 2 : ElementsCount(value);
+  return ForEachElement(
+      value,
+      [&](common::Value* element) {
+        return PutElement(element->toString(), delimiter, &left, written);
+      },
+      [&](common::Value* key, common::Value* val) {
+        std::string skey = key->toString();
+        std::string sval = val->toString();
+        return PutElement(skey.empty() || sval.empty() ? std::string() : skey + " " + sval,
+                          delimiter, &left, written);
+      });
+}
+
+// delimiter between elements, skipped ones included, like ConvertToString
+common::Error RawWriter::PutElement(const std::string& str,
+                                    const std::string& delimiter,
+                                    size_t* left,
+                                    bool* written) {
+  (*left)--;
+  if (str.empty()) {
+    return common::Error();
+  }
+
+  *written = true;
+  common::Error err = Put(str);
+  if (err && err->isError()) {
+    return err;
+  }
+  return *left ? Put(delimiter) : common::Error();
+}
+
+common::Error RawWriter::BeginStreamedArray(size_t count, const std::string& delimiter) {
+  stream_delimiter_ = delimiter;
+  stream_left_ = count;
+  stream_written_ = false;
+  if (count != 0) {
+    return common::Error();
+  }
+
+  common::Error err = Put("(empty list)");
+  if (err && err->isError()) {
+    return err;
+  }
+  return Put(delimiter);
+}
+
+common::Error RawWriter::PutStreamedElement(common::Value* element) {
+  return PutElement(element->toString(), stream_delimiter_, &stream_left_, &stream_written_);
+}
+
+common::Error RawWriter::EndStreamedArray() {
+  return stream_written_ ? Put(stream_delimiter_) : common::Error();
+}
+
+JsonWriter::JsonWriter(IWriterSink* sink) : FastoObjectWriter(sink), first_() {}
+
+common::Error JsonWriter::BeginDocument() {
+  first_.push_back(true);
+  return Put('[');
+}
+
+common::Error JsonWriter::EndDocument() {
+  first_.pop_back();
+  return Put(']');
+}
+
+common::Error JsonWriter::BeginNode(FastoObject* obj) {
+  if (IsContainerNode(obj)) {
+    return common::Error();
+  }
+
+  common::Value* value = obj->Value().get();
+  common::Error err = Separate();
+  if (err && err->isError()) {
+    return err;
+  }
+
+  if (!value) {
+    return Put("null");
+  }
+
+  common::Value::Type type = value->type();
+  if (!IsListType(type) && !IsMapType(type)) {
+    return PutScalar(value);
+  }
+
+  err = Put(IsListType(type) ? '[' : '{');
+  if (err && err->isError()) {
+    return err;
+  }
+
+  bool first = true;
+  err = ForEachElement(value,
+                       [&](common::Value* element) -> common::Error {
+                         if (!first) {
+                           common::Error err = Put(',');
+                           if (err && err->isError()) {
+                             return err;
+                           }
+                         }
+                         first = false;
+                         return PutScalar(element);
+                       },
+                       [&](common::Value* key, common::Value* val) -> common::Error {
+                         if (!first) {
+                           common::Error err = Put(',');
+                           if (err && err->isError()) {
+                             return err;
+                           }
+                         }
+                         first = false;
+                         common::Error err = PutString(key->toString());
+                         if (err && err->isError()) {
+                           return err;
+                         }
+                         err = Put(':');
+                         if (err && err->isError()) {
+                           return err;
+                         }
+                         return PutScalar(val);
+                       });
+  if (err && err->isError()) {
+    return err;
+  }
+
+  if (IsMapType(type)) {
+    return Put('}');
+  }
+
+  // array stays open for nested replies added as children
+  first_.push_back(first);
+  return common::Error();
+}
+
+common::Error JsonWriter::EndNode(FastoObject* obj) {
+  if (IsContainerNode(obj)) {
+    return common::Error();
+  }
+
+  common::Value* value = obj->Value().get();
+  if (!value || !IsListType(value->type())) {
+    return common::Error();
+  }
+
+  first_.pop_back();
+  return Put(']');
+}
+
+common::Error JsonWriter::BeginStreamedArray(size_t count, const std::string& delimiter) {
+  UNUSED(count);
+  UNUSED(delimiter);
+  common::Error err = Separate();
+  if (err && err->isError()) {
+    return err;
+  }
+
+  first_.push_back(true);
+  return Put('[');
+}
+
+common::Error JsonWriter::PutStreamedElement(common::Value* element) {
+  common::Error err = Separate();
+  if (err && err->isError()) {
+    return err;
+  }
+
+  return PutScalar(element);
+}
+
+common::Error JsonWriter::EndStreamedArray() {
+  first_.pop_back();
+  return Put(']');
+}
+
+common::Error JsonWriter::Separate() {
+  if (!first_.back()) {
+    return Put(',');
+  }
+
+  first_.back() = false;
+  return common::Error();
+}
+
+common::Error JsonWriter::PutScalar(common::Value* value) {
+  if (!value) {
+    return Put("null");
+  }
+
+  common::Value::Type type = value->type();
+  if (type == common::Value::TYPE_NULL) {
+    return Put("null");
+  } else if (type == common::Value::TYPE_BOOLEAN) {
+    bool val = false;
+    value->getAsBoolean(&val);
+    return Put(val ? "true" : "false");
+  } else if (IsIntegerType(type) || type == common::Value::TYPE_DOUBLE) {
+    return Put(value->toString());
+  }
+
+  return PutString(value->toString());
+}
+
+common::Error JsonWriter::PutString(const std::string& str) {
+  std::string escaped;
+  escaped.reserve(str.size() + 2);
+  escaped += '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else if (c == '\r') {
+      escaped += "\\r";
+    } else if (c == '\t') {
+      escaped += "\\t";
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      escaped += common::MemSPrintf("\\u%04x", static_cast<int>(c));
+    } else {
+      escaped += c;
+    }
+  }
+  escaped += '"';
+  return Put(escaped);
+}
+
+CsvWriter::CsvWriter(IWriterSink* sink) : FastoObjectWriter(sink), depth_(0), first_field_(true) {}
+
+common::Error CsvWriter::BeginNode(FastoObject* obj) {
+  if (IsContainerNode(obj)) {
+    return common::Error();
+  }
+
+  if (depth_++ == 0) {
+    first_field_ = true;
+  }
+
+  common::Value* value = obj->Value().get();
+  if (!value) {
+    return common::Error();
+  }
+
+  common::Value::Type type = value->type();
+  if (!IsListType(type) && !IsMapType(type)) {
+    return PutField(value->toString());
+  }
+
+  return ForEachElement(value,
+                        [&](common::Value* element) { return PutField(element->toString()); },
+                        [&](common::Value* key, common::Value* val) {
+                          common::Error err = PutField(key->toString());
+                          if (err && err->isError()) {
+                            return err;
+                          }
+                          return PutField(val->toString());
+                        });
+}
+
+common::Error CsvWriter::EndNode(FastoObject* obj) {
+  if (IsContainerNode(obj)) {
+    return common::Error();
+  }
+
+  if (--depth_ == 0) {
+    return Put('\n');
+  }
+
+  return common::Error();
+}
+
+common::Error CsvWriter::BeginStreamedArray(size_t count, const std::string& delimiter) {
+  UNUSED(count);
+  UNUSED(delimiter);
+  DCHECK(depth_ == 0);  // a reply of its own, one line
+  first_field_ = true;
+  return common::Error();
+}
+
+common::Error CsvWriter::PutStreamedElement(common::Value* element) {
+  return PutField(element->toString());
+}
+
+common::Error CsvWriter::EndStreamedArray() {
+  return Put('\n');
+}
+
+common::Error CsvWriter::PutField(const std::string& field) {
+  if (!first_field_) {
+    common::Error err = Put(',');
+    if (err && err->isError()) {
+      return err;
+    }
+  }
+  first_field_ = false;
+
+  if (field.find_first_of(",\"\r\n") == std::string::npos) {
+    return Put(field);
+  }
+
+  std::string quoted;
+  quoted.reserve(field.size() + 2);
+  quoted += '"';
+  for (char c : field) {
+    if (c == '"') {
+      quoted += '"';
+    }
+    quoted += c;
+  }
+  quoted += '"';
+  return Put(quoted);
+}
+
+RespWriter::RespWriter(IWriterSink* sink) : FastoObjectWriter(sink) {}
+
+common::Error RespWriter::BeginNode(FastoObject* obj) {
+  if (IsContainerNode(obj)) {
+    return common::Error();
+  }
+
+  common::Value* value = obj->Value().get();
+  if (!value) {
+    return Put("$-1\r\n");
+  }
+
+  common::Value::Type type = value->type();
+  if (!IsListType(type) && !IsMapType(type)) {
+    return PutScalar(value);
+  }
+
+  size_t count = ElementsCount(value);
+  if (IsListType(type)) {
+    count += obj->ChildrenCount();
+  }
+
+  common::Error err = Put(common::MemSPrintf("*%" PRIu64 "\r\n", static_cast<uint64_t>(count)));
+  if (err && err->isError()) {
+    return err;
+  }
+
+  return ForEachElement(value, [&](common::Value* element) { return PutScalar(element); },
+                        [&](common::Value* key, common::Value* val) {
+                          common::Error err = PutScalar(key);
+                          if (err && err->isError()) {
+                            return err;
+                          }
+                          return PutScalar(val);
+                        });
+}
+
+common::Error RespWriter::BeginStreamedArray(size_t count, const std::string& delimiter) {
+  UNUSED(delimiter);
+  return Put(common::MemSPrintf("*%" PRIu64 "\r\n", static_cast<uint64_t>(count)));
+}
+
+common::Error RespWriter::PutStreamedElement(common::Value* element) {
+  return PutScalar(element);
+}
+
+common::Error RespWriter::EndStreamedArray() {
+  return common::Error();
+}
+
+common::Error RespWriter::PutScalar(common::Value* value) {
+  common::Value::Type type = value->type();
+  if (type == common::Value::TYPE_NULL) {
+    return Put("$-1\r\n");
+  } else if (type == common::Value::TYPE_BOOLEAN) {
+    bool val = false;
+    value->getAsBoolean(&val);
+    return Put(val ? ":1\r\n" : ":0\r\n");
+  } else if (IsIntegerType(type)) {
+    return Put(":" + value->toString() + "\r\n");
+  } else if (type == common::Value::TYPE_ERROR) {
+    std::string str = value->toString();
+    for (char& c : str) {  // error lines can't span lines
+      if (c == '\r' || c == '\n') {
+        c = ' ';
+      }
+    }
+    return Put("-" + str + "\r\n");
+  }
+
+  return PutBulk(value->toString());
+}
+
+common::Error RespWriter::PutBulk(const std::string& str) {
+  common::Error err = Put(common::MemSPrintf("$%" PRIu64 "\r\n", static_cast<uint64_t>(str.size())));
+  if (err && err->isError()) {
+    return err;
+  }
+
+  err = Put(str);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  return Put("\r\n", 2);
+}
+
+FastoObjectWriter* CreateFastoObjectWriter(OutputFormat format, IWriterSink* sink) {
+  if (format == RAW_OUTPUT) {
+    return new RawWriter(sink);
+  } else if (format == JSON_OUTPUT) {
+    return new JsonWriter(sink);
+  } else if (format == CSV_OUTPUT) {
+    return new CsvWriter(sink);
+  } else if (format == RESP_OUTPUT) {
+    return new RespWriter(sink);
+  }
+
+  NOTREACHED();
+  return nullptr;
+}
+
+common::Error WriteFastoObject(FastoObject* root, OutputFormat format, IWriterSink* sink) {
+  FastoObjectWriter* writer = CreateFastoObjectWriter(format, sink);
+  if (!writer) {
+    return common::make_error_value("Unknown output format", common::ErrorValue::E_ERROR);
+  }
+
+  common::Error err = writer->Write(root);
+  delete writer;
+  return err;
+}
+
+}  // namespace core
+}  // namespace fastonosql
@@ -0,0 +1,229 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <stdio.h>   // for FILE
+
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include <common/error.h>   // for Error
+#include <common/macros.h>  // for DISALLOW_COPY_AND_ASSIGN, WARN_UNUSED_RESULT
+#include <common/value.h>   // for Value
+
+#include "core/global.h"  // for FastoObject
+
+#define FILE_SINK_BUFFER_SIZE (64 * 1024)
+#define OUTPUT_LIMIT_REACHED "Output limit reached"
+
+namespace fastonosql {
+namespace core {
+
+// Where serialized output goes, written in pieces as the tree is walked.
+class IWriterSink {
+ public:
+  virtual common::Error Write(const char* data, size_t size) WARN_UNUSED_RESULT = 0;
+  virtual ~IWriterSink();
+};
+
+// Appends to a string, optionally stopping with OUTPUT_LIMIT_REACHED after
+// limit bytes (0 - unlimited) so huge replies can be previewed cheaply.
+class StringSink : public IWriterSink {
+ public:
+  explicit StringSink(std::string* out, size_t limit = 0);
+
+  virtual common::Error Write(const char* data, size_t size) override;
+  bool IsTruncated() const;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(StringSink);
+
+  std::string* const out_;
+  const size_t limit_;
+  bool truncated_;
+};
+
+// Buffered file output, writes reach the disk in FILE_SINK_BUFFER_SIZE chunks.
+class FileSink : public IWriterSink {
+ public:
+  FileSink();
+  virtual ~FileSink();
+
+  common::Error Open(const std::string& path) WARN_UNUSED_RESULT;
+  common::Error Close() WARN_UNUSED_RESULT;
+
+  virtual common::Error Write(const char* data, size_t size) override;
+  common::Error Flush() WARN_UNUSED_RESULT;
+
+  size_t BytesWritten() const;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(FileSink);
+
+  FILE* file_;
+  std::string path_;
+  std::string buffer_;
+  size_t written_;
+};
+
+enum OutputFormat { RAW_OUTPUT = 0, JSON_OUTPUT, CSV_OUTPUT, RESP_OUTPUT };
+
+// Single pass serializer of a FastoObject tree. The tree is walked
+// iteratively without copying children vectors, values are streamed element
+// by element straight into the sink, so output is linear in the reply size.
+// Container nodes (the root and commands) only contribute their children.
+class FastoObjectWriter {
+ public:
+  explicit FastoObjectWriter(IWriterSink* sink);
+  virtual ~FastoObjectWriter();
+
+  // Start, Append(root)..., Finish
+  common::Error Write(FastoObject* root) WARN_UNUSED_RESULT;
+
+  // One document out of several trees, so replies can be written and freed
+  // command by command.
+  common::Error Start() WARN_UNUSED_RESULT;
+  common::Error Append(FastoObject* root) WARN_UNUSED_RESULT;
+  common::Error Finish() WARN_UNUSED_RESULT;
+
+  // A flat array reply written element by element while it is read, without
+  // building its node; same output as a list node of these elements.
+  common::Error BeginArray(size_t count, const std::string& delimiter) WARN_UNUSED_RESULT;
+  common::Error AppendElement(common::Value* element) WARN_UNUSED_RESULT;
+  common::Error EndArray() WARN_UNUSED_RESULT;
+
+  // Scalars count as one row, containers as one per element (pair for maps).
+  size_t RowsWritten() const;
+
+ protected:
+  virtual common::Error BeginDocument();
+  virtual common::Error EndDocument();
+  virtual common::Error BeginNode(FastoObject* obj) = 0;
+  virtual common::Error EndNode(FastoObject* obj);
+  virtual common::Error BeginStreamedArray(size_t count, const std::string& delimiter) = 0;
+  virtual common::Error PutStreamedElement(common::Value* element) = 0;
+  virtual common::Error EndStreamedArray() = 0;
+
+  static bool IsContainerNode(FastoObject* obj);
+
+  common::Error Put(const char* data, size_t size) WARN_UNUSED_RESULT;
+  common::Error Put(const std::string& data) WARN_UNUSED_RESULT;
+  common::Error Put(char c) WARN_UNUSED_RESULT;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(FastoObjectWriter);
+
+  void CountRows(FastoObject* obj);
+
+  IWriterSink* const sink_;
+  size_t rows_;
+};
+
+// Same text as common::ConvertToString(FastoObject*), each value followed by
+// its delimiter.
+class RawWriter : public FastoObjectWriter {
+ public:
+  explicit RawWriter(IWriterSink* sink);
+
+ protected:
+  virtual common::Error BeginNode(FastoObject* obj) override;
+  virtual common::Error BeginStreamedArray(size_t count, const std::string& delimiter) override;
+  virtual common::Error PutStreamedElement(common::Value* element) override;
+  virtual common::Error EndStreamedArray() override;
+
+ private:
+  common::Error PutValue(common::Value* value, const std::string& delimiter, bool* written);
+  common::Error PutElement(const std::string& str,
+                           const std::string& delimiter,
+                           size_t* left,
+                           bool* written);
+
+  std::string stream_delimiter_;
+  size_t stream_left_;
+  bool stream_written_;
+};
+
+// One JSON array of all replies, arrays and sets as arrays, hashes and zsets as
+// objects, nested replies nested.
+class JsonWriter : public FastoObjectWriter {
+ public:
+  explicit JsonWriter(IWriterSink* sink);
+
+ protected:
+  virtual common::Error BeginDocument() override;
+  virtual common::Error EndDocument() override;
+  virtual common::Error BeginNode(FastoObject* obj) override;
+  virtual common::Error EndNode(FastoObject* obj) override;
+  virtual common::Error BeginStreamedArray(size_t count, const std::string& delimiter) override;
+  virtual common::Error PutStreamedElement(common::Value* element) override;
+  virtual common::Error EndStreamedArray() override;
+
+ private:
+  common::Error Separate();
+  common::Error PutScalar(common::Value* value);
+  common::Error PutString(const std::string& str);
+
+  std::vector<bool> first_;  // per open array, nothing written yet
+};
+
+// One line per reply, elements of nested replies flattened into it, RFC 4180
+// quoting.
+class CsvWriter : public FastoObjectWriter {
+ public:
+  explicit CsvWriter(IWriterSink* sink);
+
+ protected:
+  virtual common::Error BeginNode(FastoObject* obj) override;
+  virtual common::Error EndNode(FastoObject* obj) override;
+  virtual common::Error BeginStreamedArray(size_t count, const std::string& delimiter) override;
+  virtual common::Error PutStreamedElement(common::Value* element) override;
+  virtual common::Error EndStreamedArray() override;
+
+ private:
+  common::Error PutField(const std::string& field);
+
+  size_t depth_;
+  bool first_field_;
+};
+
+// Redis protocol, arrays hold their elements followed by nested replies.
+class RespWriter : public FastoObjectWriter {
+ public:
+  explicit RespWriter(IWriterSink* sink);
+
+ protected:
+  virtual common::Error BeginNode(FastoObject* obj) override;
+  virtual common::Error BeginStreamedArray(size_t count, const std::string& delimiter) override;
+  virtual common::Error PutStreamedElement(common::Value* element) override;
+  virtual common::Error EndStreamedArray() override;
+
+ private:
+  common::Error PutScalar(common::Value* value);
+  common::Error PutBulk(const std::string& str);
+};
+
+// Caller owns the writer, sink must outlive it.
+FastoObjectWriter* CreateFastoObjectWriter(OutputFormat format, IWriterSink* sink);
+
+common::Error WriteFastoObject(FastoObject* root, OutputFormat format, IWriterSink* sink)
+    WARN_UNUSED_RESULT;
+
+}  // namespace core
+}  // namespace fastonosql
@@ -26,6 +26,8 @@
 
 #include <common/string_util.h>  // for TrimWhitespaceASCII, etc
 
+#include "core/fasto_object_writer.h"  // for RawWriter, StringSink
+
 namespace fastonosql {
 namespace core {
 
@@ -63,6 +65,14 @@ FastoObject::childs_t FastoObject::Childrens() const {
   return childrens_;
 }
 
+size_t FastoObject::ChildrenCount() const {
+  return childrens_.size();
+}
+
+FastoObject::child_t FastoObject::ChildAt(size_t index) const {
+  return childrens_[index];
+}
+
 void FastoObject::AddChildren(child_t child) {
   if (!child) {
     return;
@@ -197,16 +207,10 @@ std::string ConvertToString(fastonosql::core::FastoObject* obj) {
   }
 
   std::string result;
-  std::string str = obj->ToString();
-  if (!str.empty()) {
-    result += str + obj->Delimiter();
-  }
-
-  auto childrens = obj->Childrens();
-  for (auto it = childrens.begin(); it != childrens.end(); ++it) {
-    result += ConvertToString((*it).get());
-  }
-
+  fastonosql::core::StringSink sink(&result);
+  fastonosql::core::RawWriter writer(&sink);
+  common::Error err = writer.Write(obj);
+  DCHECK(!err);
   return result;
 }
 
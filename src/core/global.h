@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <stddef.h>  // for size_t
+
 #include <memory>   // for shared_ptr
 #include <string>   // for string
 #include <utility>  // for pair
@@ -69,6 +71,8 @@ class FastoObject : public common::intrusive_ptr_base<FastoObject> {
   static FastoObject* CreateRoot(const std::string& text, IFastoObjectObserver* observer = nullptr);
 
   childs_t Childrens() const;
+  size_t ChildrenCount() const;
+  child_t ChildAt(size_t index) const;  // no copy of childrens, for walking big trees
   void AddChildren(child_t child);
   FastoObject* Parent() const;
   void Clear();
@@ -41,6 +41,7 @@
 
 #define ALL_KEYS_PATTERNS "*"
 #define NO_KEYS_LIMIT UINT64_MAX
+#define SCAN_SESSION_TIMEOUT_MSEC 60000  // idle time after which SCAN snapshot released
 
 #define GET_KEYS_PATTERN_3ARGS_ISI "SCAN %" PRIu64 " MATCH %s COUNT %" PRIu64
 
@@ -60,7 +61,7 @@ class CDBConnection : public DBConnection<NConnection, Config, ContType>, public
   typedef DBConnection<NConnection, Config, ContType> db_base_class;
 
   CDBConnection(CDBConnectionClient* client, ICommandTranslator* translator)
-      : db_base_class(), CommandHandler(translator), client_(client) {}
+      : db_base_class(), CommandHandler(translator, ContType), client_(client) {}
   virtual ~CDBConnection() {}
 
   static std::vector<CommandHolder> Commands();
@@ -90,6 +91,9 @@ class CDBConnection : public DBConnection<NConnection, Config, ContType>, public
   common::Error GetTTL(const NKey& key, ttl_t* ttl) WARN_UNUSED_RESULT;                    // nvi
   common::Error Quit() WARN_UNUSED_RESULT;                                                 // nvi
 
+  CDBConnectionClient* Client() const { return client_; }
+  void SetClient(CDBConnectionClient* client) { client_ = client; }
+
  protected:
   CDBConnectionClient* client_;
 
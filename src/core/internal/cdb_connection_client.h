@@ -20,6 +20,8 @@
 
 #include <string>  // for string
 
+#include <common/error.h>  // for Error
+
 #include "core/db_key.h"  // for NDbKValue, NKey, NKeys, ttl_t
 
 namespace fastonosql {
@@ -42,6 +44,12 @@ class CDBConnectionClient {
   virtual void OnKeyTTLChanged(const NKey& key, ttl_t ttl) = 0;
   virtual void OnKeyTTLLoaded(const NKey& key, ttl_t ttl) = 0;
   virtual void OnQuited() = 0;
+
+  // BackgroundJob calls them from its own thread
+  virtual void OnJobProgress(const std::string& job, int percent) = 0;
+  virtual void OnJobFinished(const std::string& job,
+                             common::Error err,
+                             const std::string& summary) = 0;
 };
 
 }  // namespace core
@@ -21,7 +21,8 @@
 #include <stddef.h>  // for size_t
 #include <stdint.h>  // for uint16_t
 
-#include <string>  // for string
+#include <algorithm>  // for fill
+#include <string>     // for string
 
 extern "C" {
 #include "sds.h"
@@ -31,11 +32,16 @@ extern "C" {
 #include <common/sprintf.h>  // for MemSPrintf
 #include <common/utils.h>
 
+#include "core/command_stats.h"  // for CommandStats, PostScope
+
 namespace fastonosql {
 namespace core {
 namespace internal {
 
-CommandHandler::CommandHandler(ICommandTranslator* translator) : translator_(translator) {}
+CommandHandler::CommandHandler(ICommandTranslator* translator, connectionTypes type)
+    : translator_(translator), type_(type) {}
+
+CommandHandler::~CommandHandler() {}
 
 common::Error CommandHandler::Execute(const std::string& command, FastoObject* out) {
   const char* ccommand = common::utils::c_strornull(command);
@@ -56,16 +62,48 @@ common::Error CommandHandler::Execute(const std::string& command, FastoObject* o
 }
 
 common::Error CommandHandler::Execute(int argc, const char** argv, FastoObject* out) {
+  uint64_t stages[STAGE_COUNT];
+  std::fill(stages, stages + STAGE_COUNT, COMMAND_STAGE_SKIPPED);
+  const uint64_t start = CommandStatsNowNsec();
+
   const command_t* cmd = nullptr;
   size_t off = 0;
-  common::Error err = translator_->TestCommandLineArgs(argc, argv, &cmd, &off);
+  common::Error err = translator_->FindCommand(argc, argv, &cmd, &off);
+  const uint64_t lookup_finished = CommandStatsNowNsec();
+  stages[STAGE_LOOKUP] = lookup_finished - start;
   if (err && err->isError()) {
+    stages[STAGE_TOTAL] = stages[STAGE_LOOKUP];
+    CommandStats::instance().Record(type_, COMMAND_STATS_UNKNOWN_COMMAND, stages, true);
     return err;
   }
 
   int argc_to_call = argc - off;
   const char** argv_to_call = argv + off;
-  return cmd->func_(this, argc_to_call, argv_to_call, out);
+  err = translator_->TestCommandArgs(cmd, argc_to_call, argv_to_call);
+  const uint64_t args_finished = CommandStatsNowNsec();
+  stages[STAGE_ARGS] = args_finished - lookup_finished;
+  if (!err || !err->isError()) {
+    PostScope post;
+    err = cmd->func_(this, argc_to_call, argv_to_call, out);
+    stages[STAGE_POST] = post.ElapsedNsec();
+    stages[STAGE_CALL] = CommandStatsNowNsec() - args_finished - stages[STAGE_POST];
+  }
+
+  stages[STAGE_TOTAL] = CommandStatsNowNsec() - start;
+  CommandStats::instance().Record(type_, cmd->name, stages, err && err->isError());
+  return err;
+}
+
+bool CommandHandler::IsPipelineSupported() const {
+  return false;
+}
+
+common::Error CommandHandler::ExecutePipeline(const std::vector<std::string>& commands,
+                                              pipeline_reply_t on_reply) {
+  UNUSED(commands);
+  UNUSED(on_reply);
+  return common::make_error_value("Pipelining isn't supported by this database",
+                                  common::ErrorValue::E_ERROR);
 }
 
 }  // namespace internal
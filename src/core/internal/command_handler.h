@@ -18,13 +18,17 @@
 
 #pragma once
 
-#include <vector>  // for vector
-#include <string>  // for string
+#include <stddef.h>  // for size_t
+
+#include <functional>  // for function
+#include <vector>      // for vector
+#include <string>      // for string
 
 #include <common/error.h>   // for Error
 #include <common/macros.h>  // for WARN_UNUSED_RESULT
 
-#include "core/command_holder.h"  // for CommandHolder
+#include "core/command_holder.h"    // for CommandHolder
+#include "core/connection_types.h"  // for connectionTypes
 #include "core/icommand_translator.h"
 
 namespace fastonosql {
@@ -41,15 +45,25 @@ class CommandHandler {
  public:
   typedef fastonosql::core::CommandHolder command_t;
   typedef std::vector<command_t> commands_t;
+  typedef std::function<void(size_t index, common::Error err)> pipeline_reply_t;
+
+  CommandHandler(ICommandTranslator* translator, connectionTypes type);
+  virtual ~CommandHandler();
 
-  explicit CommandHandler(ICommandTranslator* translator);
   common::Error Execute(const std::string& command, FastoObject* out) WARN_UNUSED_RESULT;
   common::Error Execute(int argc, const char** argv, FastoObject* out) WARN_UNUSED_RESULT;
 
+  // sends all commands before reading any reply, on_reply runs as each reply
+  // arrives; replies aren't formatted, only errors are reported
+  virtual bool IsPipelineSupported() const;
+  virtual common::Error ExecutePipeline(const std::vector<std::string>& commands,
+                                        pipeline_reply_t on_reply) WARN_UNUSED_RESULT;
+
   translator_t Translator() const { return translator_; }
 
  private:
   translator_t translator_;
+  const connectionTypes type_;  // CommandStats key
 };
 
 }  // namespace internal
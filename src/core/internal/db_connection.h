@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <atomic>  // for atomic
 #include <string>  // for string
 
 #include <common/error.h>  // for Error
@@ -61,7 +62,7 @@ class DBConnection {
 
  protected:
   dbconnection_t connection_;
-  bool interrupted_;
+  std::atomic<bool> interrupted_;  // set by GUI thread, polled by range scan workers
 };
 }
 }  // namespace core
@@ -0,0 +1,416 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "core/key_pattern.h"
+
+#include <string.h>  // for memcmp, memchr
+
+#if defined(__AVX2__)
+#include <immintrin.h>  // for _mm256_cmpeq_epi8, etc
+#define KEY_PATTERN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>  // for _mm_cmpeq_epi8, etc
+#define KEY_PATTERN_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>  // for _BitScanForward
+#endif
+
+namespace fastonosql {
+namespace core {
+
+namespace {
+
+#if defined(KEY_PATTERN_AVX2) || defined(KEY_PATTERN_SSE2)
+inline unsigned CountTrailingZeros(unsigned mask) {
+#if defined(_MSC_VER)
+  unsigned long index = 0;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+size_t FindLiteralScalar(const char* haystack,
+                         size_t size,
+                         const char* needle,
+                         size_t needle_size) {
+  if (needle_size > size) {
+    return std::string::npos;
+  }
+
+  const char* cur = haystack;
+  const char* last = haystack + size - needle_size;
+  while (cur <= last) {
+    const char* found = static_cast<const char*>(memchr(cur, needle[0], last - cur + 1));
+    if (!found) {
+      return std::string::npos;
+    }
+    if (memcmp(found + 1, needle + 1, needle_size - 1) == 0) {
+      return found - haystack;
+    }
+    cur = found + 1;
+  }
+  return std::string::npos;
+}
+
+// compares first and last needle bytes against a whole register of candidate
+// positions, full compare only for candidates where both matched
+#if defined(KEY_PATTERN_AVX2)
+size_t FindLiteralVector(const char* haystack,
+                         size_t size,
+                         const char* needle,
+                         size_t needle_size) {
+  const __m256i first = _mm256_set1_epi8(needle[0]);
+  const __m256i last = _mm256_set1_epi8(needle[needle_size - 1]);
+  size_t i = 0;
+  for (; i + needle_size - 1 + 32 <= size; i += 32) {
+    const __m256i block_first =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i));
+    const __m256i block_last =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i + needle_size - 1));
+    unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(
+        _mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+    while (mask) {
+      unsigned bit = CountTrailingZeros(mask);
+      if (memcmp(haystack + i + bit + 1, needle + 1, needle_size - 2) == 0) {
+        return i + bit;
+      }
+      mask &= mask - 1;
+    }
+  }
+
+  size_t pos = FindLiteralScalar(haystack + i, size - i, needle, needle_size);
+  return pos == std::string::npos ? pos : pos + i;
+}
+#elif defined(KEY_PATTERN_SSE2)
+size_t FindLiteralVector(const char* haystack,
+                         size_t size,
+                         const char* needle,
+                         size_t needle_size) {
+  const __m128i first = _mm_set1_epi8(needle[0]);
+  const __m128i last = _mm_set1_epi8(needle[needle_size - 1]);
+  size_t i = 0;
+  for (; i + needle_size - 1 + 16 <= size; i += 16) {
+    const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+    const __m128i block_last =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i + needle_size - 1));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+    while (mask) {
+      unsigned bit = CountTrailingZeros(mask);
+      if (memcmp(haystack + i + bit + 1, needle + 1, needle_size - 2) == 0) {
+        return i + bit;
+      }
+      mask &= mask - 1;
+    }
+  }
+
+  size_t pos = FindLiteralScalar(haystack + i, size - i, needle, needle_size);
+  return pos == std::string::npos ? pos : pos + i;
+}
+#endif
+
+bool GlobMatch(const char* pattern, size_t pattern_len, const char* str, size_t str_len) {
+  while (pattern_len && str_len) {
+    switch (pattern[0]) {
+      case '*': {
+        while (pattern_len > 1 && pattern[1] == '*') {
+          pattern++;
+          pattern_len--;
+        }
+        if (pattern_len == 1) {
+          return true;
+        }
+        while (str_len) {
+          if (GlobMatch(pattern + 1, pattern_len - 1, str, str_len)) {
+            return true;
+          }
+          str++;
+          str_len--;
+        }
+        return false;
+      }
+      case '?':
+        str++;
+        str_len--;
+        break;
+      case '[': {
+        pattern++;
+        pattern_len--;
+        bool negate = pattern_len && pattern[0] == '^';
+        if (negate) {
+          pattern++;
+          pattern_len--;
+        }
+        bool match = false;
+        while (pattern_len) {
+          if (pattern[0] == '\\' && pattern_len >= 2) {
+            pattern++;
+            pattern_len--;
+            if (pattern[0] == str[0]) {
+              match = true;
+            }
+          } else if (pattern[0] == ']') {
+            break;
+          } else if (pattern_len >= 3 && pattern[1] == '-') {
+            unsigned char start = pattern[0];
+            unsigned char end = pattern[2];
+            unsigned char c = str[0];
+            if (start > end) {
+              unsigned char t = start;
+              start = end;
+              end = t;
+            }
+            if (c >= start && c <= end) {
+              match = true;
+            }
+            pattern += 2;
+            pattern_len -= 2;
+          } else if (pattern[0] == str[0]) {
+            match = true;
+          }
+          pattern++;
+          pattern_len--;
+        }
+        if (!pattern_len) {  // unterminated class, treat end of pattern as ']'
+          pattern--;
+          pattern_len++;
+        }
+        if (negate) {
+          match = !match;
+        }
+        if (!match) {
+          return false;
+        }
+        str++;
+        str_len--;
+        break;
+      }
+      case '\\':
+        if (pattern_len >= 2) {
+          pattern++;
+          pattern_len--;
+        }
+      // fall through
+      default:
+        if (pattern[0] != str[0]) {
+          return false;
+        }
+        str++;
+        str_len--;
+        break;
+    }
+    pattern++;
+    pattern_len--;
+  }
+
+  while (pattern_len && pattern[0] == '*') {
+    pattern++;
+    pattern_len--;
+  }
+  return pattern_len == 0 && str_len == 0;
+}
+
+}  // namespace
+
+size_t FindLiteral(const char* haystack, size_t size, const char* needle, size_t needle_size) {
+  if (needle_size == 0) {
+    return 0;
+  }
+
+  if (needle_size > size) {
+    return std::string::npos;
+  }
+
+  if (needle_size == 1) {  // libc memchr is vectorized already
+    const char* found = static_cast<const char*>(memchr(haystack, needle[0], size));
+    return found ? found - haystack : std::string::npos;
+  }
+
+#if defined(KEY_PATTERN_AVX2) || defined(KEY_PATTERN_SSE2)
+  return FindLiteralVector(haystack, size, needle, needle_size);
+#else
+  return FindLiteralScalar(haystack, size, needle, needle_size);
+#endif
+}
+
+KeyPattern::KeyPattern(const std::string& pattern)
+    : pattern_(pattern),
+      prefix_(),
+      kind_(SEGMENTS),
+      segments_(),
+      anchored_start_(true),
+      anchored_end_(true) {
+  bool glob = false;
+  bool prefix_done = false;
+  std::string segment;
+  for (size_t i = 0; i < pattern_.size(); ++i) {
+    char c = pattern_[i];
+    if (c == '*') {
+      if (i == 0) {
+        anchored_start_ = false;
+      }
+      if (i + 1 == pattern_.size()) {
+        anchored_end_ = false;
+      }
+      if (!segment.empty()) {
+        segments_.push_back(segment);
+        segment.clear();
+      }
+      prefix_done = true;
+      continue;
+    }
+
+    if (c == '?' || c == '[') {
+      glob = true;
+      break;
+    }
+
+    if (c == '\\' && i + 1 < pattern_.size()) {
+      i++;
+      c = pattern_[i];
+    }
+    segment += c;
+    if (!prefix_done) {
+      prefix_ += c;
+    }
+  }
+
+  if (glob) {
+    // prefix stays valid, the rest goes through GlobMatch
+    kind_ = GLOB;
+    segments_.clear();
+    return;
+  }
+
+  if (!segment.empty()) {
+    segments_.push_back(segment);
+  }
+
+  if (segments_.empty()) {
+    kind_ = anchored_start_ ? EXACT : MATCH_ALL;  // "" or "*"
+  } else if (segments_.size() == 1) {
+    if (anchored_start_ && anchored_end_) {
+      kind_ = EXACT;
+    } else if (anchored_start_) {
+      kind_ = PREFIX;
+    } else if (anchored_end_) {
+      kind_ = SUFFIX;
+    } else {
+      kind_ = CONTAINS;
+    }
+  }
+}
+
+KeyPattern::Kind KeyPattern::GetKind() const {
+  return kind_;
+}
+
+const std::string& KeyPattern::Pattern() const {
+  return pattern_;
+}
+
+const std::string& KeyPattern::Prefix() const {
+  return prefix_;
+}
+
+std::string KeyPattern::PrefixUpperBound() const {
+  std::string upper = prefix_;
+  while (!upper.empty() && static_cast<unsigned char>(upper[upper.size() - 1]) == 0xff) {
+    upper.pop_back();
+  }
+
+  if (upper.empty()) {
+    return std::string();
+  }
+
+  upper[upper.size() - 1]++;
+  return upper;
+}
+
+bool KeyPattern::HasPrefix(const char* key, size_t size) const {
+  return size >= prefix_.size() && memcmp(key, prefix_.data(), prefix_.size()) == 0;
+}
+
+bool KeyPattern::Match(const char* key, size_t size) const {
+  switch (kind_) {
+    case MATCH_ALL:
+      return true;
+    case EXACT:
+      return size == prefix_.size() && memcmp(key, prefix_.data(), size) == 0;
+    case PREFIX:
+      return HasPrefix(key, size);
+    case SUFFIX: {
+      const std::string& suffix = segments_[0];
+      return size >= suffix.size() &&
+             memcmp(key + size - suffix.size(), suffix.data(), suffix.size()) == 0;
+    }
+    case CONTAINS: {
+      const std::string& literal = segments_[0];
+      return FindLiteral(key, size, literal.data(), literal.size()) != std::string::npos;
+    }
+    case SEGMENTS:
+      return MatchSegments(key, size);
+    case GLOB:
+      return HasPrefix(key, size) && GlobMatch(pattern_.data(), pattern_.size(), key, size);
+  }
+
+  return false;
+}
+
+// leftmost placement of each segment is enough, '*' absorbs everything in between
+bool KeyPattern::MatchSegments(const char* key, size_t size) const {
+  size_t pos = 0;
+  size_t end = size;
+  size_t first = 0;
+  size_t last = segments_.size();
+  if (anchored_start_) {
+    const std::string& head = segments_[first++];
+    if (!HasPrefix(key, size)) {
+      return false;
+    }
+    pos = head.size();
+  }
+
+  if (anchored_end_) {
+    const std::string& tail = segments_[--last];
+    if (end - pos < tail.size() ||
+        memcmp(key + end - tail.size(), tail.data(), tail.size()) != 0) {
+      return false;
+    }
+    end -= tail.size();
+  }
+
+  for (size_t i = first; i < last; ++i) {
+    const std::string& segment = segments_[i];
+    size_t found = FindLiteral(key + pos, end - pos, segment.data(), segment.size());
+    if (found == std::string::npos) {
+      return false;
+    }
+    pos += found + segment.size();
+  }
+
+  return true;
+}
+
+}  // namespace core
+}  // namespace fastonosql
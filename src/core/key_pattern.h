@@ -0,0 +1,70 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+
+#include <string>  // for string
+#include <vector>  // for vector
+
+namespace fastonosql {
+namespace core {
+
+// SCAN MATCH glob (* ? [...] and \ escape) compiled once per scan;
+// ordered engines seek to Prefix() and stop at the first key without it.
+// Patterns built only from literals and '*' are matched by searching literal
+// segments (SSE2/AVX2 when compiled in), others fall back to glob matching.
+class KeyPattern {
+ public:
+  enum Kind {
+    MATCH_ALL,  // *
+    EXACT,      // abc
+    PREFIX,     // abc*
+    SUFFIX,     // *abc
+    CONTAINS,   // *abc*
+    SEGMENTS,   // a*b*c, any literals joined by '*'
+    GLOB        // contains ? or [...]
+  };
+
+  explicit KeyPattern(const std::string& pattern);
+
+  Kind GetKind() const;
+  const std::string& Pattern() const;
+  const std::string& Prefix() const;
+  std::string PrefixUpperBound() const;  // smallest key after prefix range, empty if unbounded
+
+  bool HasPrefix(const char* key, size_t size) const;
+  bool Match(const char* key, size_t size) const;  // works on raw key data, no allocations
+
+ private:
+  bool MatchSegments(const char* key, size_t size) const;
+
+  std::string pattern_;
+  std::string prefix_;
+  Kind kind_;
+  std::vector<std::string> segments_;  // literal runs between '*', unescaped
+  bool anchored_start_;                // pattern doesn't start with '*'
+  bool anchored_end_;                  // pattern doesn't end with '*'
+};
+
+// offset of first needle occurrence in haystack or std::string::npos
+size_t FindLiteral(const char* haystack, size_t size, const char* needle, size_t needle_size);
+
+}  // namespace core
+}  // namespace fastonosql
@@ -0,0 +1,278 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "core/key_ranges.h"
+
+#include <string.h>  // for memcmp
+
+#include <algorithm>  // for min, max
+#include <atomic>     // for atomic
+#include <thread>     // for thread
+
+#include <common/macros.h>  // for DCHECK
+
+namespace {
+
+uint64_t SumSizes(const std::vector<uint64_t>& sizes) {
+  uint64_t total = 0;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    total += sizes[i];
+  }
+  return total;
+}
+
+// bounds splitting [start, end) by key byte after start, keys equal to start
+// or continued by '\0' stay in the first part
+void AppendChildBounds(const std::string& start,
+                       const std::string& end,
+                       std::vector<std::string>* bounds) {
+  for (int b = 1; b <= 255; ++b) {
+    std::string bound = start + static_cast<char>(b);
+    if (end.empty() || bound < end) {
+      bounds->push_back(bound);
+    }
+  }
+}
+
+}  // namespace
+
+namespace fastonosql {
+namespace core {
+
+KeyRange::KeyRange() : start(), end() {}
+
+KeyRange::KeyRange(const std::string& start, const std::string& end) : start(start), end(end) {}
+
+bool KeyRange::Contains(const char* key, size_t size) const {
+  std::string::size_type min_size = std::min(size, start.size());
+  int cmp = memcmp(key, start.data(), min_size);
+  if (cmp < 0 || (cmp == 0 && size < start.size())) {
+    return false;
+  }
+
+  if (end.empty()) {
+    return true;
+  }
+
+  min_size = std::min(size, end.size());
+  cmp = memcmp(key, end.data(), min_size);
+  return cmp < 0 || (cmp == 0 && size < end.size());
+}
+
+std::vector<KeyRange> SplitKeyRange(const KeyRange& range,
+                                    size_t parts,
+                                    key_range_sizes_t sizes_func) {
+  std::vector<KeyRange> ranges;
+  if (parts <= 1 || !sizes_func) {
+    ranges.push_back(range);
+    return ranges;
+  }
+
+  std::vector<std::string> bounds;
+  bounds.push_back(range.start);
+  bounds.push_back(range.end);
+  std::vector<uint64_t> sizes;
+  sizes_func(bounds, &sizes);
+  for (int depth = 0; depth < KEY_RANGES_MAX_DEPTH; ++depth) {
+    const uint64_t heavy = SumSizes(sizes) / parts;
+    std::vector<std::string> refined;
+    bool split = false;
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+      if (i != 0 && sizes[i - 1] == 0 && sizes[i] == 0) {
+        continue;  // merge empty neighbours, keeps bounds count low on deep levels
+      }
+
+      refined.push_back(bounds[i]);
+      if (sizes[i] > heavy && refined.size() + bounds.size() < KEY_RANGES_MAX_BOUNDS) {
+        size_t before = refined.size();
+        AppendChildBounds(bounds[i], bounds[i + 1], &refined);
+        split |= refined.size() != before;
+      }
+    }
+    refined.push_back(bounds.back());
+    if (!split) {
+      break;
+    }
+
+    bounds.swap(refined);
+    sizes_func(bounds, &sizes);
+  }
+
+  const uint64_t total = SumSizes(sizes);
+  if (total == 0) {
+    ranges.push_back(range);
+    return ranges;
+  }
+
+  // greedy merge of neighbours up to total / parts bytes
+  const uint64_t target = std::max<uint64_t>(total / parts, 1);
+  std::string start = bounds[0];
+  uint64_t acc = 0;
+  for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+    acc += sizes[i];
+    bool last = i + 2 == bounds.size();
+    if (!last && acc >= target && ranges.size() + 1 < parts) {
+      ranges.push_back(KeyRange(start, bounds[i + 1]));
+      start = bounds[i + 1];
+      acc = 0;
+    }
+  }
+  ranges.push_back(KeyRange(start, bounds.back()));
+  return ranges;
+}
+
+common::Error MakeCompactBounds(const std::string& start,
+                                const std::string& end,
+                                std::vector<std::string>* bounds) {
+  if (!start.empty() && !end.empty() && start > end) {
+    return common::make_error_value("Invalid key range: start key is after end key",
+                                    common::ErrorValue::E_ERROR);
+  }
+
+  bounds->clear();
+  bounds->push_back(start);
+  int first = start.empty() ? 1 : static_cast<unsigned char>(start[0]) + 1;
+  int last = end.empty() ? 255 : static_cast<unsigned char>(end[0]);
+  for (int b = first; b <= last; ++b) {
+    std::string bound(1, static_cast<char>(b));
+    if (bound > start && (end.empty() || bound < end)) {
+      bounds->push_back(bound);
+    }
+  }
+  bounds->push_back(end);
+  return common::Error();
+}
+
+std::vector<KeyRange> InterpolateKeyRanges(const std::string& first,
+                                           const std::string& last,
+                                           size_t parts) {
+  size_t prefix = 0;
+  while (prefix < first.size() && prefix < last.size() && first[prefix] == last[prefix]) {
+    prefix++;
+  }
+
+  // next 8 bytes of both keys as big endian numbers, shorter keys padded by zeros
+  uint64_t low = 0;
+  uint64_t high = 0;
+  for (size_t i = prefix; i < prefix + sizeof(uint64_t); ++i) {
+    low = (low << 8) | (i < first.size() ? static_cast<unsigned char>(first[i]) : 0);
+    high = (high << 8) | (i < last.size() ? static_cast<unsigned char>(last[i]) : 0);
+  }
+
+  std::vector<KeyRange> ranges;
+  std::string start;
+  const uint64_t step = parts > 1 && high > low ? (high - low) / parts : 0;
+  for (size_t i = 1; step != 0 && i < parts; ++i) {
+    const uint64_t value = low + step * i;
+    std::string bound = last.substr(0, prefix);
+    for (int shift = 56; shift >= 0; shift -= 8) {
+      bound += static_cast<char>((value >> shift) & 0xff);
+    }
+    ranges.push_back(KeyRange(start, bound));
+    start = bound;
+  }
+  ranges.push_back(KeyRange(start, std::string()));
+  return ranges;
+}
+
+size_t KeyRangesWorkers() {
+  size_t workers = std::thread::hardware_concurrency();
+  return std::min<size_t>(std::max<size_t>(workers, 1), KEY_RANGES_MAX_WORKERS);
+}
+
+common::Error ForEachKeyRange(const std::vector<KeyRange>& ranges, key_range_func_t func) {
+  const size_t count = ranges.size();
+  std::vector<common::Error> errors(count);
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t i = next++; i < count; i = next++) {
+      common::Error err = func(i, ranges[i]);
+      if (err && err->isError()) {
+        errors[i] = err;
+        next = count;  // don't start other ranges
+      }
+    }
+  };
+
+  const size_t workers = std::min(KeyRangesWorkers(), count);
+  if (workers <= 1) {
+    worker();
+  } else {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < workers; ++i) {
+      threads.push_back(std::thread(worker));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+      threads[i].join();
+    }
+  }
+
+  for (size_t i = 0; i < errors.size(); ++i) {
+    if (errors[i]) {
+      return errors[i];
+    }
+  }
+
+  return common::Error();
+}
+
+KeyRangesCollector::KeyRangesCollector(size_t ranges_count, uint64_t limit)
+    : lock_(), keys_(ranges_count), done_(ranges_count, false), limit_(limit) {}
+
+uint64_t KeyRangesCollector::Limit() const {
+  return limit_;
+}
+
+bool KeyRangesCollector::IsEnough(size_t index) const {
+  std::lock_guard<std::mutex> lock(lock_);
+  uint64_t found = 0;
+  for (size_t i = 0; i < index; ++i) {
+    if (!done_[i]) {
+      return false;
+    }
+
+    found += keys_[i].size();
+    if (found >= limit_) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void KeyRangesCollector::Done(size_t index, std::vector<std::string>* keys) {
+  DCHECK(index < keys_.size());
+  std::lock_guard<std::mutex> lock(lock_);
+  keys_[index].swap(*keys);
+  done_[index] = true;
+}
+
+std::vector<std::string> KeyRangesCollector::Merge() {
+  std::lock_guard<std::mutex> lock(lock_);
+  std::vector<std::string> merged;
+  for (size_t i = 0; i < keys_.size() && merged.size() < limit_; ++i) {
+    for (size_t j = 0; j < keys_[i].size() && merged.size() < limit_; ++j) {
+      merged.push_back(keys_[i][j]);
+    }
+  }
+
+  return merged;
+}
+
+}  // namespace core
+}  // namespace fastonosql
@@ -0,0 +1,313 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint64_t
+
+#include <functional>  // for function
+#include <memory>      // for unique_ptr
+#include <mutex>       // for mutex
+#include <string>      // for string
+#include <vector>      // for vector
+
+#include <common/error.h>    // for Error
+#include <common/macros.h>   // for WARN_UNUSED_RESULT
+#include <common/sprintf.h>  // for MemSPrintf
+
+#include "core/key_pattern.h"  // for KeyPattern
+
+#define KEY_RANGES_PER_WORKER 4  // more ranges than workers evens out skewed ranges
+#define KEY_RANGES_MAX_WORKERS 64
+#define KEY_RANGES_MAX_DEPTH 16     // key bytes used to bisect heavy ranges
+#define KEY_RANGES_MAX_BOUNDS 8192  // size estimations per refinement
+#define KEY_RANGES_CHECK_STEP 1024  // keys between KeyRangesCollector::IsEnough checks
+#define KEY_RANGES_MIN_SCAN_COUNT 10000  // smaller SCAN pages are read by one iterator
+
+// upper bound for size estimation of ranges without end key
+#define KEY_RANGES_LIMIT_SENTINEL std::string(8, '\xff')
+
+namespace fastonosql {
+namespace core {
+
+// [start, end) part of bytewise ordered keyspace, empty end means up to the last key
+struct KeyRange {
+  KeyRange();
+  KeyRange(const std::string& start, const std::string& end);
+
+  bool Contains(const char* key, size_t size) const;
+
+  std::string start;
+  std::string end;
+};
+
+// approximate stored bytes of every [bounds[i], bounds[i + 1]) range,
+// engines answer it with GetApproximateSizes
+typedef std::function<void(const std::vector<std::string>& bounds, std::vector<uint64_t>* sizes)>
+    key_range_sizes_t;
+
+// splits range into at most parts ranges of about the same data size, ranges heavier than
+// total / parts are bisected by the next key byte up to KEY_RANGES_MAX_DEPTH times;
+// without any size estimation (empty or memtable only db) range is returned as is
+std::vector<KeyRange> SplitKeyRange(const KeyRange& range,
+                                    size_t parts,
+                                    key_range_sizes_t sizes_func);
+
+// splits [start, end) by first key byte into bounds of ranges compacted one by one,
+// empty start/end means open range; start after end is an error
+common::Error MakeCompactBounds(const std::string& start,
+                                const std::string& end,
+                                std::vector<std::string>* bounds) WARN_UNUSED_RESULT;
+
+// splits keyspace into at most parts ranges at evenly spaced keys between first and last key
+// (bytes after their common prefix read as a number), for engines without size estimation;
+// first range has empty start, last range empty end
+std::vector<KeyRange> InterpolateKeyRanges(const std::string& first,
+                                           const std::string& last,
+                                           size_t parts);
+
+// approximate stored bytes of [bounds[i], bounds[i + 1]) ranges for engines with
+// leveldb like GetApproximateSizes, returns sum of sizes
+template <typename DB, typename Range>
+uint64_t ApproximateKeyRangeSizes(DB* db,
+                                  const std::vector<std::string>& bounds,
+                                  std::vector<uint64_t>* sizes) {
+  std::vector<std::string> limits;
+  for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+    limits.push_back(bounds[i + 1].empty() ? KEY_RANGES_LIMIT_SENTINEL : bounds[i + 1]);
+  }
+  std::vector<Range> ranges;
+  for (size_t i = 0; i < limits.size(); ++i) {
+    ranges.push_back(Range(bounds[i], limits[i]));
+  }
+
+  sizes->assign(ranges.size(), 0);
+  if (ranges.empty()) {
+    return 0;
+  }
+
+  db->GetApproximateSizes(&ranges[0], static_cast<int>(ranges.size()), &(*sizes)[0]);
+  uint64_t total = 0;
+  for (size_t i = 0; i < sizes->size(); ++i) {
+    total += (*sizes)[i];
+  }
+  return total;
+}
+
+size_t KeyRangesWorkers();  // hardware threads, at most KEY_RANGES_MAX_WORKERS
+
+typedef std::function<common::Error(size_t index, const KeyRange& range)> key_range_func_t;
+
+// runs func for every range on KeyRangesWorkers() threads, each thread takes next not
+// started range; returns error of the first failed range, ranges not started are skipped
+common::Error ForEachKeyRange(const std::vector<KeyRange>& ranges, key_range_func_t func);
+
+// keys matched by parallel range scans, merged in range order gives the same first
+// limit keys as one ordered scan; a range can stop once ranges before it hold limit keys
+class KeyRangesCollector {
+ public:
+  KeyRangesCollector(size_t ranges_count, uint64_t limit);
+
+  uint64_t Limit() const;
+  bool IsEnough(size_t index) const;
+  void Done(size_t index, std::vector<std::string>* keys);  // takes keys
+  std::vector<std::string> Merge();                         // first limit keys
+
+ private:
+  mutable std::mutex lock_;
+  std::vector<std::vector<std::string> > keys_;
+  std::vector<bool> done_;
+  const uint64_t limit_;
+};
+
+// leveldb like engines describe themselves with traits:
+//   db_t, snapshot_t, range_t, read_options_t, iterator_t, slice_t, status_t types,
+//   static void SetUpperBound(read_options_t* ro, const slice_t* upper_bound),
+//   static status_t CompactRange(db_t* db, const slice_t* begin, const slice_t* end) and
+//   static uint64_t StoredBytes(db_t* db, const std::vector<std::string>& bounds)
+template <typename Traits>
+key_range_sizes_t MakeKeyRangeSizes(typename Traits::db_t* db) {
+  return [db](const std::vector<std::string>& bounds, std::vector<uint64_t>* sizes) {
+    ApproximateKeyRangeSizes<typename Traits::db_t, typename Traits::range_t>(db, bounds, sizes);
+  };
+}
+
+// walks keys of range in order over snapshot until on_key returns false,
+// engines with iterate_upper_bound get range end too so readers don't step past it
+template <typename Traits>
+typename Traits::status_t ScanKeyRange(
+    typename Traits::db_t* db,
+    const typename Traits::snapshot_t* snapshot,
+    const KeyRange& range,
+    std::function<bool(const typename Traits::slice_t& key)> on_key) {
+  typename Traits::read_options_t ro;
+  ro.snapshot = snapshot;
+  ro.fill_cache = false;
+  const typename Traits::slice_t upper_bound(range.end);
+  if (!range.end.empty()) {
+    Traits::SetUpperBound(&ro, &upper_bound);
+  }
+  std::unique_ptr<typename Traits::iterator_t> it(db->NewIterator(ro));
+  for (it->Seek(range.start); it->Valid(); it->Next()) {
+    typename Traits::slice_t key = it->key();
+    if (!range.end.empty() && key.compare(upper_bound) >= 0) {
+      break;
+    }
+
+    if (!on_key(key)) {
+      break;
+    }
+  }
+
+  return it->status();
+}
+
+// first count_keys keys matched by kpattern in key order, prefix range of kpattern
+// is scanned by KeyRangesWorkers() threads over snapshot
+template <typename Traits>
+common::Error ParallelScanKeys(typename Traits::db_t* db,
+                               const typename Traits::snapshot_t* snapshot,
+                               const KeyPattern& kpattern,
+                               uint64_t count_keys,
+                               std::function<bool()> is_interrupted,
+                               std::vector<std::string>* keys_out) {
+  const KeyRange prefix_range(kpattern.Prefix(), kpattern.PrefixUpperBound());
+  const std::vector<KeyRange> ranges = SplitKeyRange(
+      prefix_range, KeyRangesWorkers() * KEY_RANGES_PER_WORKER, MakeKeyRangeSizes<Traits>(db));
+  KeyRangesCollector collector(ranges.size(), count_keys);
+  auto scan_range = [&](size_t index, const KeyRange& range) -> common::Error {
+    std::vector<std::string> found;
+    uint64_t step = 0;
+    auto st = ScanKeyRange<Traits>(db, snapshot, range, [&](const typename Traits::slice_t& key) {
+      if (!kpattern.HasPrefix(key.data(), key.size()) || is_interrupted()) {
+        return false;
+      }
+
+      if (kpattern.Match(key.data(), key.size())) {
+        found.push_back(key.ToString());
+      }
+      return found.size() < count_keys &&
+             (++step % KEY_RANGES_CHECK_STEP != 0 || !collector.IsEnough(index));
+    });
+    if (!st.ok()) {
+      std::string buff = common::MemSPrintf("SCAN function error: %s", st.ToString());
+      return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
+
+    if (is_interrupted()) {
+      return common::make_error_value("Interrupted.", common::ErrorValue::E_INTERRUPTED);
+    }
+
+    collector.Done(index, &found);
+    return common::Error();
+  };
+
+  common::Error err = ForEachKeyRange(ranges, scan_range);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  *keys_out = collector.Merge();
+  return common::Error();
+}
+
+// number of keys in snapshot, counted by KeyRangesWorkers() threads
+template <typename Traits>
+common::Error ParallelCountKeys(typename Traits::db_t* db,
+                                const typename Traits::snapshot_t* snapshot,
+                                std::function<bool()> is_interrupted,
+                                size_t* size) {
+  const std::vector<KeyRange> ranges = SplitKeyRange(
+      KeyRange(), KeyRangesWorkers() * KEY_RANGES_PER_WORKER, MakeKeyRangeSizes<Traits>(db));
+  std::vector<size_t> counts(ranges.size(), 0);
+  auto count_range = [&](size_t index, const KeyRange& range) -> common::Error {
+    size_t count = 0;
+    auto st = ScanKeyRange<Traits>(db, snapshot, range, [&](const typename Traits::slice_t&) {
+      count++;
+      return !is_interrupted();
+    });
+    if (!st.ok()) {
+      std::string buff = common::MemSPrintf("Couldn't determine DBKCOUNT error: %s", st.ToString());
+      return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
+
+    if (is_interrupted()) {
+      return common::make_error_value("Interrupted.", common::ErrorValue::E_INTERRUPTED);
+    }
+
+    counts[index] = count;
+    return common::Error();
+  };
+
+  common::Error err = ForEachKeyRange(ranges, count_range);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  size_t sz = 0;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    sz += counts[i];
+  }
+
+  *size = sz;
+  return common::Error();
+}
+
+// compacts [bounds[i], bounds[i + 1]) ranges one by one, ranges without data are skipped;
+// is_cancelled is checked and progress reported between ranges
+template <typename Traits>
+common::Error CompactKeyRanges(typename Traits::db_t* db,
+                               const std::vector<std::string>& bounds,
+                               std::function<bool()> is_cancelled,
+                               std::function<void(int percent)> progress,
+                               uint64_t* reclaimed) {
+  const uint64_t size_before = Traits::StoredBytes(db, bounds);
+  std::vector<uint64_t> sizes;
+  const uint64_t total =
+      ApproximateKeyRangeSizes<typename Traits::db_t, typename Traits::range_t>(db, bounds, &sizes);
+  uint64_t done = 0;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (is_cancelled()) {
+      return common::make_error_value("Interrupted.", common::ErrorValue::E_INTERRUPTED);
+    }
+
+    if (total != 0 && sizes[i] == 0) {
+      continue;
+    }
+
+    const typename Traits::slice_t begin_key(bounds[i]);
+    const typename Traits::slice_t end_key(bounds[i + 1]);
+    auto st = Traits::CompactRange(db, bounds[i].empty() ? nullptr : &begin_key,
+                                   bounds[i + 1].empty() ? nullptr : &end_key);
+    if (!st.ok()) {
+      std::string buff = common::MemSPrintf("compact function error: %s", st.ToString());
+      return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+    }
+
+    done += sizes[i];
+    progress(total ? static_cast<int>(done * 100 / total) : 100);
+  }
+
+  const uint64_t size_after = Traits::StoredBytes(db, bounds);
+  *reclaimed = size_before > size_after ? size_before - size_after : 0;
+  return common::Error();
+}
+
+}  // namespace core
+}  // namespace fastonosql
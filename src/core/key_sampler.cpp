@@ -0,0 +1,289 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "core/key_sampler.h"
+
+#include <errno.h>     // for errno, ERANGE
+#include <inttypes.h>  // for PRIu64
+#include <math.h>      // for exp, log, floor
+#include <stdlib.h>    // for strtoull
+
+#include <algorithm>  // for min, search, sort
+#include <utility>    // for pair
+
+#include <common/sprintf.h>                          // for MemSPrintf
+#include <common/text_decoders/compress_edcoder.h>  // for CompressEDcoder
+#include <common/time.h>                             // for current_mstime
+
+#define KEY_SAMPLER_MAX_COMPRESS_BYTES (4 * 1024 * 1024)  // sampled bytes given to zlib
+#define KEY_SAMPLER_MAX_SKIP UINT64_C(1000000000000000000)
+
+namespace {
+
+enum ValueKind {
+  VALUE_EMPTY = 0,
+  VALUE_INTEGER,
+  VALUE_JSON,
+  VALUE_TEXT,
+  VALUE_BINARY,
+  VALUE_COUNT
+};
+
+const char* value_kinds[] = {"empty", "integer", "json", "text", "binary"};
+
+ValueKind DetectValueKind(const std::string& value) {
+  if (value.empty()) {
+    return VALUE_EMPTY;
+  }
+
+  bool digits = true;
+  bool text = true;
+  for (size_t i = 0; i < value.size(); ++i) {
+    unsigned char c = value[i];
+    if (c < '0' || c > '9') {
+      digits = digits && i == 0 && c == '-' && value.size() > 1;
+    }
+    if (c < 0x20 && c != '\t' && c != '\r' && c != '\n') {
+      text = false;
+    }
+  }
+
+  if (digits) {
+    return VALUE_INTEGER;
+  } else if (!text) {
+    return VALUE_BINARY;
+  }
+
+  size_t first = value.find_first_not_of(" \t\r\n");
+  if (first != std::string::npos && (value[first] == '{' || value[first] == '[')) {
+    return VALUE_JSON;
+  }
+  return VALUE_TEXT;
+}
+
+std::string SizesLine(const char* name, const fastonosql::core::LatencyHistogram& hist) {
+  return common::MemSPrintf("%s: min %" PRIu64 ", p50 %" PRIu64 ", p90 %" PRIu64 ", p99 %" PRIu64
+                            ", max %" PRIu64 ", mean %.1f",
+                            name, hist.Min(), hist.ValueAtPercentile(50),
+                            hist.ValueAtPercentile(90), hist.ValueAtPercentile(99), hist.Max(),
+                            hist.Mean());
+}
+
+common::Error ParseSampleArg(const char* arg, const char* name, uint32_t* out) {
+  char* end = nullptr;
+  errno = 0;
+  unsigned long long val = strtoull(arg, &end, 10);
+  if (!arg[0] || arg[0] == '-' || *end != '\0' || errno == ERANGE || val == 0 ||
+      val > UINT32_MAX) {
+    return common::make_error_value(common::MemSPrintf("Invalid %s: %s", name, arg),
+                                    common::ErrorValue::E_ERROR);
+  }
+
+  *out = static_cast<uint32_t>(val);
+  return common::Error();
+}
+
+double Percent(uint64_t part, uint64_t total) {
+  return total ? 100.0 * part / total : 0;
+}
+
+}  // namespace
+
+namespace fastonosql {
+namespace core {
+
+KeySampler::KeySampler(size_t sample_size,
+                       const std::string& ns_separator,
+                       uint32_t msec,
+                       uint64_t seed)
+    : sample_size_(sample_size),
+      ns_separator_(ns_separator),
+      deadline_msec_(common::time::current_mstime() + msec),
+      random_(seed),
+      count_(0),
+      weight_(1),
+      next_index_(0),
+      pending_slot_(0),
+      values_(),
+      key_sizes_(KEY_SAMPLER_HIGHEST_SIZE),
+      value_sizes_(KEY_SAMPLER_HIGHEST_SIZE),
+      values_bytes_(0),
+      namespaces_(),
+      other_namespaces_keys_(0) {}
+
+common::Error ParseSampleArgs(int argc, const char** argv, size_t* sample_size, uint32_t* msec) {
+  uint32_t lsample_size = KEY_SAMPLER_DEFAULT_SIZE;
+  uint32_t lmsec = KEY_SAMPLER_DEFAULT_MSEC;
+  common::Error err;
+  if (argc >= 1) {
+    err = ParseSampleArg(argv[0], "sample size", &lsample_size);
+    if (err && err->isError()) {
+      return err;
+    }
+  }
+  if (argc >= 2) {
+    err = ParseSampleArg(argv[1], "time budget", &lmsec);
+    if (err && err->isError()) {
+      return err;
+    }
+  }
+
+  *sample_size = std::min<size_t>(lsample_size, KEY_SAMPLER_MAX_SIZE);  // slot keeps up to 64 KB
+  *msec = lmsec;
+  return common::Error();
+}
+
+bool KeySampler::Add(const char* key, size_t key_size, uint64_t value_size) {
+  const uint64_t index = count_++;
+  key_sizes_.Record(key_size);
+  value_sizes_.Record(value_size);
+  values_bytes_ += value_size;
+
+  const char* end = key + key_size;
+  const char* sep = ns_separator_.empty()
+                        ? end
+                        : std::search(key, end, ns_separator_.begin(), ns_separator_.end());
+  std::string ns = sep == end ? std::string() : std::string(key, sep);
+  auto it = namespaces_.find(ns);
+  if (it != namespaces_.end()) {
+    it->second++;
+  } else if (namespaces_.size() < KEY_SAMPLER_MAX_NAMESPACES) {
+    namespaces_[ns] = 1;
+  } else {
+    other_namespaces_keys_++;
+  }
+
+  if (sample_size_ == 0) {
+    return false;
+  }
+
+  if (index < sample_size_) {  // filling reservoir
+    pending_slot_ = values_.size();
+    values_.push_back(std::string());
+    if (index + 1 == sample_size_) {
+      weight_ = exp(log(NextRandom()) / sample_size_);
+      next_index_ = index + NextSkip();
+    }
+    return true;
+  }
+
+  if (index != next_index_) {
+    return false;
+  }
+
+  pending_slot_ = random_() % sample_size_;
+  weight_ *= exp(log(NextRandom()) / sample_size_);
+  next_index_ += NextSkip();
+  return true;
+}
+
+void KeySampler::Sample(const char* value, size_t size) {
+  if (pending_slot_ >= values_.size()) {
+    return;
+  }
+
+  values_[pending_slot_].assign(value, std::min<size_t>(size, KEY_SAMPLER_MAX_VALUE_BYTES));
+}
+
+bool KeySampler::IsExpired() {
+  if (count_ % KEY_SAMPLER_CHECK_STEP != 0) {
+    return false;
+  }
+
+  return common::time::current_mstime() >= deadline_msec_;
+}
+
+uint64_t KeySampler::KeysCount() const {
+  return count_;
+}
+
+std::vector<std::string> KeySampler::Report(bool complete) const {
+  std::vector<std::string> lines;
+  lines.push_back(common::MemSPrintf("keys: %" PRIu64 " (%s)", count_,
+                                     complete ? "complete pass" : "partial pass, budget reached"));
+  if (count_ == 0) {
+    return lines;
+  }
+
+  lines.push_back(SizesLine("key length", key_sizes_));
+  lines.push_back(SizesLine("value size", value_sizes_));
+  lines.push_back(common::MemSPrintf("values total: %" PRIu64 " bytes", values_bytes_));
+
+  std::vector<std::pair<uint64_t, std::string> > top;
+  for (auto it = namespaces_.begin(); it != namespaces_.end(); ++it) {
+    top.push_back(std::make_pair(it->second, it->first));
+  }
+  std::sort(top.rbegin(), top.rend());
+  const bool overflow = other_namespaces_keys_ != 0;
+  lines.push_back(common::MemSPrintf("namespaces by \"%s\": %s%" PRIu64, ns_separator_,
+                                     overflow ? ">" : "", static_cast<uint64_t>(top.size())));
+  for (size_t i = 0; i < top.size() && i < KEY_SAMPLER_TOP_NAMESPACES; ++i) {
+    std::string name = top[i].second.empty() ? "(none)" : top[i].second;
+    lines.push_back(common::MemSPrintf("  %s: %" PRIu64 " (%.1f%%)", name, top[i].first,
+                                       Percent(top[i].first, count_)));
+  }
+  if (overflow) {
+    lines.push_back(common::MemSPrintf("  (other): %" PRIu64 " (%.1f%%)", other_namespaces_keys_,
+                                       Percent(other_namespaces_keys_, count_)));
+  }
+
+  uint64_t kinds[VALUE_COUNT] = {0};
+  std::string raw;
+  for (size_t i = 0; i < values_.size(); ++i) {
+    kinds[DetectValueKind(values_[i])]++;
+    if (raw.size() < KEY_SAMPLER_MAX_COMPRESS_BYTES) {
+      raw += values_[i];
+    }
+  }
+
+  std::string types;
+  for (size_t i = 0; i < VALUE_COUNT; ++i) {
+    types += common::MemSPrintf("%s%s %.1f%%", i ? ", " : "", value_kinds[i],
+                                Percent(kinds[i], values_.size()));
+  }
+  lines.push_back(common::MemSPrintf("sampled values: %" PRIu64 ", types: %s",
+                                     static_cast<uint64_t>(values_.size()), types));
+
+  // sampled values compressed together, like engines compress whole blocks
+  std::string packed;
+  common::CompressEDcoder enc;
+  common::Error err = raw.empty() ? common::Error() : enc.encode(raw, &packed);
+  if (!raw.empty() && !(err && err->isError())) {
+    lines.push_back(common::MemSPrintf("compressibility (zlib): %.2f of %" PRIu64 " sampled bytes",
+                                       static_cast<double>(packed.size()) / raw.size(),
+                                       static_cast<uint64_t>(raw.size())));
+  }
+
+  return lines;
+}
+
+double KeySampler::NextRandom() {
+  return 1.0 - std::uniform_real_distribution<double>(0, 1)(random_);  // (0, 1]
+}
+
+uint64_t KeySampler::NextSkip() {
+  double skip = floor(log(NextRandom()) / log(1 - weight_)) + 1;
+  if (!(skip < static_cast<double>(KEY_SAMPLER_MAX_SKIP))) {  // also NaN and inf
+    return KEY_SAMPLER_MAX_SKIP;
+  }
+
+  return static_cast<uint64_t>(skip);
+}
+
+}  // namespace core
+}  // namespace fastonosql
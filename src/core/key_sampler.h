@@ -0,0 +1,160 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint64_t, uint32_t
+
+#include <functional>  // for function
+#include <map>         // for map
+#include <memory>      // for unique_ptr
+#include <random>      // for mt19937_64
+#include <string>      // for string
+#include <vector>      // for vector
+
+#include <common/error.h>    // for Error
+#include <common/macros.h>   // for WARN_UNUSED_RESULT
+#include <common/sprintf.h>  // for MemSPrintf
+#include <common/types.h>    // for time64_t
+
+#include "core/key_ranges.h"         // for KeyRange
+#include "core/latency_histogram.h"  // for LatencyHistogram
+
+#define KEY_SAMPLER_DEFAULT_SIZE 1000                  // values kept in reservoir
+#define KEY_SAMPLER_MAX_SIZE 4096                      // slots of up to 64 KB, at most 256 MB
+#define KEY_SAMPLER_DEFAULT_MSEC 5000                  // time budget of one pass
+#define KEY_SAMPLER_MAX_VALUE_BYTES 65536              // sampled value prefix
+#define KEY_SAMPLER_MAX_NAMESPACES 1024                // counted exactly, rest as other
+#define KEY_SAMPLER_TOP_NAMESPACES 10                  // namespaces in report
+#define KEY_SAMPLER_CHECK_STEP 1024                    // keys between clock checks
+#define KEY_SAMPLER_RANGES 16                          // keyspace parts read in turn
+#define KEY_SAMPLER_HIGHEST_SIZE UINT64_C(4294967296)  // larger sizes count as 4 GB
+
+namespace fastonosql {
+namespace core {
+
+// One pass over keys of an embedded store, for cache sizing. Key length and
+// value size histograms and namespace (key part before ns_separator) counts
+// cover every visited key; value bytes are copied only for keys taken into a
+// reservoir (algorithm L) and used for type and compressibility estimates.
+class KeySampler {
+ public:
+  KeySampler(size_t sample_size, const std::string& ns_separator, uint32_t msec, uint64_t seed);
+
+  // records sizes, true if value of this key should be passed to Sample
+  bool Add(const char* key, size_t key_size, uint64_t value_size);
+  void Sample(const char* value, size_t size);  // value of key just accepted by Add
+  bool IsExpired();  // time budget is over, clock is read every KEY_SAMPLER_CHECK_STEP keys
+
+  uint64_t KeysCount() const;
+  std::vector<std::string> Report(bool complete) const;  // complete: pass reached last key
+
+ private:
+  double NextRandom();  // (0, 1]
+  uint64_t NextSkip();   // keys to next reservoir replacement
+
+  const size_t sample_size_;
+  const std::string ns_separator_;
+  const common::time64_t deadline_msec_;
+  std::mt19937_64 random_;
+
+  uint64_t count_;
+  double weight_;        // W of algorithm L
+  uint64_t next_index_;  // index of next key taken into full reservoir
+  size_t pending_slot_;
+  std::vector<std::string> values_;
+
+  LatencyHistogram key_sizes_;
+  LatencyHistogram value_sizes_;
+  uint64_t values_bytes_;
+  std::map<std::string, uint64_t> namespaces_;
+  uint64_t other_namespaces_keys_;  // keys of namespaces over KEY_SAMPLER_MAX_NAMESPACES
+};
+
+// SAMPLE [size] [msec] arguments, size is capped at KEY_SAMPLER_MAX_SIZE;
+// non numeric or zero values are rejected
+common::Error ParseSampleArgs(int argc, const char** argv, size_t* sample_size, uint32_t* msec)
+    WARN_UNUSED_RESULT;
+
+// feeds sampler from ranges in turn, KEY_SAMPLER_CHECK_STEP keys of each range per round,
+// so a pass cut by the time budget covers the whole keyspace and not only its first keys;
+// complete is set when every range reached its end. Traits as for core/key_ranges.h
+template <typename Traits>
+common::Error SampleKeyRanges(typename Traits::db_t* db,
+                              const typename Traits::snapshot_t* snapshot,
+                              const std::vector<KeyRange>& ranges,
+                              std::function<bool()> is_interrupted,
+                              KeySampler* sampler,
+                              bool* complete) {
+  std::vector<typename Traits::slice_t> upper_bounds;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    upper_bounds.push_back(typename Traits::slice_t(ranges[i].end));
+  }
+
+  std::vector<std::unique_ptr<typename Traits::iterator_t> > its;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    typename Traits::read_options_t ro;
+    ro.snapshot = snapshot;
+    ro.fill_cache = false;
+    if (!ranges[i].end.empty()) {
+      Traits::SetUpperBound(&ro, &upper_bounds[i]);
+    }
+    its.push_back(std::unique_ptr<typename Traits::iterator_t>(db->NewIterator(ro)));
+    its.back()->Seek(ranges[i].start);
+  }
+
+  size_t active = its.size();
+  std::vector<bool> done(its.size(), false);
+  while (active != 0 && !sampler->IsExpired()) {
+    if (is_interrupted()) {
+      return common::make_error_value("Interrupted.", common::ErrorValue::E_INTERRUPTED);
+    }
+
+    for (size_t i = 0; i < its.size() && !sampler->IsExpired(); ++i) {
+      typename Traits::iterator_t* it = its[i].get();
+      for (size_t step = 0; !done[i] && step < KEY_SAMPLER_CHECK_STEP && !sampler->IsExpired();
+           ++step) {
+        if (!it->Valid() || !ranges[i].Contains(it->key().data(), it->key().size())) {
+          done[i] = true;
+          active--;
+          break;
+        }
+
+        typename Traits::slice_t key = it->key();
+        typename Traits::slice_t value = it->value();
+        if (sampler->Add(key.data(), key.size(), value.size())) {
+          sampler->Sample(value.data(), value.size());
+        }
+        it->Next();
+      }
+
+      auto st = it->status();
+      if (!st.ok()) {
+        std::string buff = common::MemSPrintf("SAMPLE function error: %s", st.ToString());
+        return common::make_error_value(buff, common::ErrorValue::E_ERROR);
+      }
+    }
+  }
+
+  *complete = active == 0;
+  return common::Error();
+}
+
+}  // namespace core
+}  // namespace fastonosql
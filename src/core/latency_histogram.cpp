@@ -0,0 +1,235 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "core/latency_histogram.h"
+
+#include <math.h>  // for ceil, log, pow
+
+#include <algorithm>  // for min, max
+
+#include <common/macros.h>  // for DCHECK
+
+namespace {
+
+// index of the highest set bit + 1, value must be non zero
+int BitLength(uint64_t value) {
+#if defined(__GNUC__)
+  return 64 - __builtin_clzll(value);
+#else
+  int res = 0;
+  while (value) {
+    value >>= 1;
+    res++;
+  }
+  return res;
+#endif
+}
+
+}  // namespace
+
+namespace fastonosql {
+namespace core {
+
+LatencyHistogram::LatencyHistogram(uint64_t highest, int significant_digits)
+    : highest_(std::max(highest, UINT64_C(2))),
+      sub_bucket_half_count_magnitude_(0),
+      sub_bucket_half_count_(0),
+      sub_bucket_mask_(0),
+      counts_(),
+      total_count_(0),
+      min_(UINT64_MAX),
+      max_(0),
+      sum_(0) {
+  significant_digits = std::min(std::max(significant_digits, 1), 5);
+  double largest_single_unit = 2.0 * pow(10.0, significant_digits);
+  int sub_bucket_count_magnitude = static_cast<int>(ceil(log(largest_single_unit) / log(2.0)));
+  sub_bucket_half_count_magnitude_ = std::max(sub_bucket_count_magnitude, 1) - 1;
+  uint64_t sub_bucket_count = UINT64_C(1) << (sub_bucket_half_count_magnitude_ + 1);
+  sub_bucket_half_count_ = sub_bucket_count / 2;
+  sub_bucket_mask_ = sub_bucket_count - 1;
+
+  size_t buckets = 1;
+  uint64_t smallest_untrackable = sub_bucket_count;
+  while (smallest_untrackable <= highest_) {
+    buckets++;
+    if (smallest_untrackable > UINT64_MAX / 2) {
+      break;
+    }
+    smallest_untrackable <<= 1;
+  }
+  counts_.resize((buckets + 1) * sub_bucket_half_count_);
+}
+
+void LatencyHistogram::Record(uint64_t value) {
+  Record(value, 1);
+}
+
+void LatencyHistogram::Record(uint64_t value, uint64_t count) {
+  if (count == 0) {
+    return;
+  }
+
+  value = std::min(value, highest_);
+  counts_[CountsIndex(value)] += count;
+  total_count_ += count;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+  sum_ += static_cast<double>(value) * count;
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  DCHECK(counts_.size() == other.counts_.size() &&
+         sub_bucket_half_count_ == other.sub_bucket_half_count_);
+  if (other.total_count_ == 0) {
+    return;
+  }
+
+  for (size_t i = 0; i < counts_.size() && i < other.counts_.size(); ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  total_count_ += other.total_count_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+  sum_ += other.sum_;
+}
+
+void LatencyHistogram::Reset() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  total_count_ = 0;
+  min_ = UINT64_MAX;
+  max_ = 0;
+  sum_ = 0;
+}
+
+uint64_t LatencyHistogram::TotalCount() const {
+  return total_count_;
+}
+
+uint64_t LatencyHistogram::Min() const {
+  return total_count_ ? min_ : 0;
+}
+
+uint64_t LatencyHistogram::Max() const {
+  return max_;
+}
+
+double LatencyHistogram::Mean() const {
+  return total_count_ ? sum_ / total_count_ : 0;
+}
+
+uint64_t LatencyHistogram::ValueAtPercentile(double percentile) const {
+  if (total_count_ == 0) {
+    return 0;
+  }
+
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  uint64_t count_at = static_cast<uint64_t>(percentile / 100.0 * total_count_ + 0.5);
+  count_at = std::max(count_at, UINT64_C(1));
+
+  uint64_t total = 0;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    total += counts_[i];
+    if (total >= count_at) {
+      return std::min(HighestEquivalentValue(ValueFromIndex(i)), max_);
+    }
+  }
+
+  return max_;
+}
+
+size_t LatencyHistogram::CountsIndex(uint64_t value) const {
+  int bucket_index = BitLength(value | sub_bucket_mask_) - (sub_bucket_half_count_magnitude_ + 1);
+  uint64_t sub_bucket_index = value >> bucket_index;
+  return (static_cast<size_t>(bucket_index + 1) << sub_bucket_half_count_magnitude_) +
+         static_cast<size_t>(sub_bucket_index - sub_bucket_half_count_);
+}
+
+uint64_t LatencyHistogram::ValueFromIndex(size_t index) const {
+  int bucket_index = static_cast<int>(index >> sub_bucket_half_count_magnitude_) - 1;
+  uint64_t sub_bucket_index = (index & (sub_bucket_half_count_ - 1)) + sub_bucket_half_count_;
+  if (bucket_index < 0) {
+    sub_bucket_index -= sub_bucket_half_count_;
+    bucket_index = 0;
+  }
+  return sub_bucket_index << bucket_index;
+}
+
+uint64_t LatencyHistogram::HighestEquivalentValue(uint64_t value) const {
+  int bucket_index = BitLength(value | sub_bucket_mask_) - (sub_bucket_half_count_magnitude_ + 1);
+  uint64_t sub_bucket_index = value >> bucket_index;
+  uint64_t lowest = sub_bucket_index << bucket_index;
+  return lowest + (UINT64_C(1) << bucket_index) - 1;
+}
+
+AtomicLatencyHistogram::AtomicLatencyHistogram(uint64_t highest, int significant_digits)
+    : layout_(highest, significant_digits),
+      counts_size_(layout_.counts_.size()),
+      counts_(new std::atomic<uint64_t>[counts_size_]),
+      total_count_(0),
+      min_(UINT64_MAX),
+      max_(0),
+      sum_(0) {
+  layout_.counts_.clear();
+  layout_.counts_.shrink_to_fit();
+  for (size_t i = 0; i < counts_size_; ++i) {
+    counts_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void AtomicLatencyHistogram::Record(uint64_t value) {
+  value = std::min(value, layout_.highest_);
+  counts_[layout_.CountsIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  total_count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+
+  uint64_t cur = min_.load(std::memory_order_relaxed);
+  while (value < cur && !min_.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {
+  }
+  cur = max_.load(std::memory_order_relaxed);
+  while (value > cur && !max_.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {
+  }
+}
+
+void AtomicLatencyHistogram::Reset() {
+  for (size_t i = 0; i < counts_size_; ++i) {
+    counts_[i].store(0, std::memory_order_relaxed);
+  }
+  total_count_.store(0, std::memory_order_relaxed);
+  min_.store(UINT64_MAX, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+}
+
+LatencyHistogram AtomicLatencyHistogram::Snapshot() const {
+  LatencyHistogram res(layout_);
+  res.counts_.resize(counts_size_);
+  uint64_t total = 0;
+  for (size_t i = 0; i < counts_size_; ++i) {
+    res.counts_[i] = counts_[i].load(std::memory_order_relaxed);
+    total += res.counts_[i];
+  }
+  // count from buckets, so percentiles stay consistent with the copied counts
+  res.total_count_ = total;
+  res.min_ = min_.load(std::memory_order_relaxed);
+  res.max_ = max_.load(std::memory_order_relaxed);
+  res.sum_ = static_cast<double>(sum_.load(std::memory_order_relaxed));
+  return res;
+}
+
+}  // namespace core
+}  // namespace fastonosql
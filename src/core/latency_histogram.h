@@ -0,0 +1,101 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint64_t
+
+#include <atomic>  // for atomic
+#include <memory>  // for unique_ptr
+#include <vector>  // for vector
+
+#include <common/macros.h>  // for DISALLOW_COPY_AND_ASSIGN
+
+#define LATENCY_HISTOGRAM_HIGHEST_USEC UINT64_C(3600000000)  // 1 hour
+#define LATENCY_HISTOGRAM_SIGNIFICANT_DIGITS 3
+
+namespace fastonosql {
+namespace core {
+
+// HdrHistogram layout: log2 buckets split into linear sub buckets, so every
+// value up to highest is kept with significant_digits decimal precision and
+// memory doesn't depend on the number of samples (~30 KB for defaults).
+// Values above highest are counted as highest. Not thread safe, record per
+// thread and Merge.
+class LatencyHistogram {
+ public:
+  friend class AtomicLatencyHistogram;
+
+  explicit LatencyHistogram(uint64_t highest = LATENCY_HISTOGRAM_HIGHEST_USEC,
+                            int significant_digits = LATENCY_HISTOGRAM_SIGNIFICANT_DIGITS);
+
+  void Record(uint64_t value);
+  void Record(uint64_t value, uint64_t count);
+  void Merge(const LatencyHistogram& other);  // other must have the same layout
+  void Reset();
+
+  uint64_t TotalCount() const;
+  uint64_t Min() const;
+  uint64_t Max() const;
+  double Mean() const;
+  uint64_t ValueAtPercentile(double percentile) const;  // 0 - 100
+
+ private:
+  size_t CountsIndex(uint64_t value) const;
+  uint64_t ValueFromIndex(size_t index) const;
+  uint64_t HighestEquivalentValue(uint64_t value) const;
+
+  uint64_t highest_;
+  int sub_bucket_half_count_magnitude_;
+  uint64_t sub_bucket_half_count_;
+  uint64_t sub_bucket_mask_;
+  std::vector<uint64_t> counts_;
+
+  uint64_t total_count_;
+  uint64_t min_;
+  uint64_t max_;
+  double sum_;
+};
+
+// Same layout as LatencyHistogram, but Record is lock free and may be called
+// from any thread; readers take a Snapshot. Counters are relaxed, so a
+// snapshot taken while recording can be off by in flight samples.
+class AtomicLatencyHistogram {
+ public:
+  explicit AtomicLatencyHistogram(uint64_t highest = LATENCY_HISTOGRAM_HIGHEST_USEC,
+                                  int significant_digits = LATENCY_HISTOGRAM_SIGNIFICANT_DIGITS);
+
+  void Record(uint64_t value);
+  void Reset();
+  LatencyHistogram Snapshot() const;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(AtomicLatencyHistogram);
+
+  LatencyHistogram layout_;  // empty counts, used for index math only
+  const size_t counts_size_;
+  std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+  std::atomic<uint64_t> total_count_;
+  std::atomic<uint64_t> min_;
+  std::atomic<uint64_t> max_;
+  std::atomic<uint64_t> sum_;
+};
+
+}  // namespace core
+}  // namespace fastonosql
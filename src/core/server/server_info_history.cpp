@@ -0,0 +1,927 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "core/server/server_info_history.h"
+
+#include <errno.h>   // for errno, ENOENT
+#include <math.h>    // for floor, isnan
+#include <stdint.h>  // for uint8_t, uint32_t, uint64_t
+#include <stdio.h>   // for FILE, fopen, fwrite, rename, remove
+#include <string.h>  // for memcpy
+
+#ifdef OS_POSIX
+#include <fcntl.h>     // for open
+#include <sys/mman.h>  // for mmap, munmap
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close
+#endif
+
+#include <limits>  // for numeric_limits
+
+#include <common/sprintf.h>  // for MemSPrintf
+#include <common/value.h>    // for ErrorValue
+
+#include "core/db_traits.h"  // for InfoFieldsFromType
+
+#define HISTORY_FILE_MAGIC 0x48534e46  // "FNSH"
+#define HISTORY_BLOCK_MAGIC 0x42534e46  // "FNSB"
+#define HISTORY_FILE_VERSION 1
+#define HISTORY_FILE_HEADER_SIZE 12   // magic, version, columns
+#define HISTORY_BLOCK_HEADER_SIZE 36  // magic, level, count, series, payload, first, last
+
+#define MINUTE_MSEC (60 * 1000LL)
+#define HOUR_MSEC (60 * MINUTE_MSEC)
+
+namespace fastonosql {
+namespace core {
+namespace {
+
+enum SeriesEncoding { SERIES_INT_DELTA = 0, SERIES_XOR = 1 };
+
+typedef ServerInfoHistory::Block Block;
+
+// numbers are stored in host byte order, the file is a local cache
+template <typename T>
+void put_fixed(std::string* out, T value) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T get_fixed(const char* data) {
+  T value;
+  memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+void put_varint(std::string* out, uint64_t value) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+bool get_varint(const char** pos, const char* end, uint64_t* value) {
+  uint64_t res = 0;
+  for (int shift = 0; shift < 64 && *pos < end; shift += 7) {
+    uint8_t byte = static_cast<uint8_t>(**pos);
+    (*pos)++;
+    res |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *value = res;
+      return true;
+    }
+  }
+  return false;
+}
+
+uint64_t zigzag_encode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t zigzag_decode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+uint64_t double_bits(double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+double bits_double(uint64_t bits) {
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// xor of close doubles has zero low bytes, swap them up so varint drops them
+uint64_t swap_bytes(uint64_t value) {
+  uint64_t res = 0;
+  for (int i = 0; i < 8; ++i) {
+    res = (res << 8) | (value & 0xff);
+    value >>= 8;
+  }
+  return res;
+}
+
+bool is_delta_encodable(const std::vector<double>& values) {
+  const double limit = 9007199254740992.0;  // 2^53
+  for (size_t i = 0; i < values.size(); ++i) {
+    double val = values[i];
+    if (isnan(val) || val != floor(val) || val > limit || val < -limit) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void encode_timestamps(const std::vector<common::time64_t>& msec, std::string* out) {
+  int64_t prev = 0;
+  int64_t prev_delta = 0;
+  for (size_t i = 0; i < msec.size(); ++i) {
+    int64_t delta = msec[i] - prev;
+    put_varint(out, zigzag_encode(delta - prev_delta));
+    prev_delta = delta;
+    prev = msec[i];
+  }
+}
+
+bool decode_timestamps(const char* pos,
+                       const char* end,
+                       size_t count,
+                       std::vector<common::time64_t>* msec) {
+  int64_t prev = 0;
+  int64_t prev_delta = 0;
+  msec->resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t raw;
+    if (!get_varint(&pos, end, &raw)) {
+      return false;
+    }
+    prev_delta += zigzag_decode(raw);
+    prev += prev_delta;
+    (*msec)[i] = prev;
+  }
+  return true;
+}
+
+void encode_series(const std::vector<double>& values, std::string* out) {
+  if (is_delta_encodable(values)) {
+    out->push_back(SERIES_INT_DELTA);
+    int64_t prev = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+      int64_t cur = static_cast<int64_t>(values[i]);
+      put_varint(out, zigzag_encode(cur - prev));
+      prev = cur;
+    }
+    return;
+  }
+
+  out->push_back(SERIES_XOR);
+  uint64_t prev = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    uint64_t cur = double_bits(values[i]);
+    put_varint(out, swap_bytes(cur ^ prev));
+    prev = cur;
+  }
+}
+
+bool decode_series(const char* pos, const char* end, size_t count, std::vector<double>* values) {
+  if (pos >= end) {
+    return false;
+  }
+
+  uint8_t encoding = static_cast<uint8_t>(*pos++);
+  values->resize(count);
+  if (encoding == SERIES_INT_DELTA) {
+    int64_t prev = 0;
+    for (size_t i = 0; i < count; ++i) {
+      uint64_t raw;
+      if (!get_varint(&pos, end, &raw)) {
+        return false;
+      }
+      prev += zigzag_decode(raw);
+      (*values)[i] = static_cast<double>(prev);
+    }
+    return true;
+  }
+
+  if (encoding == SERIES_XOR) {
+    uint64_t prev = 0;
+    for (size_t i = 0; i < count; ++i) {
+      uint64_t raw;
+      if (!get_varint(&pos, end, &raw)) {
+        return false;
+      }
+      prev ^= swap_bytes(raw);
+      (*values)[i] = bits_double(prev);
+    }
+    return true;
+  }
+
+  return false;
+}
+
+std::string encode_block(const Block& block) {
+  std::string payload;
+  std::vector<uint32_t> offsets;
+  encode_timestamps(block.msec, &payload);
+  for (size_t i = 0; i < block.series.size(); ++i) {
+    offsets.push_back(payload.size());
+    encode_series(block.series[i], &payload);
+  }
+
+  std::string out;
+  put_fixed<uint32_t>(&out, HISTORY_BLOCK_MAGIC);
+  put_fixed<uint32_t>(&out, block.level);
+  put_fixed<uint32_t>(&out, block.msec.size());
+  put_fixed<uint32_t>(&out, offsets.size());
+  put_fixed<uint32_t>(&out, payload.size());
+  put_fixed<int64_t>(&out, block.msec.front());
+  put_fixed<int64_t>(&out, block.msec.back());
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    put_fixed<uint32_t>(&out, offsets[i]);
+  }
+  out += payload;
+  return out;
+}
+
+struct BlockHeader {
+  ServerInfoHistory::Level level;
+  uint32_t count;
+  uint32_t series;
+  common::time64_t first_msec;
+  common::time64_t last_msec;
+  const char* offsets;
+  const char* payload;
+  const char* end;
+};
+
+bool parse_block_header(const char* data, size_t size, BlockHeader* header) {
+  if (size < HISTORY_BLOCK_HEADER_SIZE || get_fixed<uint32_t>(data) != HISTORY_BLOCK_MAGIC) {
+    return false;
+  }
+
+  uint32_t level = get_fixed<uint32_t>(data + 4);
+  if (level > ServerInfoHistory::HOURS) {
+    return false;
+  }
+
+  header->level = static_cast<ServerInfoHistory::Level>(level);
+  header->count = get_fixed<uint32_t>(data + 8);
+  header->series = get_fixed<uint32_t>(data + 12);
+  uint32_t payload_size = get_fixed<uint32_t>(data + 16);
+  header->first_msec = get_fixed<int64_t>(data + 20);
+  header->last_msec = get_fixed<int64_t>(data + 28);
+  size_t offsets_size = static_cast<size_t>(header->series) * sizeof(uint32_t);
+  if (header->count == 0 || size - HISTORY_BLOCK_HEADER_SIZE < offsets_size ||
+      size - HISTORY_BLOCK_HEADER_SIZE - offsets_size < payload_size) {
+    return false;
+  }
+
+  header->offsets = data + HISTORY_BLOCK_HEADER_SIZE;
+  header->payload = header->offsets + offsets_size;
+  header->end = header->payload + payload_size;
+  return true;
+}
+
+bool decode_block_series(const BlockHeader& header, size_t series, std::vector<double>* values) {
+  if (series >= header.series) {
+    return false;
+  }
+
+  uint32_t offset = get_fixed<uint32_t>(header.offsets + series * sizeof(uint32_t));
+  if (offset >= header.end - header.payload) {
+    return false;
+  }
+  return decode_series(header.payload + offset, header.end, header.count, values);
+}
+
+bool decode_block(const BlockHeader& header, size_t columns, Block* block) {
+  block->level = header.level;
+  block->columns = columns;
+  block->series.resize(block->SeriesCount());
+  if (header.series != block->series.size()) {
+    return false;
+  }
+
+  if (!decode_timestamps(header.payload, header.end, header.count, &block->msec)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < block->series.size(); ++i) {
+    if (!decode_block_series(header, i, &block->series[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// read only view of the history file
+class MappedFile {
+ public:
+  MappedFile() : data_(NULL), size_(0) {}
+  ~MappedFile() {
+#ifdef OS_POSIX
+    if (data_) {
+      munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+  }
+
+  bool Open(const std::string& path) {
+#ifdef OS_POSIX
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      return false;
+    }
+
+    size_ = st.st_size;
+    if (size_ == 0) {
+      close(fd);
+      return true;
+    }
+
+    void* mapped = mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+      size_ = 0;
+      return false;
+    }
+    data_ = static_cast<const char*>(mapped);
+    return true;
+#else
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+      return false;
+    }
+
+    char chunk[65536];
+    size_t readed = 0;
+    while ((readed = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+      buffer_.append(chunk, readed);
+    }
+    fclose(file);
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    return true;
+#endif
+  }
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const char* data_;
+  size_t size_;
+#ifndef OS_POSIX
+  std::string buffer_;
+#endif
+};
+
+// fills blocks of one level and keeps them encoded
+class LevelWriter {
+ public:
+  LevelWriter(ServerInfoHistory::Level level, size_t columns)
+      : block_(level, columns), encoded_() {}
+
+  void Add(common::time64_t msec, const Block& src, size_t pos) {
+    block_.msec.push_back(msec);
+    for (size_t i = 0; i < block_.series.size(); ++i) {
+      block_.series[i].push_back(src.series[i][pos]);
+    }
+    if (block_.msec.size() == HISTORY_BLOCK_SAMPLES) {
+      FlushBlock();
+    }
+  }
+
+  void AddRollup(common::time64_t msec, const std::vector<double>& values) {
+    block_.msec.push_back(msec);
+    for (size_t i = 0; i < block_.series.size(); ++i) {
+      block_.series[i].push_back(values[i]);
+    }
+    if (block_.msec.size() == HISTORY_BLOCK_SAMPLES) {
+      FlushBlock();
+    }
+  }
+
+  void FlushBlock() {
+    if (!block_.msec.empty()) {
+      encoded_ += encode_block(block_);
+      block_.Clear();
+    }
+  }
+
+  const std::string& Encoded() const { return encoded_; }
+
+ private:
+  Block block_;
+  std::string encoded_;
+};
+
+// downsamples one level into fixed width buckets of the next one
+class RollupBuilder {
+ public:
+  RollupBuilder(common::time64_t width, size_t columns, LevelWriter* out)
+      : width_(width),
+        columns_(columns),
+        out_(out),
+        bucket_(0),
+        has_bucket_(false),
+        min_(columns),
+        max_(columns),
+        sum_(columns),
+        count_(columns) {}
+
+  // src series are values (raw) or min/max/avg triples (rollups)
+  void Add(common::time64_t msec, const Block& src, size_t pos) {
+    common::time64_t bucket = msec - ((msec % width_) + width_) % width_;
+    if (has_bucket_ && bucket != bucket_) {
+      Flush();
+    }
+    if (!has_bucket_) {
+      bucket_ = bucket;
+      has_bucket_ = true;
+    }
+
+    const bool raw = src.level == ServerInfoHistory::RAW;
+    for (size_t c = 0; c < columns_; ++c) {
+      double min = raw ? src.series[c][pos] : src.series[3 * c][pos];
+      double max = raw ? min : src.series[3 * c + 1][pos];
+      double avg = raw ? min : src.series[3 * c + 2][pos];
+      if (isnan(avg)) {
+        continue;
+      }
+
+      if (count_[c] == 0 || min < min_[c]) {
+        min_[c] = min;
+      }
+      if (count_[c] == 0 || max > max_[c]) {
+        max_[c] = max;
+      }
+      sum_[c] += avg;
+      count_[c]++;
+    }
+  }
+
+  void Flush() {
+    if (!has_bucket_) {
+      return;
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> values(3 * columns_);
+    for (size_t c = 0; c < columns_; ++c) {
+      bool empty = count_[c] == 0;
+      values[3 * c] = empty ? nan : min_[c];
+      values[3 * c + 1] = empty ? nan : max_[c];
+      values[3 * c + 2] = empty ? nan : sum_[c] / count_[c];
+      sum_[c] = 0;
+      count_[c] = 0;
+    }
+    out_->AddRollup(bucket_, values);
+    has_bucket_ = false;
+  }
+
+ private:
+  const common::time64_t width_;
+  const size_t columns_;
+  LevelWriter* out_;
+  common::time64_t bucket_;
+  bool has_bucket_;
+  std::vector<double> min_;
+  std::vector<double> max_;
+  std::vector<double> sum_;
+  std::vector<size_t> count_;
+};
+
+bool write_file(const std::string& path, const std::string& data) {
+  FILE* file = fopen(path.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+
+  bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+  ok = fflush(file) == 0 && ok;
+  fclose(file);
+  return ok;
+}
+
+bool replace_file(const std::string& from, const std::string& to) {
+#ifdef OS_WIN
+  remove(to.c_str());
+#endif
+  return rename(from.c_str(), to.c_str()) == 0;
+}
+
+std::string file_header(size_t columns) {
+  std::string header;
+  put_fixed<uint32_t>(&header, HISTORY_FILE_MAGIC);
+  put_fixed<uint32_t>(&header, HISTORY_FILE_VERSION);
+  put_fixed<uint32_t>(&header, columns);
+  return header;
+}
+
+common::time64_t align_down(common::time64_t msec, common::time64_t width) {
+  return msec - ((msec % width) + width) % width;
+}
+
+}  // namespace
+
+HistoryPoint::HistoryPoint() : msec(0), min(0), max(0), avg(0) {}
+
+HistoryPoint::HistoryPoint(common::time64_t msec, double min, double max, double avg)
+    : msec(msec), min(min), max(max), avg(avg) {}
+
+HistoryColumn::HistoryColumn(unsigned char property, unsigned char field)
+    : property(property), field(field) {}
+
+std::vector<HistoryColumn> HistoryColumnsFromType(connectionTypes type) {
+  std::vector<HistoryColumn> columns;
+  std::vector<info_field_t> fields = InfoFieldsFromType(type);
+  for (size_t i = 0; i < fields.size(); ++i) {
+    const std::vector<Field>& property = fields[i].second;
+    for (size_t j = 0; j < property.size(); ++j) {
+      if (property[j].IsIntegral()) {
+        columns.push_back(HistoryColumn(i, j));
+      }
+    }
+  }
+  return columns;
+}
+
+ServerInfoHistory::Block::Block(Level level, size_t columns)
+    : level(level), columns(columns), msec(), series() {
+  series.resize(SeriesCount());
+}
+
+size_t ServerInfoHistory::Block::SeriesCount() const {
+  return level == RAW ? columns : 3 * columns;
+}
+
+void ServerInfoHistory::Block::Clear() {
+  msec.clear();
+  for (size_t i = 0; i < series.size(); ++i) {
+    series[i].clear();
+  }
+}
+
+ServerInfoHistory::ServerInfoHistory(const std::string& path, size_t columns)
+    : path_(path),
+      columns_(columns),
+      opened_(false),
+      index_(),
+      file_size_(0),
+      pending_(RAW, columns),
+      last_compact_msec_(0) {}
+
+ServerInfoHistory::~ServerInfoHistory() {
+  if (opened_) {
+    common::Error err = Flush();
+    DCHECK(!err);
+  }
+}
+
+common::Error ServerInfoHistory::Open() {
+  if (opened_) {
+    return common::Error();
+  }
+
+  MappedFile file;
+  if (!file.Open(path_)) {
+    return CreateFile();
+  }
+
+  bool valid = file.size() >= HISTORY_FILE_HEADER_SIZE &&
+               get_fixed<uint32_t>(file.data()) == HISTORY_FILE_MAGIC &&
+               get_fixed<uint32_t>(file.data() + 4) == HISTORY_FILE_VERSION &&
+               get_fixed<uint32_t>(file.data() + 8) == columns_;
+  if (!valid) {
+    // old text history or other fields set, keep it aside
+    std::string old_path = path_ + ".old";
+    if (!replace_file(path_, old_path)) {
+      return common::make_error_value(
+          common::MemSPrintf("Couldn't move history file %s aside", path_),
+          common::ErrorValue::E_ERROR);
+    }
+    return CreateFile();
+  }
+
+  opened_ = true;
+  bool truncated = false;
+  common::Error err = LoadIndex(&truncated);
+  if (err && err->isError()) {
+    opened_ = false;
+    return err;
+  }
+
+  if (truncated || NeedsCompact(0)) {
+    return Compact(0);
+  }
+  return common::Error();
+}
+
+bool ServerInfoHistory::IsOpened() const {
+  return opened_;
+}
+
+common::Error ServerInfoHistory::Append(common::time64_t msec, const std::vector<double>& values) {
+  if (!opened_) {
+    return common::make_error_value("History isn't opened", common::ErrorValue::E_ERROR);
+  }
+
+  if (values.size() != columns_) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  pending_.msec.push_back(msec);
+  for (size_t i = 0; i < columns_; ++i) {
+    pending_.series[i].push_back(values[i]);
+  }
+
+  if (pending_.msec.size() >= HISTORY_BLOCK_SAMPLES) {
+    common::Error err = Flush();
+    if (err && err->isError()) {
+      return err;
+    }
+  }
+
+  if (last_compact_msec_ == 0) {
+    last_compact_msec_ = msec;
+  } else if (msec - last_compact_msec_ > HISTORY_COMPACT_INTERVAL_MSEC) {
+    last_compact_msec_ = msec;
+    if (NeedsCompact(msec)) {
+      return Compact(msec);
+    }
+  }
+  return common::Error();
+}
+
+common::Error ServerInfoHistory::Flush() {
+  if (pending_.msec.empty()) {
+    return common::Error();
+  }
+
+  common::Error err = WriteBlock(pending_);
+  pending_.Clear();
+  return err;
+}
+
+common::Error ServerInfoHistory::Read(size_t column,
+                                      common::time64_t from_msec,
+                                      common::time64_t to_msec,
+                                      std::vector<HistoryPoint>* points) {
+  if (!points || column >= columns_) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  if (!opened_) {
+    return common::make_error_value("History isn't opened", common::ErrorValue::E_ERROR);
+  }
+
+  MappedFile file;
+  if (!index_.empty() && !file.Open(path_)) {
+    return common::make_error_value(common::MemSPrintf("Couldn't open history file %s", path_),
+                                    common::ErrorValue::E_ERROR);
+  }
+
+  std::vector<common::time64_t> msec;
+  std::vector<double> mins, maxs, avgs;
+  for (size_t i = 0; i < index_.size(); ++i) {
+    const BlockIndex& bi = index_[i];
+    if (bi.last_msec < from_msec || bi.first_msec > to_msec) {
+      continue;
+    }
+
+    BlockHeader header;
+    if (bi.offset + bi.size > file.size() ||
+        !parse_block_header(file.data() + bi.offset, bi.size, &header) ||
+        !decode_timestamps(header.payload, header.end, header.count, &msec)) {
+      return common::make_error_value("History file is corrupted", common::ErrorValue::E_ERROR);
+    }
+
+    bool ok = true;
+    if (bi.level == RAW) {
+      ok = decode_block_series(header, column, &avgs);
+      mins = avgs;
+      maxs = avgs;
+    } else {
+      ok = decode_block_series(header, 3 * column, &mins) &&
+           decode_block_series(header, 3 * column + 1, &maxs) &&
+           decode_block_series(header, 3 * column + 2, &avgs);
+    }
+    if (!ok) {
+      return common::make_error_value("History file is corrupted", common::ErrorValue::E_ERROR);
+    }
+
+    for (size_t j = 0; j < msec.size(); ++j) {
+      if (msec[j] >= from_msec && msec[j] <= to_msec && !isnan(avgs[j])) {
+        points->push_back(HistoryPoint(msec[j], mins[j], maxs[j], avgs[j]));
+      }
+    }
+  }
+
+  const std::vector<double>& pending = pending_.series[column];
+  for (size_t j = 0; j < pending_.msec.size(); ++j) {
+    common::time64_t cur = pending_.msec[j];
+    if (cur >= from_msec && cur <= to_msec && !isnan(pending[j])) {
+      points->push_back(HistoryPoint(cur, pending[j], pending[j], pending[j]));
+    }
+  }
+  return common::Error();
+}
+
+common::Error ServerInfoHistory::Compact(common::time64_t now_msec) {
+  if (!opened_) {
+    return common::make_error_value("History isn't opened", common::ErrorValue::E_ERROR);
+  }
+
+  common::Error err = Flush();
+  if (err && err->isError()) {
+    return err;
+  }
+
+  if (now_msec == 0) {
+    now_msec = index_.empty() ? 0 : index_.back().last_msec;
+  }
+
+  const common::time64_t raw_threshold =
+      align_down(now_msec - HISTORY_RAW_RETENTION_MSEC, MINUTE_MSEC);
+  const common::time64_t minutes_threshold =
+      align_down(now_msec - HISTORY_MINUTES_RETENTION_MSEC, HOUR_MSEC);
+
+  LevelWriter hours(HOURS, columns_);
+  LevelWriter minutes(MINUTES, columns_);
+  LevelWriter raw(RAW, columns_);
+  RollupBuilder to_hours(HOUR_MSEC, columns_, &hours);
+  RollupBuilder to_minutes(MINUTE_MSEC, columns_, &minutes);
+
+  // blocks are ordered hours, minutes, raw and by time inside a level,
+  // so every writer receives its samples in time order
+  {
+    MappedFile file;
+    if (!index_.empty() && !file.Open(path_)) {
+      return common::make_error_value(common::MemSPrintf("Couldn't open history file %s", path_),
+                                      common::ErrorValue::E_ERROR);
+    }
+
+    Block block(RAW, columns_);
+    for (size_t i = 0; i < index_.size(); ++i) {
+      const BlockIndex& bi = index_[i];
+      BlockHeader header;
+      if (bi.offset + bi.size > file.size() ||
+          !parse_block_header(file.data() + bi.offset, bi.size, &header) ||
+          !decode_block(header, columns_, &block)) {
+        // rewriting without the block would lose its samples, keep the file as is
+        return common::make_error_value("History file is corrupted", common::ErrorValue::E_ERROR);
+      }
+
+      for (size_t j = 0; j < block.msec.size(); ++j) {
+        common::time64_t msec = block.msec[j];
+        if (block.level == HOURS) {
+          hours.Add(msec, block, j);
+        } else if (block.level == MINUTES) {
+          if (msec < minutes_threshold) {
+            to_hours.Add(msec, block, j);
+          } else {
+            minutes.Add(msec, block, j);
+          }
+        } else {
+          if (msec < raw_threshold) {
+            to_minutes.Add(msec, block, j);
+          } else {
+            raw.Add(msec, block, j);
+          }
+        }
+      }
+    }
+  }
+
+  to_hours.Flush();
+  to_minutes.Flush();
+  hours.FlushBlock();
+  minutes.FlushBlock();
+  raw.FlushBlock();
+
+  const std::string tmp_path = path_ + ".tmp";
+  std::string data = file_header(columns_) + hours.Encoded() + minutes.Encoded() + raw.Encoded();
+  if (!write_file(tmp_path, data) || !replace_file(tmp_path, path_)) {
+    return common::make_error_value(
+        common::MemSPrintf("Couldn't write history file %s", path_), common::ErrorValue::E_ERROR);
+  }
+
+  bool truncated = false;
+  return LoadIndex(&truncated);
+}
+
+common::Error ServerInfoHistory::Clear() {
+  if (remove(path_.c_str()) != 0 && errno != ENOENT) {
+    return common::make_error_value(common::MemSPrintf("Couldn't remove history file %s", path_),
+                                    common::ErrorValue::E_ERROR);
+  }
+
+  pending_.Clear();
+  opened_ = false;
+  return CreateFile();
+}
+
+common::Error ServerInfoHistory::CreateFile() {
+  if (!write_file(path_, file_header(columns_))) {
+    return common::make_error_value(common::MemSPrintf("Couldn't create history file %s", path_),
+                                    common::ErrorValue::E_ERROR);
+  }
+
+  index_.clear();
+  file_size_ = HISTORY_FILE_HEADER_SIZE;
+  opened_ = true;
+  return common::Error();
+}
+
+common::Error ServerInfoHistory::LoadIndex(bool* truncated) {
+  index_.clear();
+  file_size_ = 0;
+  *truncated = false;
+
+  MappedFile file;
+  if (!file.Open(path_)) {
+    return common::make_error_value(common::MemSPrintf("Couldn't open history file %s", path_),
+                                    common::ErrorValue::E_ERROR);
+  }
+
+  // headers only, payloads are skipped by size
+  size_t offset = HISTORY_FILE_HEADER_SIZE;
+  while (offset < file.size()) {
+    BlockHeader header;
+    if (!parse_block_header(file.data() + offset, file.size() - offset, &header)) {
+      *truncated = true;  // partly written block after a crash
+      break;
+    }
+
+    BlockIndex bi;
+    bi.offset = offset;
+    bi.size = header.end - (file.data() + offset);
+    bi.level = header.level;
+    bi.first_msec = header.first_msec;
+    bi.last_msec = header.last_msec;
+    index_.push_back(bi);
+    offset += bi.size;
+  }
+
+  file_size_ = offset;
+  return common::Error();
+}
+
+common::Error ServerInfoHistory::WriteBlock(const Block& block) {
+  std::string encoded = encode_block(block);
+  FILE* file = fopen(path_.c_str(), "ab");
+  if (!file) {
+    return common::make_error_value(common::MemSPrintf("Couldn't open history file %s", path_),
+                                    common::ErrorValue::E_ERROR);
+  }
+
+  bool ok = fwrite(encoded.data(), 1, encoded.size(), file) == encoded.size();
+  ok = fflush(file) == 0 && ok;
+  fclose(file);
+  if (!ok) {
+    return common::make_error_value(common::MemSPrintf("Couldn't write history file %s", path_),
+                                    common::ErrorValue::E_ERROR);
+  }
+
+  BlockIndex bi;
+  bi.offset = file_size_;
+  bi.size = encoded.size();
+  bi.level = block.level;
+  bi.first_msec = block.msec.front();
+  bi.last_msec = block.msec.back();
+  index_.push_back(bi);
+  file_size_ += encoded.size();
+  return common::Error();
+}
+
+bool ServerInfoHistory::NeedsCompact(common::time64_t now_msec) const {
+  if (index_.empty()) {
+    return false;
+  }
+
+  if (now_msec == 0) {
+    now_msec = index_.back().last_msec;
+  }
+
+  const common::time64_t raw_threshold =
+      align_down(now_msec - HISTORY_RAW_RETENTION_MSEC, MINUTE_MSEC);
+  const common::time64_t minutes_threshold =
+      align_down(now_msec - HISTORY_MINUTES_RETENTION_MSEC, HOUR_MSEC);
+  for (size_t i = 0; i < index_.size(); ++i) {
+    const BlockIndex& bi = index_[i];
+    if ((bi.level == RAW && bi.first_msec < raw_threshold) ||
+        (bi.level == MINUTES && bi.first_msec < minutes_threshold)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace core
+}  // namespace fastonosql
@@ -0,0 +1,124 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include <common/error.h>   // for Error
+#include <common/macros.h>  // for WARN_UNUSED_RESULT
+#include <common/types.h>   // for time64_t
+
+#include "core/connection_types.h"  // for connectionTypes
+
+#define HISTORY_BLOCK_SAMPLES 60                                 // samples per encoded block
+#define HISTORY_RAW_RETENTION_MSEC (24 * 60 * 60 * 1000LL)       // older raw -> minutes
+#define HISTORY_MINUTES_RETENTION_MSEC (7 * 24 * 60 * 60 * 1000LL)  // older minutes -> hours
+#define HISTORY_COMPACT_INTERVAL_MSEC (60 * 60 * 1000LL)
+
+namespace fastonosql {
+namespace core {
+
+// raw samples have min == max == avg
+struct HistoryPoint {
+  HistoryPoint();
+  HistoryPoint(common::time64_t msec, double min, double max, double avg);
+
+  common::time64_t msec;
+  double min;
+  double max;
+  double avg;
+};
+
+// integral INFO field stored as a history column
+struct HistoryColumn {
+  HistoryColumn(unsigned char property, unsigned char field);
+
+  unsigned char property;  // index in InfoFields
+  unsigned char field;     // index in property fields
+};
+
+std::vector<HistoryColumn> HistoryColumnsFromType(connectionTypes type);
+
+// append only columnar file of numeric INFO samples:
+// header, then blocks of HISTORY_BLOCK_SAMPLES samples ordered by time, each
+// block keeps delta of delta timestamps and one delta or xor encoded stream
+// per column, so a single metric is decoded without touching the others;
+// raw samples older than HISTORY_RAW_RETENTION_MSEC are downsampled into
+// 1 minute min/max/avg rollups, minute rollups into 1 hour rollups
+class ServerInfoHistory {
+ public:
+  enum Level { RAW = 0, MINUTES = 1, HOURS = 2 };
+
+  ServerInfoHistory(const std::string& path, size_t columns);
+  ~ServerInfoHistory();
+
+  common::Error Open() WARN_UNUSED_RESULT;
+  bool IsOpened() const;
+
+  // values.size() must be columns, NaN marks missing value
+  common::Error Append(common::time64_t msec, const std::vector<double>& values)
+      WARN_UNUSED_RESULT;
+  common::Error Flush() WARN_UNUSED_RESULT;
+  common::Error Read(size_t column,
+                     common::time64_t from_msec,
+                     common::time64_t to_msec,
+                     std::vector<HistoryPoint>* points) WARN_UNUSED_RESULT;
+  common::Error Compact(common::time64_t now_msec) WARN_UNUSED_RESULT;
+  common::Error Clear() WARN_UNUSED_RESULT;
+
+  struct Block {
+    Block(Level level, size_t columns);
+
+    size_t SeriesCount() const;  // columns for raw, 3 * columns for rollups
+    void Clear();
+
+    Level level;
+    size_t columns;
+    std::vector<common::time64_t> msec;
+    std::vector<std::vector<double> > series;  // rollup column c: min 3c, max 3c+1, avg 3c+2
+  };
+
+ private:
+  struct BlockIndex {
+    size_t offset;
+    size_t size;
+    Level level;
+    common::time64_t first_msec;
+    common::time64_t last_msec;
+  };
+
+  common::Error CreateFile() WARN_UNUSED_RESULT;
+  common::Error LoadIndex(bool* truncated) WARN_UNUSED_RESULT;
+  common::Error WriteBlock(const Block& block) WARN_UNUSED_RESULT;
+  bool NeedsCompact(common::time64_t now_msec) const;
+
+  const std::string path_;
+  const size_t columns_;
+  bool opened_;
+  std::vector<BlockIndex> index_;
+  size_t file_size_;
+  Block pending_;
+  common::time64_t last_compact_msec_;
+};
+
+}  // namespace core
+}  // namespace fastonosql
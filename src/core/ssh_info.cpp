@@ -37,6 +37,8 @@
 #define PRIVKEY_FIELD "privateKey"
 #define PASSPHRASE_FIELD "passphrase"
 #define CURMETHOD_FIELD "currentMethod"
+#define WINDOW_SIZE_FIELD "windowSize"
+#define PACKET_SIZE_FIELD "packetSize"
 #define MARKER "\r\n"
 
 namespace {
@@ -50,7 +52,9 @@ std::string ConvertToString(const fastonosql::core::SSHInfo& ssh_info) {
          ssh_info.user_name + MARKER PASSWORD_FIELD ":" + ssh_info.password +
          MARKER PUBKEY_FIELD ":" + ssh_info.public_key + MARKER PRIVKEY_FIELD ":" +
          ssh_info.private_key + MARKER PASSPHRASE_FIELD ":" + ssh_info.passphrase +
-         MARKER CURMETHOD_FIELD ":" + common::ConvertToString(ssh_info.current_method) + MARKER;
+         MARKER CURMETHOD_FIELD ":" + common::ConvertToString(ssh_info.current_method) +
+         MARKER WINDOW_SIZE_FIELD ":" + common::ConvertToString(ssh_info.window_size) +
+         MARKER PACKET_SIZE_FIELD ":" + common::ConvertToString(ssh_info.packet_size) + MARKER;
 }
 
 template <>
@@ -86,7 +90,9 @@ SSHInfo::SSHInfo()
       password(),
       public_key(common::file_system::prepare_path(DEFAULT_PUB_KEY_PATH)),
       private_key(common::file_system::prepare_path(DEFAULT_PRIVATE_KEY_PATH)),
-      current_method(UNKNOWN) {}
+      current_method(UNKNOWN),
+      window_size(DEFAULT_SSH_WINDOW_SIZE),
+      packet_size(DEFAULT_SSH_PACKET_SIZE) {}
 
 SSHInfo::SSHInfo(const common::net::HostAndPort& host,
                  const std::string& userName,
@@ -101,7 +107,9 @@ SSHInfo::SSHInfo(const common::net::HostAndPort& host,
       public_key(publicKey),
       private_key(privateKey),
       passphrase(passphrase),
-      current_method(method) {}
+      current_method(method),
+      window_size(DEFAULT_SSH_WINDOW_SIZE),
+      packet_size(DEFAULT_SSH_PACKET_SIZE) {}
 
 SSHInfo::SSHInfo(const std::string& text)
     : host(common::net::HostAndPort::createLocalHost(DEFAULT_SSH_PORT)),
@@ -110,7 +118,9 @@ SSHInfo::SSHInfo(const std::string& text)
       public_key(common::file_system::prepare_path(DEFAULT_PUB_KEY_PATH)),
       private_key(common::file_system::prepare_path(DEFAULT_PRIVATE_KEY_PATH)),
       passphrase(),
-      current_method(UNKNOWN) {
+      current_method(UNKNOWN),
+      window_size(DEFAULT_SSH_WINDOW_SIZE),
+      packet_size(DEFAULT_SSH_PACKET_SIZE) {
   size_t pos = 0;
   size_t start = 0;
   while ((pos = text.find(MARKER, start)) != std::string::npos) {
@@ -133,6 +143,10 @@ SSHInfo::SSHInfo(const std::string& text)
         passphrase = value;
       } else if (field == CURMETHOD_FIELD) {
         current_method = common::ConvertFromString<SupportedAuthenticationMetods>(value);
+      } else if (field == WINDOW_SIZE_FIELD) {
+        window_size = common::ConvertFromString<uint32_t>(value);
+      } else if (field == PACKET_SIZE_FIELD) {
+        packet_size = common::ConvertFromString<uint32_t>(value);
       }
     }
     start = pos + sizeof(MARKER) - 1;
@@ -18,10 +18,19 @@
 
 #pragma once
 
+#include <stdint.h>  // for uint32_t
+
 #include <string>  // for string, operator==
 
 #include <common/net/types.h>  // for operator==, HostAndPort
 
+// Tunnel channel tuning: throughput over ssh is bounded by window / rtt,
+// libssh2 can't receive transport packets bigger than 32 KB.
+#define DEFAULT_SSH_WINDOW_SIZE (16 * 1024 * 1024)
+#define MIN_SSH_WINDOW_SIZE (256 * 1024)
+#define DEFAULT_SSH_PACKET_SIZE (32 * 1024)
+#define MAX_SSH_PACKET_SIZE (32 * 1024)
+
 namespace fastonosql {
 namespace core {
 
@@ -50,12 +59,16 @@ struct SSHInfo {
   std::string passphrase;
 
   SupportedAuthenticationMetods current_method;
+
+  uint32_t window_size;
+  uint32_t packet_size;
 };
 
 inline bool operator==(const SSHInfo& r, const SSHInfo& l) {
   return r.host == l.host && r.password == l.password && r.public_key == l.public_key &&
          r.private_key == l.private_key && r.passphrase == l.passphrase &&
-         r.user_name == l.user_name;
+         r.user_name == l.user_name && r.window_size == l.window_size &&
+         r.packet_size == l.packet_size;
 }
 
 }  // namespace core
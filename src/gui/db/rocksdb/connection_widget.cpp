@@ -22,6 +22,10 @@
 
 #include "proxy/db/rocksdb/connection_settings.h"
 
+namespace {
+const QString trEnableStatistics = QObject::tr("Collect statistics (tickers, histograms)");
+}
+
 namespace fastonosql {
 namespace gui {
 namespace rocksdb {
@@ -30,6 +34,8 @@ ConnectionWidget::ConnectionWidget(QWidget* parent)
     : ConnectionLocalWidget(true, trDBPath, trCaption, trFilter, parent) {
   createDBIfMissing_ = new QCheckBox;
   addWidget(createDBIfMissing_);
+  enableStatistics_ = new QCheckBox;
+  addWidget(enableStatistics_);
 }
 
 void ConnectionWidget::syncControls(proxy::IConnectionSettingsBase* connection) {
@@ -38,12 +44,14 @@ void ConnectionWidget::syncControls(proxy::IConnectionSettingsBase* connection)
   if (rock) {
     core::rocksdb::Config config = rock->Info();
     createDBIfMissing_->setChecked(config.create_if_missing);
+    enableStatistics_->setChecked(config.enable_statistics);
   }
   ConnectionLocalWidget::syncControls(rock);
 }
 
 void ConnectionWidget::retranslateUi() {
   createDBIfMissing_->setText(trCreateDBIfMissing);
+  enableStatistics_->setText(trEnableStatistics);
   ConnectionLocalWidget::retranslateUi();
 }
 
@@ -52,6 +60,7 @@ proxy::IConnectionSettingsLocal* ConnectionWidget::createConnectionLocalImpl(
   proxy::rocksdb::ConnectionSettings* conn = new proxy::rocksdb::ConnectionSettings(path);
   core::rocksdb::Config config = conn->Info();
   config.create_if_missing = createDBIfMissing_->isChecked();
+  config.enable_statistics = enableStatistics_->isChecked();
   conn->SetInfo(config);
   return conn;
 }
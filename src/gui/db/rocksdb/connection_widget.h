@@ -39,6 +39,7 @@ class ConnectionWidget : public ConnectionLocalWidget {
       const proxy::connection_path_t& path) const override;
 
   QCheckBox* createDBIfMissing_;
+  QCheckBox* enableStatistics_;
 };
 
 }  // namespace rocksdb
@@ -19,16 +19,20 @@
 #include "gui/db/upscaledb/connection_widget.h"
 
 #include <QCheckBox>
+#include <QComboBox>
 #include <QSpinBox>
 #include <QHBoxLayout>
 #include <QLabel>
 
+#include <common/convert2string.h>  // for ConvertFromString
+
 #include "proxy/db/upscaledb/connection_settings.h"
 
 #include "proxy/connection_settings/iconnection_settings_local.h"
 
 namespace {
 const QString trDefaultDb = QObject::tr("Default database:");
+const QString trKeyType = QObject::tr("Key type:");
 }
 
 namespace fastonosql {
@@ -48,6 +52,17 @@ ConnectionWidget::ConnectionWidget(QWidget* parent)
   def_layout->addWidget(defaultDBLabel_);
   def_layout->addWidget(defaultDBNum_);
   addLayout(def_layout);
+
+  QHBoxLayout* key_layout = new QHBoxLayout;
+  keyTypeLabel_ = new QLabel;
+  keyType_ = new QComboBox;
+  for (int i = core::upscaledb::KEY_BINARY; i <= core::upscaledb::KEY_REAL64; ++i) {
+    std::string str = common::ConvertToString(static_cast<core::upscaledb::KeyType>(i));
+    keyType_->addItem(common::ConvertFromString<QString>(str));
+  }
+  key_layout->addWidget(keyTypeLabel_);
+  key_layout->addWidget(keyType_);
+  addLayout(key_layout);
 }
 
 void ConnectionWidget::syncControls(proxy::IConnectionSettingsBase* connection) {
@@ -57,6 +72,7 @@ void ConnectionWidget::syncControls(proxy::IConnectionSettingsBase* connection)
     core::upscaledb::Config config = ups->Info();
     createDBIfMissing_->setChecked(config.create_if_missing);
     defaultDBNum_->setValue(config.dbnum);
+    keyType_->setCurrentIndex(config.key_type);
   }
   ConnectionLocalWidget::syncControls(ups);
 }
@@ -64,6 +80,7 @@ void ConnectionWidget::syncControls(proxy::IConnectionSettingsBase* connection)
 void ConnectionWidget::retranslateUi() {
   createDBIfMissing_->setText(trCreateDBIfMissing);
   defaultDBLabel_->setText(trDefaultDb);
+  keyTypeLabel_->setText(trKeyType);
   ConnectionLocalWidget::retranslateUi();
 }
 
@@ -73,6 +90,7 @@ proxy::IConnectionSettingsLocal* ConnectionWidget::createConnectionLocalImpl(
   core::upscaledb::Config config = conn->Info();
   config.create_if_missing = createDBIfMissing_->isChecked();
   config.dbnum = defaultDBNum_->value();
+  config.key_type = static_cast<core::upscaledb::KeyType>(keyType_->currentIndex());
   conn->SetInfo(config);
   return conn;
 }
@@ -42,6 +42,9 @@ class ConnectionWidget : public ConnectionLocalWidget {
 
   QLabel* defaultDBLabel_;
   QSpinBox* defaultDBNum_;
+
+  QLabel* keyTypeLabel_;
+  QComboBox* keyType_;
 };
 
 }  // namespace upscaledb
@@ -21,6 +21,7 @@
 #include <stddef.h>  // for size_t
 #include <stdint.h>  // for uint32_t
 
+#include <limits>   // for numeric_limits
 #include <memory>   // for __shared_ptr
 #include <utility>  // for make_pair
 #include <vector>   // for vector
@@ -53,7 +54,11 @@ namespace fastonosql {
 namespace gui {
 
 ServerHistoryDialog::ServerHistoryDialog(proxy::IServerSPtr server, QWidget* parent)
-    : QDialog(parent, Qt::WindowMinMaxButtonsHint | Qt::WindowCloseButtonHint), server_(server) {
+    : QDialog(parent, Qt::WindowMinMaxButtonsHint | Qt::WindowCloseButtonHint),
+      points_(),
+      points_property_(-1),
+      points_field_(-1),
+      server_(server) {
   CHECK(server_);
   setWindowIcon(GuiFactory::instance().icon(server_->Type()));
   setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);  // Remove help
@@ -126,7 +131,14 @@ void ServerHistoryDialog::finishLoadServerHistoryInfo(
     return;
   }
 
-  infos_ = res.infos();
+  if (res.property != serverInfoGroupsNames_->currentIndex() ||
+      res.field != qvariant_cast<uint32_t>(serverInfoFields_->currentData())) {
+    return;  // selection changed meanwhile
+  }
+
+  points_ = res.points();
+  points_property_ = res.property;
+  points_field_ = res.field;
   reset();
 }
 
@@ -146,8 +158,19 @@ void ServerHistoryDialog::finishClearServerHistory(
 }
 
 void ServerHistoryDialog::snapShotAdd(core::ServerInfoSnapShoot snapshot) {
-  infos_.push_back(snapshot);
-  reset();
+  if (!snapshot.isValid() || points_property_ == -1) {
+    return;
+  }
+
+  common::Value* value = snapshot.info->ValueByIndexes(points_property_, points_field_);
+  if (value) {
+    double val = 0;
+    if (value->getAsDouble(&val)) {
+      points_.push_back(core::HistoryPoint(snapshot.msec, val, val, val));
+      reset();
+    }
+    delete value;
+  }
 }
 
 void ServerHistoryDialog::clearHistory() {
@@ -177,27 +200,11 @@ void ServerHistoryDialog::refreshGraph(int index) {
     return;
   }
 
-  int serverIndex = serverInfoGroupsNames_->currentIndex();
-  QVariant var = serverInfoFields_->itemData(index);
-  uint32_t indexIn = qvariant_cast<uint32_t>(var);
-  common::qt::gui::GraphWidget::nodes_container_type nodes;
-  for (auto it = infos_.begin(); it != infos_.end(); ++it) {
-    auto val = *it;
-    if (!val.isValid()) {
-      continue;
-    }
-
-    common::Value* value = val.info->ValueByIndexes(serverIndex, indexIn);  // allocate
-    if (value) {
-      qreal graphY = 0.0f;
-      if (value->getAsDouble(&graphY)) {
-        nodes.push_back(std::make_pair(val.msec, graphY));
-      }
-      delete value;
-    }
-  }
-
-  graphWidget_->setNodes(nodes);
+  points_.clear();
+  points_property_ = -1;
+  points_field_ = -1;
+  reset();
+  requestHistoryInfo();
 }
 
 void ServerHistoryDialog::changeEvent(QEvent* e) {
@@ -213,7 +220,12 @@ void ServerHistoryDialog::showEvent(QShowEvent* e) {
 }
 
 void ServerHistoryDialog::reset() {
-  refreshGraph(serverInfoFields_->currentIndex());
+  common::qt::gui::GraphWidget::nodes_container_type nodes;
+  for (size_t i = 0; i < points_.size(); ++i) {
+    nodes.push_back(std::make_pair(points_[i].msec, points_[i].avg));
+  }
+
+  graphWidget_->setNodes(nodes);
 }
 
 void ServerHistoryDialog::retranslateUi() {
@@ -223,7 +235,15 @@ void ServerHistoryDialog::retranslateUi() {
 }
 
 void ServerHistoryDialog::requestHistoryInfo() {
-  proxy::events_info::ServerInfoHistoryRequest req(this);
+  int index = serverInfoFields_->currentIndex();
+  if (index == -1) {
+    return;
+  }
+
+  unsigned char property = serverInfoGroupsNames_->currentIndex();
+  unsigned char field = qvariant_cast<uint32_t>(serverInfoFields_->itemData(index));
+  proxy::events_info::ServerInfoHistoryRequest req(
+      this, property, field, 0, std::numeric_limits<common::time64_t>::max());
   server_->RequestHistoryInfo(req);
 }
 
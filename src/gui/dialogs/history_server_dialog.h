@@ -81,7 +81,9 @@ class ServerHistoryDialog : public QDialog {
   common::qt::gui::GraphWidget* graphWidget_;
 
   common::qt::gui::GlassWidget* glassWidget_;
-  proxy::events_info::ServerInfoHistoryResponce::infos_container_type infos_;
+  proxy::events_info::ServerInfoHistoryResponce::points_container_type points_;
+  int points_property_;  // field of loaded points, -1 if nothing loaded
+  int points_field_;
   const proxy::IServerSPtr server_;
 };
 }  // namespace gui
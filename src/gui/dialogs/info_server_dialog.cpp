@@ -202,6 +202,12 @@ const QString trLeveldbTextServerTemplate = QObject::tr(
     "Read mb: %4<br/>"
     "Write mb: %5");
 
+const QString trLeveldbTextStorageTemplate = QObject::tr(
+    "<br/><b>Storage:</b><br/>"
+    "Total files: %1<br/>"
+    "Total size mb: %2<br/>"
+    "Approximate memory usage mb: %3");
+
 const QString trRocksdbTextServerTemplate = QObject::tr(
     "<b>Stats:</b><br/>"
     "Compactions level: %1<br/>"
@@ -210,6 +216,41 @@ const QString trRocksdbTextServerTemplate = QObject::tr(
     "Read mb: %4<br/>"
     "Write mb: %5");
 
+const QString trRocksdbTextCompactionTemplate = QObject::tr(
+    "<br/><b>Compaction:</b><br/>"
+    "Pending compaction mb: %1<br/>"
+    "Running compactions: %2<br/>"
+    "Running flushes: %3<br/>"
+    "Write stopped: %4<br/>"
+    "Delayed write rate: %5<br/>"
+    "Stall micros: %6");
+
+const QString trRocksdbTextMemtablesTemplate = QObject::tr(
+    "<br/><b>Memtables:</b><br/>"
+    "Active memtable mb: %1<br/>"
+    "All memtables mb: %2<br/>"
+    "Pinned memtables mb: %3<br/>"
+    "Immutable memtables: %4");
+
+const QString trRocksdbTextCacheTemplate = QObject::tr(
+    "<br/><b>Cache:</b><br/>"
+    "Block cache usage mb: %1<br/>"
+    "Block cache hit: %2<br/>"
+    "Block cache miss: %3<br/>"
+    "Block cache hit ratio: %4<br/>"
+    "Bloom filter useful: %5<br/>"
+    "Get p50/p99 micros: %6/%7<br/>"
+    "Write p50/p99 micros: %8/%9");
+
+const QString trRocksdbTextStorageTemplate = QObject::tr(
+    "<br/><b>Storage:</b><br/>"
+    "Live sst mb: %1<br/>"
+    "Total sst mb: %2<br/>"
+    "Estimate num keys: %3<br/>"
+    "Estimate live data mb: %4");
+
+const QString trLevelTextTemplate = QObject::tr("Level %1: %2 files, %3 mb<br/>");
+
 const QString trUnqliteTextServerTemplate = QObject::tr(
     "<b>Stats:</b><br/>"
     "File path: %1<br/>");
@@ -531,7 +572,20 @@ void InfoServerDialog::updateText(const core::leveldb::ServerInfo& serv) {
                          .arg(stats.read_mb)
                          .arg(stats.write_mb);
 
-  serverTextInfo_->setText(textServ);
+  core::leveldb::ServerInfo::Levels levels = serv.levels_;
+  QString textLevels = "<br/><b>" + QObject::tr("Levels:") + "</b><br/>";
+  for (size_t i = 0; i < LEVELDB_LEVELS_COUNT; ++i) {
+    textLevels += trLevelTextTemplate.arg(i)
+                      .arg(levels.files_at_level[i])
+                      .arg(levels.size_mb_at_level[i]);
+  }
+
+  core::leveldb::ServerInfo::Storage storage = serv.storage_;
+  QString textStorage = trLeveldbTextStorageTemplate.arg(storage.total_files)
+                            .arg(storage.total_size_mb)
+                            .arg(storage.approximate_memory_usage_mb);
+
+  serverTextInfo_->setText(textServ + textLevels + textStorage);
 }
 #endif
 #ifdef BUILD_WITH_ROCKSDB
@@ -543,7 +597,47 @@ void InfoServerDialog::updateText(const core::rocksdb::ServerInfo& serv) {
                          .arg(stats.read_mb)
                          .arg(stats.write_mb);
 
-  serverTextInfo_->setText(textServ);
+  core::rocksdb::ServerInfo::Levels levels = serv.levels_;
+  QString textLevels = "<br/><b>" + QObject::tr("Levels:") + "</b><br/>";
+  for (size_t i = 0; i < ROCKSDB_LEVELS_COUNT; ++i) {
+    textLevels += trLevelTextTemplate.arg(i)
+                      .arg(levels.files_at_level[i])
+                      .arg(levels.size_mb_at_level[i]);
+  }
+
+  core::rocksdb::ServerInfo::Compaction compaction = serv.compaction_;
+  QString textCompaction = trRocksdbTextCompactionTemplate.arg(compaction.pending_compaction_mb)
+                               .arg(compaction.running_compactions)
+                               .arg(compaction.running_flushes)
+                               .arg(compaction.is_write_stopped)
+                               .arg(compaction.delayed_write_rate)
+                               .arg(compaction.stall_micros);
+
+  core::rocksdb::ServerInfo::Memtables memtables = serv.memtables_;
+  QString textMemtables = trRocksdbTextMemtablesTemplate.arg(memtables.active_mem_table_mb)
+                              .arg(memtables.all_mem_tables_mb)
+                              .arg(memtables.pinned_mem_tables_mb)
+                              .arg(memtables.immutable_mem_tables);
+
+  core::rocksdb::ServerInfo::Cache cache = serv.cache_;
+  QString textCache = trRocksdbTextCacheTemplate.arg(cache.block_cache_usage_mb)
+                          .arg(cache.block_cache_hit)
+                          .arg(cache.block_cache_miss)
+                          .arg(cache.block_cache_hit_ratio)
+                          .arg(cache.bloom_filter_useful)
+                          .arg(cache.get_p50_micros)
+                          .arg(cache.get_p99_micros)
+                          .arg(cache.write_p50_micros)
+                          .arg(cache.write_p99_micros);
+
+  core::rocksdb::ServerInfo::Storage storage = serv.storage_;
+  QString textStorage = trRocksdbTextStorageTemplate.arg(storage.live_sst_mb)
+                            .arg(storage.total_sst_mb)
+                            .arg(storage.estimate_num_keys)
+                            .arg(storage.estimate_live_data_mb);
+
+  serverTextInfo_->setText(textServ + textLevels + textCompaction + textMemtables + textCache +
+                           textStorage);
 }
 #endif
 #ifdef BUILD_WITH_UNQLITE
@@ -19,11 +19,14 @@
 #include "gui/editor/fasto_editor_output.h"
 
 #include <QHBoxLayout>
+#include <QTimer>
 
 #include <common/macros.h>
 #include <common/qt/convert2string.h>
 #include <common/qt/utils_qt.h>  // for item
 
+#include "core/fasto_object_writer.h"  // for WriteFastoObject, StringSink
+
 #include "gui/editor/fasto_hex_edit.h"  // for FastoHexEdit, etc
 #include "gui/fasto_common_item.h"      // for FastoCommonItem, toRaw, etc
 
@@ -32,7 +35,12 @@
 namespace fastonosql {
 namespace gui {
 FastoEditorOutput::FastoEditorOutput(const QString& delimiter, QWidget* parent)
-    : QWidget(parent), model_(nullptr), view_method_(JSON), delimiter_(delimiter) {
+    : QWidget(parent),
+      model_(nullptr),
+      view_method_(JSON),
+      delimiter_(delimiter),
+      root_(),
+      layout_pending_(false) {
   editor_ = new FastoHexEdit;
   VERIFY(connect(editor_, &FastoHexEdit::textChanged, this, &FastoEditorOutput::textChanged));
   VERIFY(
@@ -110,6 +118,11 @@ void FastoEditorOutput::setModel(QAbstractItemModel* model) {
   reset();
 }
 
+void FastoEditorOutput::setRoot(core::FastoObjectIPtr root) {
+  root_ = root;
+  layoutChanged();
+}
+
 void FastoEditorOutput::setReadOnly(bool ro) {
   editor_->setReadOnly(ro);
 }
@@ -125,7 +138,7 @@ void FastoEditorOutput::dataChanged(QModelIndex first, QModelIndex last) {
   UNUSED(first);
   UNUSED(last);
 
-  layoutChanged();
+  scheduleLayoutChanged();
 }
 
 void FastoEditorOutput::headerDataChanged() {}
@@ -135,7 +148,7 @@ void FastoEditorOutput::rowsInserted(QModelIndex index, int r, int c) {
   UNUSED(r);
   UNUSED(c);
 
-  layoutChanged();
+  scheduleLayoutChanged();
 }
 
 void FastoEditorOutput::rowsAboutToBeRemoved(QModelIndex index, int r, int c) {
@@ -209,7 +222,51 @@ int FastoEditorOutput::childCount() const {
   return rc;
 }
 
+// replies arrive row by row, render them at most once per OUTPUT_REFRESH_MSEC
+void FastoEditorOutput::scheduleLayoutChanged() {
+  if (layout_pending_) {
+    return;
+  }
+
+  layout_pending_ = true;
+  QTimer::singleShot(OUTPUT_REFRESH_MSEC, this, &FastoEditorOutput::layoutChanged);
+}
+
+bool FastoEditorOutput::writeRoot(QString* text, bool* truncated) const {
+  core::OutputFormat format;
+  if (view_method_ == JSON) {
+    format = core::JSON_OUTPUT;
+  } else if (view_method_ == CSV) {
+    format = core::CSV_OUTPUT;
+  } else if (view_method_ == RAW) {
+    format = core::RAW_OUTPUT;
+  } else {
+    return false;
+  }
+
+  std::string out;
+  core::StringSink sink(&out, OUTPUT_TEXT_LIMIT);
+  common::Error err;
+  if (format == core::RAW_OUTPUT) {
+    // root holds the typed command line, show replies only
+    for (size_t i = 0; i < root_->ChildrenCount() && !sink.IsTruncated(); ++i) {
+      err = core::WriteFastoObject(root_->ChildAt(i).get(), format, &sink);
+    }
+  } else {
+    err = core::WriteFastoObject(root_.get(), format, &sink);
+  }
+
+  *truncated = sink.IsTruncated();
+  if (err && err->isError() && !*truncated) {
+    return false;
+  }
+
+  *text = common::EscapedText(QString::fromUtf8(out.data(), static_cast<int>(out.size())));
+  return true;
+}
+
 void FastoEditorOutput::layoutChanged() {
+  layout_pending_ = false;
   editor_->clear();
   if (!model_) {
     return;
@@ -248,6 +305,21 @@ void FastoEditorOutput::layoutChanged() {
   }
 
   QString result;
+  bool truncated = false;
+  if (root_ && writeRoot(&result, &truncated)) {
+    editor_->setMode(FastoHexEdit::TEXT_MODE);
+    if (truncated) {
+      result += tr("\n... output truncated at %1 bytes").arg(OUTPUT_TEXT_LIMIT);
+      editor_->setReadOnly(true);
+    }
+    if (result.isEmpty()) {
+      result = QString(translations::trCannotConvertPattern1ArgsS).arg(methodText);
+      editor_->setReadOnly(true);
+    }
+    editor_->setData(result.toUtf8());
+    return;
+  }
+
   for (size_t i = 0; i < root->childrenCount(); ++i) {
     FastoCommonItem* child = dynamic_cast<FastoCommonItem*>(root->child(i));  // +
     if (!child) {
@@ -20,6 +20,8 @@
 
 #include "fasto_editor.h"
 
+#include "core/global.h"  // for FastoObjectIPtr
+
 #define JSON 0
 #define CSV 1
 #define RAW 2
@@ -27,6 +29,9 @@
 #define MSGPACK 4
 #define GZIP 5
 
+#define OUTPUT_REFRESH_MSEC 100
+#define OUTPUT_TEXT_LIMIT (16 * 1024 * 1024)  // bytes shown, rest is cut
+
 namespace fastonosql {
 namespace gui {
 class FastoHexEdit;
@@ -41,6 +46,8 @@ class FastoEditorOutput : public QWidget {
   explicit FastoEditorOutput(const QString& delimiter, QWidget* parent = 0);
 
   void setModel(QAbstractItemModel* model);
+  // completed reply tree, JSON, CSV and raw views are written from it
+  void setRoot(core::FastoObjectIPtr root);
 
   QModelIndex selectedItem(int column) const;
   bool setData(const QModelIndex& index, const QVariant& value, int role);
@@ -71,10 +78,15 @@ class FastoEditorOutput : public QWidget {
   void layoutChanged();
 
  private:
+  void scheduleLayoutChanged();
+  bool writeRoot(QString* text, bool* truncated) const;
+
   FastoHexEdit* editor_;
   QAbstractItemModel* model_;
   int view_method_;
   const QString delimiter_;
+  core::FastoObjectIPtr root_;
+  bool layout_pending_;
 };
 }  // namespace gui
 }  // namespace fastonosql
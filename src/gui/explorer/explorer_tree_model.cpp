@@ -18,9 +18,11 @@
 
 #include "gui/explorer/explorer_tree_model.h"
 
-#include <memory>  // for __shared_ptr, operator==, etc
-#include <string>  // for operator==, string, etc
-#include <vector>  // for vector
+#include <algorithm>  // for sort, unique
+#include <map>        // for map
+#include <memory>     // for __shared_ptr, operator==, etc
+#include <string>     // for operator==, string, etc
+#include <vector>     // for vector
 
 #include <QIcon>
 
@@ -345,10 +347,10 @@ void ExplorerTreeModel::updateDb(proxy::IServer* server, core::IDataBaseInfoSPtr
   updateItem(dbs_index1, dbs_index2);
 }
 
-void ExplorerTreeModel::addKey(proxy::IServer* server,
-                               core::IDataBaseInfoSPtr db,
-                               const core::NDbKValue& dbv,
-                               const std::string& ns_separator) {
+void ExplorerTreeModel::addKeys(proxy::IServer* server,
+                                core::IDataBaseInfoSPtr db,
+                                const core::NDbKValues& keys,
+                                const std::string& ns_separator) {
   ExplorerServerItem* parent = findServerItem(server);
   if (!parent) {
     return;
@@ -359,25 +361,46 @@ void ExplorerTreeModel::addKey(proxy::IServer* server,
     return;
   }
 
-  core::NKey key = dbv.Key();
-  ExplorerKeyItem* keyit = findKeyItem(dbs, key);
-  if (!keyit) {
+  // new keys grouped by their database or namespace node, in arrival order
+  std::vector<std::pair<IExplorerTreeItem*, core::NDbKValues>> groups;
+  std::map<IExplorerTreeItem*, size_t> group_index;
+  for (const core::NDbKValue& dbv : keys) {
+    core::NKey key = dbv.Key();
+    if (findKeyItem(dbs, key)) {
+      continue;
+    }
+
     IExplorerTreeItem* nitem = dbs;
     core::KeyInfo kinf = key.Info(ns_separator);
     if (kinf.HasNamespace()) {
       nitem = findOrCreateNSItem(dbs, kinf);
     }
 
+    auto it = group_index.find(nitem);
+    if (it == group_index.end()) {
+      it = group_index.insert(std::make_pair(nitem, groups.size())).first;
+      groups.push_back(std::make_pair(nitem, core::NDbKValues()));
+    }
+    groups[it->second].second.push_back(dbv);
+  }
+
+  for (size_t i = 0; i < groups.size(); ++i) {
+    IExplorerTreeItem* nitem = groups[i].first;
+    const core::NDbKValues& group = groups[i].second;
     common::qt::gui::TreeItem* parent_nitem = nitem->parent();
     QModelIndex parent_index = createIndex(parent_nitem->indexOf(nitem), 0, nitem);
-    ExplorerKeyItem* item = new ExplorerKeyItem(dbv, nitem);
-    insertItem(parent_index, item);
+    int first = static_cast<int>(nitem->childrenCount());
+    beginInsertRows(parent_index, first, first + static_cast<int>(group.size()) - 1);
+    for (const core::NDbKValue& dbv : group) {
+      nitem->addChildren(new ExplorerKeyItem(dbv, nitem));
+    }
+    endInsertRows();
   }
 }
 
-void ExplorerTreeModel::removeKey(proxy::IServer* server,
-                                  core::IDataBaseInfoSPtr db,
-                                  const core::NKey& key) {
+void ExplorerTreeModel::removeKeys(proxy::IServer* server,
+                                   core::IDataBaseInfoSPtr db,
+                                   const core::NKeys& keys) {
   ExplorerServerItem* parent = findServerItem(server);
   if (!parent) {
     return;
@@ -388,11 +411,39 @@ void ExplorerTreeModel::removeKey(proxy::IServer* server,
     return;
   }
 
-  ExplorerKeyItem* keyit = findKeyItem(dbs, key);
-  if (keyit) {
-    common::qt::gui::TreeItem* par = keyit->parent();
-    QModelIndex index = createIndex(par->indexOf(keyit), 0, keyit);
-    removeItem(index.parent(), keyit);
+  // rows by parent node, removed from the bottom in runs of adjacent rows
+  std::map<common::qt::gui::TreeItem*, std::vector<int>> rows;
+  for (const core::NKey& key : keys) {
+    ExplorerKeyItem* keyit = findKeyItem(dbs, key);
+    if (keyit) {
+      common::qt::gui::TreeItem* par = keyit->parent();
+      rows[par].push_back(par->indexOf(keyit));
+    }
+  }
+
+  for (auto it = rows.begin(); it != rows.end(); ++it) {
+    common::qt::gui::TreeItem* par = it->first;
+    std::vector<int>& prows = it->second;
+    std::sort(prows.begin(), prows.end());
+    prows.erase(std::unique(prows.begin(), prows.end()), prows.end());
+    common::qt::gui::TreeItem* gpar = par->parent();
+    QModelIndex parent_index = createIndex(gpar->indexOf(par), 0, par);
+    size_t end = prows.size();
+    while (end > 0) {
+      size_t start = end - 1;
+      while (start > 0 && prows[start - 1] + 1 == prows[start]) {
+        start--;
+      }
+
+      beginRemoveRows(parent_index, prows[start], prows[end - 1]);
+      for (size_t j = end; j > start; --j) {
+        common::qt::gui::TreeItem* child = par->child(prows[j - 1]);
+        par->removeChildren(child);
+        delete child;
+      }
+      endRemoveRows();
+      end = start;
+    }
   }
 }
 
@@ -74,11 +74,12 @@ class ExplorerTreeModel : public common::qt::gui::TreeModel {
   void setDefaultDb(proxy::IServer* server, core::IDataBaseInfoSPtr db);
   void updateDb(proxy::IServer* server, core::IDataBaseInfoSPtr db);
 
-  void addKey(proxy::IServer* server,
-              core::IDataBaseInfoSPtr db,
-              const core::NDbKValue& dbv,
-              const std::string& ns_separator);
-  void removeKey(proxy::IServer* server, core::IDataBaseInfoSPtr db, const core::NKey& key);
+  // one rows insert/remove per parent node instead of one per key
+  void addKeys(proxy::IServer* server,
+               core::IDataBaseInfoSPtr db,
+               const core::NDbKValues& keys,
+               const std::string& ns_separator);
+  void removeKeys(proxy::IServer* server, core::IDataBaseInfoSPtr db, const core::NKeys& keys);
   void updateKey(proxy::IServer* server,
                  core::IDataBaseInfoSPtr db,
                  const core::NKey& old_key,
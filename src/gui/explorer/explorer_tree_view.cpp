@@ -89,6 +89,7 @@ const QString trSetTTL = QObject::tr("Set TTL");
 const QString trRenameKey = QObject::tr("Rename key");
 const QString trRenameKeyLabel = QObject::tr("New key name:");
 const QString trChangePasswordTemplate_1S = QObject::tr("Change password for %1 server");
+const QString trSampleStatistics = QObject::tr("Sample statistics");
 }  // namespace
 
 namespace fastonosql {
@@ -180,6 +181,9 @@ ExplorerTreeView::ExplorerTreeView(QWidget* parent) : QTreeView(parent) {
   setDefaultDbAction_ = new QAction(this);
   VERIFY(connect(setDefaultDbAction_, &QAction::triggered, this, &ExplorerTreeView::setDefaultDb));
 
+  sampleDbAction_ = new QAction(this);
+  VERIFY(connect(sampleDbAction_, &QAction::triggered, this, &ExplorerTreeView::sampleDb));
+
   createKeyAction_ = new QAction(this);
   VERIFY(connect(createKeyAction_, &QAction::triggered, this, &ExplorerTreeView::createKey));
 
@@ -392,6 +396,11 @@ void ExplorerTreeView::showContextMenu(const QPoint& point) {
 
     menu.addAction(setDefaultDbAction_);
     setDefaultDbAction_->setEnabled(!isDefault && is_connected);
+
+    core::connectionTypes type = server->Type();
+    bool is_sampled = type == core::LEVELDB || type == core::ROCKSDB || type == core::LMDB;
+    menu.addAction(sampleDbAction_);
+    sampleDbAction_->setEnabled(isDefault && is_connected && is_sampled);
     menu.exec(menuPoint);
   } else if (node->type() == IExplorerTreeItem::eNamespace) {
     ExplorerNSItem* ns = static_cast<ExplorerNSItem*>(node);
@@ -833,6 +842,21 @@ void ExplorerTreeView::setDefaultDb() {
   }
 }
 
+void ExplorerTreeView::sampleDb() {
+  QModelIndex sel = selectedIndex();
+  if (!sel.isValid()) {
+    return;
+  }
+
+  ExplorerDatabaseItem* node =
+      common::qt::item<common::qt::gui::TreeItem*, ExplorerDatabaseItem*>(sel);
+  // PropertyServerDialog lists redis CONFIG properties of the whole server and is disabled
+  // for embedded engines, the sample report is a multi line text, so it goes to a console
+  if (node) {
+    emit consoleOpenedAndExecute(node->server(), "SAMPLE");
+  }
+}
+
 void ExplorerTreeView::createKey() {
   QModelIndex sel = selectedIndex();
   if (!sel.isValid()) {
@@ -1031,12 +1055,8 @@ void ExplorerTreeView::finishLoadDatabaseContent(
   proxy::IServer* serv = qobject_cast<proxy::IServer*>(sender());
   CHECK(serv);
 
-  proxy::events_info::LoadDatabaseContentResponce::keys_container_t keys = res.keys;
   std::string ns = serv->NsSeparator();
-  for (size_t i = 0; i < keys.size(); ++i) {
-    core::NDbKValue key = keys[i];
-    source_model_->addKey(serv, res.inf, key, ns);
-  }
+  source_model_->addKeys(serv, res.inf, res.keys, ns);
 
   source_model_->updateDb(serv, res.inf);
 }
@@ -1064,19 +1084,19 @@ void ExplorerTreeView::currentDataBaseChange(core::IDataBaseInfoSPtr db) {
   source_model_->setDefaultDb(serv, db);
 }
 
-void ExplorerTreeView::removeKey(core::IDataBaseInfoSPtr db, core::NKey key) {
+void ExplorerTreeView::removeKeys(core::IDataBaseInfoSPtr db, core::NKeys keys) {
   proxy::IServer* serv = qobject_cast<proxy::IServer*>(sender());
   CHECK(serv);
 
-  source_model_->removeKey(serv, db, key);
+  source_model_->removeKeys(serv, db, keys);
 }
 
-void ExplorerTreeView::addKey(core::IDataBaseInfoSPtr db, core::NDbKValue key) {
+void ExplorerTreeView::addKeys(core::IDataBaseInfoSPtr db, core::NDbKValues keys) {
   proxy::IServer* serv = qobject_cast<proxy::IServer*>(sender());
   CHECK(serv);
 
   std::string ns = serv->NsSeparator();
-  source_model_->addKey(serv, db, key, ns);
+  source_model_->addKeys(serv, db, keys, ns);
 }
 
 void ExplorerTreeView::renameKey(core::IDataBaseInfoSPtr db, core::NKey key, std::string new_name) {
@@ -1141,9 +1161,9 @@ void ExplorerTreeView::syncWithServer(proxy::IServer* server) {
   VERIFY(connect(server, &proxy::IServer::FlushedDB, this, &ExplorerTreeView::flushDB));
   VERIFY(connect(server, &proxy::IServer::CurrentDataBaseChanged, this,
                  &ExplorerTreeView::currentDataBaseChange));
-  VERIFY(connect(server, &proxy::IServer::KeyRemoved, this, &ExplorerTreeView::removeKey,
+  VERIFY(connect(server, &proxy::IServer::KeysRemoved, this, &ExplorerTreeView::removeKeys,
                  Qt::DirectConnection));
-  VERIFY(connect(server, &proxy::IServer::KeyAdded, this, &ExplorerTreeView::addKey,
+  VERIFY(connect(server, &proxy::IServer::KeysAdded, this, &ExplorerTreeView::addKeys,
                  Qt::DirectConnection));
   VERIFY(connect(server, &proxy::IServer::KeyRenamed, this, &ExplorerTreeView::renameKey,
                  Qt::DirectConnection));
@@ -1174,8 +1194,8 @@ void ExplorerTreeView::unsyncWithServer(proxy::IServer* server) {
   VERIFY(disconnect(server, &proxy::IServer::FlushedDB, this, &ExplorerTreeView::flushDB));
   VERIFY(disconnect(server, &proxy::IServer::CurrentDataBaseChanged, this,
                     &ExplorerTreeView::currentDataBaseChange));
-  VERIFY(disconnect(server, &proxy::IServer::KeyRemoved, this, &ExplorerTreeView::removeKey));
-  VERIFY(disconnect(server, &proxy::IServer::KeyAdded, this, &ExplorerTreeView::addKey));
+  VERIFY(disconnect(server, &proxy::IServer::KeysRemoved, this, &ExplorerTreeView::removeKeys));
+  VERIFY(disconnect(server, &proxy::IServer::KeysAdded, this, &ExplorerTreeView::addKeys));
   VERIFY(disconnect(server, &proxy::IServer::KeyRenamed, this, &ExplorerTreeView::renameKey));
   VERIFY(disconnect(server, &proxy::IServer::KeyLoaded, this, &ExplorerTreeView::loadKey));
   VERIFY(disconnect(server, &proxy::IServer::KeyTTLChanged, this, &ExplorerTreeView::changeTTLKey));
@@ -1206,6 +1226,7 @@ void ExplorerTreeView::retranslateUi() {
   viewKeysAction_->setText(translations::trViewKeysDialog);
   pubSubAction_->setText(translations::trPubSubDialog);
   setDefaultDbAction_->setText(translations::trSetDefault);
+  sampleDbAction_->setText(trSampleStatistics);
   getValueAction_->setText(translations::trGetValue);
   renameKeyAction_->setText(trRenameKey);
   deleteKeyAction_->setText(translations::trDelete);
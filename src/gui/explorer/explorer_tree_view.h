@@ -86,6 +86,7 @@ class ExplorerTreeView : public QTreeView {
   void removeAllKeys();
   void removeBranch();
   void setDefaultDb();
+  void sampleDb();
   void createKey();
   void editKey();
   void viewKeys();
@@ -108,8 +109,8 @@ class ExplorerTreeView : public QTreeView {
 
   void flushDB(core::IDataBaseInfoSPtr db);
   void currentDataBaseChange(core::IDataBaseInfoSPtr db);
-  void removeKey(core::IDataBaseInfoSPtr db, core::NKey key);
-  void addKey(core::IDataBaseInfoSPtr db, core::NDbKValue key);
+  void removeKeys(core::IDataBaseInfoSPtr db, core::NKeys keys);
+  void addKeys(core::IDataBaseInfoSPtr db, core::NDbKValues keys);
   void renameKey(core::IDataBaseInfoSPtr db, core::NKey key, std::string new_name);
   void loadKey(core::IDataBaseInfoSPtr db, core::NDbKValue key);
   void changeTTLKey(core::IDataBaseInfoSPtr db, core::NKey key, core::ttl_t ttl);
@@ -132,6 +133,7 @@ class ExplorerTreeView : public QTreeView {
   QAction* removeAllKeysAction_;
   QAction* removeBranchAction_;
   QAction* setDefaultDbAction_;
+  QAction* sampleDbAction_;
   QAction* createKeyAction_;
   QAction* editKeyAction_;
   QAction* viewKeysAction_;
@@ -89,6 +89,10 @@ void FastoTextView::setModel(QAbstractItemModel* model) {
   editor_->setModel(model);
 }
 
+void FastoTextView::setRoot(core::FastoObjectIPtr root) {
+  editor_->setRoot(root);
+}
+
 void FastoTextView::saveChanges() {
   QModelIndex index = editor_->selectedItem(1);  // eValue
   common::StringValue* string =
@@ -20,6 +20,8 @@
 
 #include <QWidget>
 
+#include "core/global.h"  // for FastoObjectIPtr
+
 class QAbstractItemModel;  // lines 25-25
 class QEvent;
 class QPushButton;   // lines 24-24
@@ -39,6 +41,7 @@ class FastoTextView : public QWidget {
   FastoTextView(const QString& delimiter, QWidget* parent = 0);
 
   void setModel(QAbstractItemModel* model);
+  void setRoot(core::FastoObjectIPtr root);
 
  private Q_SLOTS:
   void viewChange(bool checked);
@@ -49,7 +49,9 @@
 #include <common/qt/gui/shortcuts.h>   // for FastoQKeySequence
 #include <common/qt/utils_qt.h>        // for SaveToFileText, etc
 
+#include "core/benchmark.h"            // for IsBenchmarkCommand, etc
 #include "core/command_info.h"         // for UNDEFINED_SINCE, etc
+#include "core/command_stats.h"        // for IsStatsCommand, etc
 #include "proxy/events/events_info.h"  // for DiscoveryInfoResponce, etc
 #include "proxy/server/iserver.h"      // for IServer
 #include "proxy/server/iserver_local.h"
@@ -71,6 +73,10 @@ const QString trCantReadTemplate_2S = QObject::tr(PROJECT_NAME_TITLE " can't rea
 const QString trCantSaveTemplate_2S = QObject::tr(PROJECT_NAME_TITLE " can't save to %1:\n%2.");
 const QString trAdvancedOptions = QObject::tr("Advanced options");
 const QString trCalculating = QObject::tr("Calculate...");
+const QString trExecuteToFile = QObject::tr("Execute to file");
+const QString trJsonFilter = QObject::tr("JSON Files (*.json)");
+const QString trCsvFilter = QObject::tr("CSV Files (*.csv)");
+const QString trRespFilter = QObject::tr("RESP Files (*.resp)");
 const QString trIntervalMsec = QObject::tr("Interval msec:");
 const QString trRepeat = QObject::tr("Repeat:");
 }
@@ -91,7 +97,11 @@ BaseShell* makeBaseShell(core::connectionTypes type, QWidget* parent) {
 BaseShellWidget::BaseShellWidget(proxy::IServerSPtr server,
                                  const QString& filePath,
                                  QWidget* parent)
-    : QWidget(parent), server_(server), input_(nullptr), filePath_(filePath) {
+    : QWidget(parent),
+      server_(server),
+      input_(nullptr),
+      filePath_(filePath),
+      jobRunning_(false) {
   CHECK(server_);
 
   VERIFY(connect(server_.get(), &proxy::IServer::ConnectStarted, this,
@@ -104,6 +114,8 @@ BaseShellWidget::BaseShellWidget(proxy::IServerSPtr server,
                  &BaseShellWidget::finishDisconnect));
   VERIFY(connect(server_.get(), &proxy::IServer::ProgressChanged, this,
                  &BaseShellWidget::progressChange));
+  VERIFY(connect(server_.get(), &proxy::IServer::JobProgress, this,
+                 &BaseShellWidget::jobProgressChange));
 
   VERIFY(connect(server_.get(), &proxy::IServer::ModeEntered, this, &BaseShellWidget::enterMode));
   VERIFY(connect(server_.get(), &proxy::IServer::ModeLeaved, this, &BaseShellWidget::leaveMode));
@@ -160,6 +172,11 @@ BaseShellWidget::BaseShellWidget(proxy::IServerSPtr server,
   VERIFY(connect(executeAction_, &QAction::triggered, this, &BaseShellWidget::execute));
   savebar->addAction(executeAction_);
 
+  executeToFileAction_ =
+      new QAction(gui::GuiFactory::instance().exportIcon(), trExecuteToFile, savebar);
+  VERIFY(connect(executeToFileAction_, &QAction::triggered, this, &BaseShellWidget::executeToFile));
+  savebar->addAction(executeToFileAction_);
+
   stopAction_ = new QAction(gui::GuiFactory::instance().stopIcon(), translations::trStop, savebar);
   VERIFY(connect(stopAction_, &QAction::triggered, this, &BaseShellWidget::stop));
   savebar->addAction(stopAction_);
@@ -299,6 +316,24 @@ common::Error BaseShellWidget::validate(const QString& text) {
   }
 
   for (auto cmd : cmds) {
+    if (core::IsBenchmarkCommand(cmd)) {  // handled by driver
+      core::BenchmarkConfig config;
+      err = core::ParseBenchmarkCommand(cmd, &config);
+      if (err && err->isError()) {
+        return err;
+      }
+      continue;
+    }
+    if (core::IsStatsCommand(cmd)) {
+      bool reset = false;
+      core::StatsFormat format = core::STATS_TEXT;
+      err = core::ParseStatsCommand(cmd, &reset, &format);
+      if (err && err->isError()) {
+        return err;
+      }
+      continue;
+    }
+
     err = tran->TestCommandLine(cmd);
     if (err && err->isError()) {
       return err;
@@ -320,6 +355,39 @@ void BaseShellWidget::execute() {
   executeArgs(selected, repeat, interval, history);
 }
 
+void BaseShellWidget::executeToFile() {
+  QString selected = input_->selectedText();
+  if (selected.isEmpty()) {
+    selected = input_->text();
+  }
+
+  QString selected_filter;
+  QString filter = translations::trfilterForScripts + ";;" + trJsonFilter + ";;" + trCsvFilter +
+                   ";;" + trRespFilter;
+  QString filepath =
+      QFileDialog::getSaveFileName(this, trExecuteToFile, QString(), filter, &selected_filter);
+  if (filepath.isEmpty()) {
+    return;
+  }
+
+  core::OutputFormat format = core::RAW_OUTPUT;
+  if (selected_filter == trJsonFilter) {
+    format = core::JSON_OUTPUT;
+  } else if (selected_filter == trCsvFilter) {
+    format = core::CSV_OUTPUT;
+  } else if (selected_filter == trRespFilter) {
+    format = core::RESP_OUTPUT;
+  }
+
+  int repeat = repeatCount_->value();
+  int interval = intervalMsec_->value();
+  bool history = historyCall_->isChecked();
+  proxy::events_info::ExecuteInfoRequest req(this, common::ConvertToString(selected), repeat,
+                                             interval, history, false, core::C_USER,
+                                             common::ConvertToString(filepath), format);
+  server_->Execute(req);
+}
+
 void BaseShellWidget::executeArgs(const QString& text, int repeat, int interval, bool history) {
   proxy::events_info::ExecuteInfoRequest req(this, common::ConvertToString(text), repeat, interval,
                                              history);
@@ -456,6 +524,15 @@ void BaseShellWidget::progressChange(const proxy::events_info::ProgressInfoRespo
   workProgressBar_->setValue(res.progress);
 }
 
+void BaseShellWidget::jobProgressChange(std::string job, int percent) {
+  UNUSED(job);
+
+  workProgressBar_->setValue(percent);
+  jobRunning_ = percent < 100;
+  bool is_executing = !executeAction_->isEnabled();
+  stopAction_->setEnabled(jobRunning_ || is_executing);
+}
+
 void BaseShellWidget::enterMode(const proxy::events_info::EnterModeInfo& res) {
   core::ConnectionMode mode = res.mode;
   connectionMode_->setIcon(gui::GuiFactory::instance().modeIcon(mode), iconSize);
@@ -489,6 +566,7 @@ void BaseShellWidget::startExecute(const proxy::events_info::ExecuteInfoRequest&
   intervalMsec_->setEnabled(false);
   historyCall_->setEnabled(false);
   executeAction_->setEnabled(false);
+  executeToFileAction_->setEnabled(false);
   stopAction_->setEnabled(true);
 }
 void BaseShellWidget::finishExecute(const proxy::events_info::ExecuteInfoResponce& res) {
@@ -498,7 +576,8 @@ void BaseShellWidget::finishExecute(const proxy::events_info::ExecuteInfoResponc
   intervalMsec_->setEnabled(true);
   historyCall_->setEnabled(true);
   executeAction_->setEnabled(true);
-  stopAction_->setEnabled(false);
+  executeToFileAction_->setEnabled(true);
+  stopAction_->setEnabled(jobRunning_);
 }
 
 void BaseShellWidget::serverConnect() {
@@ -575,6 +654,7 @@ void BaseShellWidget::syncConnectionActions() {
   connectAction_->setVisible(!is_connected);
   disConnectAction_->setVisible(is_connected);
   executeAction_->setEnabled(true);
+  executeToFileAction_->setEnabled(true);
   stopAction_->setEnabled(false);
 }
 
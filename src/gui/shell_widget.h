@@ -151,6 +151,7 @@ class BaseShellWidget : public QWidget {
 
  private Q_SLOTS:
   void execute();
+  void executeToFile();
   void stop();
   void connectToServer();
   void disconnectFromServer();
@@ -171,6 +172,7 @@ class BaseShellWidget : public QWidget {
   void finishDisconnect(const proxy::events_info::DisConnectInfoResponce& res);
 
   void progressChange(const proxy::events_info::ProgressInfoResponce& res);
+  void jobProgressChange(std::string job, int percent);
 
   void enterMode(const proxy::events_info::EnterModeInfo& res);
   void leaveMode(const proxy::events_info::LeaveModeInfo& res);
@@ -193,6 +195,7 @@ class BaseShellWidget : public QWidget {
 
   const proxy::IServerSPtr server_;
   QAction* executeAction_;
+  QAction* executeToFileAction_;
   QAction* stopAction_;
   QAction* connectAction_;
   QAction* disConnectAction_;
@@ -214,6 +217,7 @@ class BaseShellWidget : public QWidget {
   QSpinBox* intervalMsec_;
   QCheckBox* historyCall_;
   QString filePath_;
+  bool jobRunning_;  // background job (COMPACT) in progress, stop stays enabled
 };
 
 }  // namespace gui
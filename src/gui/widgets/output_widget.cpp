@@ -88,7 +88,7 @@ OutputWidget::OutputWidget(proxy::IServerSPtr server, QWidget* parent)
   VERIFY(connect(server_.get(), &proxy::IServer::ExecuteFinished, this,
                  &OutputWidget::finishExecuteCommand, Qt::DirectConnection));
 
-  VERIFY(connect(server_.get(), &proxy::IServer::KeyAdded, this, &OutputWidget::addKey,
+  VERIFY(connect(server_.get(), &proxy::IServer::KeysAdded, this, &OutputWidget::addKeys,
                  Qt::DirectConnection));
   VERIFY(connect(server_.get(), &proxy::IServer::KeyLoaded, this, &OutputWidget::updateKey,
                  Qt::DirectConnection));
@@ -155,15 +155,20 @@ void OutputWidget::rootCreate(const proxy::events_info::CommandRootCreatedInfo&
   core::FastoObject* rootObj = res.root.get();
   fastonosql::gui::FastoCommonItem* root = createRootItem(rootObj);
   commonModel_->setRoot(root);
+  textView_->setRoot(core::FastoObjectIPtr());
 }
 
 void OutputWidget::rootCompleate(const proxy::events_info::CommandRootCompleatedInfo& res) {
   updateTimeLabel(res);
+  // driver doesn't touch the tree anymore, text view may walk it
+  textView_->setRoot(res.root);
 }
 
-void OutputWidget::addKey(core::IDataBaseInfoSPtr db, core::NDbKValue key) {
+void OutputWidget::addKeys(core::IDataBaseInfoSPtr db, core::NDbKValues keys) {
   UNUSED(db);
-  commonModel_->changeValue(key);
+  for (const core::NDbKValue& key : keys) {
+    commonModel_->changeValue(key);
+  }
 }
 
 void OutputWidget::updateKey(core::IDataBaseInfoSPtr db, core::NDbKValue key) {
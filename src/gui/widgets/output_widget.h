@@ -71,7 +71,7 @@ class OutputWidget : public QWidget {
   void rootCreate(const proxy::events_info::CommandRootCreatedInfo& res);
   void rootCompleate(const proxy::events_info::CommandRootCompleatedInfo& res);
 
-  void addKey(core::IDataBaseInfoSPtr db, core::NDbKValue key);
+  void addKeys(core::IDataBaseInfoSPtr db, core::NDbKValues keys);
   void updateKey(core::IDataBaseInfoSPtr db, core::NDbKValue key);
 
   void addChild(core::FastoObjectIPtr child);
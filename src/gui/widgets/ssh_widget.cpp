@@ -18,6 +18,8 @@
 
 #include "gui/widgets/ssh_widget.h"
 
+#include <limits.h>  // for INT_MAX
+
 #include <QCheckBox>
 #include <QLineEdit>
 #include <QRegExpValidator>
@@ -25,6 +27,7 @@
 #include <QComboBox>
 #include <QHBoxLayout>
 #include <QPushButton>
+#include <QSpinBox>
 #include <QFileDialog>
 #include <QEvent>
 
@@ -91,6 +94,18 @@ SSHWidget::SSHWidget(QWidget* parent) : QWidget(parent) {
   VERIFY(connect(passphraseEchoModeButton_, &QPushButton::clicked, this,
                  &SSHWidget::togglePassphraseEchoMode));
 
+  windowSizeLabel_ = new QLabel;
+  windowSize_ = new QSpinBox;
+  windowSize_->setRange(MIN_SSH_WINDOW_SIZE / 1024, INT_MAX / 1024);
+  windowSize_->setSuffix(" KB");
+  windowSize_->setValue(DEFAULT_SSH_WINDOW_SIZE / 1024);
+
+  packetSizeLabel_ = new QLabel;
+  packetSize_ = new QSpinBox;
+  packetSize_->setRange(1, MAX_SSH_PACKET_SIZE / 1024);
+  packetSize_->setSuffix(" KB");
+  packetSize_->setValue(DEFAULT_SSH_PACKET_SIZE / 1024);
+
   useSshWidget_ = new QWidget;
 
   QGridLayout* sshWidgetLayout = new QGridLayout;
@@ -108,6 +123,10 @@ SSHWidget::SSHWidget(QWidget* parent) : QWidget(parent) {
   sshWidgetLayout->addWidget(sshPassphraseLabel_, 6, 0);
   sshWidgetLayout->addWidget(passphraseBox_, 6, 1);
   sshWidgetLayout->addWidget(passphraseEchoModeButton_, 6, 2);
+  sshWidgetLayout->addWidget(windowSizeLabel_, 7, 0);
+  sshWidgetLayout->addWidget(windowSize_, 7, 1);
+  sshWidgetLayout->addWidget(packetSizeLabel_, 8, 0);
+  sshWidgetLayout->addWidget(packetSize_, 8, 1);
   useSshWidget_->setLayout(sshWidgetLayout);
 
   VERIFY(connect(useSsh_, &QCheckBox::stateChanged, this, &SSHWidget::sshSupportStateChange));
@@ -148,6 +167,8 @@ core::SSHInfo SSHWidget::info() const {
   info.private_key = common::ConvertToString(privateKeyWidget_->path());
   info.passphrase = common::ConvertToString(passphraseBox_->text());
   info.current_method = selectedAuthMethod();
+  info.window_size = static_cast<uint32_t>(windowSize_->value()) * 1024;
+  info.packet_size = static_cast<uint32_t>(packetSize_->value()) * 1024;
 
   return info;
 }
@@ -167,6 +188,8 @@ void SSHWidget::setInfo(const core::SSHInfo& info) {
   privateKeyWidget_->setPath(common::ConvertFromString<QString>(info.private_key));
   publicKeyWidget_->setPath(common::ConvertFromString<QString>(info.public_key));
   passphraseBox_->setText(common::ConvertFromString<QString>(info.passphrase));
+  windowSize_->setValue(static_cast<int>(info.window_size / 1024));
+  packetSize_->setValue(static_cast<int>(info.packet_size / 1024));
 }
 
 core::SSHInfo::SupportedAuthenticationMetods SSHWidget::selectedAuthMethod() const {
@@ -230,6 +253,8 @@ void SSHWidget::retranslateUi() {
   sshAddressLabel_->setText(tr("SSH Address:"));
   sshUserNameLabel_->setText(tr("SSH User Name:"));
   sshAuthMethodLabel_->setText(tr("SSH Auth Method:"));
+  windowSizeLabel_->setText(tr("Channel Window:"));
+  packetSizeLabel_->setText(tr("Channel Packet Size:"));
 }
 
 }  // namespace gui
@@ -84,6 +84,11 @@ class SSHWidget : public QWidget {
   QPushButton* passwordEchoModeButton_;
   QLineEdit* passphraseBox_;
   QPushButton* passphraseEchoModeButton_;
+
+  QLabel* windowSizeLabel_;
+  QSpinBox* windowSize_;
+  QLabel* packetSizeLabel_;
+  QSpinBox* packetSize_;
 };
 
 }  // namespace gui
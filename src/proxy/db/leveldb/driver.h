@@ -58,6 +58,8 @@ class Driver : public IDriverLocal {
   virtual std::string Delimiter() const override;
 
  private:
+  virtual void timerEvent(QTimerEvent* event) override;
+
   virtual void InitImpl() override;
   virtual void ClearImpl() override;
   virtual core::FastoObjectCommandIPtr CreateCommand(core::FastoObject* parent,
@@ -71,6 +73,8 @@ class Driver : public IDriverLocal {
   virtual common::Error SyncDisconnect() override WARN_UNUSED_RESULT;
 
   virtual common::Error ExecuteImpl(const std::string& command, core::FastoObject* out) override;
+  virtual common::Error BenchmarkImpl(const core::BenchmarkConfig& config,
+                                      core::benchmark_results_t* results) override;
   virtual common::Error CurrentServerInfo(core::IServerInfo** info) override;
   virtual common::Error CurrentDataBaseInfo(core::IDataBaseInfo** info) override;
 
@@ -79,6 +83,7 @@ class Driver : public IDriverLocal {
   virtual core::IServerInfoSPtr MakeServerInfoFromString(const std::string& val) override;
 
   core::leveldb::DBConnection* const impl_;
+  int timer_scan_session_id_;
 };
 
 }  // namespace leveldb
@@ -52,7 +52,9 @@ namespace proxy {
 namespace lmdb {
 
 Driver::Driver(IConnectionSettingsBaseSPtr settings)
-    : IDriverLocal(settings), impl_(new core::lmdb::DBConnection(this)) {
+    : IDriverLocal(settings),
+      impl_(new core::lmdb::DBConnection(this)),
+      timer_scan_session_id_(0) {
   COMPILE_ASSERT(core::lmdb::DBConnection::connection_t == core::LMDB,
                  "DBConnection must be the same type as Driver!");
   CHECK(Type() == core::LMDB);
@@ -68,6 +70,9 @@ bool Driver::IsInterrupted() const {
 
 void Driver::SetInterrupted(bool interrupted) {
   impl_->SetInterrupted(interrupted);
+  if (interrupted) {  // stop also cancels background COMPACT
+    impl_->CancelCompact();
+  }
 }
 
 core::translator_t Driver::Translator() const {
@@ -95,9 +100,24 @@ std::string Driver::Delimiter() const {
   return impl_->Delimiter();
 }
 
-void Driver::InitImpl() {}
+void Driver::timerEvent(QTimerEvent* event) {
+  if (timer_scan_session_id_ == event->timerId()) {
+    impl_->ExpireScanSession();
+  }
+  IDriverLocal::timerEvent(event);
+}
 
-void Driver::ClearImpl() {}
+void Driver::InitImpl() {
+  timer_scan_session_id_ = startTimer(SCAN_SESSION_TIMEOUT_MSEC);
+  DCHECK(timer_scan_session_id_ != 0);
+}
+
+void Driver::ClearImpl() {
+  if (timer_scan_session_id_ != 0) {
+    killTimer(timer_scan_session_id_);
+    timer_scan_session_id_ = 0;
+  }
+}
 
 core::FastoObjectCommandIPtr Driver::CreateCommand(core::FastoObject* parent,
                                                    const std::string& input,
@@ -124,6 +144,11 @@ common::Error Driver::ExecuteImpl(const std::string& command, core::FastoObject*
   return impl_->Execute(command, out);
 }
 
+common::Error Driver::BenchmarkImpl(const core::BenchmarkConfig& config,
+                                    core::benchmark_results_t* results) {
+  return core::RunSharedBenchmark(impl_, config, [this]() { return IsInterrupted(); }, results);
+}
+
 common::Error Driver::CurrentServerInfo(core::IServerInfo** info) {
   core::FastoObjectCommandIPtr cmd = CreateCommandFast(LMDB_INFO_REQUEST, core::C_INNER);
   LOG_COMMAND(cmd);
@@ -123,6 +123,12 @@ common::Error Driver::ExecuteImpl(const std::string& command, core::FastoObject*
   return impl_->Execute(command, out);
 }
 
+common::Error Driver::BenchmarkImpl(const core::BenchmarkConfig& config,
+                                    core::benchmark_results_t* results) {
+  return core::RunConnectionsBenchmark<core::memcached::DBConnection>(
+      impl_->config(), config, [this]() { return IsInterrupted(); }, results);
+}
+
 common::Error Driver::CurrentServerInfo(core::IServerInfo** info) {
   core::FastoObjectCommandIPtr cmd = CreateCommandFast(MEMCACHED_INFO_REQUEST, core::C_INNER);
   LOG_COMMAND(cmd);
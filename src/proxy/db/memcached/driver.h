@@ -72,6 +72,8 @@ class Driver : public IDriverRemote {
   virtual common::Error SyncDisconnect() override WARN_UNUSED_RESULT;
 
   virtual common::Error ExecuteImpl(const std::string& command, core::FastoObject* out) override;
+  virtual common::Error BenchmarkImpl(const core::BenchmarkConfig& config,
+                                      core::benchmark_results_t* results) override;
   virtual common::Error CurrentServerInfo(core::IServerInfo** info) override;
   virtual common::Error CurrentDataBaseInfo(core::IDataBaseInfo** info) override;
 
@@ -0,0 +1,72 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/db/memcached/sample_source.h"
+
+#include <common/value.h>  // for ErrorValue, etc
+
+#include "core/db/memcached/db_connection.h"  // for DBConnection
+#include "core/db/memcached/server_info.h"    // for ServerInfo
+
+#include "proxy/db/memcached/connection_settings.h"  // for ConnectionSettings
+
+namespace fastonosql {
+namespace proxy {
+namespace memcached {
+
+SampleSource::SampleSource(IConnectionSettingsBaseSPtr settings)
+    : ISampleSource(), settings_(settings), impl_(new core::memcached::DBConnection(nullptr)) {}
+
+SampleSource::~SampleSource() {
+  delete impl_;
+}
+
+common::Error SampleSource::Connect() {
+  ConnectionSettings* set = dynamic_cast<ConnectionSettings*>(settings_.get());  // +
+  CHECK(set);
+  core::memcached::Config config = set->Info();
+  config.timeout_msec = SAMPLE_SOURCE_TIMEOUT_MSEC;
+  return impl_->Connect(config);
+}
+
+common::Error SampleSource::Disconnect() {
+  return impl_->Disconnect();
+}
+
+bool SampleSource::IsConnected() const {
+  return impl_->IsConnected();
+}
+
+common::Error SampleSource::Sample(core::IServerInfo** info) {
+  if (!info) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  core::memcached::ServerInfo::Stats stats;
+  common::Error err = impl_->Info(nullptr, &stats);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  *info = new core::memcached::ServerInfo(stats);
+  return common::Error();
+}
+
+}  // namespace memcached
+}  // namespace proxy
+}  // namespace fastonosql
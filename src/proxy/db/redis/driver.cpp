@@ -91,7 +91,9 @@ namespace proxy {
 namespace redis {
 
 Driver::Driver(IConnectionSettingsBaseSPtr settings)
-    : IDriverRemote(settings), impl_(new core::redis::DBConnection(this)) {
+    : IDriverRemote(settings),
+      impl_(new core::redis::DBConnection(this)),
+      timer_ssh_keepalive_id_(0) {
   COMPILE_ASSERT(core::redis::DBConnection::connection_t == core::REDIS,
                  "DBConnection must be the same type as Driver!");
   CHECK(Type() == core::REDIS);
@@ -134,9 +136,24 @@ bool Driver::IsAuthenticated() const {
   return impl_->IsAuthenticated();
 }
 
-void Driver::InitImpl() {}
+void Driver::timerEvent(QTimerEvent* event) {
+  if (timer_ssh_keepalive_id_ == event->timerId()) {
+    core::redis::KeepAliveSSHSessions();
+  }
+  IDriverRemote::timerEvent(event);
+}
 
-void Driver::ClearImpl() {}
+void Driver::InitImpl() {
+  timer_ssh_keepalive_id_ = startTimer(SSH_KEEPALIVE_TIMEOUT_MSEC);
+  DCHECK(timer_ssh_keepalive_id_ != 0);
+}
+
+void Driver::ClearImpl() {
+  if (timer_ssh_keepalive_id_ != 0) {
+    killTimer(timer_ssh_keepalive_id_);
+    timer_ssh_keepalive_id_ = 0;
+  }
+}
 
 core::FastoObjectCommandIPtr Driver::CreateCommand(core::FastoObject* parent,
                                                    const std::string& input,
@@ -164,6 +181,16 @@ common::Error Driver::ExecuteImpl(const std::string& command, core::FastoObject*
   return impl_->Execute(command, out);
 }
 
+void Driver::SetReplyWriter(core::FastoObjectWriter* writer) {
+  impl_->SetReplyWriter(writer);
+}
+
+common::Error Driver::BenchmarkImpl(const core::BenchmarkConfig& config,
+                                    core::benchmark_results_t* results) {
+  return core::RunConnectionsBenchmark<core::redis::DBConnection>(
+      impl_->config(), config, [this]() { return IsInterrupted(); }, results);
+}
+
 common::Error Driver::CurrentServerInfo(core::IServerInfo** info) {
   core::FastoObjectCommandIPtr cmd = CreateCommandFast(INFO_REQUEST, core::C_INNER);
   common::Error err = Execute(cmd.get());
@@ -69,6 +69,8 @@ class Driver : public IDriverRemote {
   virtual std::string Delimiter() const override;
 
  private:
+  virtual void timerEvent(QTimerEvent* event) override;
+
   virtual void InitImpl() override;
   virtual void ClearImpl() override;
 
@@ -83,6 +85,9 @@ class Driver : public IDriverRemote {
   virtual common::Error SyncDisconnect() override WARN_UNUSED_RESULT;
 
   virtual common::Error ExecuteImpl(const std::string& command, core::FastoObject* out) override;
+  virtual void SetReplyWriter(core::FastoObjectWriter* writer) override;
+  virtual common::Error BenchmarkImpl(const core::BenchmarkConfig& config,
+                                      core::benchmark_results_t* results) override;
 
   virtual common::Error CurrentServerInfo(core::IServerInfo** info) override;
   virtual common::Error CurrentDataBaseInfo(core::IDataBaseInfo** info) override;
@@ -103,6 +108,7 @@ class Driver : public IDriverRemote {
   virtual core::IServerInfoSPtr MakeServerInfoFromString(const std::string& val) override;
 
   core::redis::DBConnection* const impl_;
+  int timer_ssh_keepalive_id_;
 };
 
 }  // namespace redis
@@ -0,0 +1,86 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/db/redis/sample_source.h"
+
+#include <string>  // for string
+
+#include <common/value.h>  // for ErrorValue, etc
+
+#include "core/global.h"  // for FastoObjectIPtr, ConvertToString
+
+#include "core/db/redis/db_connection.h"  // for DBConnection, INFO_REQUEST, etc
+#include "core/db/redis/server_info.h"    // for MakeRedisServerInfo
+
+#include "proxy/db/redis/connection_settings.h"  // for ConnectionSettings
+
+namespace fastonosql {
+namespace proxy {
+namespace redis {
+
+SampleSource::SampleSource(IConnectionSettingsBaseSPtr settings)
+    : ISampleSource(), settings_(settings), impl_(new core::redis::DBConnection(nullptr)) {}
+
+SampleSource::~SampleSource() {
+  delete impl_;
+}
+
+common::Error SampleSource::Connect() {
+  ConnectionSettings* set = dynamic_cast<ConnectionSettings*>(settings_.get());  // +
+  CHECK(set);
+  core::redis::RConfig rconf(set->Info(), set->SSHInfo());
+  rconf.timeout_msec = SAMPLE_SOURCE_TIMEOUT_MSEC;
+  return impl_->Connect(rconf);
+}
+
+common::Error SampleSource::Disconnect() {
+  return impl_->Disconnect();
+}
+
+bool SampleSource::IsConnected() const {
+  return impl_->IsConnected();
+}
+
+common::Error SampleSource::Sample(core::IServerInfo** info) {
+  if (!info) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  core::FastoObjectIPtr root(core::FastoObject::CreateRoot(INFO_REQUEST));
+  common::Error err = impl_->Execute(INFO_REQUEST, root.get());
+  if (err && err->isError()) {
+    return err;
+  }
+
+  std::string content;
+  core::FastoObject::childs_t childrens = root->Childrens();
+  for (size_t i = 0; i < childrens.size(); ++i) {
+    content += common::ConvertToString(childrens[i].get());
+  }
+
+  *info = core::redis::MakeRedisServerInfo(content);
+  if (!*info) {
+    return common::make_error_value("Invalid " INFO_REQUEST " command output",
+                                    common::ErrorValue::E_ERROR);
+  }
+  return common::Error();
+}
+
+}  // namespace redis
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,53 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "proxy/sampler/isample_source.h"  // for ISampleSource
+
+namespace fastonosql {
+namespace core {
+namespace redis {
+class DBConnection;
+}
+}  // namespace core
+}  // namespace fastonosql
+
+namespace fastonosql {
+namespace proxy {
+namespace redis {
+
+class SampleSource : public ISampleSource {
+ public:
+  explicit SampleSource(IConnectionSettingsBaseSPtr settings);
+  virtual ~SampleSource();
+
+  virtual common::Error Connect() override;
+  virtual common::Error Disconnect() override;
+  virtual bool IsConnected() const override;
+
+  virtual common::Error Sample(core::IServerInfo** info) override;
+
+ private:
+  IConnectionSettingsBaseSPtr settings_;
+  core::redis::DBConnection* impl_;
+};
+
+}  // namespace redis
+}  // namespace proxy
+}  // namespace fastonosql
@@ -53,7 +53,9 @@ namespace proxy {
 namespace rocksdb {
 
 Driver::Driver(IConnectionSettingsBaseSPtr settings)
-    : IDriverLocal(settings), impl_(new core::rocksdb::DBConnection(this)) {
+    : IDriverLocal(settings),
+      impl_(new core::rocksdb::DBConnection(this)),
+      timer_scan_session_id_(0) {
   COMPILE_ASSERT(core::rocksdb::DBConnection::connection_t == core::ROCKSDB,
                  "DBConnection must be the same type as Driver!");
   CHECK(Type() == core::ROCKSDB);
@@ -68,7 +70,10 @@ bool Driver::IsInterrupted() const {
 }
 
 void Driver::SetInterrupted(bool interrupted) {
-  return impl_->SetInterrupted(interrupted);
+  impl_->SetInterrupted(interrupted);
+  if (interrupted) {  // stop also cancels background COMPACT
+    impl_->CancelCompact();
+  }
 }
 
 core::translator_t Driver::Translator() const {
@@ -96,9 +101,24 @@ std::string Driver::Delimiter() const {
   return impl_->Delimiter();
 }
 
-void Driver::InitImpl() {}
+void Driver::timerEvent(QTimerEvent* event) {
+  if (timer_scan_session_id_ == event->timerId()) {
+    impl_->ExpireScanSession();
+  }
+  IDriverLocal::timerEvent(event);
+}
 
-void Driver::ClearImpl() {}
+void Driver::InitImpl() {
+  timer_scan_session_id_ = startTimer(SCAN_SESSION_TIMEOUT_MSEC);
+  DCHECK(timer_scan_session_id_ != 0);
+}
+
+void Driver::ClearImpl() {
+  if (timer_scan_session_id_ != 0) {
+    killTimer(timer_scan_session_id_);
+    timer_scan_session_id_ = 0;
+  }
+}
 
 core::FastoObjectCommandIPtr Driver::CreateCommand(core::FastoObject* parent,
                                                    const std::string& input,
@@ -125,16 +145,22 @@ common::Error Driver::ExecuteImpl(const std::string& command, core::FastoObject*
   return impl_->Execute(command, out);
 }
 
+common::Error Driver::BenchmarkImpl(const core::BenchmarkConfig& config,
+                                    core::benchmark_results_t* results) {
+  return core::RunSharedBenchmark(impl_, config, [this]() { return IsInterrupted(); }, results);
+}
+
 common::Error Driver::CurrentServerInfo(core::IServerInfo** info) {
   core::FastoObjectCommandIPtr cmd = CreateCommandFast(ROCKSDB_INFO_REQUEST, core::C_INNER);
   LOG_COMMAND(cmd);
-  core::rocksdb::ServerInfo::Stats cm;
-  common::Error err = impl_->Info(nullptr, &cm);
+  core::rocksdb::ServerInfo* linfo = new core::rocksdb::ServerInfo;
+  common::Error err = impl_->Info(nullptr, linfo);
   if (err && err->isError()) {
+    delete linfo;
     return err;
   }
 
-  *info = new core::rocksdb::ServerInfo(cm);
+  *info = linfo;
   return common::Error();
 }
 
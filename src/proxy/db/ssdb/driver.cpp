@@ -22,6 +22,7 @@
 
 #include <memory>  // for __shared_ptr
 #include <string>  // for string
+#include <vector>  // for vector
 
 #include <common/intrusive_ptr.h>  // for intrusive_ptr
 #include <common/qt/utils_qt.h>    // for Event<>::value_type
@@ -44,14 +45,16 @@
 #include "core/global.h"  // for FastoObject::childs_t, etc
 
 #define SSDB_INFO_REQUEST "INFO"
-#define SSDB_GET_KEYS_PATTERN_1ARGS_I "KEYS a z %d"
 
 namespace fastonosql {
 namespace proxy {
 namespace ssdb {
 
 Driver::Driver(IConnectionSettingsBaseSPtr settings)
-    : IDriverRemote(settings), impl_(new core::ssdb::DBConnection(this)) {
+    : IDriverRemote(settings),
+      impl_(new core::ssdb::DBConnection(this)),
+      db_keys_count_(0),
+      db_keys_count_valid_(false) {
   COMPILE_ASSERT(core::ssdb::DBConnection::connection_t == core::SSDB,
                  "DBConnection must be the same type as Driver!");
   CHECK(Type() == core::SSDB);
@@ -123,6 +126,12 @@ common::Error Driver::ExecuteImpl(const std::string& command, core::FastoObject*
   return impl_->Execute(command, out);
 }
 
+common::Error Driver::BenchmarkImpl(const core::BenchmarkConfig& config,
+                                    core::benchmark_results_t* results) {
+  return core::RunConnectionsBenchmark<core::ssdb::DBConnection>(
+      impl_->config(), config, [this]() { return IsInterrupted(); }, results);
+}
+
 common::Error Driver::CurrentServerInfo(core::IServerInfo** info) {
   core::FastoObjectCommandIPtr cmd = CreateCommandFast(SSDB_INFO_REQUEST, core::C_INNER);
   LOG_COMMAND(cmd);
@@ -149,53 +158,45 @@ void Driver::HandleLoadDatabaseContentEvent(events::LoadDatabaseContentRequestEv
   QObject* sender = ev->sender();
   NotifyProgress(sender, 0);
   events::LoadDatabaseContentResponceEvent::value_type res(ev->value());
-  std::string patternResult = common::MemSPrintf(SSDB_GET_KEYS_PATTERN_1ARGS_I, res.count_keys);
+  std::string patternResult =
+      common::MemSPrintf(GET_KEYS_PATTERN_3ARGS_ISI, res.cursor_in, res.pattern, res.count_keys);
   core::FastoObjectCommandIPtr cmd = CreateCommandFast(patternResult, core::C_INNER);
+  LOG_COMMAND(cmd);
   NotifyProgress(sender, 50);
-  common::Error err = Execute(cmd);
+  std::vector<std::string> keys;
+  common::Error err =
+      impl_->Scan(res.cursor_in, res.pattern, res.count_keys, &keys, &res.cursor_out);
   if (err && err->isError()) {
     res.setErrorInfo(err);
   } else {
-    core::FastoObject::childs_t rchildrens = cmd->Childrens();
-    if (rchildrens.size()) {
-      CHECK_EQ(rchildrens.size(), 1);
-      core::FastoObjectArray* array =
-          dynamic_cast<core::FastoObjectArray*>(rchildrens[0].get());  // +
-      if (!array) {
-        goto done;
-      }
-      common::ArrayValue* ar = array->Array();
-      if (!ar) {
-        goto done;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      const std::string key = keys[i];
+      core::NKey k(key);
+      core::FastoObjectCommandIPtr cmd_ttl =
+          CreateCommandFast(common::MemSPrintf("TTL %s", key), core::C_INNER);
+      LOG_COMMAND(cmd_ttl);
+      core::ttl_t ttl = NO_TTL;
+      common::Error err = impl_->TTL(key, &ttl);
+      if (err && err->isError()) {
+        k.SetTTL(NO_TTL);
+      } else {
+        k.SetTTL(ttl);
       }
 
-      for (size_t i = 0; i < ar->size(); ++i) {
-        std::string key;
-        if (ar->getString(i, &key)) {
-          core::NKey k(key);
-          core::FastoObjectCommandIPtr cmd_ttl =
-              CreateCommandFast(common::MemSPrintf("TTL %s", key), core::C_INNER);
-          LOG_COMMAND(cmd_ttl);
-          core::ttl_t ttl = NO_TTL;
-          common::Error err = impl_->TTL(key, &ttl);
-          if (err && err->isError()) {
-            k.SetTTL(NO_TTL);
-          } else {
-            k.SetTTL(ttl);
-          }
-
-          core::NValue empty_val(
-              common::Value::createEmptyValueFromType(common::Value::TYPE_STRING));
-          core::NDbKValue ress(k, empty_val);
-          res.keys.push_back(ress);
-        }
-      }
+      core::NValue empty_val(common::Value::createEmptyValueFromType(common::Value::TYPE_STRING));
+      core::NDbKValue ress(k, empty_val);
+      res.keys.push_back(ress);
+    }
 
-      err = impl_->DBkcount(&res.db_keys_count);
+    // ssdb counts keys by pages, so count once per load and not for every page
+    if (res.cursor_in == 0 || !db_keys_count_valid_) {
+      err = impl_->DBkcount(&db_keys_count_);
       DCHECK(!err);
+      db_keys_count_valid_ = !err;
     }
+    res.db_keys_count = db_keys_count_;
   }
-done:
+
   NotifyProgress(sender, 75);
   Reply(sender, new events::LoadDatabaseContentResponceEvent(this, res));
   NotifyProgress(sender, 100);
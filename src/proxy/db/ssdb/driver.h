@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <stddef.h>  // for size_t
+
 #include <string>  // for string
 
 #include <common/error.h>      // for Error
@@ -84,6 +86,8 @@ class Driver : public IDriverRemote {
   virtual common::Error SyncDisconnect() override WARN_UNUSED_RESULT;
 
   virtual common::Error ExecuteImpl(const std::string& command, core::FastoObject* out) override;
+  virtual common::Error BenchmarkImpl(const core::BenchmarkConfig& config,
+                                      core::benchmark_results_t* results) override;
   virtual common::Error CurrentServerInfo(core::IServerInfo** info) override;
   virtual common::Error CurrentDataBaseInfo(core::IDataBaseInfo** info) override;
 
@@ -93,6 +97,8 @@ class Driver : public IDriverRemote {
 
  private:
   core::ssdb::DBConnection* const impl_;
+  size_t db_keys_count_;  // of current content load, counted on its first page
+  bool db_keys_count_valid_;
 };
 
 }  // namespace ssdb
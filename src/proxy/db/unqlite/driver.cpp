@@ -127,6 +127,14 @@ common::Error Driver::ExecuteImpl(const std::string& command, core::FastoObject*
   return impl_->Execute(command, out);
 }
 
+common::Error Driver::BenchmarkImpl(const core::BenchmarkConfig& config,
+                                    core::benchmark_results_t* results) {
+  // handle isn't thread safe without UNQLITE_ENABLE_THREADS
+  core::BenchmarkConfig single = config;
+  single.clients = 1;
+  return core::RunSharedBenchmark(impl_, single, [this]() { return IsInterrupted(); }, results);
+}
+
 common::Error Driver::CurrentServerInfo(core::IServerInfo** info) {
   core::FastoObjectCommandIPtr cmd = CreateCommandFast(UNQLITE_INFO_REQUEST, core::C_INNER);
   LOG_COMMAND(cmd);
@@ -127,6 +127,11 @@ common::Error Driver::ExecuteImpl(const std::string& command, core::FastoObject*
   return impl_->Execute(command, out);
 }
 
+common::Error Driver::BenchmarkImpl(const core::BenchmarkConfig& config,
+                                    core::benchmark_results_t* results) {
+  return core::RunSharedBenchmark(impl_, config, [this]() { return IsInterrupted(); }, results);
+}
+
 common::Error Driver::CurrentServerInfo(core::IServerInfo** info) {
   core::FastoObjectCommandIPtr cmd = CreateCommandFast(UPSCALEDB_INFO_REQUEST, core::C_INNER);
   LOG_COMMAND(cmd);
@@ -149,6 +154,20 @@ common::Error Driver::CurrentDataBaseInfo(core::IDataBaseInfo** info) {
   return impl_->Select(impl_->CurrentDBName(), info);
 }
 
+void Driver::HandleLoadDatabaseInfosEvent(events::LoadDatabasesInfoRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::LoadDatabasesInfoResponceEvent::value_type res(ev->value());
+  NotifyProgress(sender, 50);
+  common::Error err = impl_->DataBases(&res.databases);
+  if (err && err->isError()) {
+    res.setErrorInfo(err);
+  }
+  NotifyProgress(sender, 75);
+  Reply(sender, new events::LoadDatabasesInfoResponceEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
 void Driver::HandleLoadDatabaseContentEvent(events::LoadDatabaseContentRequestEvent* ev) {
   QObject* sender = ev->sender();
   NotifyProgress(sender, 0);
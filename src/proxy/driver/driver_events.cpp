@@ -0,0 +1,107 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "proxy/driver/driver_events.h"
+
+#include <utility>  // for move
+
+#include <common/time.h>  // for current_mstime
+
+namespace fastonosql {
+namespace proxy {
+
+DriverEvent::DriverEvent(Type type)
+    : type(type), object(), value(), db(), key(), new_name(), ttl(NO_TTL) {}
+
+DriverEvent DriverEvent::MakeChildAdded(core::FastoObjectIPtr child) {
+  DriverEvent ev(CHILD_ADDED);
+  ev.object = child;
+  return ev;
+}
+
+DriverEvent DriverEvent::MakeItemUpdated(core::FastoObjectIPtr item, common::ValueSPtr val) {
+  DriverEvent ev(ITEM_UPDATED);
+  ev.object = item;
+  ev.value = val;
+  return ev;
+}
+
+DriverEvent DriverEvent::MakeDataBaseChanged(core::IDataBaseInfoSPtr db) {
+  DriverEvent ev(DATABASE_CHANGED);
+  ev.db = db;
+  return ev;
+}
+
+DriverEvent DriverEvent::MakeKeyEvent(Type type, const core::NDbKValue& key) {
+  DriverEvent ev(type);
+  ev.key = key;
+  return ev;
+}
+
+DriverEvent DriverEvent::MakeKeyRenamed(const core::NKey& key, const std::string& new_name) {
+  DriverEvent ev(KEY_RENAMED);
+  ev.key.SetKey(key);
+  ev.new_name = new_name;
+  return ev;
+}
+
+DriverEvent DriverEvent::MakeKeyTTL(Type type, const core::NKey& key, core::ttl_t ttl) {
+  DriverEvent ev(type);
+  ev.key.SetKey(key);
+  ev.ttl = ttl;
+  return ev;
+}
+
+DriverEventsBatcher::DriverEventsBatcher(common::time64_t interval_msec)
+    : interval_msec_(interval_msec), pending_(), last_take_msec_(0) {}
+
+bool DriverEventsBatcher::Push(DriverEvent&& event) {
+  return Push(std::move(event), common::time::current_mstime());
+}
+
+bool DriverEventsBatcher::Push(DriverEvent&& event, common::time64_t now_msec) {
+  pending_.push_back(std::move(event));
+  return IsDue(now_msec);
+}
+
+bool DriverEventsBatcher::IsDue(common::time64_t now_msec) const {
+  return !pending_.empty() && now_msec - last_take_msec_ >= interval_msec_;
+}
+
+driver_events_batch_t DriverEventsBatcher::Take() {
+  return Take(common::time::current_mstime());
+}
+
+driver_events_batch_t DriverEventsBatcher::Take(common::time64_t now_msec) {
+  driver_events_batch_t batch = std::make_shared<const driver_events_t>(std::move(pending_));
+  pending_ = driver_events_t();
+  last_take_msec_ = now_msec;
+  return batch;
+}
+
+bool DriverEventsBatcher::IsEmpty() const {
+  return pending_.empty();
+}
+
+common::time64_t DriverEventsBatcher::IntervalMsec() const {
+  return interval_msec_;
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,101 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <memory>  // for shared_ptr
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include <common/types.h>  // for time64_t
+#include <common/value.h>  // for ValueSPtr
+
+#include "core/database/idatabase_info.h"  // for IDataBaseInfoSPtr
+#include "core/db_key.h"                   // for NDbKValue, NKey, ttl_t
+#include "core/global.h"                   // for FastoObjectIPtr
+
+#define DRIVER_EVENTS_BATCH_MSEC 16  // one frame at 60 fps
+
+namespace fastonosql {
+namespace proxy {
+
+// Notification from driver thread for GUI, kept in order in a batch.
+struct DriverEvent {
+  enum Type {
+    CHILD_ADDED,       // object
+    ITEM_UPDATED,      // object, value
+    FLUSHED_DB,        //
+    DATABASE_CHANGED,  // db
+    KEY_REMOVED,       // key
+    KEY_ADDED,         // key
+    KEY_LOADED,        // key
+    KEY_RENAMED,       // key, new_name
+    KEY_TTL_CHANGED,   // key, ttl
+    KEY_TTL_LOADED     // key, ttl
+  };
+
+  explicit DriverEvent(Type type);
+
+  static DriverEvent MakeChildAdded(core::FastoObjectIPtr child);
+  static DriverEvent MakeItemUpdated(core::FastoObjectIPtr item, common::ValueSPtr val);
+  static DriverEvent MakeDataBaseChanged(core::IDataBaseInfoSPtr db);
+  static DriverEvent MakeKeyEvent(Type type, const core::NDbKValue& key);
+  static DriverEvent MakeKeyRenamed(const core::NKey& key, const std::string& new_name);
+  static DriverEvent MakeKeyTTL(Type type, const core::NKey& key, core::ttl_t ttl);
+
+  Type type;
+  core::FastoObjectIPtr object;
+  common::ValueSPtr value;
+  core::IDataBaseInfoSPtr db;
+  core::NDbKValue key;
+  std::string new_name;
+  core::ttl_t ttl;
+};
+
+typedef std::vector<DriverEvent> driver_events_t;
+// passed through queued connection, copying it only copies the pointer
+typedef std::shared_ptr<const driver_events_t> driver_events_batch_t;
+
+// Collects driver notifications on the driver thread, so GUI gets one queued
+// signal per interval instead of one per key or reply item. The first event
+// after an idle interval is taken at once (leading edge), events of a burst
+// wait until the interval since the last Take passes; the owner takes them
+// when IsDue, a blocking command may push nothing more. Not thread safe.
+class DriverEventsBatcher {
+ public:
+  explicit DriverEventsBatcher(common::time64_t interval_msec = DRIVER_EVENTS_BATCH_MSEC);
+
+  // returns true when the batch must be taken now
+  bool Push(DriverEvent&& event);
+  bool Push(DriverEvent&& event, common::time64_t now_msec);
+  bool IsDue(common::time64_t now_msec) const;
+  driver_events_batch_t Take();
+  driver_events_batch_t Take(common::time64_t now_msec);
+  bool IsEmpty() const;
+
+  common::time64_t IntervalMsec() const;
+
+ private:
+  const common::time64_t interval_msec_;
+  driver_events_t pending_;
+  common::time64_t last_take_msec_;  // 0 - never taken
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
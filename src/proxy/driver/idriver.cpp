@@ -24,28 +24,35 @@
 #include <signal.h>
 #endif
 
-#include <memory>  // for __shared_ptr
-#include <vector>  // for vector
-#include <string>  // for allocator, string, etc
+#include <inttypes.h>  // for PRIu64
+
+#include <memory>   // for __shared_ptr
+#include <vector>   // for vector
+#include <string>   // for allocator, string, etc
+#include <utility>  // for move
 
 #include <QApplication>
 #include <QThread>
 
 #include <common/convert2string.h>  // for ConvertToString, etc
-#include <common/file_system.h>     // for File, ascii_string_path, etc
 #include <common/intrusive_ptr.h>   // for intrusive_ptr
-#include <common/log_levels.h>      // for LEVEL_LOG::L_WARNING
+#include <common/log_levels.h>      // for LEVEL_LOG::L_WARNING, etc
+#include <common/qt/logger.h>       // for LOG_ERROR, LOG_MSG
 #include <common/qt/utils_qt.h>     // for Event<>::value_type
 #include <common/sprintf.h>         // for MemSPrintf
-#include <common/string_util.h>     // for Tokenize
 #include <common/time.h>            // for current_mstime
-#include <common/types.h>           // for buffer_t, time64_t, etc
+#include <common/types.h>           // for time64_t
 #include <common/utils.h>           // for c_strornull, msleep
 
+#include "core/command_stats.h"        // for CommandStats, IsStatsCommand
+#include "core/fasto_object_writer.h"  // for FileSink, FastoObjectWriter
+
 #include "proxy/command/command_logger.h"  // for LOG_COMMAND
 #include "proxy/driver/first_child_update_root_locker.h"
 #include "proxy/driver/root_locker.h"  // for RootLocker
 #include "proxy/events/events_info.h"
+#include "proxy/sampler/metrics_sampler.h"  // for MetricsSampler
+#include "proxy/sampler/metrics_store.h"    // for MetricsStore
 
 namespace {
 #ifdef OS_WIN
@@ -63,34 +70,6 @@ struct SigIgnInit {
   SigIgnInit() { signal(SIGPIPE, SIG_IGN); }
 } sig_init;
 #endif
-
-const char magicNumber = 0x1E;
-std::string createStamp(common::time64_t time) {
-  return magicNumber + common::ConvertToString(time) + '\n';
-}
-
-bool getStamp(common::buffer_t stamp, common::time64_t* time_out) {
-  if (stamp.empty()) {
-    return false;
-  }
-
-  if (stamp[0] != magicNumber) {
-    return false;
-  }
-
-  stamp.erase(stamp.begin());  // pop_front
-  if (stamp.empty()) {
-    return false;
-  }
-
-  if (stamp[stamp.size() - 1] == '\n') {
-    stamp.pop_back();
-  }
-
-  common::time64_t ltime_out = common::ConvertFromBytes<common::time64_t>(stamp);
-  *time_out = ltime_out;
-  return ltime_out != 0;
-}
 }  // namespace
 
 namespace fastonosql {
@@ -102,10 +81,13 @@ struct RegisterTypes {
     qRegisterMetaType<core::FastoObjectIPtr>("core::FastoObjectIPtr");
     qRegisterMetaType<core::NKey>("core::NKey");
     qRegisterMetaType<core::NDbKValue>("core::NDbKValue");
+    qRegisterMetaType<core::NKeys>("core::NKeys");
+    qRegisterMetaType<core::NDbKValues>("core::NDbKValues");
     qRegisterMetaType<core::IDataBaseInfoSPtr>("core::IDataBaseInfoSPtr");
     qRegisterMetaType<core::ttl_t>("core::ttl_t");
     qRegisterMetaType<std::string>("std::string");
     qRegisterMetaType<core::ServerInfoSnapShoot>("core::ServerInfoSnapShoot");
+    qRegisterMetaType<driver_events_batch_t>("driver_events_batch_t");
   }
 } reg_type;
 
@@ -132,7 +114,12 @@ void replyNotImplementedYet(IDriver* sender, event_request_type* ev, const char*
 }  // namespace
 
 IDriver::IDriver(IConnectionSettingsBaseSPtr settings)
-    : settings_(settings), thread_(nullptr), timer_info_id_(0), log_file_(nullptr) {
+    : settings_(settings),
+      thread_(nullptr),
+      timer_info_id_(0),
+      timer_events_id_(0),
+      sampled_(false),
+      events_batcher_() {
   thread_ = new QThread(this);
   moveToThread(thread_);
 
@@ -140,9 +127,7 @@ IDriver::IDriver(IConnectionSettingsBaseSPtr settings)
   VERIFY(connect(thread_, &QThread::finished, this, &IDriver::Clear));
 }
 
-IDriver::~IDriver() {
-  destroy(&log_file_);
-}
+IDriver::~IDriver() {}
 
 common::Error IDriver::Execute(core::FastoObjectCommandIPtr cmd) {
   if (!cmd) {
@@ -151,10 +136,73 @@ common::Error IDriver::Execute(core::FastoObjectCommandIPtr cmd) {
   }
 
   LOG_COMMAND(cmd);
-  common::Error err = ExecuteImpl(cmd->InputCommand(), cmd.get());
+  const std::string input = cmd->InputCommand();
+  if (core::IsBenchmarkCommand(input)) {
+    return Benchmark(input, cmd.get());
+  }
+  if (core::IsStatsCommand(input)) {
+    return Stats(input, cmd.get());
+  }
+
+  common::Error err = ExecuteImpl(input, cmd.get());
+  return err;
+}
+
+void IDriver::SetReplyWriter(core::FastoObjectWriter* writer) {
+  UNUSED(writer);
+}
+
+common::Error IDriver::Benchmark(const std::string& command, core::FastoObject* out) {
+  if (!IsConnected()) {
+    return common::make_error_value("Not connected", common::ErrorValue::E_ERROR);
+  }
+
+  core::BenchmarkConfig config;
+  common::Error err = core::ParseBenchmarkCommand(command, &config);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  core::benchmark_results_t results;
+  err = BenchmarkImpl(config, &results);
+  if (err && err->isError() && results.empty()) {
+    return err;
+  }
+
+  std::string report = core::BenchmarkReport(config, results);
+  common::StringValue* val = common::Value::createStringValue(report);
+  core::FastoObject* child = new core::FastoObject(out, val, Delimiter());
+  out->AddChildren(child);
   return err;
 }
 
+common::Error IDriver::Stats(const std::string& command, core::FastoObject* out) {
+  bool reset = false;
+  core::StatsFormat format = core::STATS_TEXT;
+  common::Error err = core::ParseStatsCommand(command, &reset, &format);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  core::CommandStats& stats = core::CommandStats::instance();
+  std::string report;
+  if (reset) {
+    stats.Reset(Type());
+    report = "OK";
+  } else if (format == core::STATS_JSON) {
+    report = core::CommandStatsToJson(stats.Snapshot(Type()));
+  } else if (format == core::STATS_PROMETHEUS) {
+    report = core::CommandStatsToPrometheus(stats.Snapshot(Type()));
+  } else {
+    report = core::CommandStatsReport(stats.Snapshot(Type()));
+  }
+
+  common::StringValue* val = common::Value::createStringValue(report);
+  core::FastoObject* child = new core::FastoObject(out, val, Delimiter());
+  out->AddChildren(child);
+  return common::Error();
+}
+
 void IDriver::Reply(QObject* reciver, QEvent* ev) {
   qApp->postEvent(reciver, ev);
 }
@@ -194,11 +242,20 @@ void IDriver::Clear() {
     killTimer(timer_info_id_);
     timer_info_id_ = 0;
   }
+  if (timer_events_id_ != 0) {
+    killTimer(timer_events_id_);
+    timer_events_id_ = 0;
+  }
+  if (sampled_) {
+    MetricsSampler::instance().RemoveTarget(settings_, this);
+    sampled_ = false;
+  }
   common::Error err = SyncDisconnect();
   if (err && err->isError()) {
     DNOTREACHED();
   }
   ClearImpl();
+  FlushDriverEvents();
 }
 
 void IDriver::customEvent(QEvent* event) {
@@ -271,49 +328,48 @@ void IDriver::customEvent(QEvent* event) {
     HandleDiscoveryInfoEvent(ev);  //
   }
 
+  FlushDriverEvents();
   return QObject::customEvent(event);
 }
 
 void IDriver::timerEvent(QTimerEvent* event) {
-  if (timer_info_id_ == event->timerId() && settings_->IsHistoryEnabled() && IsConnected()) {
-    if (!log_file_) {
-      std::string path = settings_->LoggingPath();
-      std::string dir = common::file_system::get_dir_path(path);
-      common::Error err = common::file_system::create_directory(dir, true);
-      if (err && err->isError()) {
-      }
-      if (common::file_system::is_directory(dir) == common::SUCCESS) {
-        common::file_system::ascii_string_path p(path);
-        log_file_ = new common::file_system::File(p);
-      }
-    }
+  if (timer_events_id_ != 0 && timer_events_id_ == event->timerId()) {
+    FlushDriverEvents();
+    QObject::timerEvent(event);
+    return;
+  }
 
-    if (log_file_ && !log_file_->isOpened()) {
-      bool opened = log_file_->open("ab+");
-      DCHECK(opened);
+  if (timer_info_id_ == event->timerId() && settings_->IsHistoryEnabled() && IsConnected() &&
+      !sampled_) {
+    common::time64_t time = common::time::current_mstime();
+    core::IServerInfo* info = nullptr;
+    common::Error er = CurrentServerInfo(&info);
+    if (er && er->isError()) {
+      QObject::timerEvent(event);
+      return;
     }
 
-    if (log_file_ && log_file_->isOpened()) {
-      common::time64_t time = common::time::current_mstime();
-      std::string stamp = createStamp(time);
-      core::IServerInfo* info = nullptr;
-      common::Error er = CurrentServerInfo(&info);
-      if (er && er->isError()) {
-        QObject::timerEvent(event);
-        return;
-      }
-
-      struct core::ServerInfoSnapShoot shot(time, core::IServerInfoSPtr(info));
-      emit ServerInfoSnapShoot(shot);
+    struct core::ServerInfoSnapShoot shot(time, core::IServerInfoSPtr(info));
+    emit ServerInfoSnapShoot(shot);
 
-      log_file_->write(stamp);
-      log_file_->write(info->ToString());
-      log_file_->flush();
+    common::Error err = MetricsStore::instance().Append(settings_, time, info);
+    if (err && err->isError()) {
+      // history file is unusable (disk full, permissions), don't fail on every tick
+      LOG_ERROR(err, true);
+      killTimer(timer_info_id_);
+      timer_info_id_ = 0;
     }
   }
   QObject::timerEvent(event);
 }
 
+void IDriver::OnSampled(std::string path, core::ServerInfoSnapShoot shot) {
+  UNUSED(path);  // sampler calls only the listeners of the sampled target
+  if (sampled_) {
+    emit ServerInfoSnapShoot(shot);
+  }
+}
+
 void IDriver::NotifyProgress(QObject* reciver, int value) {
   notifyProgressImpl(this, reciver, value);
 }
@@ -326,6 +382,8 @@ void IDriver::HandleConnectEvent(events::ConnectRequestEvent* ev) {
   common::Error er = SyncConnect();
   if (er && er->isError()) {
     res.setErrorInfo(er);
+  } else if (settings_->IsHistoryEnabled() && !sampled_) {
+    sampled_ = MetricsSampler::instance().AddTarget(settings_, this);
   }
   NotifyProgress(sender, 75);
   Reply(sender, new events::ConnectResponceEvent(this, res));
@@ -338,6 +396,11 @@ void IDriver::HandleDisconnectEvent(events::DisconnectRequestEvent* ev) {
   events::DisconnectResponceEvent::value_type res(ev->value());
   NotifyProgress(sender, 50);
 
+  if (sampled_) {
+    MetricsSampler::instance().RemoveTarget(settings_, this);
+    sampled_ = false;
+  }
+
   common::Error er = SyncDisconnect();
   if (er && er->isError()) {
     res.setErrorInfo(er);
@@ -367,6 +430,31 @@ void IDriver::HandleExecuteEvent(events::ExecuteRequestEvent* ev) {
   const bool history = res.history;
   const common::time64_t msec_repeat_interval = res.msec_repeat_interval;
   const core::CmdLoggingType log_type = res.logtype;
+  const std::string output_file = res.output_file;
+  const bool to_file = !output_file.empty();
+  core::FileSink sink;
+  std::unique_ptr<core::FastoObjectWriter> writer;
+  if (to_file) {
+    err = sink.Open(output_file);
+    if (err && err->isError()) {
+      res.setErrorInfo(err);
+      Reply(sender, new events::ExecuteResponceEvent(this, res));
+      NotifyProgress(sender, 100);
+      return;
+    }
+
+    writer.reset(core::CreateFastoObjectWriter(res.output_format, &sink));
+    err = writer ? writer->Start()
+                 : common::make_error_value("Unknown output format", common::ErrorValue::E_ERROR);
+    if (err && err->isError()) {
+      res.setErrorInfo(err);
+      Reply(sender, new events::ExecuteResponceEvent(this, res));
+      NotifyProgress(sender, 100);
+      return;
+    }
+    SetReplyWriter(writer.get());
+  }
+
   RootLocker* lock =
       history ? new RootLocker(this, sender, inputLine, silence)
               : new FirstChildUpdateRootLocker(this, sender, inputLine, silence, commands);
@@ -386,13 +474,23 @@ void IDriver::HandleExecuteEvent(events::ExecuteRequestEvent* ev) {
       NotifyProgress(sender, cur_progress);
 
       std::string command = commands[i];
-      core::FastoObjectCommandIPtr cmd = silence ? CreateCommandFast(command, log_type)
-                                                 : CreateCommand(obj.get(), command, log_type);  //
+      // replies of a saved command are detached from the root, written and freed right away
+      core::FastoObjectCommandIPtr cmd = silence || to_file
+                                             ? CreateCommandFast(command, log_type)
+                                             : CreateCommand(obj.get(), command, log_type);  //
       common::Error err = Execute(cmd);
       if (err && err->isError()) {
         res.setErrorInfo(err);
         goto done;
       }
+
+      if (writer) {
+        err = writer->Append(cmd.get());
+        if (err && err->isError()) {
+          res.setErrorInfo(err);
+          goto done;
+        }
+      }
     }
 
     common::time64_t finished_ts = common::time::current_mstime();
@@ -404,6 +502,29 @@ void IDriver::HandleExecuteEvent(events::ExecuteRequestEvent* ev) {
   }
 
 done:
+  if (writer) {
+    SetReplyWriter(nullptr);
+    common::Error err = writer->Finish();
+    common::Error cerr = sink.Close();
+    if (!err) {
+      err = cerr;
+    }
+    if (err && err->isError()) {
+      res.setErrorInfo(err);
+    } else {  // interrupted runs report what was saved so far
+      std::string summary = common::MemSPrintf(
+          "Saved %" PRIu64 " rows (%" PRIu64 " bytes) to %s",
+          static_cast<uint64_t>(writer->RowsWritten()), static_cast<uint64_t>(sink.BytesWritten()),
+          output_file);
+      core::FastoObjectCommandIPtr cmd = CreateCommand(obj.get(), inputLine, log_type);
+      if (cmd) {
+        common::StringValue* val = common::Value::createStringValue(summary);
+        cmd->AddChildren(new core::FastoObject(cmd.get(), val, Delimiter()));
+      }
+    }
+  }
+
+  FlushDriverEvents();  // replies must reach GUI before execute finished
   Reply(sender, new events::ExecuteResponceEvent(this, res));
   NotifyProgress(sender, 100);
   delete lock;
@@ -489,45 +610,13 @@ void IDriver::HandleLoadServerInfoHistoryEvent(events::ServerInfoHistoryRequestE
   QObject* sender = ev->sender();
   events::ServerInfoHistoryResponceEvent::value_type res(ev->value());
 
-  std::string path = settings_->LoggingPath();
-  common::file_system::ascii_string_path p(path);
-  common::file_system::File readFile(p);
-  if (readFile.open("rb")) {
-    events::ServerInfoHistoryResponceEvent::value_type::infos_container_type tmpInfos;
-
-    common::time64_t curStamp = 0;
-    common::buffer_t dataInfo;
-
-    while (!readFile.isEof()) {
-      common::buffer_t data;
-      bool res = readFile.readLine(&data);
-      if (!res || readFile.isEof()) {
-        if (curStamp) {
-          struct core::ServerInfoSnapShoot shoot(
-              curStamp, MakeServerInfoFromString(common::ConvertToString(dataInfo)));
-          tmpInfos.push_back(shoot);
-        }
-        break;
-      }
-
-      common::time64_t tmpStamp = 0;
-      bool isSt = getStamp(data, &tmpStamp);
-      if (isSt) {
-        if (curStamp) {
-          struct core::ServerInfoSnapShoot shoot(
-              curStamp, MakeServerInfoFromString(common::ConvertToString(dataInfo)));
-          tmpInfos.push_back(shoot);
-        }
-        curStamp = tmpStamp;
-        dataInfo.clear();
-      } else {
-        dataInfo.insert(dataInfo.end(), data.begin(), data.end());
-      }
-    }
-    res.setInfos(tmpInfos);
+  events::ServerInfoHistoryResponceEvent::value_type::points_container_type points;
+  common::Error err = MetricsStore::instance().Read(settings_, res.property, res.field,
+                                                    res.from_msec, res.to_msec, &points);
+  if (err && err->isError()) {
+    res.setErrorInfo(err);
   } else {
-    res.setErrorInfo(
-        common::make_error_value("History file not found", common::ErrorValue::E_ERROR));
+    res.setPoints(points);
   }
 
   Reply(sender, new events::ServerInfoHistoryResponceEvent(this, res));
@@ -537,26 +626,12 @@ void IDriver::HandleClearServerHistoryEvent(events::ClearServerHistoryRequestEve
   QObject* sender = ev->sender();
   events::ClearServerHistoryResponceEvent::value_type res(ev->value());
 
-  bool ret = false;
-
-  if (log_file_ && log_file_->isOpened()) {
-    ret = log_file_->truncate(0);
-  } else {
-    std::string path = settings_->LoggingPath();
-    if (common::file_system::is_file_exist(path)) {
-      common::Error err = common::file_system::remove_file(path);
-      if (err && err->isError()) {
-        ret = false;
-      } else {
-        ret = true;
-      }
-    } else {
-      ret = true;
-    }
-  }
-
-  if (!ret) {
+  common::Error err = MetricsStore::instance().Clear(settings_);
+  if (err && err->isError()) {
     res.setErrorInfo(common::make_error_value("Clear file error!", common::ErrorValue::E_ERROR));
+  } else if (timer_info_id_ == 0 && settings_->IsHistoryEnabled()) {
+    // resume recording stopped by an append error
+    timer_info_id_ = startTimer(settings_->LoggingMsTimeInterval());
   }
 
   Reply(sender, new events::ClearServerHistoryResponceEvent(this, res));
@@ -615,43 +690,88 @@ common::Error IDriver::ServerDiscoveryInfo(core::IServerInfo** sinfo,
 }
 
 void IDriver::OnFlushedCurrentDB() {
-  emit FlushedDB();
+  PostDriverEvent(DriverEvent(DriverEvent::FLUSHED_DB));
 }
 
 void IDriver::OnCurrentDataBaseChanged(core::IDataBaseInfo* info) {
   core::IDataBaseInfoSPtr curdb(info->Clone());
-  emit CurrentDataBaseChanged(curdb);
+  PostDriverEvent(DriverEvent::MakeDataBaseChanged(curdb));
 }
 
 void IDriver::OnKeysRemoved(const core::NKeys& keys) {
   for (size_t i = 0; i < keys.size(); ++i) {
-    emit KeyRemoved(keys[i]);
+    core::NDbKValue key;
+    key.SetKey(keys[i]);
+    PostDriverEvent(DriverEvent::MakeKeyEvent(DriverEvent::KEY_REMOVED, key));
   }
 }
 
 void IDriver::OnKeyAdded(const core::NDbKValue& key) {
-  emit KeyAdded(key);
+  PostDriverEvent(DriverEvent::MakeKeyEvent(DriverEvent::KEY_ADDED, key));
 }
 
 void IDriver::OnKeyLoaded(const core::NDbKValue& key) {
-  emit KeyLoaded(key);
+  PostDriverEvent(DriverEvent::MakeKeyEvent(DriverEvent::KEY_LOADED, key));
 }
 
 void IDriver::OnKeyRenamed(const core::NKey& key, const std::string& new_key) {
-  emit KeyRenamed(key, new_key);
+  PostDriverEvent(DriverEvent::MakeKeyRenamed(key, new_key));
 }
 
 void IDriver::OnKeyTTLChanged(const core::NKey& key, core::ttl_t ttl) {
-  emit KeyTTLChanged(key, ttl);
+  PostDriverEvent(DriverEvent::MakeKeyTTL(DriverEvent::KEY_TTL_CHANGED, key, ttl));
 }
 
 void IDriver::OnKeyTTLLoaded(const core::NKey& key, core::ttl_t ttl) {
-  emit KeyTTLLoaded(key, ttl);
+  PostDriverEvent(DriverEvent::MakeKeyTTL(DriverEvent::KEY_TTL_LOADED, key, ttl));
 }
 
 void IDriver::OnQuited() {
+  FlushDriverEvents();
   emit Disconnected();
 }
 
+void IDriver::OnJobProgress(const std::string& job, int percent) {
+  emit JobProgress(job, percent);
+}
+
+void IDriver::OnJobFinished(const std::string& job,
+                            common::Error err,
+                            const std::string& summary) {
+  if (err && err->isError()) {
+    std::string buff = common::MemSPrintf("%s failed: %s", job, err->description());
+    LOG_MSG(buff, common::logging::L_WARNING, true);
+  } else {
+    std::string buff = common::MemSPrintf("%s finished: %s", job, summary);
+    LOG_MSG(buff, common::logging::L_INFO, true);
+  }
+  emit JobProgress(job, 100);
+}
+
+void IDriver::PostDriverEvent(DriverEvent&& event) {
+  if (events_batcher_.Push(std::move(event))) {
+    FlushDriverEvents();
+    return;
+  }
+
+  // trailing edge of a burst, fires only while the thread runs its event loop
+  if (timer_events_id_ == 0) {
+    timer_events_id_ = startTimer(static_cast<int>(events_batcher_.IntervalMsec()));
+  }
+}
+
+void IDriver::FlushDriverEvents() {
+  if (timer_events_id_ != 0) {
+    killTimer(timer_events_id_);
+    timer_events_id_ = 0;
+  }
+
+  if (events_batcher_.IsEmpty()) {
+    return;
+  }
+
+  emit EventsBatched(events_batcher_.Take());
+}
+
 }  // namespace proxy
 }  // namespace fastonosql
@@ -26,11 +26,13 @@
 #include <common/macros.h>  // for WARN_UNUSED_RESULT
 #include <common/value.h>   // for Value, Value::CommandLogging...
 
+#include "core/benchmark.h"            // for BenchmarkConfig, benchmark_results_t
 #include "core/connection_types.h"     // for core::connectionTypes
 #include "core/db_key.h"               // for NKey (ptr only), NDbKValue (...
 #include "core/icommand_translator.h"  // for translator_t
 
 #include "core/internal/cdb_connection_client.h"             // for CDBConnectionClient
+#include "proxy/driver/driver_events.h"                      // for DriverEventsBatcher, etc
 #include "proxy/connection_settings/iconnection_settings.h"  // for IConnectionSettingsBaseSPtr
 #include "proxy/events/events.h"                             // for BackupRequestEvent, ChangeMa...
 #include "core/database/idatabase_info.h"                    // for IDataBaseInfoSPtr, etc
@@ -41,17 +43,20 @@
 class QEvent;
 class QThread;  // lines 37-37
 class QTimerEvent;
-namespace common {
-namespace file_system {
-class File;
+
+namespace fastonosql {
+namespace core {
+class FastoObjectWriter;
+}
 }
-}  // lines 41-41
 
 namespace fastonosql {
 namespace proxy {
 
 class IDriver : public QObject, public core::CDBConnectionClient {
   Q_OBJECT
+  friend class RootLocker;
+
  public:
   virtual ~IDriver();
 
@@ -78,23 +83,17 @@ class IDriver : public QObject, public core::CDBConnectionClient {
   virtual std::string NsSeparator() const = 0;
 
  Q_SIGNALS:
-  void ChildAdded(core::FastoObjectIPtr child);
-  void ItemUpdated(core::FastoObject* item, common::ValueSPtr val);
+  // replies, key and database changes, see DriverEvent
+  void EventsBatched(driver_events_batch_t batch);
   void ServerInfoSnapShoot(core::ServerInfoSnapShoot shot);
-
-  void FlushedDB();
-  void CurrentDataBaseChanged(core::IDataBaseInfoSPtr db);
-  void KeyRemoved(core::NKey key);
-  void KeyAdded(core::NDbKValue key);
-  void KeyRenamed(core::NKey key, std::string new_name);
-  void KeyLoaded(core::NDbKValue key);
-  void KeyTTLChanged(core::NKey key, core::ttl_t ttl);
-  void KeyTTLLoaded(core::NKey key, core::ttl_t ttl);
   void Disconnected();
+  // background job (COMPACT) progress, emitted from job thread, 100 when job finished
+  void JobProgress(std::string job, int percent);
 
  private Q_SLOTS:
   void Init();
   void Clear();
+  void OnSampled(std::string path, core::ServerInfoSnapShoot shot);
 
  protected:
   virtual void customEvent(QEvent* event) override;
@@ -142,6 +141,13 @@ class IDriver : public QObject, public core::CDBConnectionClient {
   void HandleClearServerHistoryEvent(events::ClearServerHistoryRequestEvent* ev);
 
   virtual common::Error ExecuteImpl(const std::string& command, core::FastoObject* out) = 0;
+  // execute to file: replies the engine can serialize while reading them go straight to
+  // writer instead of into out, nullptr - off; by default out is always built
+  virtual void SetReplyWriter(core::FastoObjectWriter* writer);
+  common::Error Benchmark(const std::string& command, core::FastoObject* out) WARN_UNUSED_RESULT;
+  virtual common::Error BenchmarkImpl(const core::BenchmarkConfig& config,
+                                      core::benchmark_results_t* results) = 0;
+  common::Error Stats(const std::string& command, core::FastoObject* out) WARN_UNUSED_RESULT;
 
   virtual void OnFlushedCurrentDB() override;
   virtual void OnCurrentDataBaseChanged(core::IDataBaseInfo* info) override;
@@ -152,6 +158,10 @@ class IDriver : public QObject, public core::CDBConnectionClient {
   virtual void OnKeyTTLChanged(const core::NKey& key, core::ttl_t ttl) override;
   virtual void OnKeyTTLLoaded(const core::NKey& key, core::ttl_t ttl) override;
   virtual void OnQuited() override;
+  virtual void OnJobProgress(const std::string& job, int percent) override;
+  virtual void OnJobFinished(const std::string& job,
+                             common::Error err,
+                             const std::string& summary) override;
 
   // internal methods
   virtual core::IServerInfoSPtr MakeServerInfoFromString(const std::string& val) = 0;
@@ -162,10 +172,15 @@ class IDriver : public QObject, public core::CDBConnectionClient {
   virtual void InitImpl() = 0;
   virtual void ClearImpl() = 0;
 
+  void PostDriverEvent(DriverEvent&& event);
+  void FlushDriverEvents();
+
  private:
   QThread* thread_;
   int timer_info_id_;
-  common::file_system::File* log_file_;
+  int timer_events_id_;  // takes a batch left pending when events stop coming
+  bool sampled_;  // INFO collected by MetricsSampler
+  DriverEventsBatcher events_batcher_;
 };
 
 }  // namespace proxy
@@ -23,6 +23,8 @@
 #include <common/macros.h>  // for DCHECK
 #include <common/time.h>    // for current_mstime
 
+#include "core/command_stats.h"  // for PostScope
+
 #include "proxy/driver/idriver.h"  // for IDriver
 #include "proxy/events/events.h"   // for CommandRootCompleatedEvent, etc
 
@@ -56,11 +58,15 @@ core::FastoObjectIPtr RootLocker::Root() const {
 }
 
 void RootLocker::ChildrenAdded(core::FastoObjectIPtr child) {
-  emit parent_->ChildAdded(child);
+  const uint64_t start = core::CommandStatsNowNsec();
+  parent_->PostDriverEvent(DriverEvent::MakeChildAdded(child));
+  core::PostScope::AddPostTime(core::CommandStatsNowNsec() - start);
 }
 
 void RootLocker::Updated(core::FastoObject* item, core::FastoObject::value_t val) {
-  emit parent_->ItemUpdated(item, val);
+  const uint64_t start = core::CommandStatsNowNsec();
+  parent_->PostDriverEvent(DriverEvent::MakeItemUpdated(item, val));
+  core::PostScope::AddPostTime(core::CommandStatsNowNsec() - start);
 }
 
 }  // namespace proxy
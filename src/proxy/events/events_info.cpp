@@ -109,6 +109,8 @@ ExecuteInfoRequest::ExecuteInfoRequest(initiator_type sender,
                                        bool history,
                                        bool silence,
                                        core::CmdLoggingType logtype,
+                                       const std::string& output_file,
+                                       core::OutputFormat output_format,
                                        error_type er)
     : base_class(sender, er),
       text(text),
@@ -116,7 +118,9 @@ ExecuteInfoRequest::ExecuteInfoRequest(initiator_type sender,
       msec_repeat_interval(msec_repeat_interval),
       history(history),
       silence(silence),
-      logtype(logtype) {}
+      logtype(logtype),
+      output_file(output_file),
+      output_format(output_format) {}
 
 ExecuteInfoResponce::ExecuteInfoResponce(const base_class& request) : base_class(request) {}
 
@@ -164,18 +168,27 @@ void ServerInfoResponce::setInfo(core::IServerInfoSPtr inf) {
 
 ServerInfoResponce::~ServerInfoResponce() {}
 
-ServerInfoHistoryRequest::ServerInfoHistoryRequest(initiator_type sender, error_type er)
-    : base_class(sender, er) {}
+ServerInfoHistoryRequest::ServerInfoHistoryRequest(initiator_type sender,
+                                                   unsigned char property,
+                                                   unsigned char field,
+                                                   common::time64_t from_msec,
+                                                   common::time64_t to_msec,
+                                                   error_type er)
+    : base_class(sender, er),
+      property(property),
+      field(field),
+      from_msec(from_msec),
+      to_msec(to_msec) {}
 
 ServerInfoHistoryResponce::ServerInfoHistoryResponce(const base_class& request)
-    : base_class(request) {}
+    : base_class(request), points_() {}
 
-ServerInfoHistoryResponce::infos_container_type ServerInfoHistoryResponce::infos() const {
-  return infos_;
+ServerInfoHistoryResponce::points_container_type ServerInfoHistoryResponce::points() const {
+  return points_;
 }
 
-void ServerInfoHistoryResponce::setInfos(const infos_container_type& inf) {
-  infos_ = inf;
+void ServerInfoHistoryResponce::setPoints(const points_container_type& points) {
+  points_ = points;
 }
 
 ClearServerHistoryRequest::ClearServerHistoryRequest(initiator_type sender, error_type er)
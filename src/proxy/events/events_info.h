@@ -34,8 +34,10 @@
 #include "core/server_property_info.h"  // for property_t, ServerPropertiesInfo
 #include "core/database/idatabase_info.h"
 #include "core/server/iserver_info.h"  // for IDataBaseInfoSPtr, IServerInf...
+#include "core/server/server_info_history.h"  // for HistoryPoint
 
 #include "core/global.h"  // for FastoObjectIPtr
+#include "core/fasto_object_writer.h"  // for OutputFormat
 
 namespace fastonosql {
 namespace proxy {
@@ -188,6 +190,8 @@ struct ExecuteInfoRequest : public EventInfoBase {
                      bool history = true,
                      bool silence = false,
                      core::CmdLoggingType logtype = core::C_USER,
+                     const std::string& output_file = std::string(),
+                     core::OutputFormat output_format = core::RAW_OUTPUT,
                      error_type er = error_type());
 
   const std::string text;
@@ -196,6 +200,10 @@ struct ExecuteInfoRequest : public EventInfoBase {
   const bool history;
   const bool silence;
   const core::CmdLoggingType logtype;
+  // if not empty replies are written into this file instead of the root,
+  // GUI gets only a summary
+  const std::string output_file;
+  const core::OutputFormat output_format;
 };
 
 struct ExecuteInfoResponce : ExecuteInfoRequest {
@@ -276,22 +284,33 @@ class ServerInfoResponce : public ServerInfoRequest {
   core::IServerInfoSPtr info_;
 };
 
+// one INFO field (index in InfoFields and in its property) over [from_msec, to_msec]
 struct ServerInfoHistoryRequest : public EventInfoBase {
   typedef EventInfoBase base_class;
-  explicit ServerInfoHistoryRequest(initiator_type sender, error_type er = error_type());
+  ServerInfoHistoryRequest(initiator_type sender,
+                           unsigned char property,
+                           unsigned char field,
+                           common::time64_t from_msec,
+                           common::time64_t to_msec,
+                           error_type er = error_type());
+
+  unsigned char property;
+  unsigned char field;
+  common::time64_t from_msec;
+  common::time64_t to_msec;
 };
 
 class ServerInfoHistoryResponce : public ServerInfoHistoryRequest {
  public:
   typedef ServerInfoHistoryRequest base_class;
-  typedef std::vector<core::ServerInfoSnapShoot> infos_container_type;
+  typedef std::vector<core::HistoryPoint> points_container_type;
   explicit ServerInfoHistoryResponce(const base_class& request);
 
-  infos_container_type infos() const;
-  void setInfos(const infos_container_type& inf);
+  points_container_type points() const;
+  void setPoints(const points_container_type& points);
 
  private:
-  infos_container_type infos_;
+  points_container_type points_;
 };
 
 struct ClearServerHistoryRequest : public EventInfoBase {
@@ -0,0 +1,64 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/sampler/isample_source.h"
+
+#ifdef BUILD_WITH_REDIS
+#include "proxy/db/redis/sample_source.h"  // for SampleSource
+#endif
+#ifdef BUILD_WITH_MEMCACHED
+#include "proxy/db/memcached/sample_source.h"  // for SampleSource
+#endif
+#ifdef BUILD_WITH_SSDB
+#include "proxy/db/ssdb/sample_source.h"  // for SampleSource
+#endif
+
+namespace fastonosql {
+namespace proxy {
+
+ISampleSource::ISampleSource() {}
+
+ISampleSource::~ISampleSource() {}
+
+ISampleSource* CreateSampleSource(IConnectionSettingsBaseSPtr settings) {
+  if (!settings) {
+    return nullptr;
+  }
+
+  core::connectionTypes type = settings->Type();
+#ifdef BUILD_WITH_REDIS
+  if (type == core::REDIS) {
+    return new redis::SampleSource(settings);
+  }
+#endif
+#ifdef BUILD_WITH_MEMCACHED
+  if (type == core::MEMCACHED) {
+    return new memcached::SampleSource(settings);
+  }
+#endif
+#ifdef BUILD_WITH_SSDB
+  if (type == core::SSDB) {
+    return new ssdb::SampleSource(settings);
+  }
+#endif
+  UNUSED(type);
+  return nullptr;
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
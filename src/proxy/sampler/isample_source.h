@@ -0,0 +1,53 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <common/error.h>   // for Error
+#include <common/macros.h>  // for WARN_UNUSED_RESULT
+
+#include "core/server/iserver_info.h"  // for IServerInfo
+
+#include "proxy/connection_settings/iconnection_settings.h"  // for IConnectionSettingsBaseSPtr
+
+// connect and read limit of sample sources, all targets share one thread
+#define SAMPLE_SOURCE_TIMEOUT_MSEC 5000
+
+namespace fastonosql {
+namespace proxy {
+
+// lightweight connection used by MetricsSampler, separate from the driver one
+class ISampleSource {
+ public:
+  virtual ~ISampleSource();
+
+  virtual common::Error Connect() WARN_UNUSED_RESULT = 0;
+  virtual common::Error Disconnect() WARN_UNUSED_RESULT = 0;
+  virtual bool IsConnected() const = 0;
+
+  virtual common::Error Sample(core::IServerInfo** info) WARN_UNUSED_RESULT = 0;
+
+ protected:
+  ISampleSource();
+};
+
+// nullptr for engines which can't be opened twice (local databases)
+ISampleSource* CreateSampleSource(IConnectionSettingsBaseSPtr settings);
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,265 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/sampler/metrics_sampler.h"
+
+#include <algorithm>   // for min, max
+#include <functional>  // for hash
+
+#include <QThread>
+#include <QTimerEvent>
+
+#include <common/qt/logger.h>    // for LOG_ERROR
+#include <common/qt/utils_qt.h>  // for VERIFY
+#include <common/time.h>         // for current_mstime
+
+#include "proxy/sampler/isample_source.h"  // for ISampleSource, CreateSampleSource
+#include "proxy/sampler/metrics_store.h"   // for MetricsStore
+
+namespace fastonosql {
+namespace proxy {
+
+SamplerTargetInfo::SamplerTargetInfo()
+    : path(), interval_msec(0), failures(0), last_sample_msec(0) {}
+
+MetricsSampler::Target::Target()
+    : settings(),
+      source(nullptr),
+      refs(0),
+      interval_msec(0),
+      next_msec(0),
+      failures(0),
+      last_sample_msec(0) {}
+
+MetricsSampler::MetricsSampler()
+    : thread_(nullptr),
+      timer_id_(0),
+      jitter_(),
+      targets_(),
+      lock_(),
+      pending_(),
+      infos_(),
+      listeners_() {
+  qRegisterMetaType<std::string>("std::string");
+  qRegisterMetaType<core::ServerInfoSnapShoot>("core::ServerInfoSnapShoot");
+
+  thread_ = new QThread(this);
+  moveToThread(thread_);
+
+  VERIFY(connect(thread_, &QThread::started, this, &MetricsSampler::Start));
+  VERIFY(connect(thread_, &QThread::finished, this, &MetricsSampler::Stop));
+  thread_->start();
+}
+
+MetricsSampler::~MetricsSampler() {
+  thread_->quit();
+  thread_->wait();
+
+  QMutexLocker lock(&lock_);
+  for (size_t i = 0; i < pending_.size(); ++i) {
+    delete pending_[i].second;
+  }
+  pending_.clear();
+}
+
+bool MetricsSampler::AddTarget(IConnectionSettingsBaseSPtr settings, QObject* listener) {
+  ISampleSource* source = CreateSampleSource(settings);
+  if (!source) {
+    return false;
+  }
+
+  QMutexLocker lock(&lock_);
+  pending_.push_back(std::make_pair(settings, source));
+  if (listener) {
+    listeners_.insert(std::make_pair(settings->LoggingPath(), listener));
+  }
+  return true;
+}
+
+void MetricsSampler::RemoveTarget(IConnectionSettingsBaseSPtr settings, QObject* listener) {
+  if (!settings) {
+    return;
+  }
+
+  QMutexLocker lock(&lock_);
+  pending_.push_back(std::make_pair(settings, static_cast<ISampleSource*>(nullptr)));
+  auto range = listeners_.equal_range(settings->LoggingPath());
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == listener) {
+      listeners_.erase(it);
+      break;
+    }
+  }
+}
+
+MetricsSampler::targets_info_t MetricsSampler::Targets() const {
+  QMutexLocker lock(&lock_);
+  targets_info_t res;
+  for (auto it = infos_.begin(); it != infos_.end(); ++it) {
+    res.push_back(it->second);
+  }
+  return res;
+}
+
+void MetricsSampler::Start() {
+  jitter_.seed(static_cast<std::minstd_rand::result_type>(common::time::current_mstime()));
+  timer_id_ = startTimer(SAMPLER_TICK_MSEC);
+  DCHECK(timer_id_ != 0);
+}
+
+void MetricsSampler::Stop() {
+  if (timer_id_ != 0) {
+    killTimer(timer_id_);
+    timer_id_ = 0;
+  }
+
+  for (auto it = targets_.begin(); it != targets_.end(); ++it) {
+    ISampleSource* source = it->second.source;
+    if (source->IsConnected()) {
+      common::Error err = source->Disconnect();
+      DCHECK(!err);
+    }
+    delete source;
+  }
+  targets_.clear();
+
+  QMutexLocker lock(&lock_);
+  infos_.clear();
+}
+
+void MetricsSampler::timerEvent(QTimerEvent* event) {
+  if (timer_id_ == event->timerId()) {
+    common::time64_t now = common::time::current_mstime();
+    ApplyPending(now);
+    for (auto it = targets_.begin(); it != targets_.end(); ++it) {
+      if (it->second.next_msec <= now) {
+        SampleTarget(it->first, &it->second, now);
+        now = common::time::current_mstime();  // sampling is blocking
+      }
+    }
+  }
+  QObject::timerEvent(event);
+}
+
+void MetricsSampler::ApplyPending(common::time64_t now) {
+  std::vector<std::pair<IConnectionSettingsBaseSPtr, ISampleSource*>> pending;
+  {
+    QMutexLocker lock(&lock_);
+    pending.swap(pending_);
+  }
+
+  for (size_t i = 0; i < pending.size(); ++i) {
+    IConnectionSettingsBaseSPtr settings = pending[i].first;
+    ISampleSource* source = pending[i].second;
+    const std::string path = settings->LoggingPath();
+    auto it = targets_.find(path);
+    if (source) {
+      if (it != targets_.end()) {
+        it->second.refs++;
+        delete source;
+        continue;
+      }
+
+      Target target;
+      target.settings = settings;
+      target.source = source;
+      target.refs = 1;
+      target.interval_msec = std::max(settings->LoggingMsTimeInterval(), SAMPLER_TICK_MSEC);
+      // stagger targets over the interval so they don't fire on the same tick
+      target.next_msec = now + std::hash<std::string>()(path) % target.interval_msec;
+      targets_.insert(std::make_pair(path, target));
+
+      SamplerTargetInfo info;
+      info.path = path;
+      info.interval_msec = target.interval_msec;
+      QMutexLocker lock(&lock_);
+      infos_[path] = info;
+    } else if (it != targets_.end() && --it->second.refs == 0) {
+      if (it->second.source->IsConnected()) {
+        common::Error err = it->second.source->Disconnect();
+        DCHECK(!err);
+      }
+      delete it->second.source;
+      targets_.erase(it);
+
+      QMutexLocker lock(&lock_);
+      infos_.erase(path);
+    }
+  }
+}
+
+void MetricsSampler::SampleTarget(const std::string& path, Target* target, common::time64_t now) {
+  ISampleSource* source = target->source;
+  common::Error err;
+  if (!source->IsConnected()) {
+    err = source->Connect();
+  }
+
+  core::IServerInfo* info = nullptr;
+  if (!err || !err->isError()) {
+    err = source->Sample(&info);
+  }
+
+  if (err && err->isError()) {
+    LOG_ERROR(err, false);
+    if (source->IsConnected()) {
+      common::Error derr = source->Disconnect();
+      DCHECK(!derr);
+    }
+
+    // exponential backoff with jitter, dead targets shouldn't eat the ticks of live ones
+    target->failures++;
+    common::time64_t backoff = static_cast<common::time64_t>(target->interval_msec)
+                               << std::min(target->failures, static_cast<size_t>(16));
+    backoff = std::min(backoff, static_cast<common::time64_t>(SAMPLER_MAX_BACKOFF_MSEC));
+    target->next_msec = now + backoff + jitter_() % (backoff / 4 + 1);
+  } else {
+    common::time64_t time = common::time::current_mstime();
+    core::IServerInfoSPtr sinfo(info);
+    common::Error serr = MetricsStore::instance().Append(target->settings, time, info);
+    if (serr && serr->isError()) {
+      LOG_ERROR(serr, false);
+    }
+    core::ServerInfoSnapShoot shot(time, sinfo);
+    {
+      // listeners are removed under the lock, so none of them is gone here
+      QMutexLocker lock(&lock_);
+      auto range = listeners_.equal_range(path);
+      for (auto it = range.first; it != range.second; ++it) {
+        VERIFY(QMetaObject::invokeMethod(it->second, "OnSampled", Qt::QueuedConnection,
+                                         Q_ARG(std::string, path),
+                                         Q_ARG(core::ServerInfoSnapShoot, shot)));
+      }
+    }
+
+    target->failures = 0;
+    target->last_sample_msec = time;
+    common::time64_t missed = (now - target->next_msec) / target->interval_msec;
+    target->next_msec += target->interval_msec * (missed + 1);
+  }
+
+  QMutexLocker lock(&lock_);
+  SamplerTargetInfo* tinfo = &infos_[path];
+  tinfo->path = path;
+  tinfo->interval_msec = target->interval_msec;
+  tinfo->failures = target->failures;
+  tinfo->last_sample_msec = target->last_sample_msec;
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,108 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>     // for map
+#include <random>  // for minstd_rand
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include <QMutex>
+#include <QObject>
+
+#include <common/patterns/singleton_pattern.h>  // for LazySingleton
+#include <common/types.h>                       // for time64_t
+
+#include "core/server/iserver_info.h"  // for ServerInfoSnapShoot
+
+#include "proxy/connection_settings/iconnection_settings.h"  // for IConnectionSettingsBaseSPtr
+
+#define SAMPLER_TICK_MSEC 50
+#define SAMPLER_MAX_BACKOFF_MSEC 60000
+
+class QThread;
+
+namespace fastonosql {
+namespace proxy {
+
+class ISampleSource;
+
+struct SamplerTargetInfo {
+  SamplerTargetInfo();
+
+  std::string path;
+  int interval_msec;
+  size_t failures;
+  common::time64_t last_sample_msec;
+};
+
+// collects INFO of all remote connections with history enabled on one thread,
+// results go to MetricsStore and to the listeners of the sampled target only;
+// a listener has slot OnSampled(std::string path, core::ServerInfoSnapShoot shot)
+class MetricsSampler : public QObject, public common::patterns::LazySingleton<MetricsSampler> {
+  friend class common::patterns::LazySingleton<MetricsSampler>;
+  Q_OBJECT
+ public:
+  typedef std::vector<SamplerTargetInfo> targets_info_t;
+
+  // false if engine can't be sampled
+  bool AddTarget(IConnectionSettingsBaseSPtr settings, QObject* listener);
+  void RemoveTarget(IConnectionSettingsBaseSPtr settings, QObject* listener);
+  targets_info_t Targets() const;
+
+ private Q_SLOTS:
+  void Start();
+  void Stop();
+
+ protected:
+  virtual void timerEvent(QTimerEvent* event) override;
+
+ private:
+  struct Target {
+    Target();
+
+    IConnectionSettingsBaseSPtr settings;
+    ISampleSource* source;
+    size_t refs;
+    int interval_msec;
+    common::time64_t next_msec;
+    size_t failures;
+    common::time64_t last_sample_msec;
+  };
+  typedef std::map<std::string, Target> targets_t;
+
+  MetricsSampler();
+  ~MetricsSampler();
+
+  void ApplyPending(common::time64_t now);
+  void SampleTarget(const std::string& path, Target* target, common::time64_t now);
+
+  QThread* thread_;
+  int timer_id_;
+  std::minstd_rand jitter_;
+  targets_t targets_;  // owned by sampler thread
+
+  mutable QMutex lock_;  // guards members below
+  std::vector<std::pair<IConnectionSettingsBaseSPtr, ISampleSource*>> pending_;  // null to remove
+  std::map<std::string, SamplerTargetInfo> infos_;
+  std::multimap<std::string, QObject*> listeners_;  // by target path
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
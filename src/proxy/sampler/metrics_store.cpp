@@ -0,0 +1,142 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/sampler/metrics_store.h"
+
+#include <limits>  // for numeric_limits
+
+#include <common/file_system.h>  // for create_directory, get_dir_path
+#include <common/value.h>        // for Value, ErrorValue
+
+namespace fastonosql {
+namespace proxy {
+
+MetricsStore::MetricsStore() : lock_(), histories_() {}
+
+MetricsStore::~MetricsStore() {
+  QMutexLocker lock(&lock_);
+  for (auto it = histories_.begin(); it != histories_.end(); ++it) {
+    delete it->second;
+  }
+  histories_.clear();
+}
+
+common::Error MetricsStore::Append(IConnectionSettingsBaseSPtr settings,
+                                   common::time64_t msec,
+                                   core::IServerInfo* info) {
+  if (!settings || !info) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  const std::vector<core::HistoryColumn> columns = core::HistoryColumnsFromType(settings->Type());
+  std::vector<double> values(columns.size(), std::numeric_limits<double>::quiet_NaN());
+  for (size_t i = 0; i < columns.size(); ++i) {
+    common::Value* value = info->ValueByIndexes(columns[i].property, columns[i].field);
+    if (value) {
+      value->getAsDouble(&values[i]);
+      delete value;
+    }
+  }
+
+  QMutexLocker lock(&lock_);
+  core::ServerInfoHistory* history = nullptr;
+  common::Error err = Open(settings, &history);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  return history->Append(msec, values);
+}
+
+common::Error MetricsStore::Read(IConnectionSettingsBaseSPtr settings,
+                                 unsigned char property,
+                                 unsigned char field,
+                                 common::time64_t from_msec,
+                                 common::time64_t to_msec,
+                                 std::vector<core::HistoryPoint>* points) {
+  if (!settings || !points) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  const std::vector<core::HistoryColumn> columns = core::HistoryColumnsFromType(settings->Type());
+  size_t column = 0;
+  while (column < columns.size() &&
+         (columns[column].property != property || columns[column].field != field)) {
+    column++;
+  }
+
+  if (column == columns.size()) {
+    return common::make_error_value("Field isn't stored in history", common::ErrorValue::E_ERROR);
+  }
+
+  QMutexLocker lock(&lock_);
+  core::ServerInfoHistory* history = nullptr;
+  common::Error err = Open(settings, &history);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  return history->Read(column, from_msec, to_msec, points);
+}
+
+common::Error MetricsStore::Clear(IConnectionSettingsBaseSPtr settings) {
+  if (!settings) {
+    return common::make_error_value("Invalid input argument(s)", common::ErrorValue::E_ERROR);
+  }
+
+  QMutexLocker lock(&lock_);
+  core::ServerInfoHistory* history = nullptr;
+  common::Error err = Open(settings, &history);
+  if (err && err->isError()) {
+    return err;
+  }
+
+  return history->Clear();
+}
+
+common::Error MetricsStore::Open(IConnectionSettingsBaseSPtr settings,
+                                 core::ServerInfoHistory** history) {
+  const std::string path = settings->LoggingPath();
+  auto it = histories_.find(path);
+  if (it != histories_.end() && it->second->IsOpened()) {
+    *history = it->second;
+    return common::Error();
+  }
+
+  if (it == histories_.end()) {
+    std::string dir = common::file_system::get_dir_path(path);
+    common::Error err = common::file_system::create_directory(dir, true);
+    if (common::file_system::is_directory(dir) != common::SUCCESS) {
+      return err;
+    }
+
+    size_t columns = core::HistoryColumnsFromType(settings->Type()).size();
+    it = histories_.insert(std::make_pair(path, new core::ServerInfoHistory(path, columns))).first;
+  }
+
+  common::Error err = it->second->Open();
+  if (err && err->isError()) {
+    return err;
+  }
+
+  *history = it->second;
+  return common::Error();
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,69 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>     // for map
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include <QMutex>
+
+#include <common/error.h>                       // for Error
+#include <common/macros.h>                      // for WARN_UNUSED_RESULT
+#include <common/patterns/singleton_pattern.h>  // for LazySingleton
+#include <common/types.h>                       // for time64_t
+
+#include "core/server/iserver_info.h"         // for IServerInfo
+#include "core/server/server_info_history.h"  // for HistoryPoint, ServerInfoHistory
+
+#include "proxy/connection_settings/iconnection_settings.h"  // for IConnectionSettingsBaseSPtr
+
+namespace fastonosql {
+namespace proxy {
+
+// INFO history of all connections, shared by drivers, MetricsSampler and
+// readers on other threads; one ServerInfoHistory per LoggingPath
+class MetricsStore : public common::patterns::LazySingleton<MetricsStore> {
+  friend class common::patterns::LazySingleton<MetricsStore>;
+
+ public:
+  common::Error Append(IConnectionSettingsBaseSPtr settings,
+                       common::time64_t msec,
+                       core::IServerInfo* info) WARN_UNUSED_RESULT;
+  common::Error Read(IConnectionSettingsBaseSPtr settings,
+                     unsigned char property,
+                     unsigned char field,
+                     common::time64_t from_msec,
+                     common::time64_t to_msec,
+                     std::vector<core::HistoryPoint>* points) WARN_UNUSED_RESULT;
+  common::Error Clear(IConnectionSettingsBaseSPtr settings) WARN_UNUSED_RESULT;
+
+ private:
+  MetricsStore();
+  ~MetricsStore();
+
+  common::Error Open(IConnectionSettingsBaseSPtr settings,
+                     core::ServerInfoHistory** history) WARN_UNUSED_RESULT;  // under lock_
+
+  QMutex lock_;
+  std::map<std::string, core::ServerInfoHistory*> histories_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -37,21 +37,17 @@ namespace fastonosql {
 namespace proxy {
 
 IServer::IServer(IDriver* drv)
-    : drv_(drv), server_info_(), current_database_info_(), timer_check_key_exists_id_(0) {
-  VERIFY(QObject::connect(drv_, &IDriver::ChildAdded, this, &IServer::ChildAdded));
-  VERIFY(QObject::connect(drv_, &IDriver::ItemUpdated, this, &IServer::ItemUpdated));
+    : drv_(drv),
+      server_info_(),
+      current_database_info_(),
+      timer_check_key_exists_id_(0),
+      changed_db_(),
+      added_keys_(),
+      removed_keys_() {
+  VERIFY(QObject::connect(drv_, &IDriver::EventsBatched, this, &IServer::HandleDriverEvents));
   VERIFY(
       QObject::connect(drv_, &IDriver::ServerInfoSnapShoot, this, &IServer::ServerInfoSnapShoot));
-
-  VERIFY(QObject::connect(drv_, &IDriver::FlushedDB, this, &IServer::FlushDB));
-  VERIFY(QObject::connect(drv_, &IDriver::CurrentDataBaseChanged, this,
-                          &IServer::CurrentDataBaseChange));
-  VERIFY(QObject::connect(drv_, &IDriver::KeyRemoved, this, &IServer::KeyRemove));
-  VERIFY(QObject::connect(drv_, &IDriver::KeyAdded, this, &IServer::KeyAdd));
-  VERIFY(QObject::connect(drv_, &IDriver::KeyLoaded, this, &IServer::KeyLoad));
-  VERIFY(QObject::connect(drv_, &IDriver::KeyRenamed, this, &IServer::KeyRename));
-  VERIFY(QObject::connect(drv_, &IDriver::KeyTTLChanged, this, &IServer::KeyTTLChange));
-  VERIFY(QObject::connect(drv_, &IDriver::KeyTTLLoaded, this, &IServer::KeyTTLLoad));
+  VERIFY(QObject::connect(drv_, &IDriver::JobProgress, this, &IServer::JobProgress));
   VERIFY(QObject::connect(drv_, &IDriver::Disconnected, this, &IServer::Disconnected));
 
   drv_->Start();
@@ -509,6 +505,50 @@ void IServer::HandleLoadDatabaseContentEvent(events::LoadDatabaseContentResponce
   emit LoadDatabaseContentFinished(v);
 }
 
+void IServer::HandleDriverEvents(driver_events_batch_t batch) {
+  for (const DriverEvent& ev : *batch) {
+    bool key_rows = ev.type == DriverEvent::KEY_REMOVED || ev.type == DriverEvent::KEY_ADDED ||
+                    ev.type == DriverEvent::KEY_LOADED || ev.type == DriverEvent::KEY_TTL_LOADED;
+    if (!key_rows) {
+      FlushKeyChanges();  // views see rows in the order the driver changed them
+    }
+
+    switch (ev.type) {
+      case DriverEvent::CHILD_ADDED:
+        emit ChildAdded(ev.object);
+        break;
+      case DriverEvent::ITEM_UPDATED:
+        emit ItemUpdated(ev.object.get(), ev.value);
+        break;
+      case DriverEvent::FLUSHED_DB:
+        FlushDB();
+        break;
+      case DriverEvent::DATABASE_CHANGED:
+        CurrentDataBaseChange(ev.db);
+        break;
+      case DriverEvent::KEY_REMOVED:
+        KeyRemove(ev.key.Key());
+        break;
+      case DriverEvent::KEY_ADDED:
+        KeyAdd(ev.key);
+        break;
+      case DriverEvent::KEY_LOADED:
+        KeyLoad(ev.key);
+        break;
+      case DriverEvent::KEY_RENAMED:
+        KeyRename(ev.key.Key(), ev.new_name);
+        break;
+      case DriverEvent::KEY_TTL_CHANGED:
+        KeyTTLChange(ev.key.Key(), ev.ttl);
+        break;
+      case DriverEvent::KEY_TTL_LOADED:
+        KeyTTLLoad(ev.key.Key(), ev.ttl);
+        break;
+    }
+  }
+  FlushKeyChanges();
+}
+
 void IServer::FlushDB() {
   database_t cdb = CurrentDatabaseInfo();
   if (!cdb) {
@@ -557,7 +597,7 @@ void IServer::KeyRemove(core::NKey key) {
   }
 
   if (cdb->RemoveKey(key)) {
-    emit KeyRemoved(cdb, key);
+    QueueKeyRemoved(cdb, key);
   }
 }
 
@@ -568,8 +608,9 @@ void IServer::KeyAdd(core::NDbKValue key) {
   }
 
   if (cdb->InsertKey(key)) {
-    emit KeyAdded(cdb, key);
+    QueueKeyAdded(cdb, key);
   } else {
+    FlushKeyChanges();
     emit KeyLoaded(cdb, key);
   }
 }
@@ -581,8 +622,9 @@ void IServer::KeyLoad(core::NDbKValue key) {
   }
 
   if (cdb->InsertKey(key)) {
-    emit KeyAdded(cdb, key);
+    QueueKeyAdded(cdb, key);
   } else {
+    FlushKeyChanges();
     emit KeyLoaded(cdb, key);
   }
 }
@@ -617,16 +659,50 @@ void IServer::KeyTTLLoad(core::NKey key, core::ttl_t ttl) {
 
   if (ttl == EXPIRED_TTL) {
     if (cdb->RemoveKey(key)) {
-      emit KeyRemoved(cdb, key);
+      QueueKeyRemoved(cdb, key);
     }
     return;
   }
 
   if (cdb->UpdateKeyTTL(key, ttl)) {
+    FlushKeyChanges();
     emit KeyTTLChanged(cdb, key, ttl);
   }
 }
 
+void IServer::QueueKeyAdded(core::IDataBaseInfoSPtr db, const core::NDbKValue& key) {
+  if (!removed_keys_.empty() || changed_db_ != db) {
+    FlushKeyChanges();
+  }
+
+  changed_db_ = db;
+  added_keys_.push_back(key);
+}
+
+void IServer::QueueKeyRemoved(core::IDataBaseInfoSPtr db, const core::NKey& key) {
+  if (!added_keys_.empty() || changed_db_ != db) {
+    FlushKeyChanges();
+  }
+
+  changed_db_ = db;
+  removed_keys_.push_back(key);
+}
+
+void IServer::FlushKeyChanges() {
+  if (!added_keys_.empty()) {
+    core::NDbKValues keys;
+    keys.swap(added_keys_);
+    emit KeysAdded(changed_db_, keys);
+  }
+
+  if (!removed_keys_.empty()) {
+    core::NKeys keys;
+    keys.swap(removed_keys_);
+    emit KeysRemoved(changed_db_, keys);
+  }
+  changed_db_.reset();
+}
+
 void IServer::HandleCheckDBKeys(core::IDataBaseInfoSPtr db, core::ttl_t expired_time) {
   if (!db) {
     return;
@@ -639,7 +715,7 @@ void IServer::HandleCheckDBKeys(core::IDataBaseInfoSPtr db, core::ttl_t expired_
     if (key_ttl == NO_TTL) {
     } else if (key_ttl == EXPIRED_TTL) {
       if (db->RemoveKey(nkey)) {
-        emit KeyRemoved(db, nkey);
+        QueueKeyRemoved(db, nkey);
       }
     } else {  // live
       const core::ttl_t new_ttl = key_ttl - expired_time;
@@ -648,18 +724,20 @@ void IServer::HandleCheckDBKeys(core::IDataBaseInfoSPtr db, core::ttl_t expired_
         std::string load_ttl_cmd;
         common::Error err = trans->LoadKeyTTLCommand(nkey, &load_ttl_cmd);
         if (err && err->isError()) {
-          return;
+          break;
         }
         proxy::events_info::ExecuteInfoRequest req(this, load_ttl_cmd, 0, 0, true, true,
                                                    core::C_INNER);
         Execute(req);
       } else {
         if (db->UpdateKeyTTL(nkey, new_ttl)) {
+          FlushKeyChanges();
           emit KeyTTLChanged(db, nkey, new_ttl);
         }
       }
     }
   }
+  FlushKeyChanges();
 }
 
 void IServer::HandleEnterModeEvent(events::EnterModeEvent* ev) {
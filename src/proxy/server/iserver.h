@@ -30,6 +30,7 @@
 #include "core/icommand_translator.h"  // for translator_t
 
 #include "core/database/idatabase_info.h"  // for IDataBaseInfoSPtr
+#include "proxy/driver/driver_events.h"    // for driver_events_batch_t
 #include "proxy/events/events.h"           // for BackupResponceEvent, etc
 #include "proxy/server/iserver_base.h"     // for IServerBase
 #include "core/server/iserver_info.h"      // for IServerInfoSPtr, etc
@@ -138,11 +139,13 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
 
   void FlushedDB(core::IDataBaseInfoSPtr db);
   void CurrentDataBaseChanged(core::IDataBaseInfoSPtr db);
-  void KeyRemoved(core::IDataBaseInfoSPtr db, core::NKey key);
-  void KeyAdded(core::IDataBaseInfoSPtr db, core::NDbKValue key);
+  // rows of one driver events batch, at most one signal of each per database and batch
+  void KeysRemoved(core::IDataBaseInfoSPtr db, core::NKeys keys);
+  void KeysAdded(core::IDataBaseInfoSPtr db, core::NDbKValues keys);
   void KeyLoaded(core::IDataBaseInfoSPtr db, core::NDbKValue key);
   void KeyRenamed(core::IDataBaseInfoSPtr db, core::NKey key, std::string new_name);
   void KeyTTLChanged(core::IDataBaseInfoSPtr db, core::NKey key, core::ttl_t ttl);
+  void JobProgress(std::string job, int percent);  // background job, 100 when finished
   void Disconnected();
 
  public:
@@ -228,6 +231,9 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
   databases_t databases_;
 
  private Q_SLOTS:
+  void HandleDriverEvents(driver_events_batch_t batch);
+
+ private:
   void FlushDB();
   void CurrentDataBaseChange(core::IDataBaseInfoSPtr db);
 
@@ -238,6 +244,12 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
   void KeyTTLChange(core::NKey key, core::ttl_t ttl);
   void KeyTTLLoad(core::NKey key, core::ttl_t ttl);
 
+  // added/removed keys are collected while a batch is handled, a run of one kind
+  // ends with one KeysAdded or KeysRemoved before any other key signal
+  void QueueKeyAdded(core::IDataBaseInfoSPtr db, const core::NDbKValue& key);
+  void QueueKeyRemoved(core::IDataBaseInfoSPtr db, const core::NKey& key);
+  void FlushKeyChanges();
+
  private:
   void HandleCheckDBKeys(core::IDataBaseInfoSPtr db, core::ttl_t expired_time);
 
@@ -253,6 +265,10 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
   core::IServerInfoSPtr server_info_;
   database_t current_database_info_;
   int timer_check_key_exists_id_;
+
+  database_t changed_db_;
+  core::NDbKValues added_keys_;
+  core::NKeys removed_keys_;
 };
 
 }  // namespace proxy
@@ -45,13 +45,17 @@
 
 #ifdef FASTO
 #ifdef OS_WIN
+#include <winsock2.h>
 #define F_EINTR 0
+#define redisPoll WSAPoll
 #else
 #include <sys/socket.h>
+#include <poll.h>
 #include <netinet/in.h>
 #include <netdb.h>
 #include <arpa/inet.h>
 #define F_EINTR EINTR
+#define redisPoll poll
 #endif
 #endif
 
@@ -624,6 +628,9 @@ static redisContext *redisContextInit(void) {
 #ifdef FASTO
     c->session = NULL;
     c->channel = NULL;
+    c->ssh_window_size = 0;
+    c->ssh_packet_size = 0;
+    c->ssh_read_size = REDIS_SSH_READ_MIN;
 #endif
 
     return c;
@@ -635,11 +642,11 @@ void redisFree(redisContext *c) {
 
 #ifdef FASTO
     if(c->channel != NULL){
-        libssh2_channel_free(c->channel);
+        redisSshChannelClose(c->session, c->channel);
     }
     if(c->session != NULL){
-        libssh2_session_disconnect(c->session, "Client disconnecting normally");
-        libssh2_session_free(c->session);
+        /* The session outlives the context while other channels use it. */
+        redisSshSessionRelease(c->session);
     }
     if (c->fd > 0) {
 #ifdef OS_WIN
@@ -691,6 +698,12 @@ int redisReconnect(redisContext *c) {
     c->err = 0;
     memset(c->errstr, '\0', strlen(c->errstr));
 
+#ifdef FASTO
+    if (c->channel != NULL) {
+        redisSshChannelClose(c->session, c->channel);
+        c->channel = NULL;
+    }
+#endif
     if (c->fd > 0) {
 #ifdef FASTO
 #ifdef OS_WIN
@@ -727,116 +740,29 @@ int redisReconnect(redisContext *c) {
  * context will be set to the return value of the error function.
  * When no set of reply functions is given, the default set will be used. */
 #ifdef FASTO
-static void kbd_callback(const char *name, int name_len,
-const char *instruction, int instruction_len,
-int num_prompts,
-const LIBSSH2_USERAUTH_KBDINT_PROMPT *prompts,
-LIBSSH2_USERAUTH_KBDINT_RESPONSE *responses,
-void **abstract)
-{
-}
-
 redisContext *redisConnect(const char *ip, int port, const char *ssh_address, int ssh_port, const char *username, const char *password,
-                           const char *public_key, const char *private_key, const char *passphrase, int curMethod) {
+                           const char *public_key, const char *private_key, const char *passphrase, int curMethod,
+                           unsigned int window_size, unsigned int packet_size) {
 
   redisContext *c = redisContextInit();
   if (c == NULL) {
     return NULL;
   }
 
-  LIBSSH2_SESSION *session = NULL;
+  redisSshSession *session = NULL;
   if(ssh_address && curMethod != SSH_UNKNOWN){
-    if (curMethod == SSH_PUBLICKEY && !private_key) {
-      __redisSetError(c, REDIS_ERR_OTHER, "Invalid input argument(private key)");
-      return c;
-    } else if (curMethod == SSH_PASSWORD && !password) {
-      __redisSetError(c, REDIS_ERR_OTHER, "Invalid input argument(password)");
-      return c;
-    }
-
-    int rc = libssh2_init(0);
-    if (rc != 0) {
-      __redisSetError(c, REDIS_ERR_OTHER, "Failed to init libssh library.");
-      return c;
-    }
-
-    struct hostent* host = gethostbyname(ssh_address);
-    if(!host){
-      __redisSetError(c, REDIS_ERR_OTHER, "Failed to resolve ssh address.");
-      return c;
-    }
-
-    struct sockaddr_in sin;
-    /* Connect to SSH server */
-    int sock = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
-    sin.sin_family = AF_INET;
-    sin.sin_addr = *(struct in_addr *)host->h_addr;
-    sin.sin_port = htons(ssh_port);
-    if (connect(sock, (struct sockaddr*)(&sin),
-                sizeof(struct sockaddr_in)) != 0) {
-      __redisSetError(c, REDIS_ERR_OTHER, "Failed to connect (ssh_address).");
-      return c;
-    }
-
-    /* Create a session instance */
-    session = libssh2_session_init();
-    if(!session) {
-      __redisSetError(c, REDIS_ERR_OTHER, "Failed to create ssh session.");
-      return c;
-    }
-
-    /* ... start it up. This will trade welcome banners, exchange keys,
-     * and setup crypto, compression, and MAC layers
-     */
-    rc = libssh2_session_handshake(session, sock);
-    if(rc) {
-      libssh2_session_free(session);
-      __redisSetError(c, REDIS_ERR_OTHER, "SSH handshake failed.");
-      return c;
-    }
-
-    int auth_pw = 0;
-    libssh2_hostkey_hash(session, LIBSSH2_HOSTKEY_HASH_SHA1);
-    char *userauthlist = libssh2_userauth_list(session, username, strlen(username));
-    if (strstr(userauthlist, "password") != NULL) {
-      auth_pw |= 1;
-    }
-    if (strstr(userauthlist, "keyboard-interactive") != NULL) {
-      auth_pw |= 2;
-    }
-    if (strstr(userauthlist, "publickey") != NULL) {
-      auth_pw |= 4;
-    }
-
-    if (auth_pw & 1 && curMethod == SSH_PASSWORD) {
-      /* We could authenticate via password */
-      if (libssh2_userauth_password(session, username, password)) {
-        libssh2_session_free(session);
-        __redisSetError(c, REDIS_ERR_OTHER, "Authentication by password failed!");
-        return c;
-      }
-    } else if (auth_pw & 2) {
-      /* Or via keyboard-interactive */
-      if (libssh2_userauth_keyboard_interactive(session, username, &kbd_callback) ) {
-        libssh2_session_free(session);
-        __redisSetError(c, REDIS_ERR_OTHER, "Authentication by keyboard-interactive failed!");
-        return c;
-      }
-    } else if (auth_pw & 4 && curMethod == SSH_PUBLICKEY) {
-      /* Or by public key */
-      if (libssh2_userauth_publickey_fromfile(session, username, public_key, private_key, passphrase)){
-        libssh2_session_free(session);
-        __redisSetError(c, REDIS_ERR_OTHER, "Authentication by public key failed!");
-        return c;
-      }
-    } else {
-      __redisSetError(c, REDIS_ERR_OTHER, "No supported authentication methods found!");
-      libssh2_session_free(session);
+    char errstr[sizeof(c->errstr)];
+    session = redisSshSessionAcquire(ssh_address, ssh_port, username, password, public_key,
+                                     private_key, passphrase, curMethod, errstr, sizeof(errstr));
+    if (!session) {
+      __redisSetError(c, REDIS_ERR_OTHER, errstr);
       return c;
     }
   }
 
   c->session = session;
+  c->ssh_window_size = window_size;
+  c->ssh_packet_size = packet_size;
   c->flags |= REDIS_BLOCK;
   redisContextConnectTcp(c,ip,port,NULL);
   return c;
@@ -958,6 +884,64 @@ int redisEnableKeepAlive(redisContext *c) {
     return REDIS_OK;
 }
 
+#ifdef FASTO
+/* Reads a tunnelled channel straight into the reader buffer, skipping the
+ * stack copy. The read size doubles while reads fill it and halves when they
+ * come back mostly empty, so bulk replies (SYNC, big LRANGE/HGETALL) move in
+ * large chunks and interactive traffic keeps a small buffer. */
+static int redisSshBufferRead(redisContext *c, int timeout_msec, int *timedout) {
+    redisReader *r = c->reader;
+    size_t want = c->ssh_read_size;
+    ssize_t nread;
+    sds newbuf;
+
+    if (r->err) {
+        __redisSetError(c,r->err,r->errstr);
+        return REDIS_ERR;
+    }
+
+    /* Same shrinking as redisReaderFeed, but don't drop a buffer the next
+     * read would grow back to anyway. */
+    if (r->len == 0 && r->maxbuf != 0 && sdsavail(r->buf) > r->maxbuf &&
+        sdsavail(r->buf) > want) {
+        sdsfree(r->buf);
+        r->buf = sdsempty();
+        r->pos = 0;
+        assert(r->buf != NULL);
+    }
+
+    newbuf = sdsMakeRoomFor(r->buf, want);
+    if (newbuf == NULL) {
+        __redisSetError(c,REDIS_ERR_OOM,"Out of memory");
+        return REDIS_ERR;
+    }
+    r->buf = newbuf;
+
+    nread = redisSshChannelReadTimeout(c->session, c->channel, r->buf + sdslen(r->buf), want,
+                                       timeout_msec);
+    if (nread == -1 && errno == EAGAIN && timeout_msec >= 0) {
+        *timedout = 1;
+        return REDIS_OK;
+    } else if (nread == -1) {
+        __redisSetError(c,REDIS_ERR_IO,NULL);
+        return REDIS_ERR;
+    } else if (nread == 0) {
+        __redisSetError(c,REDIS_ERR_EOF,"Server closed the connection");
+        return REDIS_ERR;
+    }
+
+    sdsIncrLen(r->buf, (int)nread);
+    r->len = sdslen(r->buf);
+
+    if ((size_t)nread == want && want < REDIS_SSH_READ_MAX) {
+        c->ssh_read_size = want * 2;
+    } else if ((size_t)nread < want / 4 && want > REDIS_SSH_READ_MIN) {
+        c->ssh_read_size = want / 2;
+    }
+    return REDIS_OK;
+}
+#endif
+
 /* Use this function to handle a read event on the descriptor. It will try
  * and read some bytes from the socket and feed them to the reply parser.
  *
@@ -974,17 +958,17 @@ int redisBufferRead(redisContext *c) {
 #ifdef FASTO
 
     if(c->channel){
-        nread = libssh2_channel_read(c->channel, buf, sizeof(buf));
-    }
-    else{
-        #ifdef OS_WIN
-            errno = 0;
-            nread = recv(c->fd,buf,sizeof(buf),0);
-        #else
-            nread = read(c->fd,buf,sizeof(buf));
-        #endif
+        int timedout = 0;
+        return redisSshBufferRead(c, -1, &timedout);
     }
 
+    #ifdef OS_WIN
+        errno = 0;
+        nread = recv(c->fd,buf,sizeof(buf),0);
+    #else
+        nread = read(c->fd,buf,sizeof(buf));
+    #endif
+
     if (nread == -1) {
         if ((errno == EAGAIN && !(c->flags & REDIS_BLOCK)) || (errno == F_EINTR)) {
             /* Try again later */
@@ -1042,7 +1026,7 @@ int redisBufferWrite(redisContext *c, int *done) {
     if (sdslen(c->obuf) > 0) {
 #ifdef FASTO
     if(c->channel){
-        nwritten = libssh2_channel_write(c->channel, c->obuf, sdslen(c->obuf));
+        nwritten = redisSshChannelWrite(c->session, c->channel, c->obuf, sdslen(c->obuf));
     }
     else{
 #ifdef OS_WIN
@@ -1100,7 +1084,7 @@ int redisReadToBuffer(redisContext *c, char* buf, int size, ssize_t *nread)
     }
 
     if(c->channel){
-        *nread = libssh2_channel_read(c->channel, buf, size);
+        *nread = redisSshChannelRead(c->session, c->channel, buf, size);
     }
     else{
         #ifdef OS_WIN
@@ -1133,7 +1117,7 @@ int redisWriteFromBuffer(redisContext *c, const char *buf, ssize_t *nwritten)
 
     if (len > 0) {
         if(c->channel){
-            *nwritten = libssh2_channel_write(c->channel, buf, len);
+            *nwritten = redisSshChannelWrite(c->session, c->channel, buf, len);
         }
         else{
     #ifdef OS_WIN
@@ -1192,6 +1176,71 @@ int redisGetReply(redisContext *c, void **reply) {
     return REDIS_OK;
 }
 
+#ifdef FASTO
+/* Returns 1 when the socket of a plain context has data (or an error the
+ * following read reports), 0 when nothing arrived for timeout_msec and
+ * REDIS_ERR with the context error set when poll itself fails. poll has no
+ * FD_SETSIZE limit on the descriptor number unlike select. */
+static int redisWaitReadable(redisContext *c, int timeout_msec) {
+    struct pollfd pfd;
+    int res;
+
+    pfd.fd = c->fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    do {
+        res = redisPoll(&pfd, 1, timeout_msec);
+    } while (res == -1 && F_EINTR != 0 && errno == F_EINTR);
+
+    if (res < 0) {
+        __redisSetError(c,REDIS_ERR_IO,NULL);
+        return REDIS_ERR;
+    }
+    return res > 0;
+}
+
+int redisGetReplyTimeout(redisContext *c, void **reply, int timeout_msec) {
+    int wdone = 0;
+    void *aux = NULL;
+
+    /* Try to read pending replies */
+    if (redisGetReplyFromReader(c,&aux) == REDIS_ERR)
+        return REDIS_ERR;
+
+    if (aux == NULL && c->flags & REDIS_BLOCK) {
+        /* Write until done */
+        do {
+            if (redisBufferWrite(c,&wdone) == REDIS_ERR)
+                return REDIS_ERR;
+        } while (!wdone);
+
+        /* Read until there is a reply or the connection is quiet */
+        do {
+            if (c->channel) {
+                int timedout = 0;
+                if (redisSshBufferRead(c, timeout_msec, &timedout) == REDIS_ERR)
+                    return REDIS_ERR;
+                if (timedout)
+                    break;
+            } else {
+                int readable = redisWaitReadable(c, timeout_msec);
+                if (readable == REDIS_ERR)
+                    return REDIS_ERR;
+                if (!readable)
+                    break;
+                if (redisBufferRead(c) == REDIS_ERR)
+                    return REDIS_ERR;
+            }
+            if (redisGetReplyFromReader(c,&aux) == REDIS_ERR)
+                return REDIS_ERR;
+        } while (aux == NULL);
+    }
+
+    /* Set reply object */
+    if (reply != NULL) *reply = aux;
+    return REDIS_OK;
+}
+#endif
 
 /* Helper function for the redisAppendCommand* family of functions.
  *
@@ -40,7 +40,7 @@
 #include "sds.h" /* for sds */
 
 #ifdef FASTO
-#include <libssh2.h>
+#include "ssh_session.h"
 #endif
 
 #define HIREDIS_MAJOR 0
@@ -108,12 +108,6 @@
     } while (0)
 #endif
 
-#ifdef FASTO
-#define SSH_UNKNOWN 0
-#define SSH_PASSWORD 1
-#define SSH_PUBLICKEY 2
-#endif
-
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -168,14 +162,18 @@ typedef struct redisContext {
         char *path;
     } unix_sock;
 #ifdef FASTO
-    LIBSSH2_SESSION *session;
+    redisSshSession *session; /* shared, see ssh_session.h */
     LIBSSH2_CHANNEL *channel;
+    unsigned int ssh_window_size; /* channel receive window, 0 - libssh2 default */
+    unsigned int ssh_packet_size; /* channel max packet, 0 - libssh2 default */
+    size_t ssh_read_size; /* adaptive size of the next channel read */
 #endif
 } redisContext;
 
 #ifdef FASTO
 redisContext *redisConnect(const char *ip, int port, const char *ssh_address, int ssh_port, const char *username, const char *password,
-                           const char *public_key, const char *private_key, const char *passphrase, int curMethod);
+                           const char *public_key, const char *private_key, const char *passphrase, int curMethod,
+                           unsigned int window_size, unsigned int packet_size);
 #else
 redisContext *redisConnect(const char *ip, int port);
 #endif
@@ -217,6 +215,13 @@ int redisWriteFromBuffer(redisContext *c, const char *buf, ssize_t *nwritten);
  * context, it will return unconsumed replies until there are no more. */
 int redisGetReply(redisContext *c, void **reply);
 int redisGetReplyFromReader(redisContext *c, void **reply);
+#ifdef FASTO
+/* Same as redisGetReply in a blocking context, but returns REDIS_OK with
+ * *reply set to NULL when no data arrived for timeout_msec, so that callers
+ * waiting for pushed messages (MONITOR, SUBSCRIBE) can do periodic work on a
+ * quiet connection. A partially read reply stays in the reader. */
+int redisGetReplyTimeout(redisContext *c, void **reply, int timeout_msec);
+#endif
 
 /* Write a formatted command to the output buffer. Use these functions in blocking mode
  * to get a pipeline of commands. */
@@ -428,7 +428,8 @@ static int _redisContextConnectTcp(redisContext *c, const char *addr, int port,
                                    const char *source_addr) {
 #ifdef FASTO
     if(c->session){
-        if (!(c->channel = libssh2_channel_direct_tcpip(c->session, addr, port))) {
+        if (!(c->channel = redisSshChannelOpen(c->session, addr, port, c->ssh_window_size,
+                                                   c->ssh_packet_size))) {
             __redisSetError(c, REDIS_ERR_OTHER, "Unable to open a ssh session");
             return REDIS_ERR;
         }
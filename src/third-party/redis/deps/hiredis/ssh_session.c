@@ -0,0 +1,741 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "fmacros.h"
+#include "ssh_session.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef OS_WIN
+#include <winsock2.h>
+#include <windows.h>
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include "sds.h"
+
+/* Only one channel of a session waits on the socket, the others wait until
+ * it is done or until a read got packets from the socket that libssh2 may
+ * have queued for them. The socket wait is still bounded: another channel
+ * can read the packets of the waiting one before select sees them, that
+ * is short when the session is shared. */
+#define SSH_WAIT_SHARED_MSEC 50
+#define SSH_WAIT_EXCLUSIVE_MSEC 1000
+
+#ifdef OS_WIN
+typedef CRITICAL_SECTION sshMutex;
+typedef CONDITION_VARIABLE sshCond;
+#define sshMutexInit(m) InitializeCriticalSection(m)
+#define sshMutexDestroy(m) DeleteCriticalSection(m)
+#define sshMutexLock(m) EnterCriticalSection(m)
+#define sshMutexUnlock(m) LeaveCriticalSection(m)
+#define sshCondInit(c) InitializeConditionVariable(c)
+#define sshCondDestroy(c) (void)(c)
+#define sshCondBroadcast(c) WakeAllConditionVariable(c)
+#define sshCloseSocket(s) closesocket(s)
+#else
+typedef pthread_mutex_t sshMutex;
+typedef pthread_cond_t sshCond;
+#define sshMutexInit(m) pthread_mutex_init(m, NULL)
+#define sshMutexDestroy(m) pthread_mutex_destroy(m)
+#define sshMutexLock(m) pthread_mutex_lock(m)
+#define sshMutexUnlock(m) pthread_mutex_unlock(m)
+#define sshCondInit(c) pthread_cond_init(c, NULL)
+#define sshCondDestroy(c) pthread_cond_destroy(c)
+#define sshCondBroadcast(c) pthread_cond_broadcast(c)
+#define sshCloseSocket(s) close(s)
+#endif
+
+struct redisSshSession {
+    sds key;
+    libssh2_socket_t sock;
+    LIBSSH2_SESSION *session;
+    sshMutex lock; /* guards every libssh2 call on session and the fields below */
+    sshCond io; /* broadcast when packets were read or the socket wait is done */
+    unsigned long rx_seq; /* bumped on every read that got bytes from the socket */
+    int polling; /* a channel waits on the socket */
+    int wait_dir; /* directions the channels waiting on io are blocked on */
+    int channels; /* open channels, more than one means shared */
+    int broken; /* transport failed, never hand out again */
+    int refs; /* open contexts, guarded by the registry lock */
+    int connecting; /* handshake runs outside of the registry lock, guarded by it */
+    time_t idle_since;
+    struct redisSshSession *next;
+};
+
+static redisSshSession *sessions = NULL;
+static int libssh2_inited = 0;
+
+#ifdef OS_WIN
+static sshMutex registry_lock;
+static sshCond registry_cond; /* a connecting session is ready or gone */
+static INIT_ONCE registry_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK initRegistryLock(PINIT_ONCE once, PVOID param, PVOID *ctx) {
+    (void)once; (void)param; (void)ctx;
+    sshMutexInit(&registry_lock);
+    sshCondInit(&registry_cond);
+    return TRUE;
+}
+
+static void lockRegistry(void) {
+    InitOnceExecuteOnce(&registry_once, initRegistryLock, NULL, NULL);
+    sshMutexLock(&registry_lock);
+}
+#else
+static sshMutex registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static sshCond registry_cond = PTHREAD_COND_INITIALIZER; /* a connecting session is ready or gone */
+
+static void lockRegistry(void) {
+    sshMutexLock(&registry_lock);
+}
+#endif
+
+static void unlockRegistry(void) {
+    sshMutexUnlock(&registry_lock);
+}
+
+/* Waits for c with m locked, at most msec when it isn't negative. */
+static void sshCondWait(sshCond *c, sshMutex *m, int msec) {
+#ifdef OS_WIN
+    SleepConditionVariableCS(c, m, msec < 0 ? INFINITE : (DWORD)msec);
+#else
+    struct timespec ts;
+    if (msec < 0) {
+        pthread_cond_wait(c, m);
+        return;
+    }
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += msec / 1000;
+    ts.tv_nsec += (long)(msec % 1000) * 1000000;
+    if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+    pthread_cond_timedwait(c, m, &ts);
+#endif
+}
+
+static void setError(char *errstr, size_t errlen, const char *msg) {
+    if (errstr && errlen) {
+        snprintf(errstr, errlen, "%s", msg);
+    }
+}
+
+static sds appendKeyPart(sds key, const char *part) {
+    size_t len = part ? strlen(part) : 0;
+    /* Length prefixed so that no credential can alias another field. */
+    key = sdscatprintf(key, "%d:", part ? (int)len : -1);
+    return sdscatlen(key, part ? part : "", len);
+}
+
+static sds makeKey(const char *ssh_address, int ssh_port, const char *username,
+                   const char *password, const char *public_key, const char *private_key,
+                   const char *passphrase, int curMethod) {
+    sds key = sdscatprintf(sdsempty(), "%d|%d|", ssh_port, curMethod);
+    key = appendKeyPart(key, ssh_address);
+    key = appendKeyPart(key, username);
+    if (curMethod == SSH_PUBLICKEY) {
+        key = appendKeyPart(key, public_key);
+        key = appendKeyPart(key, private_key);
+        key = appendKeyPart(key, passphrase);
+    } else {
+        key = appendKeyPart(key, password);
+    }
+    return key;
+}
+
+static void kbdCallback(const char *name, int name_len, const char *instruction,
+                        int instruction_len, int num_prompts,
+                        const LIBSSH2_USERAUTH_KBDINT_PROMPT *prompts,
+                        LIBSSH2_USERAUTH_KBDINT_RESPONSE *responses, void **abstract) {
+    (void)name; (void)name_len; (void)instruction; (void)instruction_len;
+    (void)num_prompts; (void)prompts; (void)responses; (void)abstract;
+}
+
+/* libssh2 reads the socket only through here, a read that got bytes may have
+ * queued packets for any channel of the session. Errors are returned as
+ * -errno like the libssh2 default does. */
+static LIBSSH2_RECV_FUNC(countingRecv) {
+    redisSshSession *s = (redisSshSession *)*abstract;
+#ifdef OS_WIN
+    ssize_t rc = recv(socket, (char *)buffer, (int)length, flags);
+    if (rc < 0) {
+        return WSAGetLastError() == WSAEWOULDBLOCK ? -EAGAIN : -EIO;
+    }
+#else
+    ssize_t rc = recv(socket, buffer, length, flags);
+    if (rc < 0) {
+        return errno == EWOULDBLOCK ? -EAGAIN : -errno;
+    }
+#endif
+    if (rc > 0) {
+        s->rx_seq++;
+    }
+    return rc;
+}
+
+static redisSshSession *newSession(sds key) {
+    redisSshSession *s = calloc(1, sizeof(*s));
+    if (!s) {
+        return NULL;
+    }
+
+    sshMutexInit(&s->lock);
+    sshCondInit(&s->io);
+    s->sock = LIBSSH2_INVALID_SOCKET;
+    s->key = key;
+    return s;
+}
+
+static void freeSession(redisSshSession *s) {
+    if (s->session) {
+        libssh2_session_set_blocking(s->session, 1);
+        libssh2_session_disconnect(s->session, "Client disconnecting normally");
+        libssh2_session_free(s->session);
+    }
+    if (s->sock != LIBSSH2_INVALID_SOCKET) {
+        sshCloseSocket(s->sock);
+    }
+    sshCondDestroy(&s->io);
+    sshMutexDestroy(&s->lock);
+    sdsfree(s->key);
+    free(s);
+}
+
+/* Closing a session talks to the server, so it is done without the
+ * registry lock on a list unlinked under it. */
+static void freeSessions(redisSshSession *s) {
+    while (s) {
+        redisSshSession *next = s->next;
+        freeSession(s);
+        s = next;
+    }
+}
+
+static int isBroken(redisSshSession *s) {
+    int broken;
+    sshMutexLock(&s->lock);
+    broken = s->broken;
+    sshMutexUnlock(&s->lock);
+    return broken;
+}
+
+/* Called with the registry lock held, returns the unlinked sessions. */
+static redisSshSession *sweepLocked(time_t now) {
+    redisSshSession *expired = NULL;
+    redisSshSession **link = &sessions;
+    while (*link) {
+        redisSshSession *s = *link;
+        if (s->refs == 0 &&
+            (isBroken(s) || now - s->idle_since >= REDIS_SSH_SESSION_IDLE_SEC)) {
+            *link = s->next;
+            s->next = expired;
+            expired = s;
+        } else {
+            link = &s->next;
+        }
+    }
+    return expired;
+}
+
+/* Connects and authenticates s, which other threads only wait on. Returns 0
+ * or -1 with errstr set. */
+static int connectSession(redisSshSession *s, const char *ssh_address, int ssh_port,
+                          const char *username, const char *password, const char *public_key,
+                          const char *private_key, const char *passphrase, int curMethod,
+                          char *errstr, size_t errlen) {
+    struct hostent *host;
+    struct sockaddr_in sin;
+    char *userauthlist;
+    int auth_pw = 0;
+
+    host = gethostbyname(ssh_address);
+    if (!host) {
+        setError(errstr, errlen, "Failed to resolve ssh address.");
+        return -1;
+    }
+
+    /* Connect to SSH server */
+    s->sock = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_family = AF_INET;
+    sin.sin_addr = *(struct in_addr *)host->h_addr;
+    sin.sin_port = htons(ssh_port);
+    if (s->sock == LIBSSH2_INVALID_SOCKET ||
+        connect(s->sock, (struct sockaddr *)(&sin), sizeof(struct sockaddr_in)) != 0) {
+        setError(errstr, errlen, "Failed to connect (ssh_address).");
+        return -1;
+    }
+
+    /* Every command of every channel is a small ssh packet, don't let
+     * Nagle hold them back. */
+    {
+        int yes = 1;
+        setsockopt(s->sock, IPPROTO_TCP, TCP_NODELAY, (const char *)&yes, sizeof(yes));
+    }
+
+    /* Create a session instance */
+    s->session = libssh2_session_init_ex(NULL, NULL, NULL, s);
+    if (!s->session) {
+        setError(errstr, errlen, "Failed to create ssh session.");
+        return -1;
+    }
+    libssh2_session_callback_set(s->session, LIBSSH2_CALLBACK_RECV, (void *)countingRecv);
+
+    /* ... start it up. This will trade welcome banners, exchange keys,
+     * and setup crypto, compression, and MAC layers
+     */
+    if (libssh2_session_handshake(s->session, s->sock)) {
+        setError(errstr, errlen, "SSH handshake failed.");
+        return -1;
+    }
+
+    libssh2_hostkey_hash(s->session, LIBSSH2_HOSTKEY_HASH_SHA1);
+    userauthlist = libssh2_userauth_list(s->session, username, strlen(username));
+    if (userauthlist && strstr(userauthlist, "password") != NULL) {
+        auth_pw |= 1;
+    }
+    if (userauthlist && strstr(userauthlist, "keyboard-interactive") != NULL) {
+        auth_pw |= 2;
+    }
+    if (userauthlist && strstr(userauthlist, "publickey") != NULL) {
+        auth_pw |= 4;
+    }
+
+    if (auth_pw & 1 && curMethod == SSH_PASSWORD) {
+        /* We could authenticate via password */
+        if (libssh2_userauth_password(s->session, username, password)) {
+            setError(errstr, errlen, "Authentication by password failed!");
+            return -1;
+        }
+    } else if (auth_pw & 2) {
+        /* Or via keyboard-interactive */
+        if (libssh2_userauth_keyboard_interactive(s->session, username, &kbdCallback)) {
+            setError(errstr, errlen, "Authentication by keyboard-interactive failed!");
+            return -1;
+        }
+    } else if (auth_pw & 4 && curMethod == SSH_PUBLICKEY) {
+        /* Or by public key */
+        if (libssh2_userauth_publickey_fromfile(s->session, username, public_key, private_key,
+                                                passphrase)) {
+            setError(errstr, errlen, "Authentication by public key failed!");
+            return -1;
+        }
+    } else {
+        setError(errstr, errlen, "No supported authentication methods found!");
+        return -1;
+    }
+
+    /* From here on the session is driven by several threads; libssh2 calls
+     * must never block while the session lock is held. */
+    libssh2_keepalive_config(s->session, 1, REDIS_SSH_SESSION_KEEPALIVE_SEC);
+    libssh2_session_set_blocking(s->session, 0);
+    return 0;
+}
+
+redisSshSession *redisSshSessionAcquire(const char *ssh_address, int ssh_port, const char *username,
+                                        const char *password, const char *public_key,
+                                        const char *private_key, const char *passphrase,
+                                        int curMethod, char *errstr, size_t errlen) {
+    redisSshSession *s, *expired;
+    redisSshSession **link;
+    sds key;
+    int rc;
+
+    if (!ssh_address || !username || curMethod == SSH_UNKNOWN) {
+        setError(errstr, errlen, "Invalid input argument(s)");
+        return NULL;
+    }
+    if (curMethod == SSH_PUBLICKEY && !private_key) {
+        setError(errstr, errlen, "Invalid input argument(private key)");
+        return NULL;
+    } else if (curMethod == SSH_PASSWORD && !password) {
+        setError(errstr, errlen, "Invalid input argument(password)");
+        return NULL;
+    }
+
+    key = makeKey(ssh_address, ssh_port, username, password, public_key, private_key, passphrase,
+                  curMethod);
+
+    /* Concurrent connects to the same host end up on one session: the first
+     * one registers a connecting session and handshakes without the registry
+     * lock, the others wait until it is ready or gone. */
+    lockRegistry();
+    expired = sweepLocked(time(NULL));
+    for (;;) {
+        for (s = sessions; s; s = s->next) {
+            if (sdscmp(s->key, key) == 0 && !isBroken(s)) {
+                break;
+            }
+        }
+        if (!s || !s->connecting) {
+            break;
+        }
+        sshCondWait(&registry_cond, &registry_lock, -1);
+    }
+
+    if (s) {
+        s->refs++;
+        unlockRegistry();
+        freeSessions(expired);
+        sdsfree(key);
+        return s;
+    }
+
+    if (!libssh2_inited) {
+        if (libssh2_init(0) != 0) {
+            unlockRegistry();
+            freeSessions(expired);
+            sdsfree(key);
+            setError(errstr, errlen, "Failed to init libssh library.");
+            return NULL;
+        }
+        libssh2_inited = 1;
+    }
+
+    s = newSession(key);
+    if (!s) {
+        unlockRegistry();
+        freeSessions(expired);
+        sdsfree(key);
+        setError(errstr, errlen, "Out of memory");
+        return NULL;
+    }
+    s->refs = 1;
+    s->connecting = 1;
+    s->next = sessions;
+    sessions = s;
+    unlockRegistry();
+    freeSessions(expired);
+
+    rc = connectSession(s, ssh_address, ssh_port, username, password, public_key, private_key,
+                        passphrase, curMethod, errstr, errlen);
+
+    lockRegistry();
+    s->connecting = 0;
+    if (rc != 0) {
+        for (link = &sessions; *link != s; link = &(*link)->next) {
+        }
+        *link = s->next;
+    }
+    sshCondBroadcast(&registry_cond);
+    unlockRegistry();
+
+    if (rc != 0) {
+        freeSession(s);
+        return NULL;
+    }
+    return s;
+}
+
+void redisSshSessionRelease(redisSshSession *s) {
+    redisSshSession *expired;
+    time_t now;
+    if (!s) {
+        return;
+    }
+
+    now = time(NULL);
+    lockRegistry();
+    if (--s->refs == 0) {
+        s->idle_since = now;
+    }
+    expired = sweepLocked(now);
+    unlockRegistry();
+    freeSessions(expired);
+}
+
+/* Called with the session lock held right after a libssh2 call that started
+ * when rx_seq was seq. Wakes the channels waiting on io when the call read
+ * packets, marks the session broken on transport errors and returns rx_seq
+ * to wait with. */
+static unsigned long afterCallLocked(redisSshSession *s, unsigned long seq, int rc) {
+    if (s->rx_seq != seq) {
+        sshCondBroadcast(&s->io);
+    }
+    if (rc == LIBSSH2_ERROR_SOCKET_SEND || rc == LIBSSH2_ERROR_SOCKET_RECV ||
+        rc == LIBSSH2_ERROR_SOCKET_DISCONNECT || rc == LIBSSH2_ERROR_SOCKET_TIMEOUT) {
+        s->broken = 1;
+    }
+    return s->rx_seq;
+}
+
+static long long nowMsec(void) {
+#ifdef OS_WIN
+    return (long long)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+/* Waits until what libssh2 last blocked on may go on, at most max_msec when
+ * it isn't negative. seq is what afterCallLocked returned for that call.
+ * Called without the session lock. */
+static void waitSocket(redisSshSession *s, int dir, unsigned long seq, int max_msec) {
+    struct timeval tv;
+    fd_set readfds, writefds;
+    int msec;
+
+    sshMutexLock(&s->lock);
+    if (s->rx_seq != seq) {
+        /* another channel read packets meanwhile, ours may be among them */
+        sshMutexUnlock(&s->lock);
+        return;
+    }
+    if (s->polling) {
+        s->wait_dir |= dir;
+        sshCondWait(&s->io, &s->lock, max_msec);
+        sshMutexUnlock(&s->lock);
+        return;
+    }
+
+    s->polling = 1;
+    dir |= s->wait_dir;
+    s->wait_dir = 0;
+    msec = s->channels > 1 ? SSH_WAIT_SHARED_MSEC : SSH_WAIT_EXCLUSIVE_MSEC;
+    sshMutexUnlock(&s->lock);
+
+    if (max_msec >= 0 && max_msec < msec) {
+        msec = max_msec;
+    }
+    tv.tv_sec = msec / 1000;
+    tv.tv_usec = (msec % 1000) * 1000;
+
+    FD_ZERO(&readfds);
+    FD_ZERO(&writefds);
+    if (dir & LIBSSH2_SESSION_BLOCK_INBOUND) {
+        FD_SET(s->sock, &readfds);
+    }
+    if (dir & LIBSSH2_SESSION_BLOCK_OUTBOUND) {
+        FD_SET(s->sock, &writefds);
+    }
+    select((int)s->sock + 1, &readfds, &writefds, NULL, &tv);
+
+    sshMutexLock(&s->lock);
+    s->polling = 0;
+    sshCondBroadcast(&s->io);
+    sshMutexUnlock(&s->lock);
+}
+
+static unsigned char *putUint32(unsigned char *p, uint32_t v) {
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+    return p + 4;
+}
+
+static unsigned char *putString(unsigned char *p, const char *str, size_t len) {
+    p = putUint32(p, (uint32_t)len);
+    memcpy(p, str, len);
+    return p + len;
+}
+
+LIBSSH2_CHANNEL *redisSshChannelOpen(redisSshSession *s, const char *host, int port,
+                                     unsigned int window_size, unsigned int packet_size) {
+    /* libssh2_channel_direct_tcpip can't take a window or packet size, so
+     * the RFC 4254 direct-tcpip request is built here the same way libssh2
+     * does it and opened with libssh2_channel_open_ex. */
+    static const char type[] = "direct-tcpip";
+    static const char shost[] = "127.0.0.1";
+    const int sport = 22;
+    size_t host_len = strlen(host);
+    size_t message_len = 4 + host_len + 4 + 4 + (sizeof(shost) - 1) + 4;
+    unsigned char *message, *p;
+    LIBSSH2_CHANNEL *channel;
+    unsigned long seq;
+    int rc, dir;
+
+    if (window_size == 0) {
+        window_size = LIBSSH2_CHANNEL_WINDOW_DEFAULT;
+    }
+    if (packet_size == 0) {
+        packet_size = LIBSSH2_CHANNEL_PACKET_DEFAULT;
+    }
+    if (packet_size > REDIS_SSH_MAX_PACKET_SIZE) {
+        packet_size = REDIS_SSH_MAX_PACKET_SIZE;
+    }
+    if (window_size < packet_size) {
+        window_size = packet_size;
+    }
+
+    message = malloc(message_len);
+    if (!message) {
+        return NULL;
+    }
+    p = putString(message, host, host_len);
+    p = putUint32(p, (uint32_t)port);
+    p = putString(p, shost, sizeof(shost) - 1);
+    putUint32(p, (uint32_t)sport);
+
+    for (;;) {
+        sshMutexLock(&s->lock);
+        seq = s->rx_seq;
+        channel = libssh2_channel_open_ex(s->session, type, sizeof(type) - 1, window_size,
+                                          packet_size, (const char *)message,
+                                          (unsigned int)message_len);
+        rc = channel ? 0 : libssh2_session_last_errno(s->session);
+        dir = libssh2_session_block_directions(s->session);
+        seq = afterCallLocked(s, seq, rc);
+        if (channel) {
+            s->channels++;
+        }
+        sshMutexUnlock(&s->lock);
+
+        if (channel || rc != LIBSSH2_ERROR_EAGAIN) {
+            break;
+        }
+        waitSocket(s, dir, seq, -1);
+    }
+
+    free(message);
+    return channel;
+}
+
+void redisSshChannelClose(redisSshSession *s, LIBSSH2_CHANNEL *channel) {
+    unsigned long seq;
+    int rc, dir;
+
+    if (!channel) {
+        return;
+    }
+
+    for (;;) {
+        sshMutexLock(&s->lock);
+        seq = s->rx_seq;
+        rc = libssh2_channel_free(channel);
+        dir = libssh2_session_block_directions(s->session);
+        seq = afterCallLocked(s, seq, rc);
+        if (rc != LIBSSH2_ERROR_EAGAIN) {
+            s->channels--;
+        }
+        sshMutexUnlock(&s->lock);
+
+        if (rc != LIBSSH2_ERROR_EAGAIN) {
+            return;
+        }
+        waitSocket(s, dir, seq, -1);
+    }
+}
+
+ssize_t redisSshChannelRead(redisSshSession *s, LIBSSH2_CHANNEL *channel, char *buf, size_t len) {
+    return redisSshChannelReadTimeout(s, channel, buf, len, -1);
+}
+
+ssize_t redisSshChannelReadTimeout(redisSshSession *s, LIBSSH2_CHANNEL *channel, char *buf,
+                                   size_t len, int timeout_msec) {
+    ssize_t rc;
+    unsigned long seq;
+    int eof, dir;
+    long long left = timeout_msec;
+    long long deadline = timeout_msec >= 0 ? nowMsec() + timeout_msec : 0;
+
+    for (;;) {
+        sshMutexLock(&s->lock);
+        seq = s->rx_seq;
+        rc = libssh2_channel_read(channel, buf, len);
+        eof = rc == 0 && libssh2_channel_eof(channel);
+        dir = libssh2_session_block_directions(s->session);
+        seq = afterCallLocked(s, seq, rc < 0 ? (int)rc : 0);
+        sshMutexUnlock(&s->lock);
+
+        if (rc > 0 || eof) {
+            return rc;
+        }
+        if (rc < 0 && rc != LIBSSH2_ERROR_EAGAIN) {
+            errno = EIO;
+            return -1;
+        }
+        if (timeout_msec >= 0) {
+            left = deadline - nowMsec();
+            if (left <= 0) {
+                errno = EAGAIN;
+                return -1;
+            }
+        }
+        waitSocket(s, dir, seq, (int)left);
+    }
+}
+
+ssize_t redisSshChannelWrite(redisSshSession *s, LIBSSH2_CHANNEL *channel, const char *buf,
+                             size_t len) {
+    ssize_t rc;
+    unsigned long seq;
+    int dir;
+
+    for (;;) {
+        sshMutexLock(&s->lock);
+        seq = s->rx_seq;
+        rc = libssh2_channel_write(channel, buf, len);
+        dir = libssh2_session_block_directions(s->session);
+        seq = afterCallLocked(s, seq, rc < 0 ? (int)rc : 0);
+        sshMutexUnlock(&s->lock);
+
+        if (rc >= 0) {
+            return rc;
+        }
+        if (rc != LIBSSH2_ERROR_EAGAIN) {
+            errno = EIO;
+            return -1;
+        }
+        waitSocket(s, dir, seq, -1);
+    }
+}
+
+void redisSshSessionsKeepAlive(void) {
+    redisSshSession *s, *expired;
+    unsigned long seq;
+    int next;
+
+    lockRegistry();
+    expired = sweepLocked(time(NULL));
+    for (s = sessions; s; s = s->next) {
+        if (s->connecting) {
+            continue;
+        }
+        sshMutexLock(&s->lock);
+        if (!s->broken) {
+            seq = s->rx_seq;
+            if (libssh2_keepalive_send(s->session, &next) != 0 &&
+                libssh2_session_last_errno(s->session) != LIBSSH2_ERROR_EAGAIN) {
+                s->broken = 1;
+            }
+            afterCallLocked(s, seq, 0);
+        }
+        sshMutexUnlock(&s->lock);
+    }
+    unlockRegistry();
+    freeSessions(expired);
+}
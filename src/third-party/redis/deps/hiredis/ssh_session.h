@@ -0,0 +1,87 @@
+/*  Copyright (C) 2014-2016 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __HIREDIS_SSH_SESSION_H
+#define __HIREDIS_SSH_SESSION_H
+
+#include <stddef.h> /* for size_t */
+#include <sys/types.h> /* for ssize_t */
+
+#include <libssh2.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SSH_UNKNOWN 0
+#define SSH_PASSWORD 1
+#define SSH_PUBLICKEY 2
+
+/* Tunnelled contexts share one authenticated SSH session per
+ * (ssh host, ssh port, user, auth method, credentials) key and open their
+ * own direct-tcpip channel on it. A session whose last channel was closed
+ * stays in the registry for REDIS_SSH_SESSION_IDLE_SEC so that reconnects
+ * and short-lived helper connections (test, discovery) skip the handshake. */
+#define REDIS_SSH_SESSION_IDLE_SEC 60
+#define REDIS_SSH_SESSION_KEEPALIVE_SEC 30
+
+/* Bounds of the adaptive channel read size of a context. */
+#define REDIS_SSH_READ_MIN (16 * 1024)
+#define REDIS_SSH_READ_MAX (1024 * 1024)
+
+/* libssh2 drops transport packets over ~35000 bytes, bigger channel packet
+ * sizes would let the server send packets we can't receive. */
+#define REDIS_SSH_MAX_PACKET_SIZE (32 * 1024)
+
+typedef struct redisSshSession redisSshSession;
+
+/* Returns a referenced session, creating and authenticating it when no
+ * matching one is registered. On failure NULL is returned and errstr holds
+ * the reason. */
+redisSshSession *redisSshSessionAcquire(const char *ssh_address, int ssh_port, const char *username,
+                                        const char *password, const char *public_key,
+                                        const char *private_key, const char *passphrase,
+                                        int curMethod, char *errstr, size_t errlen);
+/* Drops a reference; the session is kept idle and closed by a later sweep. */
+void redisSshSessionRelease(redisSshSession *s);
+
+/* Opens a direct-tcpip channel with the given receive window and max packet
+ * size, 0 keeps the libssh2 default. */
+LIBSSH2_CHANNEL *redisSshChannelOpen(redisSshSession *s, const char *host, int port,
+                                     unsigned int window_size, unsigned int packet_size);
+void redisSshChannelClose(redisSshSession *s, LIBSSH2_CHANNEL *channel);
+
+/* Blocking read/write of one channel. The session lock is only held while
+ * libssh2 is called, so other channels of the same session keep running
+ * while this one waits on the socket. Return -1 and set errno on error. */
+ssize_t redisSshChannelRead(redisSshSession *s, LIBSSH2_CHANNEL *channel, char *buf, size_t len);
+/* Same as redisSshChannelRead, but gives up with errno EAGAIN when no data
+ * arrived for timeout_msec; a negative timeout waits forever. */
+ssize_t redisSshChannelReadTimeout(redisSshSession *s, LIBSSH2_CHANNEL *channel, char *buf,
+                                   size_t len, int timeout_msec);
+ssize_t redisSshChannelWrite(redisSshSession *s, LIBSSH2_CHANNEL *channel, const char *buf,
+                             size_t len);
+
+/* Sends keepalives on live sessions and closes the idle ones that expired. */
+void redisSshSessionsKeepAlive(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -66,6 +66,10 @@ class Client{
 public:
 	static Client* connect(const char *ip, int port);
 	static Client* connect(const std::string &ip, int port);
+#ifdef FASTO
+	// timeout_ms limits connect and every send/recv, 0 - blocking
+	static Client* connect(const std::string &ip, int port, int timeout_ms);
+#endif
 	Client(){};
 	virtual ~Client(){};
 
@@ -59,6 +59,12 @@ Client* Client::connect(const char *ip, int port){
 }
 
 Client* Client::connect(const std::string &ip, int port){
+#ifdef FASTO
+	return Client::connect(ip, port, 0);
+}
+
+Client* Client::connect(const std::string &ip, int port, int timeout_ms){
+#endif
 	static bool inited = false;
 	if(!inited){
 		inited = true;
@@ -71,7 +77,11 @@ Client* Client::connect(const std::string &ip, int port){
 #endif
 	}
 	ClientImpl *client = new ClientImpl();
+#ifdef FASTO
+	client->link = Link::connect(ip.c_str(), port, timeout_ms);
+#else
 	client->link = Link::connect(ip.c_str(), port);
+#endif
 	if(client->link == NULL){
 		delete client;
 		return NULL;
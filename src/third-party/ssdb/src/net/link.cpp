@@ -12,6 +12,7 @@ found in the LICENSE file.
         #define F_EINTR 0
     #else
         #include <sys/socket.h>
+        #include <sys/select.h>
         #include <netdb.h>
         #define F_EINTR EINTR
     #endif
@@ -162,9 +163,68 @@ static bool is_ip(const char *host){
     #endif
 #endif
 
-
-Link* Link::connect(const char *host, int port){
 #ifdef FASTO
+Link* Link::connect(const char *host, int port){
+    return connect(host, port, 0);
+}
+
+// connect() limited by timeout_ms (0 - blocking), the same limit is set as
+// the send/recv timeout of the socket
+static int connect_timeout(int sock, const struct sockaddr *addr, int addrlen, int timeout_ms){
+    if(timeout_ms <= 0){
+        return ::connect(sock, addr, addrlen);
+    }
+
+    #ifdef OS_WIN
+        u_long mode = 1;
+        ioctlsocket(sock, FIONBIO, &mode);
+    #else
+        int flags = fcntl(sock, F_GETFL, 0);
+        fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+    #endif
+    int ret = ::connect(sock, addr, addrlen);
+    if(ret == -1){
+    #ifdef OS_WIN
+        bool in_progress = WSAGetLastError() == WSAEWOULDBLOCK;
+    #else
+        bool in_progress = errno == EINPROGRESS;
+    #endif
+        if(!in_progress){
+            return -1;
+        }
+
+        fd_set wset;
+        FD_ZERO(&wset);
+        FD_SET(sock, &wset);
+        struct timeval tv;
+        tv.tv_sec = timeout_ms / 1000;
+        tv.tv_usec = (timeout_ms % 1000) * 1000;
+        if(::select(sock + 1, NULL, &wset, NULL, &tv) <= 0){
+            return -1;
+        }
+
+        int so_error = 0;
+        socklen_t len = sizeof(so_error);
+        if(::getsockopt(sock, SOL_SOCKET, SO_ERROR, (char *)&so_error, &len) == -1 || so_error != 0){
+            return -1;
+        }
+    }
+    #ifdef OS_WIN
+        mode = 0;
+        ioctlsocket(sock, FIONBIO, &mode);
+        DWORD tv = timeout_ms;
+    #else
+        fcntl(sock, F_SETFL, flags);
+        struct timeval tv;
+        tv.tv_sec = timeout_ms / 1000;
+        tv.tv_usec = (timeout_ms % 1000) * 1000;
+    #endif
+    ::setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char *)&tv, sizeof(tv));
+    ::setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, (const char *)&tv, sizeof(tv));
+    return 0;
+}
+
+Link* Link::connect(const char *host, int port, int timeout_ms){
     #ifdef OS_WIN
         Link *link;
         int sock = -1;
@@ -192,7 +252,7 @@ Link* Link::connect(const char *host, int port){
         if((sock = ::socket(AF_INET, SOCK_STREAM, 0)) == -1){
             goto sock_err;
         }
-        if(::connect(sock, (struct sockaddr *)&addr, sizeof(addr)) == -1){
+        if(connect_timeout(sock, (struct sockaddr *)&addr, sizeof(addr), timeout_ms) == -1){
             goto sock_err;
         }
 
@@ -233,7 +293,7 @@ Link* Link::connect(const char *host, int port){
         if((sock = ::socket(AF_INET, SOCK_STREAM, 0)) == -1){
             goto sock_err;
         }
-        if(::connect(sock, (struct sockaddr *)&addr, sizeof(addr)) == -1){
+        if(connect_timeout(sock, (struct sockaddr *)&addr, sizeof(addr), timeout_ms) == -1){
             goto sock_err;
         }
 
@@ -249,7 +309,9 @@ Link* Link::connect(const char *host, int port){
         }
         return NULL;
     #endif
+}
 #else
+Link* Link::connect(const char *host, int port){
     Link *link;
     int sock = -1;
 
@@ -290,8 +352,8 @@ sock_err:
         ::close(sock);
     }
     return NULL;
-#endif
 }
+#endif
 
 Link* Link::listen(const char *ip, int port){
 	Link *link;
@@ -70,6 +70,9 @@ class Link{
 		}
 
 		static Link* connect(const char *ip, int port);
+#ifdef FASTO
+		static Link* connect(const char *ip, int port, int timeout_ms);
+#endif
 		static Link* listen(const char *ip, int port);
 		Link* accept();
 
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "sds.h"
+}
+
+#include "core/global.h"
+
+#ifdef BUILD_WITH_REDIS
+#include <hiredis/hiredis.h>
+
+#include "core/db/redis/db_connection.h"
+#endif
+
+#include "bench_fixtures.h"
+
+using namespace fastonosql;
+
+static void BM_SdsSplitArgs(benchmark::State& state) {
+  std::string line = "SET";
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    line += " \"arg " + common::ConvertToString(i) + "\"";
+  }
+
+  for (auto _ : state) {
+    int argc = 0;
+    sds* argv = sdssplitargslong(line.c_str(), &argc);
+    benchmark::DoNotOptimize(argv);
+    sdsfreesplitres(argv, argc);
+  }
+}
+BENCHMARK(BM_SdsSplitArgs)->Arg(2)->Arg(16)->Arg(1024);
+
+static void BM_ConvertToStringFastoObject(benchmark::State& state) {
+  std::vector<std::string> keys = bench::MakeKeys(state.range(0));
+  core::FastoObjectIPtr root(core::FastoObject::CreateRoot("KEYS *"));
+  for (size_t i = 0; i < keys.size(); ++i) {
+    core::FastoObject* child =
+        new core::FastoObject(root.get(), common::Value::createStringValue(keys[i]), "\n");
+    root->AddChildren(child);
+  }
+
+  for (auto _ : state) {
+    std::string res = common::ConvertToString(root.get());
+    benchmark::DoNotOptimize(res);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConvertToStringFastoObject)->Arg(BENCH_KEYS_SMALL)->Arg(BENCH_KEYS_LARGE);
+
+#ifdef BUILD_WITH_REDIS
+static void BM_FindCommand(benchmark::State& state) {
+  core::redis::DBConnection db(nullptr);
+  core::translator_t tran = db.Translator();
+  // commands from the start and the end of the redis table, and an unknown one
+  const char* lines[][3] = {{"APPEND", "key", "val"}, {"ZSCORE", "key", "member"},
+                            {"UNKNOWN", "key", "val"}};
+  const char** argv = lines[state.range(0)];
+
+  for (auto _ : state) {
+    const core::CommandHolder* cmd = nullptr;
+    size_t off = 0;
+    common::Error err = tran->FindCommand(3, argv, &cmd, &off);
+    benchmark::DoNotOptimize(cmd);
+  }
+}
+BENCHMARK(BM_FindCommand)->DenseRange(0, 2);
+
+static void BM_ValueFromReplay(benchmark::State& state) {
+  std::vector<std::string> keys = bench::MakeKeys(state.range(0));
+  std::vector<redisReply> elements(keys.size());
+  std::vector<redisReply*> pelements(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    redisReply* el = &elements[i];
+    el->type = REDIS_REPLY_STRING;
+    el->str = const_cast<char*>(keys[i].c_str());
+    el->len = keys[i].size();
+    pelements[i] = el;
+  }
+  redisReply reply = redisReply();
+  reply.type = REDIS_REPLY_ARRAY;
+  reply.elements = pelements.size();
+  reply.element = pelements.data();
+
+  for (auto _ : state) {
+    common::Value* val = nullptr;
+    common::Error err = core::redis::valueFromReplay(&reply, &val);
+    benchmark::DoNotOptimize(val);
+    delete val;
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ValueFromReplay)->Arg(BENCH_KEYS_SMALL)->Arg(BENCH_KEYS_LARGE);
+#endif
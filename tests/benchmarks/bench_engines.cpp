@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "engine_traits.h"
+
+using namespace fastonosql;
+
+namespace {
+
+template <typename DBConnection>
+void BM_EngineSet(benchmark::State& state) {
+  typedef bench::EngineTraits<DBConnection> traits_t;
+  std::vector<std::string> keys = bench::MakeKeys(state.range(0));
+  core::NValue val(common::Value::createStringValue("value"));
+  DBConnection db(nullptr);
+  auto config = traits_t::MakeConfig(keys.size(), 5);  // "value"
+  common::Error err = db.Connect(config);
+  if (err && err->isError()) {
+    state.SkipWithError(err->description().c_str());
+    return;
+  }
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      core::NDbKValue added;
+      err = db.Set(core::NDbKValue(core::NKey(keys[i]), val), &added);
+      benchmark::DoNotOptimize(err);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+
+  err = db.Disconnect();
+  traits_t::Remove(config.dbname);
+}
+
+template <typename DBConnection>
+void BM_EngineGet(benchmark::State& state) {
+  typedef bench::EngineTraits<DBConnection> traits_t;
+  std::vector<std::string> keys = bench::MakeKeys(state.range(0));
+  core::NValue val(common::Value::createStringValue("value"));
+  DBConnection db(nullptr);
+  auto config = traits_t::MakeConfig(keys.size(), 5);  // "value"
+  common::Error err = db.Connect(config);
+  if (err && err->isError()) {
+    state.SkipWithError(err->description().c_str());
+    return;
+  }
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    core::NDbKValue added;
+    err = db.Set(core::NDbKValue(core::NKey(keys[i]), val), &added);
+  }
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      core::NDbKValue loaded;
+      err = db.Get(core::NKey(keys[i]), &loaded);
+      benchmark::DoNotOptimize(err);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+
+  err = db.Disconnect();
+  traits_t::Remove(config.dbname);
+}
+
+}  // namespace
+
+#ifdef BUILD_WITH_LEVELDB
+BENCHMARK_TEMPLATE(BM_EngineSet, core::leveldb::DBConnection)->Arg(BENCH_KEYS_SMALL);
+BENCHMARK_TEMPLATE(BM_EngineGet, core::leveldb::DBConnection)->Arg(BENCH_KEYS_SMALL);
+#endif
+#ifdef BUILD_WITH_ROCKSDB
+BENCHMARK_TEMPLATE(BM_EngineSet, core::rocksdb::DBConnection)->Arg(BENCH_KEYS_SMALL);
+BENCHMARK_TEMPLATE(BM_EngineGet, core::rocksdb::DBConnection)->Arg(BENCH_KEYS_SMALL);
+#endif
+#ifdef BUILD_WITH_LMDB
+BENCHMARK_TEMPLATE(BM_EngineSet, core::lmdb::DBConnection)->Arg(BENCH_KEYS_SMALL);
+BENCHMARK_TEMPLATE(BM_EngineGet, core::lmdb::DBConnection)->Arg(BENCH_KEYS_SMALL);
+#endif
+#ifdef BUILD_WITH_UNQLITE
+BENCHMARK_TEMPLATE(BM_EngineSet, core::unqlite::DBConnection)->Arg(BENCH_KEYS_SMALL);
+BENCHMARK_TEMPLATE(BM_EngineGet, core::unqlite::DBConnection)->Arg(BENCH_KEYS_SMALL);
+#endif
+#ifdef BUILD_WITH_UPSCALEDB
+BENCHMARK_TEMPLATE(BM_EngineSet, core::upscaledb::DBConnection)->Arg(BENCH_KEYS_SMALL);
+BENCHMARK_TEMPLATE(BM_EngineGet, core::upscaledb::DBConnection)->Arg(BENCH_KEYS_SMALL);
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdlib.h>  // for getenv
+#ifdef OS_WIN
+#include <process.h>  // for _getpid
+#define bench_getpid _getpid
+#else
+#include <unistd.h>  // for getpid
+#define bench_getpid getpid
+#endif
+
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include <common/convert2string.h>  // for ConvertToString
+
+#define BENCH_KEYS_SMALL 10000
+#define BENCH_KEYS_LARGE 1000000
+#define BENCH_KEY_SIZE_MAX 64  // upper bound of MakeKeys and engine_benchmarks keys
+
+namespace fastonosql {
+namespace bench {
+
+// keys spread over 100 namespaces: ns:<i % 100>:key:<i>
+inline std::vector<std::string> MakeKeys(size_t count) {
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    keys.push_back("ns:" + common::ConvertToString(i % 100) + ":key:" + common::ConvertToString(i));
+  }
+  return keys;
+}
+
+// unique path in temp directory, not created; the pid keeps concurrent
+// runs and leftovers of crashed ones apart
+inline std::string TempPath(const std::string& name) {
+  const char* tmp = getenv("TMPDIR");
+  std::string dir = tmp && tmp[0] ? tmp : "/tmp";
+  static size_t counter = 0;
+  return dir + "/fastonosql_bench_" + name + "_" +
+         common::ConvertToString(static_cast<int>(bench_getpid())) + "_" +
+         common::ConvertToString(counter++);
+}
+
+}  // namespace bench
+}  // namespace fastonosql
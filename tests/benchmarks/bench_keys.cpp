@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "core/database/idatabase_info.h"
+
+#ifdef BUILD_WITH_LEVELDB
+#include "core/db/leveldb/database_info.h"
+
+#include "proxy/connection_settings_factory.h"
+#include "proxy/servers_manager.h"
+
+#include "gui/explorer/explorer_tree_model.h"
+#endif
+
+#include "bench_fixtures.h"
+
+using namespace fastonosql;
+
+#ifdef BUILD_WITH_LEVELDB
+// InsertKey and addKey search siblings linearly, fill is quadratic,
+// so fixtures stay at the small size
+static void BM_IDataBaseInfoInsertKey(benchmark::State& state) {
+  std::vector<std::string> keys = bench::MakeKeys(state.range(0));
+  core::NValue val(common::Value::createStringValue("value"));
+
+  for (auto _ : state) {
+    core::leveldb::DataBaseInfo db("0", true, 0);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      bool inserted = db.InsertKey(core::NDbKValue(core::NKey(keys[i]), val));
+      benchmark::DoNotOptimize(inserted);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IDataBaseInfoInsertKey)->Arg(1000)->Arg(BENCH_KEYS_SMALL);
+
+static void BM_ExplorerTreeModelAddKey(benchmark::State& state) {
+  std::vector<std::string> keys = bench::MakeKeys(state.range(0));
+  core::NValue val(common::Value::createStringValue("value"));
+  proxy::IConnectionSettingsBaseSPtr settings(
+      proxy::ConnectionSettingsFactory::instance().CreateFromType(
+          core::LEVELDB, proxy::connection_path_t("/bench")));
+  proxy::IServerSPtr server = proxy::ServersManager::instance().CreateServer(settings);
+  core::IDataBaseInfoSPtr db(new core::leveldb::DataBaseInfo("0", true, 0));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    gui::ExplorerTreeModel* model = new gui::ExplorerTreeModel;
+    model->addServer(server);
+    model->addDatabase(server.get(), db);
+    state.ResumeTiming();
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+      model->addKey(server.get(), db, core::NDbKValue(core::NKey(keys[i]), val), ":");
+    }
+
+    state.PauseTiming();
+    delete model;
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+
+  proxy::ServersManager::instance().CloseServer(server);
+}
+BENCHMARK(BM_ExplorerTreeModelAddKey)->Arg(1000)->Arg(BENCH_KEYS_SMALL);
+#endif
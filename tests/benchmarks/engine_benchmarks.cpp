@@ -0,0 +1,453 @@
+// Same workloads against every embedded core::<engine>::DBConnection:
+//   engine_benchmarks [--engines=leveldb,rocksdb,...] [--keys=1000000]
+//                     [--value-size=100] [--scans=100] [--workloads=fillseq,get,...]
+// Each workload is timed per operation, the table has ops/s, p50/p99 latency,
+// size of the database on disk and resident memory of the process after it.
+
+#include <inttypes.h>  // for PRIu64
+#include <stdio.h>     // for printf, fopen
+#include <stdlib.h>    // for strtoull
+#include <string.h>    // for strncmp
+
+#ifdef OS_POSIX
+#include <dirent.h>        // for opendir, readdir
+#include <sys/resource.h>  // for getrusage
+#include <sys/stat.h>      // for lstat
+#include <unistd.h>        // for sysconf
+#endif
+
+#include <algorithm>  // for find
+#include <chrono>     // for steady_clock
+#include <iterator>   // for begin, end
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include <common/string_util.h>  // for Tokenize
+
+#include "core/db_key.h"             // for NKey, NDbKValue, NValue
+#include "core/latency_histogram.h"  // for LatencyHistogram
+
+#include "engine_traits.h"
+
+#define ENGINE_BENCH_DEFAULT_KEYS 1000000
+#define ENGINE_BENCH_DEFAULT_VALUE_SIZE 100
+#define ENGINE_BENCH_DEFAULT_SCANS 100
+#define ENGINE_BENCH_SCAN_BATCH 1000
+#define ENGINE_BENCH_KEY_FORMAT "key:%016" PRIu64
+
+using namespace fastonosql;
+
+namespace {
+
+const char* const kWorkloads[] = {"fillseq", "get",        "scan",  "count",
+                                  "flush",   "fillrandom", "delete"};
+
+struct Options {
+  Options()
+      : engines(),
+        workloads(std::begin(kWorkloads), std::end(kWorkloads)),
+        keys(ENGINE_BENCH_DEFAULT_KEYS),
+        value_size(ENGINE_BENCH_DEFAULT_VALUE_SIZE),
+        scans(ENGINE_BENCH_DEFAULT_SCANS) {}
+
+  bool IsEngineEnabled(const std::string& engine) const {
+    return engines.empty() || std::find(engines.begin(), engines.end(), engine) != engines.end();
+  }
+
+  bool IsWorkloadEnabled(const std::string& workload) const {
+    return std::find(workloads.begin(), workloads.end(), workload) != workloads.end();
+  }
+
+  std::vector<std::string> engines;  // empty means all built in
+  std::vector<std::string> workloads;
+  uint64_t keys;
+  uint64_t value_size;
+  uint64_t scans;
+};
+
+struct Row {
+  std::string workload;
+  uint64_t ops;
+  uint64_t elapsed_usec;
+  uint64_t errors;
+  core::LatencyHistogram latency;
+};
+
+uint64_t NowUsec() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// keys are fixed width so lexicographic order is numeric order and a key
+// without its last 3 digits is a prefix of exactly 1000 keys
+std::string MakeKey(uint64_t index) {
+  char buff[32];
+  snprintf(buff, sizeof(buff), ENGINE_BENCH_KEY_FORMAT, index);
+  return buff;
+}
+
+uint64_t Gcd(uint64_t a, uint64_t b) {
+  while (b) {
+    uint64_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+// full permutation of [0, count) without keeping count keys in memory:
+// i * step mod count visits every index once when step is coprime with count,
+// products fit in 64 bits while count < 2^32
+class Permutation {
+ public:
+  explicit Permutation(uint64_t count) : count_(count), step_(count ? 2654435761u % count : 0) {
+    while (count_ > 1 && Gcd(step_, count_) != 1) {
+      step_ = (step_ + 1) % count_;
+    }
+  }
+
+  uint64_t At(uint64_t i) const { return count_ ? (i % count_) * step_ % count_ : 0; }
+
+ private:
+  const uint64_t count_;
+  uint64_t step_;
+};
+
+uint64_t DiskUsage(const std::string& path) {
+#ifdef OS_POSIX
+  struct stat st;
+  if (lstat(path.c_str(), &st) != 0) {
+    return 0;
+  }
+
+  if (!S_ISDIR(st.st_mode)) {
+    return st.st_size;
+  }
+
+  uint64_t total = 0;
+  DIR* dir = opendir(path.c_str());
+  if (!dir) {
+    return 0;
+  }
+
+  while (struct dirent* ent = readdir(dir)) {
+    if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) {
+      continue;
+    }
+    total += DiskUsage(path + "/" + ent->d_name);
+  }
+  closedir(dir);
+  return total;
+#else
+  UNUSED(path);
+  return 0;
+#endif
+}
+
+// current resident set where /proc is available, peak otherwise
+uint64_t ResidentMemory() {
+#ifdef OS_POSIX
+  FILE* statm = fopen("/proc/self/statm", "r");
+  if (statm) {
+    unsigned long size = 0, resident = 0;
+    int res = fscanf(statm, "%lu %lu", &size, &resident);
+    fclose(statm);
+    if (res == 2) {
+      return static_cast<uint64_t>(resident) * sysconf(_SC_PAGESIZE);
+    }
+  }
+
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef OS_MAC
+  return usage.ru_maxrss;  // bytes
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;  // kilobytes
+#endif
+#else
+  return 0;
+#endif
+}
+
+void PrintHeader() {
+  printf("%-10s %-10s %12s %12s %10s %10s %8s %10s %10s\n", "engine", "workload", "ops", "ops/s",
+         "p50 usec", "p99 usec", "errors", "disk MB", "rss MB");
+}
+
+void PrintRow(const std::string& engine, const Row& row, const std::string& path) {
+  double ops_per_sec = row.elapsed_usec ? row.ops * 1000000.0 / row.elapsed_usec : 0;
+  printf("%-10s %-10s %12" PRIu64 " %12.0f %10" PRIu64 " %10" PRIu64 " %8" PRIu64
+         " %10.1f %10.1f\n",
+         engine.c_str(), row.workload.c_str(), row.ops, ops_per_sec,
+         row.latency.ValueAtPercentile(50), row.latency.ValueAtPercentile(99), row.errors,
+         DiskUsage(path) / (1024.0 * 1024.0), ResidentMemory() / (1024.0 * 1024.0));
+  fflush(stdout);
+}
+
+template <typename DBConnection>
+class EngineRunner {
+ public:
+  typedef bench::EngineTraits<DBConnection> traits_t;
+
+  EngineRunner(const std::string& engine, const Options& options)
+      : engine_(engine),
+        options_(options),
+        value_(common::Value::createStringValue(std::string(options.value_size, 'v'))),
+        db_(nullptr),
+        config_(traits_t::MakeConfig(options.keys, options.value_size)) {}
+
+  ~EngineRunner() {
+    Close();
+    traits_t::Remove(config_.dbname);
+  }
+
+  common::Error Run() {
+    common::Error err = db_.Connect(config_);
+    if (err && err->isError()) {
+      return err;
+    }
+
+    // gets, scans, count and flush need loaded database
+    Fill("fillseq", false, options_.IsWorkloadEnabled("fillseq"));
+    if (options_.IsWorkloadEnabled("get")) {
+      Get();
+    }
+    if (options_.IsWorkloadEnabled("scan")) {
+      Scan();
+    }
+    if (options_.IsWorkloadEnabled("count")) {
+      Count();
+    }
+    if (options_.IsWorkloadEnabled("flush")) {
+      Flush();
+    }
+
+    if (!options_.IsWorkloadEnabled("fillrandom") && !options_.IsWorkloadEnabled("delete")) {
+      return common::Error();
+    }
+
+    // fresh database for random order inserts, deletes use it
+    err = Reopen();
+    if (err && err->isError()) {
+      return err;
+    }
+    Fill("fillrandom", true, options_.IsWorkloadEnabled("fillrandom"));
+    if (options_.IsWorkloadEnabled("delete")) {
+      Delete();
+    }
+    return common::Error();
+  }
+
+ private:
+  void Fill(const std::string& name, bool random, bool report) {
+    Row row = MakeRow(name);
+    Permutation perm(options_.keys);
+    uint64_t start = NowUsec();
+    for (uint64_t i = 0; i < options_.keys; ++i) {
+      core::NKey key(MakeKey(random ? perm.At(i) : i));
+      core::NDbKValue added;
+      uint64_t op_start = NowUsec();
+      common::Error err = db_.Set(core::NDbKValue(key, value_), &added);
+      Finish(&row, op_start, err);
+    }
+    row.elapsed_usec = NowUsec() - start;
+    if (report) {
+      PrintRow(engine_, row, config_.dbname);
+    }
+  }
+
+  void Get() {
+    Row row = MakeRow("get");
+    Permutation perm(options_.keys);
+    uint64_t start = NowUsec();
+    for (uint64_t i = 0; i < options_.keys; ++i) {
+      core::NKey key(MakeKey(perm.At(i)));
+      core::NDbKValue loaded;
+      uint64_t op_start = NowUsec();
+      common::Error err = db_.Get(key, &loaded);
+      Finish(&row, op_start, err);
+    }
+    row.elapsed_usec = NowUsec() - start;
+    PrintRow(engine_, row, config_.dbname);
+  }
+
+  // one op is a full prefix walk over up to 1000 keys
+  void Scan() {
+    Row row = MakeRow("scan");
+    Permutation perm(options_.keys);
+    uint64_t start = NowUsec();
+    for (uint64_t i = 0; i < options_.scans && options_.keys; ++i) {
+      std::string key = MakeKey(perm.At(i % options_.keys));
+      std::string pattern = key.substr(0, key.size() - 3) + "*";
+      uint64_t op_start = NowUsec();
+      uint64_t cursor = 0;
+      common::Error err;
+      do {
+        std::vector<std::string> keys;
+        uint64_t cursor_out = 0;
+        err = db_.Scan(cursor, pattern, ENGINE_BENCH_SCAN_BATCH, &keys, &cursor_out);
+        cursor = cursor_out;
+      } while (cursor != 0 && !(err && err->isError()));
+      Finish(&row, op_start, err);
+    }
+    row.elapsed_usec = NowUsec() - start;
+    PrintRow(engine_, row, config_.dbname);
+  }
+
+  void Count() {
+    Row row = MakeRow("count");
+    uint64_t start = NowUsec();
+    size_t count = 0;
+    common::Error err = db_.DBkcount(&count);
+    Finish(&row, start, err);
+    row.elapsed_usec = NowUsec() - start;
+    if (count != options_.keys) {
+      row.errors++;
+    }
+    PrintRow(engine_, row, config_.dbname);
+  }
+
+  void Flush() {
+    Row row = MakeRow("flush");
+    uint64_t start = NowUsec();
+    common::Error err = db_.FlushDB();
+    Finish(&row, start, err);
+    row.elapsed_usec = NowUsec() - start;
+    PrintRow(engine_, row, config_.dbname);
+  }
+
+  void Delete() {
+    Row row = MakeRow("delete");
+    Permutation perm(options_.keys);
+    uint64_t start = NowUsec();
+    for (uint64_t i = 0; i < options_.keys; ++i) {
+      core::NKeys keys = {core::NKey(MakeKey(perm.At(i)))};
+      core::NKeys deleted;
+      uint64_t op_start = NowUsec();
+      common::Error err = db_.Delete(keys, &deleted);
+      Finish(&row, op_start, err);
+    }
+    row.elapsed_usec = NowUsec() - start;
+    PrintRow(engine_, row, config_.dbname);
+  }
+
+  Row MakeRow(const std::string& workload) const {
+    Row row;
+    row.workload = workload;
+    row.ops = 0;
+    row.elapsed_usec = 0;
+    row.errors = 0;
+    return row;
+  }
+
+  static void Finish(Row* row, uint64_t op_start, common::Error err) {
+    row->latency.Record(NowUsec() - op_start);
+    row->ops++;
+    if (err && err->isError()) {
+      row->errors++;
+    }
+  }
+
+  void Close() {
+    if (db_.IsConnected()) {
+      common::Error err = db_.Disconnect();
+      UNUSED(err);
+    }
+  }
+
+  common::Error Reopen() {
+    Close();
+    traits_t::Remove(config_.dbname);
+    config_ = traits_t::MakeConfig(options_.keys, options_.value_size);
+    return db_.Connect(config_);
+  }
+
+  const std::string engine_;
+  const Options& options_;
+  const core::NValue value_;
+  DBConnection db_;
+  decltype(traits_t::MakeConfig(0, 0)) config_;
+};
+
+template <typename DBConnection>
+int RunEngine(const std::string& engine, const Options& options) {
+  if (!options.IsEngineEnabled(engine)) {
+    return 0;
+  }
+
+  EngineRunner<DBConnection> runner(engine, options);
+  common::Error err = runner.Run();
+  if (err && err->isError()) {
+    fprintf(stderr, "%s: %s\n", engine.c_str(), err->description().c_str());
+    return 1;
+  }
+  return 0;
+}
+
+bool ParseOption(const char* arg, const char* name, std::string* value) {
+  size_t len = strlen(name);
+  if (strncmp(arg, name, len) != 0 || arg[len] != '=') {
+    return false;
+  }
+  *value = arg + len + 1;
+  return true;
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string value;
+    if (ParseOption(argv[i], "--engines", &value)) {
+      common::Tokenize(value, ",", &options->engines);
+    } else if (ParseOption(argv[i], "--workloads", &value)) {
+      options->workloads.clear();
+      common::Tokenize(value, ",", &options->workloads);
+    } else if (ParseOption(argv[i], "--keys", &value)) {
+      options->keys = strtoull(value.c_str(), NULL, 10);
+    } else if (ParseOption(argv[i], "--value-size", &value)) {
+      options->value_size = strtoull(value.c_str(), NULL, 10);
+    } else if (ParseOption(argv[i], "--scans", &value)) {
+      options->scans = strtoull(value.c_str(), NULL, 10);
+    } else {
+      fprintf(stderr,
+              "Usage: %s [--engines=a,b] [--workloads=a,b] [--keys=N] [--value-size=N] "
+              "[--scans=N]\n",
+              argv[0]);
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    return 1;
+  }
+
+  printf("keys: %" PRIu64 ", value size: %" PRIu64 ", scans: %" PRIu64 "\n", options.keys,
+         options.value_size, options.scans);
+  PrintHeader();
+
+  int res = 0;
+#ifdef BUILD_WITH_LEVELDB
+  res |= RunEngine<core::leveldb::DBConnection>("leveldb", options);
+#endif
+#ifdef BUILD_WITH_ROCKSDB
+  res |= RunEngine<core::rocksdb::DBConnection>("rocksdb", options);
+#endif
+#ifdef BUILD_WITH_LMDB
+  res |= RunEngine<core::lmdb::DBConnection>("lmdb", options);
+#endif
+#ifdef BUILD_WITH_UNQLITE
+  res |= RunEngine<core::unqlite::DBConnection>("unqlite", options);
+#endif
+#ifdef BUILD_WITH_UPSCALEDB
+  res |= RunEngine<core::upscaledb::DBConnection>("upscaledb", options);
+#endif
+  return res;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint64_t
+
+#include <string>  // for string
+
+#include <common/file_system.h>  // for remove_directory, remove_file
+#include <common/macros.h>       // for UNUSED
+
+#ifdef BUILD_WITH_LEVELDB
+#include "core/db/leveldb/db_connection.h"
+#endif
+#ifdef BUILD_WITH_ROCKSDB
+#include "core/db/rocksdb/db_connection.h"
+#endif
+#ifdef BUILD_WITH_LMDB
+#include "core/db/lmdb/db_connection.h"
+#endif
+#ifdef BUILD_WITH_UNQLITE
+#include "core/db/unqlite/db_connection.h"
+#endif
+#ifdef BUILD_WITH_UPSCALEDB
+#include "core/db/upscaledb/db_connection.h"
+#endif
+
+#include "bench_fixtures.h"
+
+#define BENCH_LMDB_MAP_HEADROOM (64 << 20)
+
+namespace fastonosql {
+namespace bench {
+
+// per engine: opening database for keys of value_size bytes in a fresh
+// temp location and cleanup
+template <typename DBConnection>
+struct EngineTraits;
+
+#ifdef BUILD_WITH_LEVELDB
+template <>
+struct EngineTraits<core::leveldb::DBConnection> {
+  static core::leveldb::Config MakeConfig(size_t keys, size_t value_size) {
+    UNUSED(keys);
+    UNUSED(value_size);
+    core::leveldb::Config config;
+    config.dbname = bench::TempPath("leveldb");
+    config.create_if_missing = true;
+    return config;
+  }
+  static void Remove(const std::string& path) {
+    common::Error err = common::file_system::remove_directory(path, true);
+    UNUSED(err);
+  }
+};
+#endif
+#ifdef BUILD_WITH_ROCKSDB
+template <>
+struct EngineTraits<core::rocksdb::DBConnection> {
+  static core::rocksdb::Config MakeConfig(size_t keys, size_t value_size) {
+    UNUSED(keys);
+    UNUSED(value_size);
+    core::rocksdb::Config config;
+    config.dbname = bench::TempPath("rocksdb");
+    config.create_if_missing = true;
+    return config;
+  }
+  static void Remove(const std::string& path) {
+    common::Error err = common::file_system::remove_directory(path, true);
+    UNUSED(err);
+  }
+};
+#endif
+#ifdef BUILD_WITH_LMDB
+template <>
+struct EngineTraits<core::lmdb::DBConnection> {
+  // the default 10MB map is full long before a million keys, LMDB needs
+  // the size up front: data with page overhead plus room for the freelist
+  static core::lmdb::Config MakeConfig(size_t keys, size_t value_size) {
+    core::lmdb::Config config;
+    config.dbname = bench::TempPath("lmdb");
+    config.SetReadOnlyDB(false);
+    uint64_t data = static_cast<uint64_t>(keys) * (BENCH_KEY_SIZE_MAX + value_size);
+    config.map_size = data * 2 + BENCH_LMDB_MAP_HEADROOM;
+    common::Error err = common::file_system::create_directory(config.dbname, false);
+    UNUSED(err);
+    return config;
+  }
+  static void Remove(const std::string& path) {
+    common::Error err = common::file_system::remove_directory(path, true);
+    UNUSED(err);
+  }
+};
+#endif
+#ifdef BUILD_WITH_UNQLITE
+template <>
+struct EngineTraits<core::unqlite::DBConnection> {
+  static core::unqlite::Config MakeConfig(size_t keys, size_t value_size) {
+    UNUSED(keys);
+    UNUSED(value_size);
+    core::unqlite::Config config;
+    config.dbname = bench::TempPath("unqlite");
+    config.SetCreateIfMissingDB(true);
+    return config;
+  }
+  static void Remove(const std::string& path) {
+    common::Error err = common::file_system::remove_file(path);
+    UNUSED(err);
+  }
+};
+#endif
+#ifdef BUILD_WITH_UPSCALEDB
+template <>
+struct EngineTraits<core::upscaledb::DBConnection> {
+  static core::upscaledb::Config MakeConfig(size_t keys, size_t value_size) {
+    UNUSED(keys);
+    UNUSED(value_size);
+    core::upscaledb::Config config;
+    config.dbname = bench::TempPath("upscaledb");
+    config.create_if_missing = true;
+    return config;
+  }
+  static void Remove(const std::string& path) {
+    common::Error err = common::file_system::remove_file(path);
+    UNUSED(err);
+  }
+};
+#endif
+
+}  // namespace bench
+}  // namespace fastonosql
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+
+#include "proxy/driver/driver_events.h"
+
+using namespace fastonosql;
+
+TEST(DriverEventsBatcher, idle_event_is_taken_at_once) {
+  proxy::DriverEventsBatcher batcher(16);
+  ASSERT_TRUE(batcher.IsEmpty());
+  ASSERT_FALSE(batcher.IsDue(1000));
+
+  // e.g. the only reply of a blocking MONITOR, nothing pushes after it
+  ASSERT_TRUE(batcher.Push(proxy::DriverEvent(proxy::DriverEvent::FLUSHED_DB), 1000));
+  proxy::driver_events_batch_t batch = batcher.Take(1000);
+  ASSERT_EQ(batch->size(), 1u);
+  ASSERT_EQ((*batch)[0].type, proxy::DriverEvent::FLUSHED_DB);
+  ASSERT_TRUE(batcher.IsEmpty());
+}
+
+TEST(DriverEventsBatcher, burst_waits_for_interval) {
+  proxy::DriverEventsBatcher batcher(16);
+  ASSERT_TRUE(batcher.Push(proxy::DriverEvent(proxy::DriverEvent::KEY_ADDED), 1000));
+  ASSERT_EQ(batcher.Take(1000)->size(), 1u);
+
+  ASSERT_FALSE(batcher.Push(proxy::DriverEvent(proxy::DriverEvent::KEY_ADDED), 1005));
+  ASSERT_FALSE(batcher.Push(proxy::DriverEvent(proxy::DriverEvent::KEY_REMOVED), 1010));
+  ASSERT_FALSE(batcher.IsDue(1015));
+  ASSERT_TRUE(batcher.IsDue(1016));
+
+  proxy::driver_events_batch_t batch = batcher.Take(1016);
+  ASSERT_EQ(batch->size(), 2u);
+  ASSERT_EQ((*batch)[0].type, proxy::DriverEvent::KEY_ADDED);
+  ASSERT_EQ((*batch)[1].type, proxy::DriverEvent::KEY_REMOVED);
+  ASSERT_FALSE(batcher.IsDue(2000));
+
+  // idle again after the interval
+  ASSERT_TRUE(batcher.Push(proxy::DriverEvent(proxy::DriverEvent::KEY_LOADED), 1040));
+}
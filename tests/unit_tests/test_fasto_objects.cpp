@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <memory>
+
 #include "core/global.h"
+#include "core/fasto_object_writer.h"
 
 using namespace fastonosql::core;
 
@@ -19,3 +22,96 @@ TEST(FastoObject, LifeTimeScope) {
     root->AddChildren(ptr);
   }
 }
+
+namespace {
+
+// root -> "a", [1, "b,c", [3]]
+FastoObjectIPtr MakeReplyTree() {
+  FastoObjectIPtr root = FastoObject::CreateRoot("root");
+  root->AddChildren(new FastoObject(root.get(), common::Value::createStringValue("a"), "\n"));
+  common::ArrayValue* arv = common::Value::createArrayValue();
+  FastoObjectArray* arr = new FastoObjectArray(root.get(), arv, "\n");
+  arr->Append(common::Value::createLongLongIntegerValue(1));
+  arr->Append(common::Value::createStringValue("b,c"));
+  root->AddChildren(arr);
+  FastoObjectArray* nested = new FastoObjectArray(arr, common::Value::createArrayValue(), "\n");
+  nested->Append(common::Value::createLongLongIntegerValue(3));
+  arr->AddChildren(nested);
+  return root;
+}
+
+std::string WriteTree(FastoObject* root, OutputFormat format) {
+  std::string out;
+  StringSink sink(&out);
+  common::Error err = WriteFastoObject(root, format, &sink);
+  EXPECT_FALSE(err && err->isError());
+  return out;
+}
+
+}  // namespace
+
+TEST(FastoObjectWriter, raw_matches_convert_to_string) {
+  FastoObjectIPtr root = MakeReplyTree();
+  ASSERT_EQ(WriteTree(root.get(), RAW_OUTPUT), "roota\n1\nb,c\n3\n");
+  ASSERT_EQ(common::ConvertToString(root.get()), "roota\n1\nb,c\n3\n");
+}
+
+TEST(FastoObjectWriter, formats) {
+  FastoObjectIPtr root = MakeReplyTree();
+  ASSERT_EQ(WriteTree(root.get(), JSON_OUTPUT), "[\"a\",[1,\"b,c\",[3]]]");
+  ASSERT_EQ(WriteTree(root.get(), CSV_OUTPUT), "a\n1,\"b,c\",3\n");
+  ASSERT_EQ(WriteTree(root.get(), RESP_OUTPUT),
+            "$1\r\na\r\n*3\r\n:1\r\n$3\r\nb,c\r\n*1\r\n:3\r\n");
+}
+
+TEST(FastoObjectWriter, string_sink_limit) {
+  FastoObjectIPtr root = MakeReplyTree();
+  std::string out;
+  StringSink sink(&out, 4);
+  common::Error err = WriteFastoObject(root.get(), RAW_OUTPUT, &sink);
+  ASSERT_TRUE(err && err->isError());
+  ASSERT_TRUE(sink.IsTruncated());
+  ASSERT_EQ(out, "root");
+}
+
+TEST(FastoObjectWriter, append_trees) {
+  FastoObjectIPtr first = MakeReplyTree();
+  FastoObjectIPtr second = MakeReplyTree();
+  std::string out;
+  StringSink sink(&out);
+  JsonWriter writer(&sink);
+  ASSERT_FALSE(writer.Start());
+  ASSERT_FALSE(writer.Append(first.get()));
+  ASSERT_FALSE(writer.Append(second.get()));
+  ASSERT_FALSE(writer.Finish());
+  ASSERT_EQ(out, "[\"a\",[1,\"b,c\",[3]],\"a\",[1,\"b,c\",[3]]]");
+  ASSERT_EQ(writer.RowsWritten(), 8u);
+}
+
+namespace {
+
+// [1, "b,c"] as a flat array reply read element by element
+std::string StreamArray(OutputFormat format) {
+  std::string out;
+  StringSink sink(&out);
+  std::unique_ptr<FastoObjectWriter> writer(CreateFastoObjectWriter(format, &sink));
+  EXPECT_FALSE(writer->Start());
+  EXPECT_FALSE(writer->BeginArray(2, "\n"));
+  std::unique_ptr<common::Value> first(common::Value::createLongLongIntegerValue(1));
+  EXPECT_FALSE(writer->AppendElement(first.get()));
+  std::unique_ptr<common::Value> second(common::Value::createStringValue("b,c"));
+  EXPECT_FALSE(writer->AppendElement(second.get()));
+  EXPECT_FALSE(writer->EndArray());
+  EXPECT_FALSE(writer->Finish());
+  EXPECT_EQ(writer->RowsWritten(), 2u);
+  return out;
+}
+
+}  // namespace
+
+TEST(FastoObjectWriter, streamed_array_matches_list_node) {
+  ASSERT_EQ(StreamArray(RAW_OUTPUT), "1\nb,c\n");
+  ASSERT_EQ(StreamArray(JSON_OUTPUT), "[[1,\"b,c\"]]");
+  ASSERT_EQ(StreamArray(CSV_OUTPUT), "1,\"b,c\"\n");
+  ASSERT_EQ(StreamArray(RESP_OUTPUT), "*2\r\n:1\r\n$3\r\nb,c\r\n");
+}
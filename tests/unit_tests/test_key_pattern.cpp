@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include "core/key_pattern.h"
+
+using namespace fastonosql;
+
+bool match(const std::string& pattern, const std::string& key) {
+  core::KeyPattern kp(pattern);
+  return kp.Match(key.data(), key.size());
+}
+
+TEST(KeyPattern, prefix) {
+  core::KeyPattern all("*");
+  ASSERT_EQ(all.Prefix(), std::string());
+  ASSERT_EQ(all.PrefixUpperBound(), std::string());
+
+  core::KeyPattern user("user:123:*");
+  ASSERT_EQ(user.Prefix(), "user:123:");
+  ASSERT_EQ(user.PrefixUpperBound(), "user:123;");
+
+  core::KeyPattern escaped("a\\*b?");
+  ASSERT_EQ(escaped.Prefix(), "a*b");
+
+  core::KeyPattern high("ab\xff*");
+  ASSERT_EQ(high.PrefixUpperBound(), "ac");
+}
+
+TEST(KeyPattern, match) {
+  ASSERT_TRUE(match("*", ""));
+  ASSERT_TRUE(match("*", "key"));
+  ASSERT_TRUE(match("user:1*", "user:12"));
+  ASSERT_FALSE(match("user:1*", "user:2"));
+  ASSERT_TRUE(match("key", "key"));
+  ASSERT_FALSE(match("key", "key1"));
+  ASSERT_TRUE(match("h?llo", "hello"));
+  ASSERT_FALSE(match("h?llo", "hllo"));
+  ASSERT_TRUE(match("h*llo", "hllo"));
+  ASSERT_TRUE(match("h[ae]llo", "hallo"));
+  ASSERT_FALSE(match("h[^e]llo", "hello"));
+  ASSERT_TRUE(match("k[a-c]*z", "kbxyz"));
+  ASSERT_TRUE(match("a\\*b", "a*b"));
+  ASSERT_FALSE(match("a\\*b", "axb"));
+}
+
+TEST(KeyPattern, kind) {
+  ASSERT_EQ(core::KeyPattern("*").GetKind(), core::KeyPattern::MATCH_ALL);
+  ASSERT_EQ(core::KeyPattern("key").GetKind(), core::KeyPattern::EXACT);
+  ASSERT_EQ(core::KeyPattern("key*").GetKind(), core::KeyPattern::PREFIX);
+  ASSERT_EQ(core::KeyPattern("*key").GetKind(), core::KeyPattern::SUFFIX);
+  ASSERT_EQ(core::KeyPattern("*key*").GetKind(), core::KeyPattern::CONTAINS);
+  ASSERT_EQ(core::KeyPattern("a*b*c").GetKind(), core::KeyPattern::SEGMENTS);
+  ASSERT_EQ(core::KeyPattern("a?b").GetKind(), core::KeyPattern::GLOB);
+  ASSERT_EQ(core::KeyPattern("a\\?b*").GetKind(), core::KeyPattern::PREFIX);
+}
+
+TEST(KeyPattern, segments) {
+  ASSERT_TRUE(match("*session*", "user:1:session:42"));
+  ASSERT_FALSE(match("*session*", "user:1:sess"));
+  ASSERT_TRUE(match("*:42", "user:1:session:42"));
+  ASSERT_TRUE(match("user:*:session:*", "user:1:session:42"));
+  ASSERT_FALSE(match("user:*:session:*", "user:1:token:42"));
+  ASSERT_FALSE(match("ab*ab", "ab"));  // head and tail must not overlap
+}
+
+TEST(KeyPattern, find_literal) {
+  const std::string haystack = std::string(100, 'a') + "needle" + std::string(100, 'b');
+  ASSERT_EQ(core::FindLiteral(haystack.data(), haystack.size(), "needle", 6), 100u);
+  ASSERT_EQ(core::FindLiteral(haystack.data(), haystack.size(), "needles", 7), std::string::npos);
+  ASSERT_EQ(core::FindLiteral(haystack.data(), haystack.size(), "b", 1), 106u);
+  ASSERT_EQ(core::FindLiteral(haystack.data(), haystack.size(), "", 0), 0u);
+}
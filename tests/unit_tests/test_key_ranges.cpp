@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+#include <common/sprintf.h>
+
+#include "core/key_ranges.h"
+
+using namespace fastonosql;
+
+namespace {
+
+std::vector<std::string> MakeKeys(const std::string& prefix, int count) {
+  std::vector<std::string> keys;
+  for (int i = 0; i < count; ++i) {
+    keys.push_back(common::MemSPrintf("%s%05d", prefix, i));
+  }
+  return keys;
+}
+
+core::key_range_sizes_t MakeSizes(const std::vector<std::string>& keys) {
+  return [keys](const std::vector<std::string>& bounds, std::vector<uint64_t>* sizes) {
+    sizes->assign(bounds.size() - 1, 0);
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+      core::KeyRange range(bounds[i], bounds[i + 1]);
+      for (size_t j = 0; j < keys.size(); ++j) {
+        if (range.Contains(keys[j].data(), keys[j].size())) {
+          (*sizes)[i] += 100;
+        }
+      }
+    }
+  };
+}
+
+struct FakeRange {
+  FakeRange(const std::string& start, const std::string& limit) : start(start), limit(limit) {}
+
+  std::string start;
+  std::string limit;
+};
+
+struct FakeDB {
+  void GetApproximateSizes(const FakeRange* ranges, int n, uint64_t* sizes) {
+    for (int i = 0; i < n; ++i) {
+      sizes[i] = 0;
+      for (size_t j = 0; j < keys.size(); ++j) {
+        if (keys[j] >= ranges[i].start && keys[j] < ranges[i].limit) {
+          sizes[i] += 100;
+        }
+      }
+    }
+  }
+
+  std::vector<std::string> keys;
+};
+
+}  // namespace
+
+TEST(KeyRanges, compact_bounds) {
+  std::vector<std::string> bounds;
+  common::Error err = core::MakeCompactBounds(std::string(), std::string(), &bounds);
+  ASSERT_FALSE(err && err->isError());
+  ASSERT_EQ(bounds.size(), 257u);
+  ASSERT_EQ(bounds.front(), std::string());
+  ASSERT_EQ(bounds[1], std::string(1, '\x01'));
+  ASSERT_EQ(bounds.back(), std::string());
+
+  err = core::MakeCompactBounds("b1", "d", &bounds);
+  ASSERT_FALSE(err && err->isError());
+  ASSERT_EQ(bounds, std::vector<std::string>({"b1", "c", "d"}));
+
+  err = core::MakeCompactBounds("d", "b1", &bounds);
+  ASSERT_TRUE(err && err->isError());
+}
+
+TEST(KeyRanges, approximate_sizes) {
+  FakeDB db;
+  db.keys = {"a", "b", "b1", "\xfe"};
+  std::vector<uint64_t> sizes;
+  uint64_t total = core::ApproximateKeyRangeSizes<FakeDB, FakeRange>(
+      &db, std::vector<std::string>({"", "b", ""}), &sizes);
+  ASSERT_EQ(total, 400u);
+  ASSERT_EQ(sizes, std::vector<uint64_t>({100, 300}));
+}
+
+TEST(KeyRanges, contains) {
+  core::KeyRange all;
+  ASSERT_TRUE(all.Contains("", 0));
+  ASSERT_TRUE(all.Contains("\xff", 1));
+
+  core::KeyRange ab("a", "b");
+  ASSERT_TRUE(ab.Contains("a", 1));
+  ASSERT_TRUE(ab.Contains("azz", 3));
+  ASSERT_FALSE(ab.Contains("", 0));
+  ASSERT_FALSE(ab.Contains("b", 1));
+  ASSERT_FALSE(ab.Contains("ba", 2));
+}
+
+TEST(KeyRanges, split_skewed_prefix) {
+  const std::vector<std::string> keys = MakeKeys("user:", 1000);
+  const size_t parts = 4;
+  std::vector<core::KeyRange> ranges = core::SplitKeyRange(core::KeyRange(), parts, MakeSizes(keys));
+  ASSERT_GT(ranges.size(), 1u);
+  ASSERT_LE(ranges.size(), parts);
+  ASSERT_EQ(ranges.front().start, std::string());
+  ASSERT_EQ(ranges.back().end, std::string());
+  for (size_t i = 0; i + 1 < ranges.size(); ++i) {
+    ASSERT_EQ(ranges[i].end, ranges[i + 1].start);
+  }
+
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    size_t in_range = 0;
+    for (size_t j = 0; j < keys.size(); ++j) {
+      if (ranges[i].Contains(keys[j].data(), keys[j].size())) {
+        in_range++;
+      }
+    }
+    ASSERT_LE(in_range, keys.size() / 2);
+  }
+}
+
+TEST(KeyRanges, split_without_sizes) {
+  core::KeyRange range("a", "b");
+  std::vector<core::KeyRange> ranges = core::SplitKeyRange(range, 8, MakeSizes({}));
+  ASSERT_EQ(ranges.size(), 1u);
+  ASSERT_EQ(ranges[0].start, "a");
+  ASSERT_EQ(ranges[0].end, "b");
+}
+
+TEST(KeyRanges, interpolate) {
+  std::vector<std::string> keys = MakeKeys("user:", 1000);
+  std::vector<core::KeyRange> ranges = core::InterpolateKeyRanges(keys.front(), keys.back(), 4);
+  ASSERT_EQ(ranges.size(), 4u);
+  ASSERT_TRUE(ranges.front().start.empty());
+  ASSERT_TRUE(ranges.back().end.empty());
+  for (size_t i = 0; i + 1 < ranges.size(); ++i) {
+    ASSERT_EQ(ranges[i].end, ranges[i + 1].start);
+    ASSERT_GT(ranges[i].end, keys.front());
+    ASSERT_LT(ranges[i].end, keys.back());
+  }
+
+  ranges = core::InterpolateKeyRanges("same", "same", 4);
+  ASSERT_EQ(ranges.size(), 1u);
+  ASSERT_TRUE(ranges[0].start.empty());
+  ASSERT_TRUE(ranges[0].end.empty());
+}
+
+TEST(KeyRanges, for_each) {
+  std::vector<core::KeyRange> ranges(16);
+  std::atomic<size_t> calls(0);
+  common::Error err = core::ForEachKeyRange(ranges, [&calls](size_t, const core::KeyRange&) {
+    calls++;
+    return common::Error();
+  });
+  ASSERT_FALSE(err);
+  ASSERT_EQ(calls, 16u);
+
+  err = core::ForEachKeyRange(ranges, [](size_t index, const core::KeyRange&) {
+    return index == 3 ? common::make_error_value("fail", common::ErrorValue::E_ERROR)
+                      : common::Error();
+  });
+  ASSERT_TRUE(err && err->isError());
+}
+
+TEST(KeyRanges, collector) {
+  core::KeyRangesCollector collector(3, 3);
+  ASSERT_FALSE(collector.IsEnough(0));
+  ASSERT_FALSE(collector.IsEnough(2));
+
+  std::vector<std::string> second = {"c", "d"};
+  collector.Done(1, &second);
+  ASSERT_FALSE(collector.IsEnough(2));
+
+  std::vector<std::string> first = {"a", "b"};
+  collector.Done(0, &first);
+  ASSERT_TRUE(collector.IsEnough(2));
+
+  std::vector<std::string> merged = collector.Merge();
+  ASSERT_EQ(merged, std::vector<std::string>({"a", "b", "c"}));
+}
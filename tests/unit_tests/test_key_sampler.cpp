@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+#include <common/sprintf.h>
+
+#include "core/key_sampler.h"
+
+using namespace fastonosql;
+
+TEST(KeySampler, reservoir) {
+  const size_t sample_size = 100;
+  core::KeySampler sampler(sample_size, ":", 60000, 42);
+  size_t accepted = 0;
+  size_t accepted_late = 0;
+  for (int i = 0; i < 10000; ++i) {
+    std::string key = common::MemSPrintf("key:%d", i);
+    if (sampler.Add(key.data(), key.size(), 10)) {
+      sampler.Sample("0123456789", 10);
+      accepted++;
+      if (i >= 5000) {
+        accepted_late++;
+      }
+    }
+  }
+
+  // algorithm L takes about k * (1 + ln(n / k)) keys
+  ASSERT_GT(accepted, 300u);
+  ASSERT_LT(accepted, 1000u);
+  ASSERT_GT(accepted_late, 0u);
+  ASSERT_EQ(sampler.KeysCount(), 10000u);
+}
+
+TEST(KeySampler, report) {
+  core::KeySampler sampler(10, ":", 60000, 1);
+  const char* keys[] = {"user:1", "user:2", "user:3", "order:1", "plain"};
+  const char* values[] = {"{\"a\":1}", "[1]", "123", "text", ""};
+  for (size_t i = 0; i < 5; ++i) {
+    ASSERT_TRUE(sampler.Add(keys[i], strlen(keys[i]), strlen(values[i])));
+    sampler.Sample(values[i], strlen(values[i]));
+  }
+
+  std::vector<std::string> lines = sampler.Report(true);
+  ASSERT_GE(lines.size(), 8u);
+  ASSERT_EQ(lines[0], "keys: 5 (complete pass)");
+  ASSERT_EQ(lines[4], "namespaces by \":\": 3");
+  ASSERT_EQ(lines[5], "  user: 3 (60.0%)");
+  ASSERT_EQ(lines[8],
+            "sampled values: 5, types: empty 20.0%, integer 20.0%, json 40.0%, text 20.0%, "
+            "binary 0.0%");
+}
+
+TEST(KeySampler, parse_args) {
+  size_t sample_size = 0;
+  uint32_t msec = 0;
+  common::Error err = core::ParseSampleArgs(0, nullptr, &sample_size, &msec);
+  ASSERT_FALSE(err && err->isError());
+  ASSERT_EQ(sample_size, static_cast<size_t>(KEY_SAMPLER_DEFAULT_SIZE));
+  ASSERT_EQ(msec, static_cast<uint32_t>(KEY_SAMPLER_DEFAULT_MSEC));
+
+  const char* capped[] = {"100000", "250"};
+  err = core::ParseSampleArgs(2, capped, &sample_size, &msec);
+  ASSERT_FALSE(err && err->isError());
+  ASSERT_EQ(sample_size, static_cast<size_t>(KEY_SAMPLER_MAX_SIZE));
+  ASSERT_EQ(msec, 250u);
+
+  const char* zero[] = {"0"};
+  err = core::ParseSampleArgs(1, zero, &sample_size, &msec);
+  ASSERT_TRUE(err && err->isError());
+  const char* text[] = {"10", "fast"};
+  err = core::ParseSampleArgs(2, text, &sample_size, &msec);
+  ASSERT_TRUE(err && err->isError());
+  const char* negative[] = {"-5"};
+  err = core::ParseSampleArgs(1, negative, &sample_size, &msec);
+  ASSERT_TRUE(err && err->isError());
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include "core/latency_histogram.h"
+
+using namespace fastonosql;
+
+TEST(LatencyHistogram, percentiles) {
+  core::LatencyHistogram hist;
+  ASSERT_EQ(hist.ValueAtPercentile(50), 0u);
+  for (uint64_t i = 1; i <= 10000; ++i) {
+    hist.Record(i);
+  }
+
+  ASSERT_EQ(hist.TotalCount(), 10000u);
+  ASSERT_EQ(hist.Min(), 1u);
+  ASSERT_EQ(hist.Max(), 10000u);
+  ASSERT_DOUBLE_EQ(hist.Mean(), 5000.5);
+  ASSERT_EQ(hist.ValueAtPercentile(0), 1u);
+  ASSERT_NEAR(hist.ValueAtPercentile(50), 5000, 5);  // 3 significant digits
+  ASSERT_NEAR(hist.ValueAtPercentile(99), 9900, 10);
+  ASSERT_EQ(hist.ValueAtPercentile(100), 10000u);
+}
+
+TEST(LatencyHistogram, merge_and_clamp) {
+  core::LatencyHistogram first(1000000, 2);
+  core::LatencyHistogram second(1000000, 2);
+  first.Record(10, 99);
+  second.Record(5000000);  // above highest
+  first.Merge(second);
+
+  ASSERT_EQ(first.TotalCount(), 100u);
+  ASSERT_EQ(first.ValueAtPercentile(50), 10u);
+  ASSERT_EQ(first.Max(), 1000000u);
+  ASSERT_EQ(first.ValueAtPercentile(100), 1000000u);
+
+  first.Reset();
+  ASSERT_EQ(first.TotalCount(), 0u);
+  ASSERT_EQ(first.Min(), 0u);
+}
+
+TEST(AtomicLatencyHistogram, snapshot_matches_plain) {
+  core::LatencyHistogram plain(1000000, 2);
+  core::AtomicLatencyHistogram atomic(1000000, 2);
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    plain.Record(i * 7);
+    atomic.Record(i * 7);
+  }
+
+  core::LatencyHistogram snapshot = atomic.Snapshot();
+  ASSERT_EQ(snapshot.TotalCount(), plain.TotalCount());
+  ASSERT_EQ(snapshot.Min(), plain.Min());
+  ASSERT_EQ(snapshot.Max(), plain.Max());
+  ASSERT_DOUBLE_EQ(snapshot.Mean(), plain.Mean());
+  ASSERT_EQ(snapshot.ValueAtPercentile(50), plain.ValueAtPercentile(50));
+  ASSERT_EQ(snapshot.ValueAtPercentile(99), plain.ValueAtPercentile(99));
+
+  atomic.Reset();
+  ASSERT_EQ(atomic.Snapshot().TotalCount(), 0u);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#ifdef BUILD_WITH_REDIS
+
+#include "core/db/redis/monitor_stats.h"
+
+using namespace fastonosql;
+
+TEST(EventRing, keeps_last_events) {
+  core::redis::EventRing ring(3);
+  ASSERT_TRUE(ring.Events().empty());
+
+  ring.Push("a");
+  ring.Push("b");
+  ASSERT_EQ(ring.Events(), std::vector<std::string>({"a", "b"}));
+  ASSERT_EQ(ring.DroppedCount(), 0u);
+
+  ring.Push("c");
+  ring.Push("d");
+  ring.Push("e");
+  ASSERT_EQ(ring.Events(), std::vector<std::string>({"c", "d", "e"}));
+  ASSERT_EQ(ring.TotalCount(), 5u);
+  ASSERT_EQ(ring.DroppedCount(), 2u);
+
+  for (int i = 0; i < 7; ++i) {
+    ring.Push("x");
+  }
+  ring.Push("last");
+  ASSERT_EQ(ring.Events(), std::vector<std::string>({"x", "x", "last"}));
+  ASSERT_EQ(ring.TotalCount(), 13u);
+  ASSERT_EQ(ring.DroppedCount(), 10u);
+}
+
+TEST(EventRing, zero_capacity) {
+  core::redis::EventRing ring(0);
+  ring.Push("a");
+  ring.Push("b");
+  ASSERT_TRUE(ring.Events().empty());
+  ASSERT_EQ(ring.TotalCount(), 2u);
+  ASSERT_EQ(ring.DroppedCount(), 2u);
+}
+
+TEST(TopCounter, exact_under_capacity) {
+  core::redis::TopCounter counter(10);
+  for (int i = 0; i < 5; ++i) {
+    counter.Add("get");
+  }
+  for (int i = 0; i < 3; ++i) {
+    counter.Add("set");
+  }
+  counter.Add("del");
+
+  std::vector<core::redis::TopCounter::item_t> top = counter.Top(2);
+  ASSERT_EQ(top.size(), 2u);
+  ASSERT_EQ(top[0], core::redis::TopCounter::item_t("get", 5));
+  ASSERT_EQ(top[1], core::redis::TopCounter::item_t("set", 3));
+  ASSERT_EQ(counter.Top(100).size(), 3u);
+}
+
+TEST(TopCounter, evicts_least_counted) {
+  core::redis::TopCounter counter(2);
+  for (int i = 0; i < 10; ++i) {
+    counter.Add("hot");
+  }
+  counter.Add("a");
+  counter.Add("b");  // replaces "a" and inherits its count
+
+  std::vector<core::redis::TopCounter::item_t> top = counter.Top(10);
+  ASSERT_EQ(top.size(), 2u);
+  ASSERT_EQ(top[0], core::redis::TopCounter::item_t("hot", 10));
+  ASSERT_EQ(top[1], core::redis::TopCounter::item_t("b", 2));
+
+  // heavy hitter survives a tail of distinct items while their inherited counts stay lower
+  for (int i = 0; i < 6; ++i) {
+    counter.Add("tail" + std::to_string(i));
+  }
+  top = counter.Top(2);
+  ASSERT_EQ(top[0], core::redis::TopCounter::item_t("hot", 10));
+  ASSERT_EQ(top[1], core::redis::TopCounter::item_t("tail5", 8));
+}
+
+TEST(TopCounter, zero_capacity) {
+  core::redis::TopCounter counter(0);
+  counter.Add("a");
+  ASSERT_TRUE(counter.Top(10).empty());
+}
+
+#endif
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include <limits>
+
+#include "core/server/server_info_history.h"
+
+using namespace fastonosql;
+
+#define HISTORY_TEST_PATH "test_server_info_history.bin"
+#define HISTORY_TEST_START 1700002800000LL  // hour aligned
+
+TEST(ServerInfoHistory, append_read) {
+  remove(HISTORY_TEST_PATH);
+  {
+    core::ServerInfoHistory history(HISTORY_TEST_PATH, 2);
+    ASSERT_FALSE(history.Open());
+    for (int i = 0; i < 150; ++i) {
+      std::vector<double> values = {static_cast<double>(i * 1000), i + 0.25};
+      ASSERT_FALSE(history.Append(HISTORY_TEST_START + i * 1000, values));
+    }
+
+    std::vector<core::HistoryPoint> points;
+    ASSERT_FALSE(history.Read(0, 0, std::numeric_limits<common::time64_t>::max(), &points));
+    ASSERT_EQ(points.size(), 150u);  // two written blocks and pending samples
+    ASSERT_EQ(points[149].avg, 149000);
+  }
+
+  core::ServerInfoHistory history(HISTORY_TEST_PATH, 2);
+  ASSERT_FALSE(history.Open());
+  std::vector<core::HistoryPoint> points;
+  ASSERT_FALSE(history.Read(1, HISTORY_TEST_START + 10000, HISTORY_TEST_START + 12000, &points));
+  ASSERT_EQ(points.size(), 3u);
+  ASSERT_EQ(points[0].msec, HISTORY_TEST_START + 10000);
+  ASSERT_EQ(points[0].avg, 10.25);
+  ASSERT_FALSE(history.Clear());
+  points.clear();
+  ASSERT_FALSE(history.Read(1, 0, std::numeric_limits<common::time64_t>::max(), &points));
+  ASSERT_TRUE(points.empty());
+  remove(HISTORY_TEST_PATH);
+}
+
+TEST(ServerInfoHistory, rollups) {
+  remove(HISTORY_TEST_PATH);
+  core::ServerInfoHistory history(HISTORY_TEST_PATH, 1);
+  ASSERT_FALSE(history.Open());
+  const common::time64_t step = 10000;
+  const common::time64_t end = HISTORY_TEST_START + HISTORY_RAW_RETENTION_MSEC + 60 * 60 * 1000;
+  for (common::time64_t msec = HISTORY_TEST_START; msec < end; msec += step) {
+    std::vector<double> values = {static_cast<double>((msec / step) % 6)};
+    ASSERT_FALSE(history.Append(msec, values));
+  }
+  ASSERT_FALSE(history.Compact(end));
+
+  // first minute became one min/max/avg point
+  std::vector<core::HistoryPoint> points;
+  ASSERT_FALSE(history.Read(0, HISTORY_TEST_START, HISTORY_TEST_START + 59999, &points));
+  ASSERT_EQ(points.size(), 1u);
+  ASSERT_EQ(points[0].min, 0);
+  ASSERT_EQ(points[0].max, 5);
+  ASSERT_EQ(points[0].avg, 2.5);
+
+  // recent samples stay raw
+  points.clear();
+  ASSERT_FALSE(history.Read(0, end - 60000, end, &points));
+  ASSERT_EQ(points.size(), 6u);
+  remove(HISTORY_TEST_PATH);
+}
+
+TEST(ServerInfoHistory, missing_values) {
+  remove(HISTORY_TEST_PATH);
+  core::ServerInfoHistory history(HISTORY_TEST_PATH, 2);
+  ASSERT_FALSE(history.Open());
+  std::vector<double> values = {1, std::numeric_limits<double>::quiet_NaN()};
+  ASSERT_FALSE(history.Append(HISTORY_TEST_START, values));
+  ASSERT_FALSE(history.Flush());
+
+  std::vector<core::HistoryPoint> points;
+  ASSERT_FALSE(history.Read(1, 0, std::numeric_limits<common::time64_t>::max(), &points));
+  ASSERT_TRUE(points.empty());
+  ASSERT_TRUE(history.Append(HISTORY_TEST_START, std::vector<double>(3)));
+  remove(HISTORY_TEST_PATH);
+}
+
+TEST(ServerInfoHistory, compact_corrupted) {
+  remove(HISTORY_TEST_PATH);
+  core::ServerInfoHistory history(HISTORY_TEST_PATH, 1);
+  ASSERT_FALSE(history.Open());
+  for (int i = 0; i < 150; ++i) {
+    ASSERT_FALSE(history.Append(HISTORY_TEST_START + i * 1000, std::vector<double>(1, i)));
+  }
+  ASSERT_FALSE(history.Flush());
+
+  // break the magic of the first block, right after the file header
+  FILE* file = fopen(HISTORY_TEST_PATH, "r+b");
+  ASSERT_TRUE(file);
+  ASSERT_EQ(fseek(file, 12, SEEK_SET), 0);
+  const char zeros[4] = {0, 0, 0, 0};
+  ASSERT_EQ(fwrite(zeros, 1, sizeof(zeros), file), sizeof(zeros));
+  ASSERT_EQ(fseek(file, 0, SEEK_END), 0);
+  long size = ftell(file);
+  fclose(file);
+
+  common::Error err = history.Compact(HISTORY_TEST_START + 150 * 1000);
+  ASSERT_TRUE(err && err->isError());
+  file = fopen(HISTORY_TEST_PATH, "rb");
+  ASSERT_TRUE(file);
+  ASSERT_EQ(fseek(file, 0, SEEK_END), 0);
+  ASSERT_EQ(ftell(file), size);
+  fclose(file);
+  remove(HISTORY_TEST_PATH);
+}